@@ -15,6 +15,7 @@
 #include "groufix/core/formats.h"
 #include "groufix/core/gamepad.h"
 #include "groufix/core/heap.h"
+#include "groufix/core/jobs.h"
 #include "groufix/core/keys.h"
 #include "groufix/core/log.h"
 #include "groufix/core/refs.h"
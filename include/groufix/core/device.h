@@ -49,6 +49,7 @@ typedef struct GFXDevice
 		bool indexUint32;
 		bool indirectMultiDraw;
 		bool indirectFirstInstance;
+		bool indirectCount;
 		bool cubeArray;
 		bool multisampledStorageImage;
 		bool geometryShader;
@@ -102,6 +103,7 @@ typedef struct GFXDevice
 	struct
 	{
 		uint32_t maxIndexValue;
+		uint32_t maxIndirectCount; // #draws of a single indirect draw command.
 		uint32_t maxImageSize1D;   // For { width }.
 		uint32_t maxImageSize2D;   // For { width, height }.
 		uint32_t maxImageSize3D;   // For { width, height, depth }.
@@ -138,6 +140,18 @@ typedef struct GFXDevice
 		uint32_t maxBoundSamplers;
 		uint32_t maxBoundAttachmentInputs;
 
+		// Bindless (i.e. update-after-bind) limits, apply to all descriptors
+		// of any technique containing a runtime-sized array.
+		uint32_t maxPerStageBindlessStorageBuffers;
+		uint32_t maxPerStageBindlessSampledImages;
+		uint32_t maxPerStageBindlessStorageImages;
+		uint32_t maxPerStageBindlessSamplers;
+
+		uint32_t maxBoundBindlessStorageBuffers;
+		uint32_t maxBoundBindlessSampledImages;
+		uint32_t maxBoundBindlessStorageImages;
+		uint32_t maxBoundBindlessSamplers;
+
 		uint64_t maxBufferSize;
 		uint64_t minTexelBufferAlign;
 		uint64_t minUniformBufferAlign;
@@ -0,0 +1,59 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+
+#ifndef GFX_CORE_JOBS_H
+#define GFX_CORE_JOBS_H
+
+#include "groufix/def.h"
+
+
+/**
+ * Job function, called for a range of work items.
+ * @param worker Index of the calling worker, in [0, gfx_job_get_num_workers()).
+ * @param first  First work item to process.
+ * @param count  Number of work items to process, never 0.
+ * @param ptr    User pointer as passed to gfx_job_for.
+ *
+ * No two concurrent invocations (of the same job) receive the same worker.
+ * Worker 0 is always the thread that called gfx_job_for.
+ */
+typedef void (*GFXJobFunc)(size_t worker, size_t first, size_t count,
+                           void* ptr);
+
+
+/**
+ * Retrieves the number of job workers, including the calling thread.
+ * Useful for allocating state for each worker, indexed by the worker index.
+ * Must be called after gfx_init has succesfully returned.
+ * @return At least 1.
+ *
+ * Can be called from any thread.
+ */
+GFX_API size_t gfx_job_get_num_workers(void);
+
+/**
+ * Runs a job over a range of work items in parallel & waits for completion.
+ * Must be called after gfx_init has succesfully returned.
+ * @param numItems Number of work items, must be <= UINT32_MAX.
+ * @param grain    Maximum number of items per invocation, 0 for automatic.
+ * @param func     Job function, cannot be NULL.
+ *
+ * The range is distributed over all workers, which steal from each other
+ * when they run out of work. The calling thread participates as worker 0.
+ * Worker threads are started on first use and attached to groufix.
+ *
+ * Can be called from any attached thread.
+ * If called from within a job function, or if parallel execution fails,
+ * the job is run sequentially on the calling thread, as worker 0.
+ */
+GFX_API void gfx_job_for(size_t numItems, size_t grain,
+                         GFXJobFunc func, void* ptr);
+
+
+#endif
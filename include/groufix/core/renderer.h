@@ -131,6 +131,21 @@ typedef struct GFXAttachment
 } GFXAttachment;
 
 
+/**
+ * Descriptor pool statistics.
+ */
+typedef struct GFXDescriptorStats
+{
+	size_t   pools;    // #alive Vulkan descriptor pools.
+	uint64_t capacity; // #descriptor sets all alive pools can hold.
+	uint64_t sets;     // #in-use descriptor sets.
+	uint64_t allocs;   // Total #descriptor pools ever allocated.
+	uint64_t retries;  // Total #allocation retries due to full pools.
+	uint64_t demand;   // Observed #descriptor sets per frame (decayed).
+
+} GFXDescriptorStats;
+
+
 /**
  * Image clear value.
  */
@@ -552,11 +567,13 @@ typedef struct GFXRenderable
 	GFXPrimitive* primitive;
 
 	const GFXRenderState* state;
+	size_t                permutation;
 
 	GFX_ATOMIC(bool) lock;
 
 	uintptr_t pipeline;
 	uint32_t  gen;
+	void*     perms; // Prebuilt pipeline of each permutation (or NULL).
 
 } GFXRenderable;
 
@@ -568,15 +585,18 @@ typedef struct GFXComputable
 {
 	// All read-only.
 	GFXTechnique* technique;
+	size_t        permutation;
 
 	GFX_ATOMIC(uintptr_t) pipeline;
+	void* perms; // Prebuilt pipeline of each permutation (or NULL).
 
 } GFXComputable;
 
 
 /**
  * Initializes a renderable.
- * The object pointed to by renderable _CAN_ be moved or copied!
+ * The object pointed to by renderable _CAN_ be moved or copied,
+ * unless it holds prebuilt pipelines (see gfx_renderable_prebuild_block)!
  * Any member of state may be NULL to omit setting the associated state.
  * @param renderable Cannot be NULL.
  * @param pass       Cannot be NULL, must be a render pass.
@@ -586,16 +606,65 @@ typedef struct GFXComputable
  * @return Non-zero on success.
  *
  * Can be called from any thread at any time!
- * Does not need to be cleared, hence no _init postfix.
+ * Does not need to be cleared, hence no _init postfix,
+ * unless gfx_renderable_prebuild_block was called, then it owns memory and
+ * MUST be cleared with gfx_renderable_clear before calling this again,
+ * otherwise its prebuilt pipelines are leaked.
  *
  * The object(s) pointed to by state cannot be moved or copied and must
  * remain constant as long as the renderable is being used in function calls!
  * To update state, call this function again.
+ *
+ * Initially selects permutation 0 of the technique.
  */
 GFX_API bool gfx_renderable(GFXRenderable* renderable,
                             GFXPass* pass, GFXTechnique* tech, GFXPrimitive* prim,
                             const GFXRenderState* state);
 
+/**
+ * Selects a specialization constant permutation of the technique.
+ * @param renderable Cannot be NULL, must be initialized.
+ * @param perm       Must be < gfx_tech_get_num_permutations(technique).
+ *
+ * This resets the renderable's pipeline, it cannot be in use during this call.
+ * If perm was prebuilt with gfx_renderable_prebuild_block, its pipeline is
+ * selected without any lookup.
+ */
+GFX_API void gfx_renderable_permute(GFXRenderable* renderable, size_t perm);
+
+/**
+ * Builds the pipelines of a set of permutations in parallel and blocks until
+ * all are built, keeping them around so gfx_renderable_permute can select
+ * them instantly. This is not a background compile, to not stall a frame,
+ * call it at load time or from a thread other than the one rendering.
+ * The associated technique must be locked!
+ * @param renderable Cannot be NULL, must be initialized.
+ * @param numPerms   Number of permutations, 0 for all permutations.
+ * @param perms      Permutations to build, cannot be NULL if numPerms > 0.
+ * @return Non-zero on success.
+ * @see gfx_renderable_warmup.
+ *
+ * Runs on the job system, see gfx_job_for, and blocks until all are built.
+ * Cannot be called from within a job function.
+ * The renderable cannot be in use during this call.
+ *
+ * After this call the renderable owns an allocated permutation table.
+ * It CANNOT be copied anymore (copies would free it twice) and must be
+ * cleared with gfx_renderable_clear, before being re-initialized too.
+ * Can be called again to build more permutations.
+ */
+GFX_API bool gfx_renderable_prebuild_block(GFXRenderable* renderable,
+                                     size_t numPerms, const size_t* perms);
+
+/**
+ * Clears all prebuilt pipelines of a renderable.
+ * Does nothing if gfx_renderable_prebuild_block was never called.
+ * @param renderable Cannot be NULL.
+ *
+ * The renderable is left initialized, with its permutation reset.
+ */
+GFX_API void gfx_renderable_clear(GFXRenderable* renderable);
+
 /**
  * Warms up the internal pipeline cache.
  * The associated technique must be locked!
@@ -619,7 +688,8 @@ GFX_API bool gfx_renderable_warmup(GFXRenderable* renderable);
 
 /**
  * Initializes a computable.
- * The object pointed to by computable _CAN_ be moved or copied!
+ * The object pointed to by computable _CAN_ be moved or copied,
+ * unless it holds prebuilt pipelines (see gfx_computable_prebuild_block)!
  * @param computable Cannot be NULL.
  * @see gfx_renderable.
  *
@@ -628,6 +698,29 @@ GFX_API bool gfx_renderable_warmup(GFXRenderable* renderable);
 GFX_API bool gfx_computable(GFXComputable* computable,
                             GFXTechnique* tech);
 
+/**
+ * Selects a specialization constant permutation of the technique.
+ * @param computable Cannot be NULL, must be initialized.
+ * @see gfx_renderable_permute.
+ */
+GFX_API void gfx_computable_permute(GFXComputable* computable, size_t perm);
+
+/**
+ * Builds the pipelines of a set of permutations in parallel, blocking.
+ * The associated technique must be locked!
+ * @param computable Cannot be NULL, must be initialized.
+ * @see gfx_renderable_prebuild_block.
+ */
+GFX_API bool gfx_computable_prebuild_block(GFXComputable* computable,
+                                     size_t numPerms, const size_t* perms);
+
+/**
+ * Clears all prebuilt pipelines of a computable.
+ * @param computable Cannot be NULL.
+ * @see gfx_renderable_clear.
+ */
+GFX_API void gfx_computable_clear(GFXComputable* computable);
+
 /**
  * Warms up the internal pipeline cache.
  * The associated technique must be locked!
@@ -675,6 +768,15 @@ GFX_API GFXDevice* gfx_renderer_get_device(GFXRenderer* renderer);
  */
 GFX_API unsigned int gfx_renderer_get_num_frames(GFXRenderer* renderer);
 
+/**
+ * Retrieves the statistics of the descriptor pools of a renderer.
+ * @param renderer Cannot be NULL.
+ *
+ * NOT thread-safe with respect to the renderer!
+ * Cannot be called during or inbetween gfx_frame_start and gfx_frame_submit!
+ */
+GFX_API GFXDescriptorStats gfx_renderer_get_descriptor_stats(GFXRenderer* renderer);
+
 /**
  * Loads groufix pipeline cache data, merging it into the current cache.
  * @param renderer Cannot be NULL.
@@ -808,6 +910,18 @@ GFX_API void gfx_pass_inject(GFXPass* pass,
  * All semaphores are referenced until gfx_pass_undepend(_all) is called
  * or either of the passes are erased.
  *
+ * Signal commands without a semaphore between an asynchronous compute pass
+ * and a non-asynchronous pass implicitly signal a semaphore of the renderer,
+ * transferring queue ownership to the wait pass, async modifiers are ignored.
+ * If a non-asynchronous pass waits on an asynchronous pass this way,
+ * all asynchronous passes are submitted before all others, otherwise they
+ * are submitted after all others. Either way the wait pass waits on work
+ * of the same frame, there is no latency of an entire frame.
+ * Dependencies both to and from asynchronous passes cannot exist at the same
+ * time, such signal commands are ignored until gfx_pass_undepend(_all).
+ * The semaphore is waited upon by the entire submission of the wait pass,
+ * i.e. all (non-)asynchronous passes, at the stages given by the signal.
+ *
  * It is undefined behaviour to use this call to inject a semaphore
  * between two render passes in the same frame.
  */
@@ -870,6 +984,10 @@ GFX_API void gfx_frame_block(GFXFrame* frame);
  *
  * The GFX_MEMORY_HOST_VISIBLE flag is ignored, images cannot be mapped!
  * If anything needs to be detached, this will block until rendering is done!
+ *
+ * Without any of the GFX_MEMORY_(READ|WRITE|*_CONCURRENT) flags, the image
+ * may share memory with other attachments whose lifetimes in the render graph
+ * do not overlap, its contents are undefined outside the passes consuming it.
  */
 GFX_API bool gfx_renderer_attach(GFXRenderer* renderer,
                                  size_t index, GFXAttachment attachment);
@@ -948,9 +1066,12 @@ typedef enum GFXPassType
  *
  * Asynchronous compute passes cannot be the parent of any render or inline
  * compute passes and vice versa. They are separate graphs to allow for
- * asynchronous execution.
+ * asynchronous execution, use gfx_pass_depend to synchronize between them.
  *
- * All asynchronous passes are after all others in submission order.
+ * All asynchronous passes are after all others in submission order,
+ * they are not interleaved with other passes within the same frame.
+ * Unless another pass waits on one of them through gfx_pass_depend,
+ * then all asynchronous passes are before all others.
  */
 GFX_API GFXPass* gfx_renderer_add_pass(GFXRenderer* renderer, GFXPassType type,
                                        bool culled,
@@ -1198,6 +1319,22 @@ typedef union GFXConstant
 } GFXConstant;
 
 
+/**
+ * Specialization constant domain definition.
+ * Describes all values a constant can take for permutation.
+ */
+typedef struct GFXConstantDomain
+{
+	uint32_t       id;    // ID of the specialization constant in SPIR-V.
+	GFXShaderStage stage; // Shader stages to set the constant of.
+	size_t         size;  // Must be sizeof(value.(i32|u32|f)).
+
+	size_t             numValues; // Must be > 0.
+	const GFXConstant* values;
+
+} GFXConstantDomain;
+
+
 /**
  * Adds a new technique to the renderer.
  * @param renderer   Cannot be NULL.
@@ -1307,6 +1444,40 @@ GFX_API bool gfx_tech_constant(GFXTechnique* technique,
                                uint32_t id, GFXShaderStage stage,
                                size_t size, GFXConstant value);
 
+/**
+ * Sets the specialization constant permutation domains of the technique.
+ * @param technique  Cannot be NULL.
+ * @param numDomains Number of domains, 0 to remove all permutations.
+ * @param domains    Cannot be NULL if numDomains > 0.
+ * @return Zero on failure, all domains are removed.
+ *
+ * Fails if the technique is already locked.
+ * Replaces all previously set domains, the first value of each domain is set
+ * through gfx_tech_constant. Each combination of values is a permutation,
+ * with the first domain varying fastest. Permutations are built into the
+ * pipeline cache by warming up renderables/computables that select them,
+ * or by prebuilding all (or a subset) of them at once.
+ */
+GFX_API bool gfx_tech_permute(GFXTechnique* technique,
+                              size_t numDomains, const GFXConstantDomain* domains);
+
+/**
+ * Retrieves the number of permutations of a technique (at least 1).
+ * Can be called from any thread.
+ * @param technique Cannot be NULL.
+ */
+GFX_API size_t gfx_tech_get_num_permutations(GFXTechnique* technique);
+
+/**
+ * Retrieves the permutation index of a combination of domain values.
+ * Can be called from any thread.
+ * @param technique Cannot be NULL.
+ * @param values    Value index for each domain, in order, cannot be NULL.
+ * @return Permutation index, always < gfx_tech_get_num_permutations(technique).
+ */
+GFX_API size_t gfx_tech_get_permutation(GFXTechnique* technique,
+                                        const size_t* values);
+
 /**
  * Sets immutable samplers of the technique.
  * @param technique   Cannot be NULL.
@@ -1343,6 +1514,36 @@ GFX_API bool gfx_tech_immutable(GFXTechnique* technique,
 GFX_API bool gfx_tech_dynamic(GFXTechnique* technique,
                               size_t set, size_t binding);
 
+/**
+ * Sets the capacity of a runtime-sized (i.e. unsized) array binding.
+ * @see gfx_tech_immutable.
+ * @param capacity Must be > 0, maximum #descriptors of the array.
+ * @return Non-zero if the binding is a runtime-sized array.
+ *
+ * Any set containing a runtime-sized array is bindless: it is updated in-place
+ * (i.e. after being bound) and descriptors may be left empty.
+ * Bindless sets cannot contain uniform or dynamic buffers or attachment inputs.
+ * If not set, the capacity of a runtime-sized array defaults to 1024.
+ * Locking fails if the descriptors of all sets exceed the bindless limits
+ * of the device (i.e. GFXDevice::limits.max*Bindless*).
+ */
+GFX_API bool gfx_tech_bindless(GFXTechnique* technique,
+                               size_t set, size_t binding, size_t capacity);
+
+/**
+ * Sets a set of the technique to be pushed (i.e. push descriptors).
+ * @param technique Cannot be NULL.
+ * @param set       Must be < gfx_tech_get_num_sets(technique).
+ * @return Non-zero if the set can be pushed.
+ *
+ * Pushed sets are written into the command buffer when bound, they never
+ * allocate, hash or recycle descriptor sets; ideal for per-draw sets.
+ * Only one set of a technique can be pushed, it cannot contain dynamic
+ * buffers, runtime-sized arrays or more than 32 descriptors.
+ * Fails if the technique is already locked or the device does not support it.
+ */
+GFX_API bool gfx_tech_push(GFXTechnique* technique, size_t set);
+
 /**
  * Locks the technique, preparing it for rendering & making it immutable.
  * Creating sets from a technique automatically locks the technique.
@@ -1501,6 +1702,60 @@ GFX_API bool gfx_set_is_binding_dynamic(GFXSet* set, size_t binding);
  */
 GFX_API size_t gfx_set_get_num_dynamics(GFXSet* set);
 
+/**
+ * Allocates a descriptor slot (i.e. array index) of a bindless binding.
+ * Can be called from any thread, is lock-free.
+ * @param set Cannot be NULL.
+ * @return The allocated index, SIZE_MAX on failure.
+ *
+ * The binding must be a runtime-sized array, @see gfx_tech_bindless.
+ * The returned index can be used with gfx_set_resources, gfx_set_views and
+ * gfx_set_samplers to write the descriptor, which can then be indexed from
+ * shaders without re-binding the set.
+ */
+GFX_API size_t gfx_set_alloc(GFXSet* set, size_t binding);
+
+/**
+ * Frees a descriptor slot of a bindless binding.
+ * Can be called from any thread, is lock-free.
+ * @param set   Cannot be NULL.
+ * @param index Must be an index returned by gfx_set_alloc.
+ *
+ * The slot will not be handed out again until all virtual frames that
+ * could have used it are done rendering.
+ */
+GFX_API void gfx_set_free(GFXSet* set, size_t binding, size_t index);
+
+/**
+ * Streams a dynamic buffer binding from the renderer's uniform ring.
+ * @param set Cannot be NULL.
+ * @return Zero on failure.
+ *
+ * The binding must be a dynamic buffer with a known block size, all of its
+ * descriptors are set to reference the ring (allocated on first use).
+ * Data is then pushed every frame with gfx_set_push_uniform, so per-object
+ * constants never allocate new descriptor sets.
+ * Setting any other resource to the binding stops it from being streamed.
+ */
+GFX_API bool gfx_set_stream(GFXSet* set, size_t binding);
+
+/**
+ * Pushes data to a streamed binding of a set, @see gfx_set_stream.
+ * @param recorder Cannot be NULL, must be recording.
+ * @param set      Cannot be NULL.
+ * @param data     Cannot be NULL.
+ * @param size     Must be > 0 and <= gfx_set_get_binding_block_size.
+ * @return Dynamic offset to pass to gfx_cmd_bind, UINT32_MAX on failure.
+ *
+ * Can be called from any thread, is lock-free.
+ * The data lives until the current virtual frame is done rendering.
+ * Fails when called during a static recording, as its commands (including
+ * the dynamic offset) are reused in frames the data does not live for.
+ */
+GFX_API uint32_t gfx_set_push_uniform(GFXRecorder* recorder,
+                                      GFXSet* set, size_t binding,
+                                      const void* data, size_t size);
+
 /**
  * Sets descriptor binding resources of the set.
  * @param set          Cannot be NULL.
@@ -1597,6 +1852,18 @@ typedef struct GFXDispatchCmd
 } GFXDispatchCmd;
 
 
+/**
+ * Batched draw parameters.
+ */
+typedef struct GFXBatchDraw
+{
+	GFXRenderable* renderable; // Cannot be NULL, must have a primitive.
+	uint32_t       instances;  // Must be > 0.
+	uint32_t       firstInstance;
+
+} GFXBatchDraw;
+
+
 /**
  * Adds a new recorder to the renderer.
  * @param renderer Cannot be NULL.
@@ -1641,6 +1908,33 @@ GFX_API void gfx_recorder_render(GFXRecorder* recorder, GFXPass* pass,
                                  void (*cb)(GFXRecorder*, void*),
                                  void* ptr);
 
+/**
+ * Records render commands for a range of work items in parallel.
+ * @param recorder Cannot be NULL.
+ * @param pass     Cannot be NULL, must be a render pass.
+ * @param numItems Number of work items, must be <= UINT32_MAX.
+ * @param grain    Maximum number of items per callback, 0 for automatic.
+ * @param cb       Callback, cannot be NULL.
+ * @param ptr      User pointer as last argument of cb.
+ * @see gfx_recorder_render.
+ *
+ * The callback takes a recorder, the first work item, the number of work
+ * items and a user pointer as arguments. It is called from the workers of
+ * the job system (see gfx_job_for), each with their own recorder owned by
+ * this recorder, which are only valid during the callback.
+ * The recorded commands are executed in order of work items, as if
+ * gfx_recorder_render was called once for the entire range.
+ * Each callback starts without any bound state (like gfx_recorder_render).
+ * Static recording does not apply, deferred recording applies per callback.
+ *
+ * Must be called inbetween gfx_frame_start and gfx_frame_submit!
+ * Cannot be called within a job function.
+ */
+GFX_API void gfx_recorder_render_range(GFXRecorder* recorder, GFXPass* pass,
+                                       size_t numItems, size_t grain,
+                                       void (*cb)(GFXRecorder*, size_t, size_t, void*),
+                                       void* ptr);
+
 /**
  * Records compute commands within a given compute pass.
  * @param pass Cannot be NULL, must be a compute pass.
@@ -1650,6 +1944,59 @@ GFX_API void gfx_recorder_compute(GFXRecorder* recorder, GFXPass* pass,
                                   void (*cb)(GFXRecorder*, void*),
                                   void* ptr);
 
+/**
+ * Sets whether render commands are deferred and sorted before recording.
+ * @param recorder Cannot be NULL.
+ * @param deferred Non-zero to defer, default is zero.
+ *
+ * When deferred, all draw commands within gfx_recorder_render are captured
+ * (including the bind, push & dynamic state they use) and sorted by
+ * pipeline, bound sets and primitive before being recorded,
+ * minimizing state changes. Commands are never reordered across sort groups,
+ * commands with equal state keep their relative order.
+ * Sets are captured as they are when bound, just as when not deferred.
+ * Cannot be called within a callback of gfx_recorder_(render|compute)!
+ */
+GFX_API void gfx_recorder_set_deferred(GFXRecorder* recorder, bool deferred);
+
+/**
+ * Retrieves the number of binds saved by deferred recording.
+ * @param recorder Cannot be NULL.
+ * @return #pipeline, set and primitive binds saved since gfx_renderer_start.
+ *
+ * Counted as the number of binds in submission order minus the number of
+ * binds after sorting, only increases during deferred recording.
+ */
+GFX_API uint64_t gfx_recorder_get_saved_binds(GFXRecorder* recorder);
+
+/**
+ * Sets whether render recordings are kept and reused across frames.
+ * @param recorder Cannot be NULL.
+ * @param isStatic Non-zero to reuse, default is zero.
+ *
+ * When static, gfx_recorder_render records each pass (per virtual frame)
+ * once and resubmits the same commands in subsequent frames, without
+ * calling the callback, until the pass is rebuilt, any set bound during
+ * recording changes or gfx_recorder_invalidate is called.
+ * Calling gfx_recorder_render multiple times for the same pass within a
+ * frame results in a separate recording for each call (in call order).
+ *
+ * Anything else referenced (e.g. resources or primitives) is assumed to not
+ * change! Streamed bindings cannot be pushed to, gfx_set_push_uniform fails.
+ * Cannot be called within a callback of gfx_recorder_(render|compute)!
+ */
+GFX_API void gfx_recorder_set_static(GFXRecorder* recorder, bool isStatic);
+
+/**
+ * Invalidates static recordings, forcing them to be re-recorded.
+ * @param recorder Cannot be NULL.
+ * @param pass     NULL to invalidate the recordings of all passes.
+ *
+ * Must be called before erasing any pass or set used in static recordings!
+ * Cannot be called within a callback of gfx_recorder_(render|compute)!
+ */
+GFX_API void gfx_recorder_invalidate(GFXRecorder* recorder, GFXPass* pass);
+
 /**
  * Retrieves the current virtual frame index.
  * @param recorder Cannot be NULL.
@@ -1822,6 +2169,63 @@ GFX_API void gfx_cmd_draw_indexed_from(GFXRecorder* recorder, GFXRenderable* ren
                                        uint32_t count,
                                        uint32_t stride, GFXBufferRef ref);
 
+/**
+ * Render command to indirectly (from buffer) record non-indexed draws,
+ * where the number of draws is read from a buffer as well.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @param recorder   Cannot be NULL.
+ * @param renderable Cannot be NULL.
+ * @param maxCount   Maximum number of draws to execute, can be zero.
+ * @param stride     Must be a multiple of 4, zero for tight packing.
+ * @param ref        Cannot be GFX_REF_NULL.
+ * @param countRef   Cannot be GFX_REF_NULL, offset must be a multiple of 4.
+ * @see gfx_cmd_draw_from.
+ *
+ * The buffer must contain maxCount GFXDrawCmd structures
+ * with stride bytes inbetween successive structures.
+ * The count buffer must contain a single uint32_t, the number of draws
+ * executed is the minimum of this value and maxCount.
+ * Not recorded if the device does not support indirectCount.
+ */
+GFX_API void gfx_cmd_draw_from_count(GFXRecorder* recorder, GFXRenderable* renderable,
+                                     uint32_t maxCount, uint32_t stride,
+                                     GFXBufferRef ref, GFXBufferRef countRef);
+
+/**
+ * Render command to indirectly (from buffer) record indexed draws,
+ * where the number of draws is read from a buffer as well.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @see gfx_cmd_draw_from_count.
+ *
+ * The buffer must contain maxCount GFXDrawIndexedCmd structures
+ * with stride bytes inbetween successive structures.
+ */
+GFX_API void gfx_cmd_draw_indexed_from_count(GFXRecorder* recorder, GFXRenderable* renderable,
+                                             uint32_t maxCount, uint32_t stride,
+                                             GFXBufferRef ref, GFXBufferRef countRef);
+
+/**
+ * Render command to record a batch of (entire) primitive draws.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @param recorder Cannot be NULL.
+ * @param numDraws Number of draws, must be > 0.
+ * @param draws    Array of numDraws GFXBatchDraw structures, cannot be NULL.
+ *
+ * Draw commands are written to a per-frame buffer owned by the renderer
+ * and every run of successive compatible draws is recorded as a single
+ * multi-draw indirect command. Draws are compatible if they have the same
+ * pipeline (i.e. technique, pass, state & vertex input) and their
+ * primitives reference the same buffers, such that one can be drawn
+ * relative to the other's bindings (i.e. at a whole vertex/index offset).
+ * Runs longer than the device's maxIndirectCount limit are split.
+ *
+ * Falls back to separate draws (i.e. gfx_cmd_draw_prim) if the device does
+ * not support indirectMultiDraw (or indirectFirstInstance, if used),
+ * when deferring, in static recordings or if the buffer is full.
+ */
+GFX_API void gfx_cmd_draw_batch(GFXRecorder* recorder,
+                                size_t numDraws, const GFXBatchDraw* draws);
+
 /**
  * Compute command to record a compute dispatch.
  * Can only be called within a callback of gfx_recorder_compute!
@@ -1884,5 +2288,16 @@ GFX_API void gfx_cmd_set_scissor(GFXRecorder* recorder, GFXScissor scissor);
  */
 GFX_API void gfx_cmd_set_line_width(GFXRecorder* recorder, float lineWidth);
 
+/**
+ * State command to start a new sort group.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @param recorder Cannot be NULL.
+ *
+ * Deferred draw commands are never sorted across sort groups,
+ * use this to preserve order (e.g. for blending).
+ * No-op if the recorder is not deferred.
+ */
+GFX_API void gfx_cmd_group(GFXRecorder* recorder);
+
 
 #endif
@@ -70,6 +70,24 @@ typedef enum GFXShaderResourceType
 typedef struct GFXShader GFXShader;
 
 
+/**
+ * Shader source description, for batch compilation.
+ * Equivalent to the arguments of gfx_shader_compile_bin.
+ */
+typedef struct GFXShaderSource
+{
+	GFXShaderLanguage language;
+	bool              optimize;
+
+	const GFXReader*   src; // Cannot be NULL.
+	const GFXIncluder* inc;
+	const GFXWriter*   out;
+	const GFXWriter*   bin;
+	const GFXWriter*   err;
+
+} GFXShaderSource;
+
+
 /**
  * Creates a shader.
  * @param stage  Shader stage, exactly 1 stage must be set.
@@ -101,6 +119,8 @@ GFX_API GFXDevice* gfx_shader_get_device(GFXShader* shader);
  *
  * Silently fails if shader already stores SPIR-V bytecode.
  * Output stream failure is ignored.
+ * Uses the on-disk cache if set (see gfx_shader_cache),
+ * no warnings are streamed to err when loaded from the cache.
  */
 GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
                                 bool optimize,
@@ -108,12 +128,71 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
                                 const GFXWriter* out, const GFXWriter* err);
 
 /**
- * Loads SPIR-V bytecode for use.
+ * Compiles a shader, also streaming out a binary shader.
+ * @param bin Optional binary shader output stream.
+ * @see gfx_shader_compile.
+ *
+ * A binary shader contains SPIR-V bytecode & its reflection data and can be
+ * loaded with gfx_shader_load, it is portable across platforms but specific
+ * to this version of groufix.
+ */
+GFX_API bool gfx_shader_compile_bin(GFXShader* shader, GFXShaderLanguage language,
+                                    bool optimize,
+                                    const GFXReader* src, const GFXIncluder* inc,
+                                    const GFXWriter* out, const GFXWriter* bin,
+                                    const GFXWriter* err);
+
+/**
+ * Compiles multiple shaders in parallel, see gfx_shader_compile_bin.
+ * @param shaders Cannot be NULL if numShaders > 0, all must be distinct.
+ * @param sources Cannot be NULL if numShaders > 0.
+ * @param results Optional output, non-zero for each successful compile.
+ * @return Number of successfully compiled shaders.
+ *
+ * Blocks until all shaders are compiled, distributing them over all job
+ * workers (see gfx_job_for), so the calling thread is used as worker as well.
+ * Cannot be called from within a job function.
+ * All streams are used concurrently, unless they are thread-safe
+ * themselves, every source must use distinct streams!
+ */
+GFX_API size_t gfx_shaders_compile(size_t numShaders, GFXShader** shaders,
+                                   const GFXShaderSource* sources,
+                                   bool* results);
+
+/**
+ * Sets the directory of the on-disk SPIR-V compile cache.
+ * @param path Existing directory, NULL to disable the cache.
+ * @return Non-zero on success.
+ *
+ * The cache is disabled by default.
+ * When set, gfx_shader_compile loads SPIR-V bytecode and its reflection data
+ * from this directory if the source, language, optimize flag, target API
+ * version, GPU limits and the content of all includes match.
+ * If not, the shader is compiled and stored in the cache.
+ *
+ * Logs and resets the statistics of the previous cache directory.
+ * NOT thread-safe with respect to gfx_shader_compile!
+ */
+GFX_API bool gfx_shader_cache(const char* path);
+
+/**
+ * Retrieves the statistics of the on-disk SPIR-V compile cache.
+ * @param hits   Cannot be NULL, #compiles loaded from the cache.
+ * @param misses Cannot be NULL, #compiles not loaded from the cache.
+ *
+ * Statistics are reset by gfx_shader_cache.
+ */
+GFX_API void gfx_shader_cache_stats(uint64_t* hits, uint64_t* misses);
+
+/**
+ * Loads SPIR-V bytecode or a binary shader for use.
  * @param shader Cannot be NULL.
  * @param src    Source bytecode stream, cannot be NULL.
  * @return Non-zero on success.
  *
  * Silently fails if shader already stores SPIR-V bytecode.
+ * A binary shader (see gfx_shader_compile_bin) skips all reflection,
+ * it must have been compiled for the same shader stage.
  */
 GFX_API bool gfx_shader_load(GFXShader* shader, const GFXReader* src);
 
@@ -0,0 +1,127 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+
+#ifndef GFX_DRAWERS_CULL_H
+#define GFX_DRAWERS_CULL_H
+
+#include "groufix/core/heap.h"
+#include "groufix/core/renderer.h"
+#include "groufix/core/shader.h"
+#include "groufix/def.h"
+
+
+/**
+ * GPU culled instance definition.
+ * Bounds are a box around center with extents, grown by radius,
+ * this way both bounding spheres and boxes can be described.
+ */
+typedef struct GFXCullInstance
+{
+	float center[3];
+	float radius;     // Sphere radius, 0 for boxes, INFINITY to never cull.
+	float extents[3]; // Half size of the box, 0 for spheres.
+
+	GFXDrawIndexedCmd cmd; // Drawn if the instance is visible.
+
+} GFXCullInstance;
+
+
+/**
+ * GPU culling drawer definition.
+ */
+typedef struct GFXCullDrawer
+{
+	GFXHeap*     heap;
+	GFXRenderer* renderer;
+	GFXPass*     compute;
+	GFXPass*     render;
+
+	GFXShader*    shader;
+	GFXTechnique* tech;
+	GFXComputable computable;
+
+	// Uploaded instances.
+	uint32_t   numInstances;
+	GFXBuffer* instances; // Stores { vec4 sphere, vec4 extents, GFXDrawIndexedCmd }.
+	GFXBuffer* out;       // Stores { uint32_t counts[4], GFXDrawIndexedCmd[] } per frame.
+	GFXSet*    set;
+
+} GFXCullDrawer;
+
+
+/**
+ * Initializes a GPU culling drawer.
+ * @param drawer   Cannot be NULL.
+ * @param renderer Renderer to build for, cannot be NULL.
+ * @param compute  Compute pass to cull in, cannot be NULL, must be of renderer.
+ * @param render   Render pass to draw in, may be NULL, must be of renderer.
+ * @param heap     Heap to allocate from, NULL to use the heap from renderer.
+ * @return Non-zero on success.
+ *
+ * compute must be an inline compute pass before render in submission order,
+ * a dependency from compute to render is appended with gfx_pass_depend,
+ * if render is NULL, any such dependency must be injected manually.
+ *
+ * Fails if the device does not support indirectCount (see GFXDevice).
+ */
+GFX_API bool gfx_cull_init(GFXCullDrawer* drawer, GFXRenderer* renderer,
+                           GFXPass* compute, GFXPass* render, GFXHeap* heap);
+
+/**
+ * Clears a GPU culling drawer, invalidating the contents of `drawer`.
+ * @param drawer Cannot be NULL.
+ *
+ * Cannot be called until all frames that used this drawer are done rendering!
+ * The dependency appended to the passes remains until gfx_pass_undepend.
+ */
+GFX_API void gfx_cull_clear(GFXCullDrawer* drawer);
+
+/**
+ * Uploads all instances to cull & draw, replacing any previous instances.
+ * @param drawer    Cannot be NULL.
+ * @param instances Cannot be NULL if numInstances > 0.
+ * @return Non-zero on success, zero instances are left on failure.
+ *
+ * Cannot be called until all frames that used this drawer are done rendering!
+ * Nor can it be called during or inbetween gfx_frame_start and gfx_frame_submit.
+ */
+GFX_API bool gfx_cull_upload(GFXCullDrawer* drawer,
+                             uint32_t numInstances,
+                             const GFXCullInstance* instances);
+
+/**
+ * Compute command to cull all instances against a view frustum.
+ * Can only be called within a callback of gfx_recorder_compute!
+ * @param recorder Cannot be NULL, must use the compute pass of gfx_cull_init!
+ * @param drawer   Cannot be NULL.
+ * @param viewProj Column-major view-projection matrix (float[16]),
+ *                 to Vulkan clip space (i.e. depth in [0,1]), cannot be NULL.
+ *
+ * All visible instances are compacted into a per-frame indirect buffer,
+ * their order is undefined. Tests bounds the same as gfx_draw_list_cull.
+ */
+GFX_API void gfx_cmd_cull(GFXRecorder* recorder,
+                          GFXCullDrawer* drawer, const float* viewProj);
+
+/**
+ * Render command to draw all visible instances with a single indirect draw.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @param recorder   Cannot be NULL, must use the render pass of gfx_cull_init!
+ * @param drawer     Cannot be NULL.
+ * @param renderable Cannot be NULL, technique & primitive to draw with.
+ * @see gfx_cmd_draw_indexed_from_count.
+ *
+ * Must be preceded by gfx_cmd_cull in the same frame.
+ * Per-instance data can be fetched with the first instance of each draw.
+ */
+GFX_API void gfx_cmd_draw_cull(GFXRecorder* recorder,
+                               GFXCullDrawer* drawer, GFXRenderable* renderable);
+
+
+#endif
@@ -27,12 +27,18 @@ typedef size_t GFXDrawInd;
 typedef struct GFXDrawList
 {
 	GFXVec inds;  // Stores size_t, 0-based index into items, to sort.
-	GFXVec items; // Stores { size_t pos, data... }.
-	size_t free;  // First free index into items (or SIZE_MAX).
+	GFXVec items; // Stores { size_t pos, uint64_t key, data... }.
+	GFXVec sorts;   // Stores { uint64_t key, size_t ind }, sort scratch.
+	GFXVec changed; // Stores size_t, index into items changed since sorting.
+	GFXVec bounds;  // Stores bounds of 8 items (SoA), empty if unbounded.
+	GFXVec masks;   // Stores uint8_t, visibility of 8 items, cull scratch.
+	size_t free;    // First free index into items (or SIZE_MAX).
 
 	size_t numVisible;
 	size_t elementSize;
-	bool   dirty; // True if sorting needed.
+	bool   dirty;    // True if a full sort is needed.
+	bool   rekey;    // True if all keys need to be recomputed.
+	bool   parallel; // True if large lists may be sorted in parallel.
 
 	// Draw function.
 	void (*draw)(GFXRecorder*, const void*, void*);
@@ -40,6 +46,9 @@ typedef struct GFXDrawList
 	// Comparison function, may be NULL.
 	int (*cmp)(const void*, const void*);
 
+	// Sort key function, may be NULL.
+	uint64_t (*key)(const void*);
+
 } GFXDrawList;
 
 
@@ -62,6 +71,25 @@ GFX_API void gfx_draw_list_init(GFXDrawList* list, size_t elemSize,
                                 void (*draw)(GFXRecorder*, const void*, void*),
                                 int (*cmp)(const void*, const void*));
 
+/**
+ * Initializes a draw list sorted by 64-bit keys.
+ * @param list     Cannot be NULL.
+ * @param elemSize Must be > 0.
+ * @param draw     Cannot be NULL.
+ * @param key      Cannot be NULL.
+ * @see gfx_draw_list_init.
+ *
+ * 'key' takes an element pointer and returns its sort key, elements are
+ * drawn in ascending order of keys, equal keys keep their relative order.
+ * It is called when an element is added (with non-NULL data) or dirtied,
+ * sorting is then done with a radix sort instead of comparisons.
+ * Keys should pack the most expensive state in their most significant bits,
+ * which is used to split the list when recording in parallel.
+ */
+GFX_API void gfx_draw_list_init_keyed(GFXDrawList* list, size_t elemSize,
+                                      void (*draw)(GFXRecorder*, const void*, void*),
+                                      uint64_t (*key)(const void*));
+
 /**
  * Clears the content of a draw list.
  * @param list Cannot be NULL.
@@ -113,16 +141,84 @@ GFX_API void gfx_draw_list_set_visible(GFXDrawList* list, GFXDrawInd ind,
 GFX_API void gfx_draw_list_reset_visible(GFXDrawList* list, bool visible);
 
 /**
- * Flags a draw list as dirty, forcing a re-sort.
+ * Sets the bounding sphere of an element of a draw list, used for culling.
+ * @param list   Cannot be NULL.
+ * @param ind    Must be a non-zero value returned by gfx_draw_list_add.
+ * @param center Center { x, y, z }, cannot be NULL.
+ * @param radius Must be >= 0, INFINITY to never cull.
+ * @return Zero on failure.
+ *
+ * Elements without bounds are never culled.
+ */
+GFX_API bool gfx_draw_list_set_sphere(GFXDrawList* list, GFXDrawInd ind,
+                                      const float* center, float radius);
+
+/**
+ * Sets the axis-aligned bounding box of an element of a draw list.
+ * @param list Cannot be NULL.
+ * @param ind  Must be a non-zero value returned by gfx_draw_list_add.
+ * @param min  Minimum corner { x, y, z }, cannot be NULL.
+ * @param max  Maximum corner { x, y, z }, cannot be NULL.
+ * @return Zero on failure.
+ * @see gfx_draw_list_set_sphere.
+ */
+GFX_API bool gfx_draw_list_set_aabb(GFXDrawList* list, GFXDrawInd ind,
+                                    const float* min, const float* max);
+
+/**
+ * Sets the visibility of all elements of a draw list by frustum culling.
+ * @param list     Cannot be NULL.
+ * @param viewProj Column-major view-projection matrix (float[16]),
+ *                 to Vulkan clip space (i.e. depth in [0,1]), cannot be NULL.
+ * @return Zero on failure, visibility is left untouched.
+ *
+ * All bounds are tested in a single vectorized pass, replacing any
+ * visibility set with gfx_draw_list_(set|reset)_visible.
+ * Elements without bounds are always visible.
+ */
+GFX_API bool gfx_draw_list_cull(GFXDrawList* list, const float* viewProj);
+
+/**
+ * Flags a draw list as dirty, forcing a full re-sort.
  * Useful when the order of elements changes when element data is modified.
  * @param list Cannot be NULL.
+ *
+ * If the list is keyed, the keys of all elements are recomputed.
+ * Prefer gfx_draw_list_dirty_elem if only a few elements are modified.
  */
 GFX_API void gfx_draw_list_dirty(GFXDrawList* list);
 
+/**
+ * Flags a single element of a draw list as dirty.
+ * Only dirty elements are re-sorted and merged back into the sorted order.
+ * If the list is keyed, only the key of this element is recomputed.
+ * @param list Cannot be NULL.
+ * @param ind  Must be a non-zero value returned by gfx_draw_list_add.
+ */
+GFX_API void gfx_draw_list_dirty_elem(GFXDrawList* list, GFXDrawInd ind);
+
+/**
+ * Sets whether a keyed draw list may be sorted in parallel.
+ * @param list     Cannot be NULL.
+ * @param parallel Non-zero to allow, default is zero.
+ *
+ * Only lists with many visible elements are sorted in parallel,
+ * using the job system (see gfx_job_for).
+ * When sorted from within a job function, it is sorted sequentially.
+ */
+GFX_API void gfx_draw_list_set_parallel(GFXDrawList* list, bool parallel);
+
 /**
  * Sort all visible elements of a draw list.
  * Automatically called by gfx_cmd_draw_list.
  * @param list Cannot be NULL.
+ *
+ * Uses quicksort with the comparison function or,
+ * if keyed, a least significant digit radix sort over the keys.
+ *
+ * If only some elements changed since the last sort (i.e. they were dirtied
+ * through gfx_draw_list_dirty_elem or made visible), only those are sorted
+ * and merged back in, proportional to the number of changed elements.
  */
 GFX_API void gfx_draw_list_sort(GFXDrawList* list);
 
@@ -138,5 +234,35 @@ GFX_API void gfx_draw_list_sort(GFXDrawList* list);
 GFX_API void gfx_cmd_draw_list(GFXRecorder* recorder,
                                GFXDrawList* list, void* ptr);
 
+/**
+ * Records a draw list within a given render pass, in parallel.
+ * @param list     Cannot be NULL.
+ * @param recorder Cannot be NULL.
+ * @param pass     Cannot be NULL, must be a render pass.
+ * @param ptr      User pointer as last argument of the draw function.
+ * @see gfx_recorder_render_range.
+ *
+ * The sorted visible elements are split into contiguous chunks, preferably
+ * where state changes (i.e. keys differ in their most significant bits or
+ * the comparison function does not return 0), which are recorded by the
+ * workers of the job system. Everything is still drawn in sorted order.
+ *
+ * The draw function is called concurrently from multiple threads, each with
+ * a different recorder, it must be thread-safe with respect to `ptr` and
+ * any other state it accesses. The elements themselves are only read.
+ *
+ * Each chunk starts without any bound state, the draw function cannot
+ * assume the previous element's pipeline, sets or vertex/index buffers are
+ * still bound. State it skips binding for equal consecutive elements must be
+ * tracked per recorder and reset whenever the recorder changes.
+ *
+ * The list cannot be modified during this call.
+ * Must be called inbetween gfx_frame_start and gfx_frame_submit!
+ * Cannot be called within a job function.
+ */
+GFX_API void gfx_draw_list_render(GFXDrawList* list,
+                                  GFXRecorder* recorder, GFXPass* pass,
+                                  void* ptr);
+
 
 #endif
@@ -0,0 +1,127 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+
+#ifndef GFX_DRAWERS_SCENE_H
+#define GFX_DRAWERS_SCENE_H
+
+#include "groufix/assets/gltf.h"
+#include "groufix/containers/vec.h"
+#include "groufix/core/heap.h"
+#include "groufix/core/renderer.h"
+#include "groufix/def.h"
+
+
+/**
+ * Scene instance batch definition.
+ * All instances of the same primitive/material pair.
+ */
+typedef struct GFXSceneBatch
+{
+	GFXGltfPrimitive prim;
+	GFXRenderable    renderable;
+
+	uint32_t firstInstance; // Into the transforms of a single frame.
+	uint32_t numInstances;
+
+} GFXSceneBatch;
+
+
+/**
+ * Instanced scene drawer definition.
+ */
+typedef struct GFXSceneDrawer
+{
+	GFXHeap*              heap;
+	GFXRenderer*          renderer;
+	GFXPass*              pass;
+	GFXTechnique*         tech;
+	const GFXRenderState* state;
+
+	size_t set;
+	size_t binding;
+
+	// Flattened scene.
+	GFXVec nodes;     // Stores { GFXGltfNode*, size_t parent }, parents first.
+	GFXVec worlds;    // Stores float[16], world matrix of each node.
+	GFXVec instances; // Stores size_t, node of each instance (batch order).
+	GFXVec batches;   // Stores GFXSceneBatch, sorted by material.
+
+	// Streamed transforms.
+	GFXBuffer* transforms; // Stores float[16] per instance, per frame.
+	GFXSet*    tset;
+	float*     data; // Mapped transforms.
+
+} GFXSceneDrawer;
+
+
+/**
+ * Initializes an instanced scene drawer.
+ * @param drawer   Cannot be NULL.
+ * @param renderer Renderer to build for, cannot be NULL.
+ * @param pass     Render pass to draw in, cannot be NULL, must be of renderer.
+ * @param tech     Technique to draw with, cannot be NULL, must be of renderer.
+ * @param state    Render state to draw with, may be NULL.
+ * @param set      Descriptor set of tech to bind the transforms to.
+ * @param binding  Descriptor binding within set of the transforms.
+ * @param heap     Heap to allocate from, NULL to use the heap from renderer.
+ *
+ * The binding must be a storage buffer of column-major mat4 world matrices,
+ * indexed by gl_InstanceIndex, the drawer owns (and binds) the entire set.
+ * If not NULL, state must outlive the drawer.
+ */
+GFX_API void gfx_scene_init(GFXSceneDrawer* drawer, GFXRenderer* renderer,
+                            GFXPass* pass, GFXTechnique* tech,
+                            const GFXRenderState* state,
+                            size_t set, size_t binding, GFXHeap* heap);
+
+/**
+ * Clears an instanced scene drawer, invalidating the contents of `drawer`.
+ * @param drawer Cannot be NULL.
+ *
+ * Cannot be called until all frames that used this drawer are done rendering!
+ */
+GFX_API void gfx_scene_clear(GFXSceneDrawer* drawer);
+
+/**
+ * Flattens a glTF scene and groups it into instance batches,
+ * replacing any previously built scene.
+ * @param drawer Cannot be NULL.
+ * @param scene  Scene to build, cannot be NULL.
+ * @return Non-zero on success, the drawer is empty on failure.
+ *
+ * Cannot be called until all frames that used this drawer are done rendering!
+ * Nor can it be called during or inbetween gfx_frame_start and gfx_frame_submit.
+ *
+ * Every node with a mesh becomes an instance of each of its primitives,
+ * instances of identical primitive/material pairs are drawn at once.
+ * The nodes and materials are referenced, not copied, meaning the
+ * GFXGltfResult must not be released until the drawer is rebuilt or cleared.
+ */
+GFX_API bool gfx_scene_build(GFXSceneDrawer* drawer, const GFXGltfScene* scene);
+
+/**
+ * Render command to draw an entire built scene.
+ * Can only be called within a callback of gfx_recorder_render!
+ * @param recorder Cannot be NULL, must use the pass of gfx_scene_init!
+ * @param drawer   Cannot be NULL.
+ * @param material Called before the first batch of each material, may be NULL.
+ * @param ptr      User pointer passed to material.
+ *
+ * Can be called at most once per frame, as it streams all transforms
+ * of the current frame, read from the matrix of every node.
+ * 'material' takes a recorder, the material (may be NULL) and a user pointer,
+ * it should bind any material resources, the transforms are bound before it.
+ */
+GFX_API void gfx_cmd_scene(GFXRecorder* recorder, GFXSceneDrawer* drawer,
+                           void (*material)(GFXRecorder*,
+                                            const GFXGltfMaterial*, void*),
+                           void* ptr);
+
+
+#endif
@@ -73,6 +73,7 @@
 typedef struct GFXThreadState_
 {
 	uintmax_t id;
+	size_t    jobs; // #job functions being run, non-zero if within a job.
 
 
 	// Logging data.
@@ -112,6 +113,17 @@ typedef struct GFXState_
 	void (*gamepadEvent)(GFXGamepad*, bool);
 
 
+	// On-disk shader compile cache.
+	struct
+	{
+		char* path; // Directory, NULL if disabled.
+
+		atomic_uint_fast64_t hits;
+		atomic_uint_fast64_t misses;
+
+	} shaders;
+
+
 	// Thread local data access.
 	struct
 	{
@@ -124,6 +136,23 @@ typedef struct GFXState_
 	} thread;
 
 
+	// Job system (worker threads are started on first use).
+	struct
+	{
+		GFXMutex_ lock;
+		GFXCond_  wake; // Signaled when a job is listed or on termination.
+		GFXCond_  done; // Signaled when a job loses its last worker.
+
+		GFXList     list;    // References GFXJob_ (with work left to steal).
+		GFXThread_* threads; // NULL if not started.
+		size_t      count;   // Upper bound of #workers (incl. calling thread).
+		size_t      numThreads;
+		bool        started;
+		bool        stop;
+
+	} jobs;
+
+
 	// Vulkan fields.
 	struct
 	{
@@ -224,7 +253,11 @@ typedef struct GFXContext_
 	enum
 	{
 		GFX_SUPPORT_GEOMETRY_SHADER_     = 0x0001,
-		GFX_SUPPORT_TESSELLATION_SHADER_ = 0x0002
+		GFX_SUPPORT_TESSELLATION_SHADER_ = 0x0002,
+		GFX_SUPPORT_DYNAMIC_RENDERING_   = 0x0004,
+		GFX_SUPPORT_BINDLESS_            = 0x0008,
+		GFX_SUPPORT_PUSH_DESCRIPTOR_     = 0x0010,
+		GFX_SUPPORT_INDIRECT_COUNT_      = 0x0020
 
 	} features;
 
@@ -257,6 +290,7 @@ typedef struct GFXContext_
 		GFX_VK_PFN_(BindBufferMemory);
 		GFX_VK_PFN_(BindImageMemory);
 		GFX_VK_PFN_(CmdBeginRenderPass);
+		GFX_VK_PFN_(CmdBeginRendering); // May be NULL.
 		GFX_VK_PFN_(CmdBindDescriptorSets);
 		GFX_VK_PFN_(CmdBindIndexBuffer);
 		GFX_VK_PFN_(CmdBindPipeline);
@@ -272,12 +306,16 @@ typedef struct GFXContext_
 		GFX_VK_PFN_(CmdDraw);
 		GFX_VK_PFN_(CmdDrawIndexed);
 		GFX_VK_PFN_(CmdDrawIndexedIndirect);
+		GFX_VK_PFN_(CmdDrawIndexedIndirectCount); // May be NULL.
 		GFX_VK_PFN_(CmdDrawIndirect);
+		GFX_VK_PFN_(CmdDrawIndirectCount); // May be NULL.
 		GFX_VK_PFN_(CmdEndRenderPass);
+		GFX_VK_PFN_(CmdEndRendering); // May be NULL.
 		GFX_VK_PFN_(CmdExecuteCommands);
 		GFX_VK_PFN_(CmdNextSubpass);
 		GFX_VK_PFN_(CmdPipelineBarrier);
 		GFX_VK_PFN_(CmdPushConstants);
+		GFX_VK_PFN_(CmdPushDescriptorSetWithTemplateKHR); // May be NULL.
 		GFX_VK_PFN_(CmdResolveImage);
 		GFX_VK_PFN_(CmdSetLineWidth);
 		GFX_VK_PFN_(CmdSetScissor);
@@ -340,6 +378,7 @@ typedef struct GFXContext_
 		GFX_VK_PFN_(ResetDescriptorPool);
 		GFX_VK_PFN_(ResetFences);
 		GFX_VK_PFN_(UnmapMemory);
+		GFX_VK_PFN_(UpdateDescriptorSets);
 		GFX_VK_PFN_(UpdateDescriptorSetWithTemplate);
 		GFX_VK_PFN_(WaitForFences);
 
@@ -528,6 +567,13 @@ void gfx_destroy_local_(void);
  */
 GFXThreadState_* gfx_get_local_(void);
 
+/**
+ * Stops & joins all job worker threads, no-op if they were never started.
+ * groufix_.initialized must be 1, no job can be running.
+ * Must be called before gfx_terminate_, on the same thread.
+ */
+void gfx_jobs_terminate_(void);
+
 
 /****************************
  * Devices, monitors, gamepads and Vulkan contexts.
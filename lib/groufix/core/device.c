@@ -118,15 +118,13 @@ static bool gfx_contains_substr_(const char* str, const char* substr)
 }
 
 
-#if defined (GFX_USE_VK_SUBSET_DEVICES)
-
 /****************************
- * Checks whether a given physical Vulkan device exposes the
- * VK_KHR_portability_subset extension.
+ * Checks whether a given physical Vulkan device exposes an extension.
+ * @param name Cannot be NULL, NULL-terminated extension name.
  */
-static bool gfx_device_is_subset_(VkPhysicalDevice device)
+static bool gfx_device_has_extension_(VkPhysicalDevice device, const char* name)
 {
-	bool subset = 0;
+	bool found = 0;
 
 	uint32_t extCount;
 	GFX_VK_CHECK_(groufix_.vk.EnumerateDeviceExtensionProperties(
@@ -144,11 +142,9 @@ static bool gfx_device_is_subset_(VkPhysicalDevice device)
 				device, NULL, &extCount, extProps), extCount = 0);
 
 			for (uint32_t e = 0; e < extCount; ++e)
-				if (strcmp(
-					extProps[e].extensionName,
-					"VK_KHR_portability_subset") == 0)
+				if (strcmp(extProps[e].extensionName, name) == 0)
 				{
-					subset = 1;
+					found = 1;
 					break;
 				}
 
@@ -156,11 +152,9 @@ static bool gfx_device_is_subset_(VkPhysicalDevice device)
 		}
 	}
 
-	return subset;
+	return found;
 }
 
-#endif
-
 
 /****************************
  * Fills a VkPhysicalDeviceFeatures struct with features to enable,
@@ -271,22 +265,11 @@ static void gfx_get_device_features_(GFXDevice_* device,
 
 	if (pdv12f)
 	{
-		pdv12f->drawIndirectCount                                  = VK_FALSE;
 		pdv12f->storageBuffer8BitAccess                            = VK_FALSE;
 		pdv12f->uniformAndStorageBuffer8BitAccess                  = VK_FALSE;
 		pdv12f->shaderBufferInt64Atomics                           = VK_FALSE;
 		pdv12f->shaderSharedInt64Atomics                           = VK_FALSE;
-		pdv12f->descriptorIndexing                                 = VK_FALSE;
 		pdv12f->descriptorBindingUniformBufferUpdateAfterBind      = VK_FALSE;
-		pdv12f->descriptorBindingSampledImageUpdateAfterBind       = VK_FALSE;
-		pdv12f->descriptorBindingStorageImageUpdateAfterBind       = VK_FALSE;
-		pdv12f->descriptorBindingStorageBufferUpdateAfterBind      = VK_FALSE;
-		pdv12f->descriptorBindingUniformTexelBufferUpdateAfterBind = VK_FALSE;
-		pdv12f->descriptorBindingStorageTexelBufferUpdateAfterBind = VK_FALSE;
-		pdv12f->descriptorBindingUpdateUnusedWhilePending          = VK_FALSE;
-		pdv12f->descriptorBindingPartiallyBound                    = VK_FALSE;
-		pdv12f->descriptorBindingVariableDescriptorCount           = VK_FALSE;
-		pdv12f->runtimeDescriptorArray                             = VK_FALSE;
 		pdv12f->scalarBlockLayout                                  = VK_FALSE;
 		pdv12f->imagelessFramebuffer                               = VK_FALSE;
 		pdv12f->uniformBufferStandardLayout                        = VK_FALSE;
@@ -321,7 +304,6 @@ static void gfx_get_device_features_(GFXDevice_* device,
 		pdv13f->synchronization2                                   = VK_FALSE;
 		pdv13f->textureCompressionASTC_HDR                         = VK_FALSE;
 		pdv13f->shaderZeroInitializeWorkgroupMemory                = VK_FALSE;
-		pdv13f->dynamicRendering                                   = VK_FALSE;
 	}
 
 	if (pdv14f)
@@ -345,7 +327,6 @@ static void gfx_get_device_features_(GFXDevice_* device,
 		pdv14f->pipelineProtectedAccess                = VK_FALSE;
 		pdv14f->pipelineRobustness                     = VK_FALSE;
 		pdv14f->hostImageCopy                          = VK_FALSE;
-		pdv14f->pushDescriptor                         = VK_FALSE;
 	}
 }
 
@@ -873,22 +854,54 @@ static void gfx_create_context_(GFXDevice_* device)
 		vk11, vk12, vk13, vk14,
 		pdf, pdv11f, pdv12f, pdv13f, pdv14f);
 
+	// Dynamic rendering is left enabled if supported (core since 1.3),
+	// this allows single render passes to skip render pass/framebuffer objects.
+	if (vk13 && pdv13f.dynamicRendering)
+		context->features |= GFX_SUPPORT_DYNAMIC_RENDERING_;
+
+	// Descriptor indexing is left enabled if supported (core since 1.2),
+	// bindless sets need all of these for every type but uniform buffers.
+	if (vk12 &&
+		pdv12f.runtimeDescriptorArray &&
+		pdv12f.descriptorBindingPartiallyBound &&
+		pdv12f.descriptorBindingVariableDescriptorCount &&
+		pdv12f.descriptorBindingUpdateUnusedWhilePending &&
+		pdv12f.descriptorBindingSampledImageUpdateAfterBind &&
+		pdv12f.descriptorBindingStorageImageUpdateAfterBind &&
+		pdv12f.descriptorBindingStorageBufferUpdateAfterBind &&
+		pdv12f.descriptorBindingUniformTexelBufferUpdateAfterBind &&
+		pdv12f.descriptorBindingStorageTexelBufferUpdateAfterBind)
+	{
+		context->features |= GFX_SUPPORT_BINDLESS_;
+	}
+
+	// Push descriptors are left enabled if supported (core since 1.4),
+	// otherwise we fall back to VK_KHR_push_descriptor if exposed.
+	const bool pushCore = vk14 && pdv14f.pushDescriptor;
+	const bool pushExt = !pushCore &&
+		gfx_device_has_extension_(device->vk.device, "VK_KHR_push_descriptor");
+
+	if (pushCore || pushExt)
+		context->features |= GFX_SUPPORT_PUSH_DESCRIPTOR_;
+
+	// Indirect draw counts are left enabled if supported (core since 1.2),
+	// this allows the GPU to decide how many indirect draws to execute.
+	if (vk12 && pdv12f.drawIndirectCount)
+		context->features |= GFX_SUPPORT_INDIRECT_COUNT_;
+
 	// Enable VK_KHR_swapchain so we can interact with surfaces from GLFW.
-	const char* extensions[] = {
-		"VK_KHR_swapchain",
+	const char* extensions[3] = { "VK_KHR_swapchain" };
+	uint32_t extensionCount = 1;
 
-		// If a portability subset device, add VK_KHR_portability_subset.
+	// If a portability subset device, add VK_KHR_portability_subset.
 #if defined (GFX_USE_VK_SUBSET_DEVICES)
-		"VK_KHR_portability_subset"
+	if (device->subset)
+		extensions[extensionCount++] = "VK_KHR_portability_subset";
 #endif
-	};
 
-	const uint32_t extensionCount =
-#if defined (GFX_USE_VK_SUBSET_DEVICES)
-		sizeof(extensions)/sizeof(char*) - (device->subset ? 0 : 1);
-#else
-		sizeof(extensions)/sizeof(char*);
-#endif
+	// If push descriptors are not core, add VK_KHR_push_descriptor.
+	if (pushExt)
+		extensions[extensionCount++] = "VK_KHR_push_descriptor";
 
 	// Enable VK_LAYER_KHRONOS_validation,
 	// this is deprecated by now, but for older Vulkan versions.
@@ -1082,9 +1095,50 @@ static void gfx_create_context_(GFXDevice_* device)
 	GFX_GET_DEVICE_PROC_ADDR_(ResetDescriptorPool);
 	GFX_GET_DEVICE_PROC_ADDR_(ResetFences);
 	GFX_GET_DEVICE_PROC_ADDR_(UnmapMemory);
+	GFX_GET_DEVICE_PROC_ADDR_(UpdateDescriptorSets);
 	GFX_GET_DEVICE_PROC_ADDR_(UpdateDescriptorSetWithTemplate);
 	GFX_GET_DEVICE_PROC_ADDR_(WaitForFences);
 
+	// Load functions of optional features, NULL if not supported.
+	context->vk.CmdBeginRendering = NULL;
+	context->vk.CmdEndRendering = NULL;
+
+	if (context->features & GFX_SUPPORT_DYNAMIC_RENDERING_)
+	{
+		GFX_GET_DEVICE_PROC_ADDR_(CmdBeginRendering);
+		GFX_GET_DEVICE_PROC_ADDR_(CmdEndRendering);
+	}
+
+	context->vk.CmdDrawIndexedIndirectCount = NULL;
+	context->vk.CmdDrawIndirectCount = NULL;
+
+	if (context->features & GFX_SUPPORT_INDIRECT_COUNT_)
+	{
+		GFX_GET_DEVICE_PROC_ADDR_(CmdDrawIndexedIndirectCount);
+		GFX_GET_DEVICE_PROC_ADDR_(CmdDrawIndirectCount);
+	}
+
+	// The core & extension entry points are aliases,
+	// so load the core one into the KHR pointer if core.
+	context->vk.CmdPushDescriptorSetWithTemplateKHR = NULL;
+
+	if (pushExt)
+		GFX_GET_DEVICE_PROC_ADDR_(CmdPushDescriptorSetWithTemplateKHR);
+
+	else if (pushCore)
+	{
+		context->vk.CmdPushDescriptorSetWithTemplateKHR =
+			(PFN_vkCmdPushDescriptorSetWithTemplateKHR)
+			groufix_.vk.GetDeviceProcAddr(
+				context->vk.device, "vkCmdPushDescriptorSetWithTemplate");
+
+		if (context->vk.CmdPushDescriptorSetWithTemplateKHR == NULL)
+		{
+			gfx_log_error("Could not load vkCmdPushDescriptorSetWithTemplate.");
+			goto clean;
+		}
+	}
+
 
 	// Set device's reference to this context.
 	device->context = context;
@@ -1142,7 +1196,7 @@ static void gfx_device_init_(GFXDevice_* dev, VkPhysicalDevice device)
 	// If we're including portability subset devices, we need to check if
 	// the device exposes VK_KHR_portability_subset.
 	// If it does, we need to enable the extension in the device.
-	dev->subset = gfx_device_is_subset_(device);
+	dev->subset = gfx_device_has_extension_(device, "VK_KHR_portability_subset");
 #endif
 
 	// Get all Vulkan device features as well.
@@ -1231,6 +1285,7 @@ static void gfx_device_init_(GFXDevice_* dev, VkPhysicalDevice device)
 			.indexUint32              = pdf.fullDrawIndexUint32,
 			.indirectMultiDraw        = pdf.multiDrawIndirect,
 			.indirectFirstInstance    = pdf.drawIndirectFirstInstance,
+			.indirectCount            = (vk12 ? pdv12f.drawIndirectCount : 0),
 			.cubeArray                = pdf.imageCubeArray,
 			.multisampledStorageImage = pdf.shaderStorageImageMultisample,
 			.geometryShader           = pdf.geometryShader,
@@ -1281,6 +1336,7 @@ static void gfx_device_init_(GFXDevice_* dev, VkPhysicalDevice device)
 
 		.limits = {
 			.maxIndexValue         = pdp->limits.maxDrawIndexedIndexValue,
+			.maxIndirectCount      = pdp->limits.maxDrawIndirectCount,
 			.maxImageSize1D        = pdp->limits.maxImageDimension1D,
 			.maxImageSize2D        = pdp->limits.maxImageDimension2D,
 			.maxImageSize3D        = pdp->limits.maxImageDimension3D,
@@ -1317,6 +1373,16 @@ static void gfx_device_init_(GFXDevice_* dev, VkPhysicalDevice device)
 			.maxBoundSamplers              = pdp->limits.maxDescriptorSetSamplers,
 			.maxBoundAttachmentInputs      = pdp->limits.maxDescriptorSetInputAttachments,
 
+			.maxPerStageBindlessStorageBuffers = (vk12 ? pdv12p.maxPerStageDescriptorUpdateAfterBindStorageBuffers : 0),
+			.maxPerStageBindlessSampledImages  = (vk12 ? pdv12p.maxPerStageDescriptorUpdateAfterBindSampledImages : 0),
+			.maxPerStageBindlessStorageImages  = (vk12 ? pdv12p.maxPerStageDescriptorUpdateAfterBindStorageImages : 0),
+			.maxPerStageBindlessSamplers       = (vk12 ? pdv12p.maxPerStageDescriptorUpdateAfterBindSamplers : 0),
+
+			.maxBoundBindlessStorageBuffers = (vk12 ? pdv12p.maxDescriptorSetUpdateAfterBindStorageBuffers : 0),
+			.maxBoundBindlessSampledImages  = (vk12 ? pdv12p.maxDescriptorSetUpdateAfterBindSampledImages : 0),
+			.maxBoundBindlessStorageImages  = (vk12 ? pdv12p.maxDescriptorSetUpdateAfterBindStorageImages : 0),
+			.maxBoundBindlessSamplers       = (vk12 ? pdv12p.maxDescriptorSetUpdateAfterBindSamplers : 0),
+
 			.maxBufferSize         = (vk13 ? pdv13p.maxBufferSize : (uint64_t)1073741824), // 2^30
 			.minTexelBufferAlign   = pdp->limits.minTexelBufferOffsetAlignment,
 			.minUniformBufferAlign = pdp->limits.minUniformBufferOffsetAlignment,
@@ -317,21 +317,25 @@ static void gfx_image_free_(GFXImage_* image)
 	gfx_free_(&heap->allocator, &image->alloc);
 }
 
-/****************************/
-GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
-                                const GFXImageAttach_* attach)
+/****************************
+ * Creates the Vulkan image of a new backing image, without any memory.
+ * @param attach Cannot be NULL, { .width, .height, .depth } > 0.
+ * @param usage  Outputs the Vulkan image usage flags, cannot be NULL.
+ * @return NULL on failure.
+ */
+static GFXBacking_* gfx_create_backing_(GFXHeap* heap,
+                                        const GFXImageAttach_* attach,
+                                        VkImageUsageFlags* usage)
 {
 	assert(heap != NULL);
 	assert(attach != NULL);
-	assert(attach->width > 0);
-	assert(attach->height > 0);
-	assert(attach->depth > 0);
+	assert(usage != NULL);
 
 	GFXContext_* context = heap->allocator.context;
 
 	// Allocate a new backing image.
 	GFXBacking_* backing = malloc(sizeof(GFXBacking_));
-	if (backing == NULL) goto clean;
+	if (backing == NULL) return NULL;
 
 	// Get queue families to share with.
 	uint32_t families[3] = {
@@ -350,7 +354,7 @@ GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
 		(attach->base.type == GFX_IMAGE_CUBE) ?
 			VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
 
-	VkImageUsageFlags usage = GFX_GET_VK_IMAGE_USAGE_(
+	*usage = GFX_GET_VK_IMAGE_USAGE_(
 		attach->base.flags, attach->base.usage, attach->base.format);
 
 	VkImageCreateInfo ici = {
@@ -369,7 +373,7 @@ GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
 		.arrayLayers           = attach->base.layers,
 		.samples               = attach->base.samples,
 		.tiling                = VK_IMAGE_TILING_OPTIMAL,
-		.usage                 = usage,
+		.usage                 = *usage,
 		.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED,
 		.queueFamilyIndexCount = fCount > 1 ? fCount : 0,
 		.pQueueFamilyIndices   = fCount > 1 ? families : NULL,
@@ -380,6 +384,35 @@ GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
 	GFX_VK_CHECK_(context->vk.CreateImage(
 		context->vk.device, &ici, NULL, &backing->vk.image), goto clean);
 
+	backing->shared = NULL;
+
+	return backing;
+
+
+	// Cleanup on failure.
+clean:
+	free(backing);
+
+	return NULL;
+}
+
+/****************************/
+GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
+                                const GFXImageAttach_* attach)
+{
+	assert(heap != NULL);
+	assert(attach != NULL);
+	assert(attach->width > 0);
+	assert(attach->height > 0);
+	assert(attach->depth > 0);
+
+	GFXContext_* context = heap->allocator.context;
+
+	// Create a new backing image.
+	VkImageUsageFlags usage;
+	GFXBacking_* backing = gfx_create_backing_(heap, attach, &usage);
+	if (backing == NULL) goto error;
+
 	// Get memory requirements & do actual allocation.
 	VkImageMemoryRequirementsInfo2 imri2 = {
 		.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
@@ -428,6 +461,7 @@ GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
 	// Cleanup on failure.
 clean:
 	free(backing);
+error:
 	gfx_log_error(
 		"Could not allocate a %"PRIu32"x%"PRIu32"x%"PRIu32" backing image.",
 		attach->width, attach->height, attach->depth);
@@ -449,13 +483,124 @@ void gfx_free_backing_(GFXHeap* heap, GFXBacking_* backing)
 		context->vk.device, backing->vk.image, NULL);
 
 	// Lock, free the memory & unlock.
+	// If shared, only free it when the last backing is freed.
 	gfx_mutex_lock_(&heap->lock);
-	gfx_free_(alloc, &backing->alloc);
+
+	if (backing->shared == NULL)
+		gfx_free_(alloc, &backing->alloc);
+
+	else if (--backing->shared->refs == 0)
+	{
+		gfx_free_(alloc, &backing->shared->alloc);
+		free(backing->shared);
+	}
+
 	gfx_mutex_unlock_(&heap->lock);
 
 	free(backing);
 }
 
+/****************************/
+bool gfx_alloc_backings_(GFXHeap* heap, size_t num,
+                         const GFXImageAttach_** attachs,
+                         GFXBacking_** backings)
+{
+	assert(heap != NULL);
+	assert(num > 0);
+	assert(attachs != NULL);
+	assert(backings != NULL);
+
+	GFXContext_* context = heap->allocator.context;
+
+	// Allocate the shared memory object.
+	GFXBackingMem_* shared = malloc(sizeof(GFXBackingMem_));
+	if (shared == NULL) goto error;
+
+	// Create all backing images & merge their memory requirements.
+	// The memory must satisfy the requirements of each of them.
+	VkMemoryRequirements reqs = {
+		.size = 0,
+		.alignment = 1,
+		.memoryTypeBits = ~(uint32_t)0
+	};
+
+	size_t b;
+	for (b = 0; b < num; ++b)
+	{
+		VkImageUsageFlags usage;
+		backings[b] = gfx_create_backing_(heap, attachs[b], &usage);
+		if (backings[b] == NULL) goto clean;
+
+		VkMemoryRequirements mr;
+		context->vk.GetImageMemoryRequirements(
+			context->vk.device, backings[b]->vk.image, &mr);
+
+		reqs.size = GFX_MAX(reqs.size, mr.size);
+		reqs.alignment = GFX_MAX(reqs.alignment, mr.alignment);
+		reqs.memoryTypeBits &= mr.memoryTypeBits;
+	}
+
+	// No memory type that suits all, cannot alias.
+	if (reqs.memoryTypeBits == 0)
+		goto clean;
+
+	// Lock just before the allocation, never dedicated memory,
+	// which binds the first image.
+	gfx_mutex_lock_(&heap->lock);
+
+	if (!gfx_alloc_mem_(
+		&heap->allocator, &shared->alloc, 0, 0, attachs[0]->base.flags,
+		&reqs, NULL,
+		VK_NULL_HANDLE, backings[0]->vk.image))
+	{
+		gfx_mutex_unlock_(&heap->lock);
+		goto clean;
+	}
+
+	gfx_mutex_unlock_(&heap->lock);
+
+	// Bind all other images to the same memory.
+	for (b = 1; b < num; ++b)
+		GFX_VK_CHECK_(
+			context->vk.BindImageMemory(
+				context->vk.device, backings[b]->vk.image,
+				shared->alloc.block->vk.memory, shared->alloc.offset),
+			goto unbind);
+
+	// Link the memory to all backings.
+	shared->refs = num;
+
+	for (b = 0; b < num; ++b)
+		backings[b]->shared = shared;
+
+	return 1;
+
+
+	// Cleanup on failure.
+unbind:
+	gfx_mutex_lock_(&heap->lock);
+	gfx_free_(&heap->allocator, &shared->alloc);
+	gfx_mutex_unlock_(&heap->lock);
+
+	b = num;
+clean:
+	while (b > 0)
+	{
+		--b;
+		context->vk.DestroyImage(
+			context->vk.device, backings[b]->vk.image, NULL);
+		free(backings[b]);
+	}
+
+	free(shared);
+error:
+	gfx_log_error(
+		"Could not allocate %"GFX_PRIs" aliased backing images.",
+		num);
+
+	return 0;
+}
+
 /****************************/
 GFXStaging_* gfx_alloc_staging_(GFXHeap* heap,
                                 VkBufferUsageFlags usage, uint64_t size)
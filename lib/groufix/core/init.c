@@ -36,6 +36,23 @@ bool gfx_init_(void)
 	if (!gfx_mutex_init_(&groufix_.contextLock))
 		goto clean_io;
 
+	// Initialize the job system, its workers are started on first use.
+	if (!gfx_mutex_init_(&groufix_.jobs.lock))
+		goto clean_context;
+
+	if (!gfx_cond_init_(&groufix_.jobs.wake))
+		goto clean_jobs;
+
+	if (!gfx_cond_init_(&groufix_.jobs.done))
+		goto clean_wake;
+
+	gfx_list_init(&groufix_.jobs.list);
+	groufix_.jobs.threads = NULL;
+	groufix_.jobs.count = gfx_thread_concurrency_();
+	groufix_.jobs.numThreads = 0;
+	groufix_.jobs.started = 0;
+	groufix_.jobs.stop = 0;
+
 	gfx_vec_init(&groufix_.devices, sizeof(GFXDevice_));
 	gfx_list_init(&groufix_.contexts);
 	gfx_vec_init(&groufix_.monitors, sizeof(GFXMonitor_*));
@@ -43,8 +60,12 @@ bool gfx_init_(void)
 
 	groufix_.monitorEvent = NULL;
 	groufix_.gamepadEvent = NULL;
+	groufix_.shaders.path = NULL;
 	groufix_.vk.instance = NULL;
 
+	atomic_store_explicit(&groufix_.shaders.hits, 0, memory_order_relaxed);
+	atomic_store_explicit(&groufix_.shaders.misses, 0, memory_order_relaxed);
+
 #if !defined (NDEBUG)
 	groufix_.vk.useValidationLayers = 1;
 #endif
@@ -59,6 +80,12 @@ bool gfx_init_(void)
 
 
 	// Cleanup on failure.
+clean_wake:
+	gfx_cond_clear_(&groufix_.jobs.wake);
+clean_jobs:
+	gfx_mutex_clear_(&groufix_.jobs.lock);
+clean_context:
+	gfx_mutex_clear_(&groufix_.contextLock);
 clean_io:
 	gfx_mutex_clear_(&groufix_.thread.ioLock);
 clean_key:
@@ -76,11 +103,17 @@ void gfx_terminate_(void)
 	gfx_list_clear(&groufix_.contexts);
 	gfx_vec_clear(&groufix_.monitors);
 	gfx_vec_clear(&groufix_.gamepads);
+	free(groufix_.shaders.path);
 
 	gfx_thread_key_clear_(groufix_.thread.key);
 	gfx_mutex_clear_(&groufix_.thread.ioLock);
 	gfx_mutex_clear_(&groufix_.contextLock);
 
+	gfx_list_clear(&groufix_.jobs.list);
+	gfx_cond_clear_(&groufix_.jobs.done);
+	gfx_cond_clear_(&groufix_.jobs.wake);
+	gfx_mutex_clear_(&groufix_.jobs.lock);
+
 	// Signal that termination is done.
 	atomic_store(&groufix_.initialized, 0);
 }
@@ -105,6 +138,8 @@ bool gfx_create_local_(void)
 	state->id =
 		atomic_fetch_add_explicit(&groufix_.thread.id, 1, memory_order_relaxed);
 
+	state->jobs = 0;
+
 	// Initialize the logging stuff.
 	state->log.level = groufix_.logDef;
 	gfx_buf_writer(&state->log.out, gfx_io_buf_def_.dest);
@@ -0,0 +1,387 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#include "groufix/core.h"
+#include <stdlib.h>
+
+
+// Packs a range of work items into a single (atomic) value.
+#define GFX_JOB_PACK_(begin, end) \
+	(((uint_fast64_t)(end) << 32) | (uint_fast64_t)(begin))
+
+#define GFX_JOB_BEGIN_(range) \
+	((size_t)((range) & UINT32_MAX))
+
+#define GFX_JOB_END_(range) \
+	((size_t)(((range) >> 32) & UINT32_MAX))
+
+
+/**
+ * Parallel job definition.
+ */
+typedef struct GFXJob_
+{
+	GFXListNode list; // Base-type.
+
+	GFXJobFunc func;
+	void*      ptr;
+	size_t     grain;
+
+	// Locked by groufix_.jobs.lock.
+	size_t users;  // #worker threads participating.
+	bool   listed; // Non-zero if in groufix_.jobs.list.
+
+	// Remaining range of each worker, packed.
+	size_t               numRanges;
+	atomic_uint_fast64_t ranges[];
+
+} GFXJob_;
+
+
+/****************************
+ * Takes the next piece of work from a worker's own range.
+ * @param job   Cannot be NULL.
+ * @param slot  Worker index, must be < job->numRanges.
+ * @param first Output first work item, cannot be NULL.
+ * @param count Output number of work items, cannot be NULL.
+ * @return Zero if the worker's range is empty.
+ */
+static bool gfx_job_take_(GFXJob_* job, size_t slot,
+                          size_t* first, size_t* count)
+{
+	assert(job != NULL);
+	assert(slot < job->numRanges);
+	assert(first != NULL);
+	assert(count != NULL);
+
+	atomic_uint_fast64_t* range = &job->ranges[slot];
+	uint_fast64_t r = atomic_load_explicit(range, memory_order_relaxed);
+
+	// Take from the front, thieves take from the back.
+	while (1)
+	{
+		const size_t begin = GFX_JOB_BEGIN_(r);
+		const size_t end = GFX_JOB_END_(r);
+		if (begin >= end) return 0;
+
+		const size_t n = GFX_MIN(job->grain, end - begin);
+
+		if (atomic_compare_exchange_weak_explicit(
+			range, &r, GFX_JOB_PACK_(begin + n, end),
+			memory_order_relaxed, memory_order_relaxed))
+		{
+			*first = begin;
+			*count = n;
+			return 1;
+		}
+	}
+}
+
+/****************************
+ * Steals work from any other worker, moving it into a worker's own range.
+ * @param job  Cannot be NULL.
+ * @param slot Worker index, must be < job->numRanges, its range must be empty.
+ * @return Zero if there was nothing left to steal.
+ */
+static bool gfx_job_steal_(GFXJob_* job, size_t slot)
+{
+	assert(job != NULL);
+	assert(slot < job->numRanges);
+
+	// Start at our neighbour so not all thieves hit the same victim.
+	for (size_t i = 1; i < job->numRanges; ++i)
+	{
+		const size_t victim = (slot + i) % job->numRanges;
+		atomic_uint_fast64_t* range = &job->ranges[victim];
+		uint_fast64_t r = atomic_load_explicit(range, memory_order_relaxed);
+
+		while (1)
+		{
+			const size_t begin = GFX_JOB_BEGIN_(r);
+			const size_t end = GFX_JOB_END_(r);
+			if (begin >= end) break;
+
+			// Steal the back half, or all of it if it's not worth splitting.
+			const size_t rem = end - begin;
+			const size_t n = rem > job->grain ? rem >> 1 : rem;
+
+			if (atomic_compare_exchange_weak_explicit(
+				range, &r, GFX_JOB_PACK_(begin, end - n),
+				memory_order_relaxed, memory_order_relaxed))
+			{
+				// Our own range was empty, so no-one can steal from it.
+				atomic_store_explicit(&job->ranges[slot],
+					GFX_JOB_PACK_(end - n, end), memory_order_relaxed);
+
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/****************************
+ * Participates in a job until there is no work left to take or steal.
+ * @param job  Cannot be NULL.
+ * @param slot Worker index, must be < job->numRanges.
+ */
+static void gfx_job_work_(GFXJob_* job, size_t slot)
+{
+	assert(job != NULL);
+	assert(slot < job->numRanges);
+
+	// Flag the calling thread as being within a job,
+	// so nested calls to gfx_job_for run sequentially.
+	GFXThreadState_* state = gfx_get_local_();
+	if (state != NULL) ++state->jobs;
+
+	size_t first, count;
+
+	while (1)
+	{
+		if (!gfx_job_take_(job, slot, &first, &count))
+		{
+			if (!gfx_job_steal_(job, slot)) break;
+			continue;
+		}
+
+		job->func(slot, first, count, job->ptr);
+	}
+
+	if (state != NULL) --state->jobs;
+}
+
+/****************************
+ * Removes a job from the job list, so no more workers pick it up.
+ * groufix_.jobs.lock must be locked.
+ * @param job Cannot be NULL.
+ */
+static void gfx_job_unlist_(GFXJob_* job)
+{
+	assert(job != NULL);
+
+	if (job->listed)
+	{
+		gfx_list_erase(&groufix_.jobs.list, &job->list);
+		job->listed = 0;
+	}
+}
+
+/****************************
+ * Worker thread entry point.
+ * @param arg Worker index (i.e. slot in each job), cast to a pointer.
+ */
+static GFXThreadRet_ GFX_THREAD_CALL_ gfx_job_worker_(void* arg)
+{
+	const size_t slot = (size_t)(uintptr_t)arg;
+
+	// Job functions may call into groufix, so attach ourselves.
+	// If this fails, just never participate, jobs complete without us.
+	if (!gfx_create_local_())
+		return 0;
+
+	gfx_mutex_lock_(&groufix_.jobs.lock);
+
+	while (!groufix_.jobs.stop)
+	{
+		if (groufix_.jobs.list.head == NULL)
+		{
+			gfx_cond_wait_(&groufix_.jobs.wake, &groufix_.jobs.lock);
+			continue;
+		}
+
+		// Join the oldest job with work left.
+		GFXJob_* job = (GFXJob_*)groufix_.jobs.list.head;
+		++job->users;
+
+		gfx_mutex_unlock_(&groufix_.jobs.lock);
+		gfx_job_work_(job, slot);
+		gfx_mutex_lock_(&groufix_.jobs.lock);
+
+		// All work is taken, stop others from joining it.
+		// Then let the calling thread know if we were the last one.
+		gfx_job_unlist_(job);
+
+		if (--job->users == 0)
+			gfx_cond_broadcast_(&groufix_.jobs.done);
+	}
+
+	gfx_mutex_unlock_(&groufix_.jobs.lock);
+	gfx_destroy_local_();
+
+	return 0;
+}
+
+/****************************
+ * Starts all worker threads.
+ * groufix_.jobs.lock must be locked, groufix_.jobs.started must be 0.
+ *
+ * Always marks the workers as started, even if no threads could be created.
+ */
+static void gfx_jobs_start_(void)
+{
+	assert(!groufix_.jobs.started);
+
+	groufix_.jobs.started = 1;
+	groufix_.jobs.stop = 0;
+
+	// The calling thread of each job is also a worker.
+	const size_t count = groufix_.jobs.count - 1;
+	if (count == 0) return;
+
+	groufix_.jobs.threads = malloc(sizeof(GFXThread_) * count);
+	if (groufix_.jobs.threads == NULL)
+		goto warn;
+
+	// Slot 0 is reserved for the calling thread.
+	while (groufix_.jobs.numThreads < count)
+	{
+		const size_t slot = groufix_.jobs.numThreads + 1;
+
+		if (!gfx_thread_init_(
+			groufix_.jobs.threads + groufix_.jobs.numThreads,
+			gfx_job_worker_, (void*)(uintptr_t)slot))
+		{
+			goto warn;
+		}
+
+		++groufix_.jobs.numThreads;
+	}
+
+	return;
+
+
+	// Continue with however many workers we got.
+warn:
+	gfx_log_warn(
+		"Could only start %"GFX_PRIs" out of %"GFX_PRIs" job worker threads.",
+		groufix_.jobs.numThreads, count);
+}
+
+/****************************/
+void gfx_jobs_terminate_(void)
+{
+	assert(atomic_load(&groufix_.initialized));
+
+	gfx_mutex_lock_(&groufix_.jobs.lock);
+	assert(groufix_.jobs.list.head == NULL);
+
+	groufix_.jobs.stop = 1;
+	gfx_cond_broadcast_(&groufix_.jobs.wake);
+
+	gfx_mutex_unlock_(&groufix_.jobs.lock);
+
+	// Join outside the lock, workers need it to exit.
+	for (size_t t = 0; t < groufix_.jobs.numThreads; ++t)
+		gfx_thread_join_(groufix_.jobs.threads[t]);
+
+	free(groufix_.jobs.threads);
+	groufix_.jobs.threads = NULL;
+	groufix_.jobs.numThreads = 0;
+	groufix_.jobs.started = 0;
+}
+
+/****************************/
+GFX_API size_t gfx_job_get_num_workers(void)
+{
+	assert(atomic_load(&groufix_.initialized));
+
+	return groufix_.jobs.count;
+}
+
+/****************************/
+GFX_API void gfx_job_for(size_t numItems, size_t grain,
+                         GFXJobFunc func, void* ptr)
+{
+	assert(atomic_load(&groufix_.initialized));
+	assert(numItems <= UINT32_MAX);
+	assert(func != NULL);
+
+	if (numItems == 0) return;
+
+	// If already within a job, run it sequentially on the calling thread.
+	// Otherwise we would wait on workers that may be waiting on us.
+	GFXThreadState_* state = gfx_get_local_();
+	if (state != NULL && state->jobs > 0)
+	{
+		if (grain == 0) grain = numItems;
+
+		++state->jobs;
+		for (size_t first = 0; first < numItems; first += grain)
+			func(0, first, GFX_MIN(grain, numItems - first), ptr);
+
+		--state->jobs;
+		return;
+	}
+
+	// Start the workers if not done so yet.
+	gfx_mutex_lock_(&groufix_.jobs.lock);
+
+	if (!groufix_.jobs.started)
+		gfx_jobs_start_();
+
+	const size_t numRanges = groufix_.jobs.numThreads + 1;
+
+	gfx_mutex_unlock_(&groufix_.jobs.lock);
+
+	// Default to a few pieces per worker so stealing can balance the load.
+	if (grain == 0)
+		grain = GFX_MAX(1, numItems / (numRanges * 4));
+
+	// Allocate the job, with a range for each worker.
+	GFXJob_* job = NULL;
+
+	if (numRanges > 1 && numItems > grain)
+		job = malloc(
+			sizeof(GFXJob_) + sizeof(atomic_uint_fast64_t) * numRanges);
+
+	// If nothing to share (or failed to), run it on the calling thread.
+	if (job == NULL)
+	{
+		if (state != NULL) ++state->jobs;
+		for (size_t first = 0; first < numItems; first += grain)
+			func(0, first, GFX_MIN(grain, numItems - first), ptr);
+
+		if (state != NULL) --state->jobs;
+		return;
+	}
+
+	job->func = func;
+	job->ptr = ptr;
+	job->grain = grain;
+	job->users = 0;
+	job->listed = 1;
+	job->numRanges = numRanges;
+
+	// Initially distribute the items evenly.
+	for (size_t r = 0; r < numRanges; ++r)
+		atomic_init(&job->ranges[r], GFX_JOB_PACK_(
+			(uint64_t)numItems * r / numRanges,
+			(uint64_t)numItems * (r + 1) / numRanges));
+
+	// List the job & wake up the workers.
+	gfx_mutex_lock_(&groufix_.jobs.lock);
+	gfx_list_insert_after(&groufix_.jobs.list, &job->list, NULL);
+	gfx_cond_broadcast_(&groufix_.jobs.wake);
+	gfx_mutex_unlock_(&groufix_.jobs.lock);
+
+	// Participate ourselves.
+	gfx_job_work_(job, 0);
+
+	// Wait for all workers to finish their last pieces of work.
+	gfx_mutex_lock_(&groufix_.jobs.lock);
+	gfx_job_unlist_(job);
+
+	while (job->users > 0)
+		gfx_cond_wait_(&groufix_.jobs.done, &groufix_.jobs.lock);
+
+	gfx_mutex_unlock_(&groufix_.jobs.lock);
+
+	free(job);
+}
@@ -72,6 +72,32 @@ int gfx_hash_cmp_(const void* l, const void* r);
  */
 uint64_t gfx_hash_murmur3_(const void* key);
 
+/**
+ * Block-wise hashing, the key is split into blocks of GFX_HASH_BLOCK_SIZE_
+ * bytes that are hashed individually, the sum of all is then folded.
+ * This allows for rehashing only the blocks of a key that changed.
+ */
+#define GFX_HASH_BLOCK_SIZE_ 64
+
+/**
+ * Hashes a single block of a key (MurmurHash3, seeded by block index).
+ * @param key   Cannot be NULL.
+ * @param block Must be < the number of blocks spanned by key->len.
+ */
+uint32_t gfx_hash_block_(const GFXHashKey_* key, size_t block);
+
+/**
+ * Folds the sum of all block hashes of a key into its final hash.
+ * @param len Length of the key in bytes.
+ */
+uint64_t gfx_hash_fold_(size_t len, uint64_t sum);
+
+/**
+ * Block-wise hash implementation as GFXMap hash function,
+ * key is of type GFXHashKey_*.
+ */
+uint64_t gfx_hash_blocks_(const void* key);
+
 /**
  * Initializes a hash key builder.
  * Needs to eventually be 'cleared' with a call to gfx_hash_builder_get_().
@@ -263,6 +289,14 @@ void gfx_unmap_(GFXAllocator_* alloc, GFXMemAlloc_* mem);
  * Vulkan object cache.
  ****************************/
 
+/**
+ * Number of tracked descriptor types,
+ * all Vulkan 1.0 types are contiguous, ending with input attachments.
+ */
+#define GFX_NUM_DESCRIPTOR_TYPES_ \
+	((size_t)VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1)
+
+
 /**
  * Cached element (i.e. cachable Vulkan object).
  */
@@ -271,6 +305,9 @@ typedef struct GFXCacheElem_
 	// Input structure type.
 	VkStructureType type;
 
+	// #descriptors of each type, only for descriptor set layouts.
+	uint32_t descriptors[GFX_NUM_DESCRIPTOR_TYPES_];
+
 
 	// Vulkan fields.
 	struct
@@ -440,6 +477,7 @@ typedef struct GFXPoolBlock_
 	GFXListNode list;  // Base-type, undefined if claimed by subordinate.
 	GFXList     elems; // References GFXPoolElem_.
 	bool        full;
+	uint32_t    maxSets;
 
 	// #in-use descriptor sets (i.e. not-recycled).
 	atomic_uint_fast32_t sets;
@@ -461,10 +499,12 @@ typedef struct GFXPoolBlock_
 typedef struct GFXPoolElem_
 {
 	GFXListNode    list; // Base-type.
+	GFXListNode    age;  // Only linked in the pool's age list if immutable.
 	GFXPoolBlock_* block;
 
-	// #flushes left to recycle.
-	atomic_uint flushes;
+	// Generation of last use, or #flushes left to recycle if stale.
+	atomic_uint gen;
+	unsigned int aged; // Generation when linked into the age list.
 
 
 	// Vulkan fields.
@@ -486,6 +526,12 @@ typedef struct GFXPoolSub_
 	GFXMap         mutable; // Stores GFXHashKey_ : GFXPoolElem_.
 	GFXPoolBlock_* block;   // Currently claimed for new allocations.
 
+	// Demand & statistics since last flush.
+	uint32_t sets;
+	uint32_t descriptors[GFX_NUM_DESCRIPTOR_TYPES_];
+	uint32_t blocks;
+	uint32_t retries;
+
 } GFXPoolSub_;
 
 
@@ -499,6 +545,7 @@ typedef struct GFXPool_
 	GFXList free; // References GFXPoolBlock_.
 	GFXList full; // References GFXPoolBlock_.
 	GFXList subs; // References GFXPoolSub_.
+	GFXList age;  // References GFXPoolElem_ (by `age`), least recently aged first.
 
 	GFXMap immutable; // Stores GFXHashKey_ : GFXPoolElem_.
 	GFXMap stale;     // Stores GFXHashKey_ : GFXPoolElem_.
@@ -508,10 +555,38 @@ typedef struct GFXPool_
 	GFXMutex_ recLock; // For recycling.
 
 	unsigned int flushes;
+	unsigned int gen; // Current generation (i.e. #flushes so far).
+
+	// Observed demand (decays every flush), used to size new blocks.
+	uint64_t sets;
+	uint64_t descriptors[GFX_NUM_DESCRIPTOR_TYPES_];
+
+	// Demand gathered since the last flush, summed over all subordinates.
+	uint64_t newSets;
+	uint64_t newDescriptors[GFX_NUM_DESCRIPTOR_TYPES_];
+
+	// Statistics.
+	uint64_t blocks;  // Total #blocks allocated.
+	uint64_t retries; // Total #allocation retries due to full blocks.
 
 } GFXPool_;
 
 
+/**
+ * Pool statistics.
+ */
+typedef struct GFXPoolStats_
+{
+	size_t   blocks;   // #alive blocks (i.e. Vulkan descriptor pools).
+	uint64_t capacity; // #descriptor sets all alive blocks can hold.
+	uint64_t sets;     // #in-use descriptor sets (i.e. not-recycled).
+	uint64_t allocs;   // Total #blocks ever allocated.
+	uint64_t retries;  // Total #allocation retries due to full blocks.
+	uint64_t demand;   // Observed #descriptor sets per flush (decayed).
+
+} GFXPoolStats_;
+
+
 /**
  * Initializes a pool.
  * @param pool    Cannot be NULL.
@@ -537,6 +612,8 @@ void gfx_pool_clear_(GFXPool_* pool);
  * @param pool Cannot be NULL.
  * @return Non-zero on success, can be partially flushed on failure.
  *
+ * Only touches descriptor sets that were created or aged since last flush,
+ * i.e. its cost does not depend on the total number of descriptor sets.
  * Not thread-safe at all.
  */
 bool gfx_pool_flush_(GFXPool_* pool);
@@ -576,13 +653,24 @@ void gfx_pool_unsub_(GFXPool_* pool, GFXPoolSub_* sub);
  * Useful for when specific keys have been invalidated.
  * @param pool Cannot be NULL.
  * @param key  Matched against the keys passed in gfx_pool_get_.
+ * @param hash Must be gfx_hash_blocks_(key).
  * @param flushes Number of flushes after which the descriptor set is recycled.
  *
  * Not thread-safe at all, unlike gfx_pool_get_!
  * Note: when a set is recycled, its associated block might be freed if empty!
  */
 void gfx_pool_recycle_(GFXPool_* pool,
-                       const GFXHashKey_* key, unsigned int flushes);
+                       const GFXHashKey_* key, uint64_t hash,
+                       unsigned int flushes);
+
+/**
+ * Retrieves the current statistics of a pool.
+ * @param pool  Cannot be NULL.
+ * @param stats Output statistics, cannot be NULL.
+ *
+ * Not thread-safe at all.
+ */
+void gfx_pool_stats_(GFXPool_* pool, GFXPoolStats_* stats);
 
 /**
  * Retrieves, allocates or recycles a Vulkan descriptor set from the pool.
@@ -590,12 +678,14 @@ void gfx_pool_recycle_(GFXPool_* pool,
  * @param sub       Cannot be NULL.
  * @param setLayout Must be a descriptor set layout returned by gfx_cache_get_.
  * @param key       Must uniquely identify the given layout + descriptors.
+ * @param hash      Must be gfx_hash_blocks_(key).
  * @param update    Template-formatted data to update the descriptors with.
  * @return NULL on failure.
  *
  * Thread-safe with respect to other subordinates.
  * However, can never run concurrently with other pool functions.
  *
+ * The hash is taken as argument so callers can maintain it incrementally.
  * The first bytes of key must be setLayout, pushed as a GFXCacheElem_*.
  * Naturally key must at least be of size sizeof(GFXCacheElem_*), the total
  * size must be fixed for a given descriptor set layout.
@@ -606,7 +696,8 @@ void gfx_pool_recycle_(GFXPool_* pool,
  */
 GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
                             const GFXCacheElem_* setLayout,
-                            const GFXHashKey_* key, const void* update);
+                            const GFXHashKey_* key, uint64_t hash,
+                            const void* update);
 
 
 #endif
@@ -57,6 +57,25 @@ typedef struct GFXPipelineCacheHeader_
 } GFXPipelineCacheHeader_;
 
 
+/****************************
+ * Finds a struct of a given type in a Vulkan pNext chain.
+ * @param pNext First struct in the chain, may be NULL.
+ * @return NULL if not found.
+ */
+static const void* gfx_cache_find_next_(const void* pNext, VkStructureType sType)
+{
+	for (
+		const VkBaseInStructure* next = pNext;
+		next != NULL;
+		next = next->pNext)
+	{
+		if (next->sType == sType)
+			return next;
+	}
+
+	return NULL;
+}
+
 /****************************
  * Allocates & builds a hashable key value from a Vk*CreateInfo struct
  * with given replace handles for non-hashable fields.
@@ -77,6 +96,7 @@ static GFXHashKey_* gfx_cache_alloc_key_(const VkStructureType* createInfo,
 	// The elements of the Vk*CreateInfo struct will be pushed linearly,
 	// such as the specs say, to avoid confusion.
 	// Note we do not push any VkStructureType fields except for the main one.
+	// Structs in pNext chains are found by type, all others are ignored.
 	// Plus we insert the given handles for fields we cannot hash.
 	size_t currHandle = 0;
 	char temp;
@@ -89,7 +109,25 @@ static GFXHashKey_* gfx_cache_alloc_key_(const VkStructureType* createInfo,
 		const VkDescriptorSetLayoutCreateInfo* dslci =
 			(const VkDescriptorSetLayoutCreateInfo*)createInfo;
 
-		// Ignore the pNext field.
+		// Binding flags are what distinguishes
+		// bindless (update-after-bind) layouts.
+		const VkDescriptorSetLayoutBindingFlagsCreateInfo* dslbfci =
+			gfx_cache_find_next_(dslci->pNext,
+				VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO);
+
+		// Insert bool 'has binding flags'.
+		temp = dslbfci != NULL;
+		GFX_KEY_PUSH_(temp);
+
+		if (dslbfci != NULL)
+		{
+			// Ignore the pNext field.
+			GFX_KEY_PUSH_(dslbfci->bindingCount);
+
+			for (size_t b = 0; b < dslbfci->bindingCount; ++b)
+				GFX_KEY_PUSH_(dslbfci->pBindingFlags[b]);
+		}
+
 		GFX_KEY_PUSH_(dslci->flags);
 		GFX_KEY_PUSH_(dslci->bindingCount);
 
@@ -143,16 +181,16 @@ static GFXHashKey_* gfx_cache_alloc_key_(const VkStructureType* createInfo,
 		const VkSamplerCreateInfo* sci =
 			(const VkSamplerCreateInfo*)createInfo;
 
-		// Insert bool 'has pNext'.
-		temp = sci->pNext != NULL;
+		const VkSamplerReductionModeCreateInfo* srmci =
+			gfx_cache_find_next_(sci->pNext,
+				VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO);
+
+		// Insert bool 'has reduction mode'.
+		temp = srmci != NULL;
 		GFX_KEY_PUSH_(temp);
 
-		// Assume pNext is a VkSamplerReductionModeCreateInfo*.
-		if (sci->pNext != NULL)
+		if (srmci != NULL)
 		{
-			const VkSamplerReductionModeCreateInfo* srmci =
-				(const VkSamplerReductionModeCreateInfo*)sci->pNext;
-
 			// Ignore the pNext field.
 			GFX_KEY_PUSH_(srmci->reductionMode);
 		}
@@ -271,7 +309,29 @@ static GFXHashKey_* gfx_cache_alloc_key_(const VkStructureType* createInfo,
 		const VkGraphicsPipelineCreateInfo* gpci =
 			(const VkGraphicsPipelineCreateInfo*)createInfo;
 
-		// Ignore the pNext field.
+		// Rendering info is what distinguishes dynamic rendering pipelines,
+		// as they have no render pass handle.
+		const VkPipelineRenderingCreateInfo* prci =
+			gfx_cache_find_next_(gpci->pNext,
+				VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO);
+
+		// Insert bool 'has rendering info'.
+		temp = prci != NULL;
+		GFX_KEY_PUSH_(temp);
+
+		if (prci != NULL)
+		{
+			// Ignore the pNext field.
+			GFX_KEY_PUSH_(prci->viewMask);
+			GFX_KEY_PUSH_(prci->colorAttachmentCount);
+
+			for (size_t c = 0; c < prci->colorAttachmentCount; ++c)
+				GFX_KEY_PUSH_(prci->pColorAttachmentFormats[c]);
+
+			GFX_KEY_PUSH_(prci->depthAttachmentFormat);
+			GFX_KEY_PUSH_(prci->stencilAttachmentFormat);
+		}
+
 		GFX_KEY_PUSH_(gpci->flags);
 		GFX_KEY_PUSH_(gpci->stageCount);
 
@@ -622,6 +682,17 @@ static bool gfx_cache_create_elem_(GFXCache_* cache, GFXCacheElem_* elem,
 			uint32_t count = dslci->bindingCount;
 			size_t offset = 0;
 
+			// Also count #descriptors of each type,
+			// so the pool can size its blocks to what is being allocated.
+			memset(elem->descriptors, 0, sizeof(elem->descriptors));
+
+			for (uint32_t b = 0; b < dslci->bindingCount; ++b)
+			{
+				const size_t t = (size_t)dslci->pBindings[b].descriptorType;
+				if (t < GFX_NUM_DESCRIPTOR_TYPES_)
+					elem->descriptors[t] += dslci->pBindings[b].descriptorCount;
+			}
+
 			for (uint32_t b = 0; b < dslci->bindingCount; ++b)
 			{
 				if (
@@ -651,7 +722,11 @@ static bool gfx_cache_create_elem_(GFXCache_* cache, GFXCacheElem_* elem,
 			}
 
 			// If no bindings remain, do not create an update template!
-			if (count == 0)
+			// Neither for push descriptor layouts, their template
+			// depends on the pipeline layout, the technique creates it.
+			if (
+				count == 0 ||
+				(dslci->flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR))
 			{
 				elem->vk.template = VK_NULL_HANDLE;
 				break;
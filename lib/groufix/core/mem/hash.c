@@ -40,19 +40,21 @@ int gfx_hash_cmp_(const void* l, const void* r)
 	return kL->len != kR->len || memcmp(kL->bytes, kR->bytes, kL->len);
 }
 
-/****************************/
-uint64_t gfx_hash_murmur3_(const void* key)
+/****************************
+ * MurmurHash3 (32 bits) of an arbitrary range of bytes.
+ * @param bytes Must be aligned to 4 bytes.
+ */
+static uint32_t gfx_murmur3_(const char* bytes, size_t len, uint32_t seed)
 {
-	const GFXHashKey_* cKey = key;
-	const size_t nblocks = cKey->len / sizeof(uint32_t);
+	const size_t nblocks = len / sizeof(uint32_t);
 
-	uint32_t h = GFX_HASH_SEED_;
+	uint32_t h = seed;
 
 	const uint32_t c1 = 0xcc9e2d51;
 	const uint32_t c2 = 0x1b873593;
 
 	// Process the body in blocks of 4 bytes.
-	const uint32_t* body = (const uint32_t*)cKey->bytes + nblocks;
+	const uint32_t* body = (const uint32_t*)bytes + nblocks;
 
 	for (size_t i = nblocks; i; --i)
 	{
@@ -72,7 +74,7 @@ uint64_t gfx_hash_murmur3_(const void* key)
 
 	uint32_t k = 0;
 
-	switch (cKey->len & 3)
+	switch (len & 3)
 	{
 	case 3:
 		k ^= (uint32_t)tail[2] << 16;
@@ -89,7 +91,7 @@ uint64_t gfx_hash_murmur3_(const void* key)
 	}
 
 	// Finalize.
-	h ^= (uint32_t)cKey->len;
+	h ^= (uint32_t)len;
 
 	h ^= h >> 16;
 	h *= 0x85ebca6b;
@@ -100,6 +102,57 @@ uint64_t gfx_hash_murmur3_(const void* key)
 	return h;
 }
 
+/****************************/
+uint64_t gfx_hash_murmur3_(const void* key)
+{
+	const GFXHashKey_* cKey = key;
+
+	return gfx_murmur3_(cKey->bytes, cKey->len, GFX_HASH_SEED_);
+}
+
+/****************************/
+uint32_t gfx_hash_block_(const GFXHashKey_* key, size_t block)
+{
+	assert(key != NULL);
+	assert(block * GFX_HASH_BLOCK_SIZE_ < key->len);
+
+	// Seed with the block index, so equal blocks at different
+	// positions do not cancel each other out when summed.
+	const size_t offset = block * GFX_HASH_BLOCK_SIZE_;
+
+	return gfx_murmur3_(
+		key->bytes + offset,
+		GFX_MIN(key->len - offset, GFX_HASH_BLOCK_SIZE_),
+		GFX_HASH_SEED_ ^ (uint32_t)block);
+}
+
+/****************************/
+uint64_t gfx_hash_fold_(size_t len, uint64_t sum)
+{
+	// 64 bits finalizer of MurmurHash3.
+	uint64_t h = sum ^ (uint64_t)len;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ull;
+	h ^= h >> 33;
+
+	return h;
+}
+
+/****************************/
+uint64_t gfx_hash_blocks_(const void* key)
+{
+	const GFXHashKey_* cKey = key;
+	uint64_t sum = 0;
+
+	for (size_t b = 0; b * GFX_HASH_BLOCK_SIZE_ < cKey->len; ++b)
+		sum += gfx_hash_block_(cKey, b);
+
+	return gfx_hash_fold_(cKey->len, sum);
+}
+
 /****************************/
 bool gfx_hash_builder_(GFXHashBuilder_* builder)
 {
@@ -11,6 +11,14 @@
 #include <string.h>
 
 
+// #descriptor sets a single descriptor block can hold.
+#define GFX_POOL_BLOCK_SETS_ 1000
+
+// Retrieves a GFXPoolElem_ from its age list node.
+#define GFX_POOL_ELEM_FROM_AGE_(node) \
+	((GFXPoolElem_*)((char*)(node) - offsetof(GFXPoolElem_, age)))
+
+
 /****************************
  * Mirrors GFXHashKey_, but containing only one GFXCacheElem_*.
  */
@@ -45,16 +53,102 @@ static void gfx_unclaim_pool_blocks_(GFXPool_* pool)
 	}
 }
 
+/****************************
+ * Helper to merge a subordinate's mutable hashtable into the immutable one,
+ * linking all merged elements into the age list of the pool.
+ * @return Zero if nothing was merged.
+ */
+static bool gfx_merge_pool_sub_(GFXPool_* pool, GFXPoolSub_* sub)
+{
+	assert(pool != NULL);
+	assert(sub != NULL);
+
+	// Link them first, as they are all in one place.
+	// Only elements created or recycled since last flush are in here.
+	for (
+		GFXPoolElem_* elem = gfx_map_first(&sub->mutable);
+		elem != NULL;
+		elem = gfx_map_next(&sub->mutable, elem))
+	{
+		elem->aged = pool->gen;
+		gfx_list_insert_after(&pool->age, &elem->age, NULL);
+	}
+
+	if (gfx_map_merge(&pool->immutable, &sub->mutable))
+		return 1;
+
+	// On failure, unlink them again.
+	for (
+		GFXPoolElem_* elem = gfx_map_first(&sub->mutable);
+		elem != NULL;
+		elem = gfx_map_next(&sub->mutable, elem))
+	{
+		gfx_list_erase(&pool->age, &elem->age);
+	}
+
+	return 0;
+}
+
+/****************************
+ * Helper to gather the demand & statistics of a subordinate into the pool,
+ * resetting the subordinate's counters afterwards.
+ * Demand is summed until gfx_decay_pool_demand_ is called.
+ */
+static void gfx_gather_pool_demand_(GFXPool_* pool, GFXPoolSub_* sub)
+{
+	assert(pool != NULL);
+	assert(sub != NULL);
+
+	pool->newSets += sub->sets;
+
+	for (size_t t = 0; t < GFX_NUM_DESCRIPTOR_TYPES_; ++t)
+		pool->newDescriptors[t] += sub->descriptors[t];
+
+	pool->blocks += sub->blocks;
+	pool->retries += sub->retries;
+
+	sub->sets = 0;
+	sub->blocks = 0;
+	sub->retries = 0;
+	memset(sub->descriptors, 0, sizeof(sub->descriptors));
+}
+
+/****************************
+ * Helper to fold all demand gathered since the last flush into the pool.
+ * Previously observed demand decays by half once per flush with new demand,
+ * this way block sizes follow the current descriptor mix.
+ */
+static void gfx_decay_pool_demand_(GFXPool_* pool)
+{
+	assert(pool != NULL);
+
+	if (pool->newSets > 0)
+	{
+		pool->sets = (pool->sets >> 1) + pool->newSets;
+
+		for (size_t t = 0; t < GFX_NUM_DESCRIPTOR_TYPES_; ++t)
+			pool->descriptors[t] =
+				(pool->descriptors[t] >> 1) + pool->newDescriptors[t];
+	}
+
+	pool->newSets = 0;
+	memset(pool->newDescriptors, 0, sizeof(pool->newDescriptors));
+}
+
 /****************************
  * Allocates and initializes a new block (i.e. Vulkan descriptor pool).
+ * The block is sized to the observed descriptor demand of the pool.
+ * @param setLayout Descriptor set layout that must fit in the block.
  * @return NULL on failure.
  *
  * The block is not linked into the free or full list of the pool,
  * must manually be claimed by either the pool or a subordinate!
  */
-static GFXPoolBlock_* gfx_alloc_pool_block_(GFXPool_* pool)
+static GFXPoolBlock_* gfx_alloc_pool_block_(GFXPool_* pool,
+                                            const GFXCacheElem_* setLayout)
 {
 	assert(pool != NULL);
+	assert(setLayout != NULL);
 
 	GFXContext_* context = pool->context;
 
@@ -63,41 +157,44 @@ static GFXPoolBlock_* gfx_alloc_pool_block_(GFXPool_* pool)
 	if (block == NULL)
 		goto clean;
 
-	// Create descriptor pool.
-	// TODO: Come up with something to determine all the pool sizes.
-	uint32_t sams = 1000;
-	uint32_t combImgSams = 1000;
-	uint32_t samImgs = 1000;
-	uint32_t stoImgs = 1000;
-	uint32_t uniTexBufs = 1000;
-	uint32_t stoTexBufs = 1000;
-	uint32_t uniBufs = 1000;
-	uint32_t stoBufs = 1000;
-	uint32_t uniBufDyns = 1000;
-	uint32_t stoBufDyns = 1000;
-	uint32_t inps = 1000;
+	// Compute all the pool sizes.
+	// If nothing was observed yet, give every type an equal share.
+	// Otherwise, size each type to its average #descriptors per set,
+	// with 25% headroom, so no single type runs out way before the others.
+	// Every type keeps a minimum so unseen types do not instantly fill up.
+	// Lastly, always make sure the requested layout fits in the block.
+	const uint32_t maxSets = GFX_POOL_BLOCK_SETS_;
+	const uint32_t minCount = GFX_POOL_BLOCK_SETS_ >> 4;
+
+	VkDescriptorPoolSize sizes[GFX_NUM_DESCRIPTOR_TYPES_];
+
+	for (size_t t = 0; t < GFX_NUM_DESCRIPTOR_TYPES_; ++t)
+	{
+		uint64_t count = maxSets;
+
+		if (pool->sets > 0)
+		{
+			count = (pool->descriptors[t] * maxSets + pool->sets - 1) / pool->sets;
+			count = GFX_MAX(count + (count >> 2), minCount);
+		}
+
+		count = GFX_MAX(count, setLayout->descriptors[t]);
 
+		sizes[t] = (VkDescriptorPoolSize){
+			.type            = (VkDescriptorType)t,
+			.descriptorCount = (uint32_t)GFX_MIN(count, UINT32_MAX)
+		};
+	}
+
+	// Create descriptor pool.
 	VkDescriptorPoolCreateInfo dpci = {
 		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
 
 		.pNext         = NULL,
 		.flags         = 0,
-		.maxSets       = 1000,
-		.poolSizeCount = 11,
-
-		.pPoolSizes = (VkDescriptorPoolSize[]){
-			{ VK_DESCRIPTOR_TYPE_SAMPLER, sams },
-			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, combImgSams },
-			{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, samImgs },
-			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, stoImgs },
-			{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, uniTexBufs },
-			{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, stoTexBufs },
-			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniBufs },
-			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stoBufs },
-			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, uniBufDyns },
-			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, stoBufDyns },
-			{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, inps }
-		}
+		.maxSets       = maxSets,
+		.poolSizeCount = (uint32_t)GFX_NUM_DESCRIPTOR_TYPES_,
+		.pPoolSizes    = sizes
 	};
 
 	GFX_VK_CHECK_(context->vk.CreateDescriptorPool(
@@ -106,11 +203,13 @@ static GFXPoolBlock_* gfx_alloc_pool_block_(GFXPool_* pool)
 	// Init the rest & return.
 	gfx_list_init(&block->elems);
 	block->full = 0;
+	block->maxSets = maxSets;
 	atomic_store_explicit(&block->sets, 0, memory_order_relaxed);
 
 	// Weee.
 	gfx_log_debug(
 		"New Vulkan descriptor pool allocated:\n"
+		"    #sets: %"PRIu32".\n"
 		"    #samplers: %"PRIu32".\n"
 		"    #combined image samplers: %"PRIu32".\n"
 		"    #sampled images: %"PRIu32".\n"
@@ -122,12 +221,18 @@ static GFXPoolBlock_* gfx_alloc_pool_block_(GFXPool_* pool)
 		"    #dynamic uniform buffers: %"PRIu32".\n"
 		"    #dynamic storage buffers: %"PRIu32".\n"
 		"    #attachment inputs: %"PRIu32".\n",
-		sams, combImgSams,
-		samImgs, stoImgs,
-		uniTexBufs, stoTexBufs,
-		uniBufs, stoBufs,
-		uniBufDyns, stoBufDyns,
-		inps);
+		maxSets,
+		sizes[VK_DESCRIPTOR_TYPE_SAMPLER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC].descriptorCount,
+		sizes[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT].descriptorCount);
 
 	return block;
 
@@ -182,6 +287,10 @@ static bool gfx_recycle_pool_elem_(GFXPool_* pool, GFXMap* map,
 	GFXPoolBlock_* block = elem->block;
 	bool recycled = 1;
 
+	// Only immutable elements are in the age list.
+	if (map == &pool->immutable)
+		gfx_list_erase(&pool->age, &elem->age);
+
 	// Build a new key, only containing the cache element storing the
 	// descriptor set layout, this way we do not search for specific
 	// descriptors anymore, but only for the layout.
@@ -251,12 +360,16 @@ static bool gfx_make_pool_elem_stale_(GFXPool_* pool, GFXMap* map,
 	// First check if the element was already flushed enough times.
 	// If so, immediately recycle.
 	const unsigned int flushed =
-		pool->flushes -
-		atomic_load_explicit(&elem->flushes, memory_order_relaxed);
+		pool->gen -
+		atomic_load_explicit(&elem->gen, memory_order_relaxed);
 
 	if (flushed >= flushes)
 		return gfx_recycle_pool_elem_(pool, map, elem);
 
+	// Stale elements are not aged, they are counted down instead.
+	if (map == &pool->immutable)
+		gfx_list_erase(&pool->age, &elem->age);
+
 	// Try to move the element to the stale hashtable.
 	// Make sure to use the fast variants of map_(move|erase), so
 	// we can keep iterating outside this function!
@@ -271,7 +384,7 @@ static bool gfx_make_pool_elem_stale_(GFXPool_* pool, GFXMap* map,
 
 	// And set its new flush count on success.
 	atomic_store_explicit(
-		&elem->flushes, flushes - flushed, memory_order_relaxed);
+		&elem->gen, flushes - flushed, memory_order_relaxed);
 
 	return 1;
 }
@@ -285,6 +398,15 @@ bool gfx_pool_init_(GFXPool_* pool, GFXDevice_* device, unsigned int flushes)
 
 	pool->context = device->context;
 	pool->flushes = flushes;
+	pool->gen = 0;
+
+	// Nothing observed yet.
+	pool->sets = 0;
+	pool->newSets = 0;
+	pool->blocks = 0;
+	pool->retries = 0;
+	memset(pool->descriptors, 0, sizeof(pool->descriptors));
+	memset(pool->newDescriptors, 0, sizeof(pool->newDescriptors));
 
 	// Initialize the locks.
 	if (!gfx_mutex_init_(&pool->subLock))
@@ -300,11 +422,12 @@ bool gfx_pool_init_(GFXPool_* pool, GFXDevice_* device, unsigned int flushes)
 	gfx_list_init(&pool->free);
 	gfx_list_init(&pool->full);
 	gfx_list_init(&pool->subs);
+	gfx_list_init(&pool->age);
 
 	gfx_map_init(&pool->immutable,
-		sizeof(GFXPoolElem_), gfx_hash_murmur3_, gfx_hash_cmp_);
+		sizeof(GFXPoolElem_), gfx_hash_blocks_, gfx_hash_cmp_);
 	gfx_map_init(&pool->stale,
-		sizeof(GFXPoolElem_), gfx_hash_murmur3_, gfx_hash_cmp_);
+		sizeof(GFXPoolElem_), gfx_hash_blocks_, gfx_hash_cmp_);
 	gfx_map_init(&pool->recycled,
 		sizeof(GFXPoolElem_), gfx_hash_murmur3_, gfx_hash_cmp_);
 
@@ -316,6 +439,21 @@ void gfx_pool_clear_(GFXPool_* pool)
 {
 	assert(pool != NULL);
 
+	// Report how well the pool behaved before destroying everything.
+	GFXPoolStats_ stats;
+	gfx_pool_stats_(pool, &stats);
+
+	gfx_log_debug(
+		"Clearing Vulkan descriptor pools:\n"
+		"    #blocks alive: %"GFX_PRIs".\n"
+		"    #sets in-use: %"PRIu64" (of %"PRIu64").\n"
+		"    #blocks allocated: %"PRIu64".\n"
+		"    #allocation retries: %"PRIu64".\n",
+		stats.blocks,
+		stats.sets, stats.capacity,
+		stats.allocs,
+		stats.retries);
+
 	// Free all descriptor blocks.
 	// For this we first loop over all subordinates.
 	for (
@@ -353,6 +491,7 @@ void gfx_pool_clear_(GFXPool_* pool)
 	gfx_list_clear(&pool->free);
 	gfx_list_clear(&pool->full);
 	gfx_list_clear(&pool->subs);
+	gfx_list_clear(&pool->age);
 
 	gfx_mutex_clear_(&pool->recLock);
 	gfx_mutex_clear_(&pool->subLock);
@@ -369,54 +508,75 @@ bool gfx_pool_flush_(GFXPool_* pool)
 	gfx_unclaim_pool_blocks_(pool);
 
 	// So we keep track of success.
-	// This so at least all the flush counts of all elements in the
-	// immutable hashtable are updated.
+	// Elements that fail to merge simply stay in their subordinate.
 	bool success = 1;
 
 	// So we loop over all subordinates and flush them.
+	// While we're at it, gather their observed demand.
 	for (
 		GFXPoolSub_* sub = (GFXPoolSub_*)pool->subs.head;
 		sub != NULL;
 		sub = (GFXPoolSub_*)sub->list.next)
 	{
-		if (!gfx_map_merge(&pool->immutable, &sub->mutable))
+		if (!gfx_merge_pool_sub_(pool, sub))
 			success = 0;
+
+		gfx_gather_pool_demand_(pool, sub);
 	}
 
+	// Then decay the demand once for all subordinates.
+	gfx_decay_pool_demand_(pool);
+
 	if (!success) gfx_log_warn(
 		"Pool flush failed to make cache available to all threads.");
 
-	// Then recycle all descriptor sets that need to be.
-	// We are moving nodes from immutable to recycled, but gfx_map_fmove
-	// guarantees the node order stays the same.
-	// We use this to loop 'over' the moved nodes.
+	// Advance to the next generation, elements last used #flushes
+	// generations ago can be recycled.
+	++pool->gen;
 	size_t lost = 0;
 
-	// Start at the immutable table.
-	GFXMap* map = &pool->immutable;
-	GFXPoolElem_* elem;
+	// Then recycle all immutable descriptor sets that need to be.
+	// The age list is sorted on the generation elements were linked in,
+	// so we only need to look at the front that has aged long enough.
+	// Those that were used in the meantime are re-linked at the back,
+	// meaning each in-use element is only visited once every #flushes.
+	while (pool->age.head != NULL)
+	{
+		GFXPoolElem_* elem = GFX_POOL_ELEM_FROM_AGE_(pool->age.head);
 
-recycle:
-	elem = gfx_map_first(map);
+		if (pool->gen - elem->aged < pool->flushes)
+			break;
+
+		const unsigned int gen =
+			atomic_load_explicit(&elem->gen, memory_order_relaxed);
+
+		if (pool->gen - gen >= pool->flushes)
+			lost += !gfx_recycle_pool_elem_(pool, &pool->immutable, elem);
+		else
+		{
+			gfx_list_erase(&pool->age, &elem->age);
+			elem->aged = pool->gen;
+			gfx_list_insert_after(&pool->age, &elem->age, NULL);
+		}
+	}
+
+	// Then count down all stale descriptor sets.
+	// We are moving nodes from stale to recycled, but gfx_map_fmove
+	// guarantees the node order stays the same.
+	// We use this to loop 'over' the moved nodes.
+	GFXPoolElem_* elem = gfx_map_first(&pool->stale);
 
 	while (elem != NULL)
 	{
-		GFXPoolElem_* next = gfx_map_next(map, elem);
+		GFXPoolElem_* next = gfx_map_next(&pool->stale, elem);
 
 		// Recycle it if it has no more flushes to do (i.e. reaches 0).
-		if (atomic_fetch_sub_explicit(&elem->flushes, 1, memory_order_relaxed) == 1)
-			lost += !gfx_recycle_pool_elem_(pool, map, elem);
+		if (atomic_fetch_sub_explicit(&elem->gen, 1, memory_order_relaxed) == 1)
+			lost += !gfx_recycle_pool_elem_(pool, &pool->stale, elem);
 
 		elem = next;
 	}
 
-	// Continue to the stale table.
-	if (map == &pool->immutable)
-	{
-		map = &pool->stale;
-		goto recycle;
-	}
-
 	// Shrink the immutable & stale hashtables back down.
 	gfx_map_shrink(&pool->immutable);
 	gfx_map_shrink(&pool->stale);
@@ -444,6 +604,7 @@ void gfx_pool_reset_(GFXPool_* pool)
 	gfx_map_clear(&pool->immutable);
 	gfx_map_clear(&pool->stale);
 	gfx_map_clear(&pool->recycled);
+	gfx_list_clear(&pool->age);
 
 	for (
 		GFXPoolSub_* sub = (GFXPoolSub_*)pool->subs.head;
@@ -487,9 +648,13 @@ void gfx_pool_sub_(GFXPool_* pool, GFXPoolSub_* sub)
 
 	// Initialize the subordinate.
 	gfx_map_init(&sub->mutable,
-		sizeof(GFXPoolElem_), gfx_hash_murmur3_, gfx_hash_cmp_);
+		sizeof(GFXPoolElem_), gfx_hash_blocks_, gfx_hash_cmp_);
 
 	sub->block = NULL;
+	sub->sets = 0;
+	sub->blocks = 0;
+	sub->retries = 0;
+	memset(sub->descriptors, 0, sizeof(sub->descriptors));
 
 	// Lastly to link the subordinate into the pool.
 	gfx_list_insert_after(&pool->subs, &sub->list, NULL);
@@ -507,7 +672,7 @@ void gfx_pool_unsub_(GFXPool_* pool, GFXPoolSub_* sub)
 
 	// Flush this subordinate & clear the hashtable.
 	// If it did not want to merge, the descriptor sets are lost...
-	if (!gfx_map_merge(&pool->immutable, &sub->mutable))
+	if (!gfx_merge_pool_sub_(pool, sub))
 	{
 		// Try to make every element stale instead...
 		// Same as in gfx_pool_flush_, we loop 'over' the moved nodes.
@@ -533,6 +698,7 @@ void gfx_pool_unsub_(GFXPool_* pool, GFXPoolSub_* sub)
 	}
 
 	gfx_map_clear(&sub->mutable);
+	gfx_gather_pool_demand_(pool, sub);
 
 	// Unlink subordinate from the pool.
 	gfx_list_erase(&pool->subs, &sub->list);
@@ -540,12 +706,12 @@ void gfx_pool_unsub_(GFXPool_* pool, GFXPoolSub_* sub)
 
 /****************************/
 void gfx_pool_recycle_(GFXPool_* pool,
-                       const GFXHashKey_* key, unsigned int flushes)
+                       const GFXHashKey_* key, uint64_t hash,
+                       unsigned int flushes)
 {
 	assert(pool != NULL);
 	assert(key != NULL);
-
-	const uint64_t hash = pool->immutable.hash(key);
+	assert(hash == pool->immutable.hash(key));
 
 	// First unclaim all subordinate blocks, so we can recycle elements.
 	gfx_unclaim_pool_blocks_(pool);
@@ -594,19 +760,68 @@ void gfx_pool_recycle_(GFXPool_* pool,
 		lost);
 }
 
+/****************************/
+void gfx_pool_stats_(GFXPool_* pool, GFXPoolStats_* stats)
+{
+	assert(pool != NULL);
+	assert(stats != NULL);
+
+	stats->blocks = 0;
+	stats->capacity = 0;
+	stats->sets = 0;
+	stats->allocs = pool->blocks;
+	stats->retries = pool->retries;
+	stats->demand = pool->sets;
+
+	// Count all blocks in the free and full lists.
+	GFXList* lists[] = { &pool->free, &pool->full };
+
+	for (size_t l = 0; l < sizeof(lists) / sizeof(lists[0]); ++l)
+		for (
+			GFXPoolBlock_* block = (GFXPoolBlock_*)lists[l]->head;
+			block != NULL;
+			block = (GFXPoolBlock_*)block->list.next)
+		{
+			++stats->blocks;
+			stats->capacity += block->maxSets;
+			stats->sets +=
+				atomic_load_explicit(&block->sets, memory_order_relaxed);
+		}
+
+	// And all blocks claimed by subordinates,
+	// plus their yet-to-be-gathered statistics.
+	for (
+		GFXPoolSub_* sub = (GFXPoolSub_*)pool->subs.head;
+		sub != NULL;
+		sub = (GFXPoolSub_*)sub->list.next)
+	{
+		stats->allocs += sub->blocks;
+		stats->retries += sub->retries;
+
+		if (sub->block != NULL)
+		{
+			++stats->blocks;
+			stats->capacity += sub->block->maxSets;
+			stats->sets +=
+				atomic_load_explicit(&sub->block->sets, memory_order_relaxed);
+		}
+	}
+}
+
 /****************************/
 GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
                             const GFXCacheElem_* setLayout,
-                            const GFXHashKey_* key, const void* update)
+                            const GFXHashKey_* key, uint64_t hash,
+                            const void* update)
 {
 	assert(pool != NULL);
 	assert(sub != NULL);
 	assert(setLayout != NULL);
 	assert(setLayout->type == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
 	assert(key != NULL);
+	assert(hash == pool->immutable.hash(key));
 
 	GFXContext_* context = pool->context;
-	const uint64_t hash = pool->immutable.hash(key);
 
 	// First we check the pool's immutable table.
 	// We check this first because elements will always be flushed to this,
@@ -653,6 +868,10 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 
 		if (elem == NULL) return NULL;
 
+		// Whether the current block was freshly allocated,
+		// if so and it is still full, we cannot fit this set at all.
+		bool fresh = 0;
+
 		// Goto here to try another descriptor block.
 	try_block:
 
@@ -671,12 +890,18 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 
 			// If we didn't manage to claim a block, make one ourselves...
 			if (sub->block == NULL)
-				if ((sub->block = gfx_alloc_pool_block_(pool)) == NULL)
+			{
+				sub->block = gfx_alloc_pool_block_(pool, setLayout);
+				if (sub->block == NULL)
 				{
 					// ...
 					gfx_map_erase(&sub->mutable, elem);
 					return NULL;
 				}
+
+				++sub->blocks;
+				fresh = 1;
+			}
 		}
 
 		// Now allocate a descriptor set from this block/pool.
@@ -702,6 +927,21 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 			result == VK_ERROR_FRAGMENTED_POOL ||
 			result == VK_ERROR_OUT_OF_POOL_MEMORY)
 		{
+			// If the block was freshly allocated, trying again is futile.
+			// Just free the (empty) block, it is of no use to anyone.
+			if (fresh)
+			{
+				gfx_free_pool_block_(pool, sub->block);
+				sub->block = NULL;
+
+				gfx_log_error(
+					"Could not allocate a Vulkan descriptor set "
+					"from a newly allocated descriptor pool.");
+
+				gfx_map_erase(&sub->mutable, elem);
+				return NULL;
+			}
+
 			gfx_mutex_lock_(&pool->subLock);
 
 			// Don't forget to set the full flag!
@@ -711,6 +951,7 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 			gfx_mutex_unlock_(&pool->subLock);
 
 			sub->block = NULL;
+			++sub->retries;
 			goto try_block;
 		}
 
@@ -724,6 +965,11 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 		// And link the element and block together.
 		elem->block = sub->block;
 		gfx_list_insert_after(&sub->block->elems, &elem->list, NULL);
+
+		// Lastly, record the demand for sizing future blocks.
+		++sub->sets;
+		for (size_t t = 0; t < GFX_NUM_DESCRIPTOR_TYPES_; ++t)
+			sub->descriptors[t] += setLayout->descriptors[t];
 	}
 
 	// Now that we surely have an element, initialize it!
@@ -738,8 +984,12 @@ GFXPoolElem_* gfx_pool_get_(GFXPool_* pool, GFXPoolSub_* sub,
 		context->vk.UpdateDescriptorSetWithTemplate(
 			context->vk.device, elem->vk.set, setLayout->vk.template, update);
 
-	// Reset #flushes of the element & return when found.
+	// Mark the element as used in this generation & return when found.
+	// Only write if changed, the same element is often retrieved by
+	// many threads in the same generation.
 found:
-	atomic_store_explicit(&elem->flushes, pool->flushes, memory_order_relaxed);
+	if (atomic_load_explicit(&elem->gen, memory_order_relaxed) != pool->gen)
+		atomic_store_explicit(&elem->gen, pool->gen, memory_order_relaxed);
+
 	return elem;
 }
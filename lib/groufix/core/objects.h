@@ -730,14 +730,32 @@ typedef struct GFXGroup_
 #define GFX_PASS_GEN_(pass) \
 	(((GFXRenderPass_*)(pass))->gen)
 
+/**
+ * Detect whether a GFXRenderPass_ uses dynamic rendering (set on warmup).
+ */
+#define GFX_PASS_IS_DYNAMIC_(pass) \
+	(((GFXRenderPass_*)(pass))->vk.attachs.size > 0)
+
+
+/**
+ * Memory shared by aliased attachment backings.
+ */
+typedef struct GFXBackingMem_
+{
+	GFXMemAlloc_ alloc;
+	size_t       refs; // #backings bound to it.
+
+} GFXBackingMem_;
+
 
 /**
  * Attachment backing.
  */
 typedef struct GFXBacking_
 {
-	GFXListNode  list; // Base-type.
-	GFXMemAlloc_ alloc;
+	GFXListNode     list; // Base-type.
+	GFXMemAlloc_    alloc;
+	GFXBackingMem_* shared; // If not NULL, alloc is unused.
 
 	unsigned int purge; // If stale, index of frame to purge at.
 
@@ -768,6 +786,10 @@ typedef struct GFXImageAttach_
 	// Set by dependency injections, signaled out of the renderer.
 	bool signaled;
 
+	// Aliasing group (i.e. index of its first attachment), or SIZE_MAX.
+	// Set by the render graph, from the lifetimes of all attachments.
+	size_t alias;
+
 
 	// Vulkan fields.
 	struct
@@ -822,19 +844,45 @@ typedef struct GFXAttach_
 } GFXAttach_;
 
 
+/**
+ * Static recording (reusable across frames).
+ */
+typedef struct GFXRecorderStatic_
+{
+	GFXPass* pass;
+	uint32_t gen;   // Pass build generation when recorded.
+	bool     valid; // Zero if (to be) re-recorded.
+	bool     used;  // Non-zero if used this frame.
+	GFXVec   sets;  // Stores { GFXSet*, GFXPoolElem_*, uint64_t }.
+
+
+	// Vulkan fields.
+	struct
+	{
+		VkCommandBuffer cmd;
+		VkViewport      viewport; // Initial viewport when recorded.
+		VkRect2D        scissor;  // Initial scissor when recorded.
+
+	} vk;
+
+} GFXRecorderStatic_;
+
+
 /**
  * Recording command pool.
  */
 typedef struct GFXRecorderPool_
 {
-	size_t used; // #used buffers in cmds.
+	size_t used;    // #used buffers in cmds.
+	GFXVec statics; // Stores GFXRecorderStatic_ (graphics pools only).
 
 
 	// Vulkan fields.
 	struct
 	{
 		VkCommandPool pool;
-		GFXVec        cmds; // Stores VkCommandBuffer.
+		VkCommandPool statics; // Never reset, may be VK_NULL_HANDLE.
+		GFXVec        cmds;    // Stores VkCommandBuffer.
 
 	} vk;
 
@@ -855,8 +903,9 @@ struct GFXRecorder
 	// Recording input.
 	struct
 	{
-		GFXPass*        pass;
-		VkCommandBuffer cmd;
+		GFXPass*            pass;
+		VkCommandBuffer     cmd;
+		GFXRecorderStatic_* stat; // May be NULL.
 
 	} inp;
 
@@ -879,6 +928,30 @@ struct GFXRecorder
 	} state;
 
 
+	// Deferred (state-sorted) recording.
+	struct
+	{
+		bool     enabled; // Set by user, defer within render passes.
+		bool     active;  // Currently deferring commands.
+		bool     dirty;   // Bound set state changed since last snapshot.
+		bool     pushed;  // Current push state is referenced by a command.
+		uint32_t group;   // Current sort group.
+		uint64_t saved;   // #binds saved since last reset.
+
+		GFXTechnique*      technique; // Of bound set state.
+		const GFXHashKey_* bind;      // Bound set state snapshot (or NULL).
+		size_t             push;      // Push state offset in data (or SIZE_MAX).
+
+		GFXVec cmds;    // Stores GFXDeferCmd_.
+		GFXVec data;    // Stores { GFXTechnique*, uint32_t, char[] } (aligned).
+		GFXVec sets;    // Stores { GFXSet*, GFXPoolElem_*, size_t }.
+		GFXVec offsets; // Stores uint32_t.
+		GFXVec key;     // Stores char, scratch space to build a key in.
+		GFXMap binds;   // Stores GFXHashKey_ : (nothing).
+
+	} defer;
+
+
 	// Recording output.
 	struct
 	{
@@ -887,8 +960,10 @@ struct GFXRecorder
 	} out;
 
 
-	unsigned int     current; // Current virtual frame index.
-	GFXRecorderPool_ pools[]; // Two { graphics, compute } for each virtual frame.
+	GFXVec           workers;  // Stores GFXRecorder*, one for each job worker.
+	bool             isStatic; // Reuse render recordings across frames.
+	unsigned int     current;  // Current virtual frame index.
+	GFXRecorderPool_ pools[];  // Two { graphics, compute } for each virtual frame.
 };
 
 
@@ -977,6 +1052,7 @@ struct GFXRenderer
 
 	// Current virtual frame state.
 	bool recording;
+	atomic_uint_fast32_t ticks; // #submitted virtual frames.
 
 	GFXFrame* public; // Public frame, if not NULL, user has access.
 	GFXDeque  stales; // Stores { unsigned int, (Vk*)+ }.
@@ -987,6 +1063,20 @@ struct GFXRenderer
 	GFXMutex_ reentrantLock;
 
 
+	// Streaming ring (one region for each virtual frame).
+	// For uniform data & indirect draw commands.
+	struct
+	{
+		GFXBuffer* buffer; // NULL until first used.
+		char*      ptr;    // Persistently mapped.
+		uint64_t   size;   // Size of a single region.
+		uint64_t   align;  // Alignment of each push.
+
+		atomic_uint_fast64_t head; // Stores { uint32_t tick, uint32_t offset }.
+
+	} stream;
+
+
 	// Render backing (i.e. attachments).
 	struct
 	{
@@ -1013,6 +1103,10 @@ struct GFXRenderer
 		size_t culledRender;
 		size_t culledCompute;
 
+		// Number of renderer semaphores between async & other passes.
+		size_t numToAsync;   // Waited upon by an async compute pass.
+		size_t numFromAsync; // Signaled by an async compute pass.
+
 		enum {
 			GFX_GRAPH_EMPTY_,
 			GFX_GRAPH_INVALID_, // Needs to purge.
@@ -1092,6 +1186,11 @@ typedef struct GFXConsume_
 		// Non-NULL regardless of dependencies.
 		const struct GFXConsume_* next;
 
+		// Non-NULL if the first consumption of an attachment aliasing
+		// the memory of another, its last consumption in that case.
+		// May point to a later consumption, i.e. of the previous frame.
+		const struct GFXConsume_* alias;
+
 	} out;
 
 } GFXConsume_;
@@ -1107,6 +1206,7 @@ typedef struct GFXDepend_
 	GFXPass*  target;
 
 	unsigned int waits; // #times this wait command is signaled.
+	bool         owned; // Whether inj.sem is owned by the renderer.
 
 
 	// Graph output (relative to neighbouring passes).
@@ -1136,6 +1236,7 @@ struct GFXPass
 	unsigned int order;   // Actual submission order.
 	unsigned int childs;  // Number of unculled (!) passes this is a parent of.
 	bool         culled;
+	bool         invalid; // Needs to be purged on the next graph analysis.
 
 	// Stores GFXConsume_.
 	GFXVec consumes;
@@ -1153,6 +1254,9 @@ struct GFXPass
 		// Next 'master' (or to be built/recorded) pass.
 		GFXPass* nextMaster;
 
+		// Hash of all graph output, to detect changes on re-analysis.
+		uint64_t hash;
+
 	} out;
 };
 
@@ -1195,6 +1299,7 @@ typedef struct GFXRenderPass_
 		uint32_t subpass;   // Subpass index.
 		uint32_t subpasses; // Number of subpasses (undefined if not master).
 		size_t   backing;   // Window attachment index (or SIZE_MAX).
+		size_t   chain;     // Chain summary index, only valid during analysis.
 
 	} out;
 
@@ -1206,7 +1311,7 @@ typedef struct GFXRenderPass_
 		uint32_t fHeight;
 		uint32_t fLayers;
 
-		GFXCacheElem_* pass; // Built on warmup.
+		GFXCacheElem_* pass; // Built on warmup, NULL if dynamic.
 
 	} build;
 
@@ -1214,11 +1319,13 @@ typedef struct GFXRenderPass_
 	// Vulkan fields.
 	struct
 	{
-		VkRenderPass pass;   // For locality.
-		GFXVec       clears; // Stores VkClearValue.
-		GFXVec       blends; // Stores { GFXBlendOpState (x2), char }.
-		GFXVec       views;  // Stores { GFXConsume_*, VkImageView }.
-		GFXVec       frames; // Stores { VkImageView, VkFramebuffer }.
+		VkRenderPass pass;    // For locality.
+		GFXVec       clears;  // Stores VkClearValue.
+		GFXVec       blends;  // Stores { GFXBlendOpState (x2), char }.
+		GFXVec       views;   // Stores { GFXConsume_*, VkImageView }.
+		GFXVec       frames;  // Stores { VkImageView, VkFramebuffer }.
+		GFXVec       attachs; // Stores { uint32_t (x2), VkRenderingAttachmentInfo }.
+		GFXVec       formats; // Stores VkFormat (colors, depth, stencil).
 
 	} vk;
 
@@ -1248,10 +1355,24 @@ typedef struct GFXTechniqueSet_
 	// All undefined until locked.
 	size_t numEntries;
 	size_t numDynamics; // #dynamic buffer entries.
+	bool   bindless;    // Contains runtime-sized arrays.
 
 } GFXTechniqueSet_;
 
 
+/**
+ * Technique constant element definition.
+ */
+typedef struct GFXConstantElem_
+{
+	uint32_t    stage; // Shader stage index.
+	uint32_t    id;
+	size_t      size;
+	GFXConstant value;
+
+} GFXConstantElem_;
+
+
 /**
  * Internal technique (i.e. shader pipeline layout).
  */
@@ -1266,15 +1387,28 @@ struct GFXTechnique
 	GFXShaderStage pushStages;
 
 	// Sorted on { stage, id }.
-	GFXVec constants; // Stores { uint32_t stage, uint32_t id, size_t, GFXConstant }.
+	GFXVec constants; // Stores GFXConstantElem_.
+
+	// Specialization constant permutations.
+	GFXVec domains;  // Stores { uint32_t, GFXShaderStage, size_t stride, GFXVec values }.
+	size_t numPerms; // Product of all #values, at least 1.
 
 	// All sorted on { set, binding, index }.
 	GFXVec samplers;  // Stores { size_t set, GFXSampler }, temporary!
 	GFXVec immutable; // Stores { size_t set, size_t binding }.
 	GFXVec dynamic;   // Stores { size_t set, size_t binding }.
+	GFXVec bindless;  // Stores { size_t set, size_t binding, size_t capacity }.
+
+	size_t pushSet; // Push descriptor set, SIZE_MAX if none.
+
 
 	// Vulkan fields.
-	struct { VkPipelineLayout layout; } vk; // For locality.
+	struct
+	{
+		VkPipelineLayout           layout; // For locality.
+		VkDescriptorUpdateTemplate push;   // VK_NULL_HANDLE until locked.
+
+	} vk;
 
 
 	// Locking output.
@@ -1316,6 +1450,25 @@ typedef struct GFXSetEntry_
 } GFXSetEntry_;
 
 
+/**
+ * Set slot allocator (i.e. lock-free free list of descriptor indices).
+ */
+typedef struct GFXSetSlots_
+{
+	// Free list head, stores { uint32_t tag, uint32_t slot }.
+	atomic_uint_fast64_t free;
+	atomic_uint_fast32_t used; // #slots ever claimed.
+
+	struct
+	{
+		atomic_uint_fast32_t next; // Next slot in the free list.
+		atomic_uint_fast32_t tick; // Renderer tick when it was freed.
+
+	} slots[];
+
+} GFXSetSlots_;
+
+
 /**
  * Set binding (i.e. descriptor binding info).
  */
@@ -1327,7 +1480,9 @@ typedef struct GFXSetBinding_
 	size_t        count;   // 0 = empty binding.
 	size_t        size;    // 0 = not a struct, empty or unknown.
 	GFXSetEntry_* entries; // NULL if empty or immutable samplers only.
+	GFXSetSlots_* slots;   // NULL if not a runtime-sized array.
 	char*         hash;
+	bool          stream;  // Non-zero if streamed from the renderer's ring.
 
 } GFXSetBinding_;
 
@@ -1343,17 +1498,45 @@ struct GFXSet
 	GFXSetEntry_*  first;
 	GFXHashKey_*   key;
 
+	// Incremental key hash, only dirty bindings are rehashed.
+	// Descriptors are not written per dirty binding: only bindless sets
+	// are written in-place, pooled descriptor sets are written whole.
+	uint64_t* dirty;  // Bitmask of bindings whose key portion changed.
+	uint32_t* blocks; // Hash of each GFX_HASH_BLOCK_SIZE_ bytes of key.
+	uint64_t  sum;    // Sum of all blocks.
+
+	atomic_uint_fast64_t hash; // Always gfx_hash_blocks_(key).
+
 	// If used since last modification.
 	atomic_bool used;
 
 	size_t numAttachs;  // #referenced attachments.
 	size_t numDynamics; // #dynamic buffer entries.
 	size_t numBindings;
+	bool   push;        // Pushed when bound, no descriptor set.
+
+	// Bindless & push sets own their element, not from the renderer's pool.
+	GFXPoolElem_ elem;
+
+
+	// Vulkan fields.
+	struct
+	{
+		VkDescriptorPool pool; // VK_NULL_HANDLE if not bindless.
+
+	} vk;
 
 	GFXSetBinding_ bindings[]; // Sorted, no gaps.
 };
 
 
+/**
+ * Detect whether a GFXSet is bindless (i.e. updated after bind).
+ */
+#define GFX_SET_IS_BINDLESS_(set) \
+	((set)->vk.pool != VK_NULL_HANDLE)
+
+
 /****************************
  * Resource reference operations.
  ****************************/
@@ -1779,6 +1962,23 @@ GFXBacking_* gfx_alloc_backing_(GFXHeap* heap,
  */
 void gfx_free_backing_(GFXHeap* heap, GFXBacking_* backing);
 
+/**
+ * Allocates multiple backing images from a heap, aliasing the same memory.
+ * @param heap     Cannot be NULL.
+ * @param num      Number of backing images, must be > 0.
+ * @param attachs  Cannot be NULL, { .width, .height, .depth } > 0.
+ * @param backings Cannot be NULL, outputs num backing images.
+ * @return Zero on failure, nothing is allocated.
+ *
+ * Thread-safe with respect to the heap!
+ * Leaves the `purge` index and `list` base-type uninitialized!
+ * The backing images may NOT be in use at the same time,
+ * the memory is freed when the last of them is freed.
+ */
+bool gfx_alloc_backings_(GFXHeap* heap, size_t num,
+                         const GFXImageAttach_** attachs,
+                         GFXBacking_** backings);
+
 /**
  * Allocates a staging buffer from a heap.
  * @param heap Cannot be NULL.
@@ -1952,6 +2152,22 @@ bool gfx_render_backing_build_(GFXRenderer* renderer);
  */
 void gfx_render_backing_rebuild_(GFXRenderer* renderer, GFXRecreateFlags_ flags);
 
+/**
+ * Assigns aliasing groups to all image attachments, given their lifetimes.
+ * Image attachments whose lifetimes do not overlap may share memory,
+ * any built attachment sharing memory with another attachment that left
+ * its group is released to be rebuilt.
+ * @param renderer Cannot be NULL.
+ * @param firsts   Cannot be NULL, first use of each attachment (or UINT_MAX).
+ * @param lasts    Cannot be NULL, last use of each attachment.
+ *
+ * Both firsts and lasts must hold `renderer->backing.attachs.size` values.
+ * Will block until rendering is done if releasing, and only then!
+ */
+void gfx_render_backing_alias_(GFXRenderer* renderer,
+                               const unsigned int* firsts,
+                               const unsigned int* lasts);
+
 /**
  * Purges all relevant render backing resources.
  * Use to destroy stale backings to be purged at the current frame index.
@@ -1971,6 +2187,16 @@ void gfx_render_graph_init_(GFXRenderer* renderer);
  */
 void gfx_render_graph_clear_(GFXRenderer* renderer);
 
+/**
+ * Analyzes the render graph if it is not yet validated.
+ * Must be called before building the render backing,
+ * which depends on the analyzed lifetimes of all attachments.
+ * @param renderer Cannot be NULL.
+ *
+ * This will call the relevant gfx_pass_destruct_ calls.
+ */
+void gfx_render_graph_validate_(GFXRenderer* renderer);
+
 /**
  * Builds the Vulkan render passes if not present yet.
  * Can be used for potential pipeline warmups.
@@ -2014,11 +2240,21 @@ void gfx_render_graph_destruct_(GFXRenderer* renderer);
  * Invalidates the render graph, forcing it to first destruct everything
  * the next time gfx_render_graph_(warmup|build)_ is called.
  * If gfx_render_graph_rebuild_ is called before that, it is rendered a no-op.
- * Suitable for consumptions have changed or new attachments are described.
+ * Suitable for when new attachments are described.
  * @param renderer Cannot be NULL.
  */
 void gfx_render_graph_invalidate_(GFXRenderer* renderer);
 
+/**
+ * Invalidates a single pass of the render graph, forcing the graph to be
+ * re-analyzed the next time gfx_render_graph_(warmup|build)_ is called.
+ * Only the subpass chain of the pass is destructed then, along with any
+ * other chain whose analyzed output changed as a result.
+ * Suitable for when consumptions or dependencies of a pass have changed.
+ * @param pass Cannot be NULL.
+ */
+void gfx_render_graph_invalidate_pass_(GFXPass* pass);
+
 
 /****************************
  * Pass (nodes in the render graph).
@@ -2057,8 +2293,24 @@ void gfx_destroy_pass_(GFXPass* pass);
  */
 VkFramebuffer gfx_pass_framebuffer_(GFXRenderPass_* rPass, GFXFrame* frame);
 
+/**
+ * Retrieves the current dynamic rendering attachments of a pass
+ * with respect to a frame.
+ * @param rPass   Cannot be NULL, must not be culled and must be dynamic.
+ * @param frame   Cannot be NULL.
+ * @param attachs Output, must hold rPass->vk.attachs.size elements.
+ * @return Zero if not built or unknown.
+ *
+ * The output is ordered as all color attachments followed by the depth and
+ * stencil attachment, the latter two have a VK_NULL_HANDLE view if unused.
+ */
+bool gfx_pass_rendering_(GFXRenderPass_* rPass, GFXFrame* frame,
+                         VkRenderingAttachmentInfo* attachs);
+
 /**
  * Builds the Vulkan render pass if not present yet.
+ * If the pass is not merged with other passes and the device supports it,
+ * no render pass is built and dynamic rendering is used instead.
  * Can be used for potential pipeline warmups.
  * @param rPass Cannot be NULL, cannot be culled and must be a master pass!
  * @return Non-zero on success.
@@ -2127,7 +2379,8 @@ bool gfx_push_stale_(GFXRenderer* renderer,
                      VkFramebuffer framebuffer,
                      VkImageView imageView,
                      VkBufferView bufferView,
-                     VkCommandPool commandPool);
+                     VkCommandPool commandPool,
+                     VkDescriptorPool descriptorPool);
 
 /**
  * Blocks until all frames in a renderer's render frame are done.
@@ -2161,18 +2414,23 @@ void gfx_recorder_record_(GFXRecorder* recorder,
 /**
  * Retrieves all Vulkan specialization constant info and map entries.
  * @param technique Cannot be NULL, must be locked.
+ * @param perm      Permutation index, must be < technique->numPerms.
  * @param infos     `GFX_NUM_SHADER_STAGES_` VkSpecilizationInfo structs.
  * @param entries   `technique->constants.size` VkSpecializationMapEntry structs.
+ * @param data      `technique->constants.size` GFXConstantElem_ structs.
  *
  * All output entries are sorted on { stage, constantID }.
+ * infos will point into data, which holds the constants of the permutation.
  */
-void gfx_tech_get_constants_(GFXTechnique* technique,
+void gfx_tech_get_constants_(GFXTechnique* technique, size_t perm,
                              VkSpecializationInfo* infos,
-                             VkSpecializationMapEntry* entries);
+                             VkSpecializationMapEntry* entries,
+                             GFXConstantElem_* data);
 
 /**
  * Retrieves a descriptor set binding from a technique and populates the
  * `type`, `viewType`, `count` and `size` fields of a GFXSetBinding_ struct.
+ * The count of runtime-sized arrays is their bindless capacity.
  * @param technique Cannot be NULL, must be locked.
  * @param set       Must be < technique->numSets.
  * @param binding   Descriptor binding number.
@@ -2182,6 +2440,15 @@ void gfx_tech_get_constants_(GFXTechnique* technique,
 bool gfx_tech_get_set_binding_(GFXTechnique* technique,
                                size_t set, size_t binding, GFXSetBinding_* out);
 
+/**
+ * Retrieves whether a descriptor set binding of a technique is bindless,
+ * i.e. a runtime-sized array in the shaders.
+ * @param technique Cannot be NULL, must be locked.
+ * @param set       Must be < technique->numSets.
+ * @param binding   Descriptor binding number.
+ */
+bool gfx_tech_is_bindless_(GFXTechnique* technique, size_t set, size_t binding);
+
 /**
  * Retrieves, allocates or recycles a Vulkan descriptor set of the given set.
  * @param set Cannot be NULL.
@@ -2194,5 +2461,26 @@ bool gfx_tech_get_set_binding_(GFXTechnique* technique,
  */
 GFXPoolElem_* gfx_set_get_(GFXSet* set, GFXPoolSub_* sub);
 
+/**
+ * Allocates the renderer's streaming ring, if not yet allocated.
+ * @param renderer Cannot be NULL.
+ * @return Zero on failure.
+ *
+ * Thread-safe, locks the renderer.
+ */
+bool gfx_stream_init_(GFXRenderer* renderer);
+
+/**
+ * Suballocates from a virtual frame's region of the streaming ring.
+ * @param renderer Cannot be NULL, ring must be allocated.
+ * @param frame    Virtual frame index of the region.
+ * @param size     Size in bytes, aligned up to `renderer->stream.align`.
+ * @return Offset into the entire ring, UINT64_MAX if the region is full.
+ *
+ * Thread-safe and lock-free, only valid during recording!
+ */
+uint64_t gfx_stream_alloc_(GFXRenderer* renderer,
+                           unsigned int frame, uint64_t size);
+
 
 #endif
@@ -23,6 +23,7 @@
 typedef struct GFXStale_
 {
 	unsigned int frame; // Index of last frame that used this resource.
+	GFXSemaphore* sem;  // May be NULL, owned by the renderer.
 
 
 	// Vulkan fields (any may be VK_NULL_HANDLE).
@@ -32,6 +33,7 @@ typedef struct GFXStale_
 		VkImageView imageView;
 		VkBufferView bufferView;
 		VkCommandPool commandPool;
+		VkDescriptorPool descriptorPool;
 
 	} vk;
 
@@ -138,36 +140,28 @@ static inline void gfx_destroy_stale_(GFXRenderer* renderer, GFXStale_* stale)
 		context->vk.device, stale->vk.bufferView, NULL);
 	context->vk.DestroyCommandPool(
 		context->vk.device, stale->vk.commandPool, NULL);
+	context->vk.DestroyDescriptorPool(
+		context->vk.device, stale->vk.descriptorPool, NULL);
+
+	gfx_destroy_sem(stale->sem);
 }
 
-/****************************/
-bool gfx_push_stale_(GFXRenderer* renderer,
-                     VkFramebuffer framebuffer,
-                     VkImageView imageView,
-                     VkBufferView bufferView,
-                     VkCommandPool commandPool)
+/****************************
+ * Pushes a stale resource object to the renderer,
+ * stamping it with the last submitted frame's index.
+ * @param renderer Cannot be NULL.
+ * @param stale    Cannot be NULL, copied into the renderer.
+ * @return Non-zero if successfully pushed.
+ */
+static bool gfx_push_stale_obj_(GFXRenderer* renderer, GFXStale_* stale)
 {
 	assert(renderer != NULL);
-	assert(
-		framebuffer != VK_NULL_HANDLE ||
-		imageView != VK_NULL_HANDLE ||
-		bufferView != VK_NULL_HANDLE ||
-		commandPool != VK_NULL_HANDLE);
+	assert(stale != NULL);
 
 	// Get the last submitted frame's index.
-	const unsigned int index =
+	stale->frame =
 		(renderer->current + renderer->numFrames - 1) % renderer->numFrames;
 
-	GFXStale_ stale = {
-		.frame = index,
-		.vk = {
-			.framebuffer = framebuffer,
-			.imageView = imageView,
-			.bufferView = bufferView,
-			.commandPool = commandPool
-		}
-	};
-
 	// Try to push the stale resource otherwise.
 	// We push even if there is only one frame which is public, meaning
 	// nothing is actually rendering. If we were to account for that,
@@ -176,13 +170,13 @@ bool gfx_push_stale_(GFXRenderer* renderer,
 	// Besides, the stales will eventually get destroyed anyway...
 	gfx_mutex_lock_(&renderer->staleLock);
 
-	if (!gfx_deque_push(&renderer->stales, 1, &stale))
+	if (!gfx_deque_push(&renderer->stales, 1, stale))
 	{
 		gfx_log_fatal(
 			"Stale resources could not be pushed, "
 			"prematurely destroyed instead...");
 
-		gfx_destroy_stale_(renderer, &stale);
+		gfx_destroy_stale_(renderer, stale);
 
 		gfx_mutex_unlock_(&renderer->staleLock);
 		return 0;
@@ -193,6 +187,36 @@ bool gfx_push_stale_(GFXRenderer* renderer,
 	return 1;
 }
 
+/****************************/
+bool gfx_push_stale_(GFXRenderer* renderer,
+                     VkFramebuffer framebuffer,
+                     VkImageView imageView,
+                     VkBufferView bufferView,
+                     VkCommandPool commandPool,
+                     VkDescriptorPool descriptorPool)
+{
+	assert(renderer != NULL);
+	assert(
+		framebuffer != VK_NULL_HANDLE ||
+		imageView != VK_NULL_HANDLE ||
+		bufferView != VK_NULL_HANDLE ||
+		commandPool != VK_NULL_HANDLE ||
+		descriptorPool != VK_NULL_HANDLE);
+
+	GFXStale_ stale = {
+		.sem = NULL,
+		.vk = {
+			.framebuffer = framebuffer,
+			.imageView = imageView,
+			.bufferView = bufferView,
+			.commandPool = commandPool,
+			.descriptorPool = descriptorPool
+		}
+	};
+
+	return gfx_push_stale_obj_(renderer, &stale);
+}
+
 /****************************/
 bool gfx_sync_frames_(GFXRenderer* renderer)
 {
@@ -296,6 +320,13 @@ GFX_API GFXRenderer* gfx_create_renderer(GFXHeap* heap, unsigned int frames)
 	rend->public = NULL;
 	rend->numFrames = frames;
 	rend->current = 0;
+	atomic_store_explicit(&rend->ticks, 0, memory_order_relaxed);
+
+	rend->stream.buffer = NULL;
+	rend->stream.ptr = NULL;
+	rend->stream.size = 0;
+	rend->stream.align = 1;
+	atomic_store_explicit(&rend->stream.head, 0, memory_order_relaxed);
 
 	gfx_list_init(&rend->recorders);
 	gfx_list_init(&rend->techniques);
@@ -352,6 +383,13 @@ GFX_API void gfx_destroy_renderer(GFXRenderer* renderer)
 	gfx_list_clear(&renderer->techniques);
 	gfx_list_clear(&renderer->sets);
 
+	// Free the uniform streaming ring, all frames are done with it.
+	if (renderer->stream.buffer != NULL)
+	{
+		gfx_unmap(gfx_ref_buffer(renderer->stream.buffer));
+		gfx_free_buffer(renderer->stream.buffer);
+	}
+
 	// Destroy all stale resources.
 	// Just before this, clear the render backing & graph,
 	// as they might still be pushing stale resources!
@@ -399,6 +437,24 @@ GFX_API unsigned int gfx_renderer_get_num_frames(GFXRenderer* renderer)
 	return renderer->numFrames;
 }
 
+/****************************/
+GFX_API GFXDescriptorStats gfx_renderer_get_descriptor_stats(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+
+	GFXPoolStats_ stats;
+	gfx_pool_stats_(&renderer->pool, &stats);
+
+	return (GFXDescriptorStats){
+		.pools = stats.blocks,
+		.capacity = stats.capacity,
+		.sets = stats.sets,
+		.allocs = stats.allocs,
+		.retries = stats.retries,
+		.demand = stats.demand
+	};
+}
+
 /****************************/
 GFX_API bool gfx_renderer_load_cache(GFXRenderer* renderer, const GFXReader* src)
 {
@@ -540,6 +596,45 @@ GFX_API void gfx_pass_inject(GFXPass* pass,
 			"injection commands could not be stored at pass inject.");
 }
 
+/****************************
+ * Retrieves the semaphore owned by the renderer to inject dependencies with
+ * from an asynchronous compute pass to a non-asynchronous pass or vice versa.
+ * @param pass Cannot be NULL.
+ * @param wait Cannot be NULL.
+ * @param sem  Output semaphore if newly created, untouched if not.
+ * @return NULL on failure.
+ */
+static GFXSemaphore* gfx_pass_async_sem_(GFXPass* pass, GFXPass* wait,
+                                         GFXSemaphore** sem)
+{
+	assert(pass != NULL);
+	assert(wait != NULL);
+	assert(sem != NULL);
+
+	// Reuse the one from a previous call with the same passes.
+	for (size_t d = 0; d < pass->deps.size; ++d)
+	{
+		GFXDepend_* depend = gfx_vec_at(&pass->deps, d);
+		if (
+			GFX_INJ_IS_SIGNAL_(depend->inj) &&
+			depend->owned &&
+			depend->target == wait)
+		{
+			return depend->inj.sem;
+		}
+	}
+
+	// Or create a new one if not created by this call yet.
+	// The wait pass waits at most once per virtual frame,
+	// so it can hold the wait commands of all virtual frames.
+	if (*sem == NULL)
+		*sem = gfx_create_sem(
+			gfx_renderer_get_device(pass->renderer),
+			pass->renderer->numFrames);
+
+	return *sem;
+}
+
 /****************************/
 GFX_API void gfx_pass_depend(GFXPass* pass, GFXPass* wait,
                              size_t numInjs, const GFXInject* injs)
@@ -553,6 +648,9 @@ GFX_API void gfx_pass_depend(GFXPass* pass, GFXPass* wait,
 	const size_t numPass = pass->deps.size;
 	const size_t numWait = wait->deps.size;
 
+	// Semaphore created by this call, to destroy on failure.
+	GFXSemaphore* sem = NULL;
+
 	// Check renderer.
 	if (pass->renderer != wait->renderer)
 	{
@@ -585,7 +683,8 @@ GFX_API void gfx_pass_depend(GFXPass* pass, GFXPass* wait,
 			.inj = injs[i],
 			.source = pass,
 			.target = wait,
-			.waits = 1
+			.waits = 1,
+			.owned = 0
 		};
 
 		depend.inj.ref = gfx_ref_resolve_(depend.inj.ref);
@@ -622,63 +721,98 @@ GFX_API void gfx_pass_depend(GFXPass* pass, GFXPass* wait,
 			}
 
 			// And the pass type too.
+			// If injecting between an asynchronous compute pass and a
+			// non-asynchronous pass, they are submitted to different queues.
+			// Signal a semaphore of the renderer instead of a barrier,
+			// which transfers ownership to the queue of the wait pass.
+			// Asynchronous passes are submitted either before or after all
+			// others, so only one direction can be waited upon in-frame.
 			if (
-				(pass->type == GFX_PASS_COMPUTE_ASYNC &&
-				wait->type != GFX_PASS_COMPUTE_ASYNC) ||
-
-				(pass->type != GFX_PASS_COMPUTE_ASYNC &&
-				wait->type == GFX_PASS_COMPUTE_ASYNC))
+				(pass->type == GFX_PASS_COMPUTE_ASYNC) !=
+				(wait->type == GFX_PASS_COMPUTE_ASYNC))
 			{
-				gfx_log_warn(
-					"Dependency signal command ignored, must signal "
-					"a semaphore when injecting between an asynchronous "
-					"compute pass and a non-asynchronous pass.");
+				if (wait->type == GFX_PASS_COMPUTE_ASYNC ?
+					pass->renderer->graph.numFromAsync > 0 :
+					pass->renderer->graph.numToAsync > 0)
+				{
+					gfx_log_warn(
+						"Dependency signal command ignored, cannot inject "
+						"dependencies both to and from asynchronous compute "
+						"passes at the same time.");
 
-				continue;
+					continue;
+				}
+
+				depend.inj.sem = gfx_pass_async_sem_(pass, wait, &sem);
+				depend.owned = 1;
+
+				if (depend.inj.sem == NULL)
+					goto clean;
+
+				depend.inj.mask &= ~(GFXAccessMask)(
+					GFX_ACCESS_COMPUTE_ASYNC | GFX_ACCESS_TRANSFER_ASYNC);
+
+				if (wait->type == GFX_PASS_COMPUTE_ASYNC)
+					depend.inj.mask |= GFX_ACCESS_COMPUTE_ASYNC;
 			}
 
 			// If no semaphore, we just inject a barrier
 			// at the catch operation, i.e. at target.
-			if (!gfx_vec_push(&wait->deps, 1, &depend))
-				goto clean;
+			else
+			{
+				if (!gfx_vec_push(&wait->deps, 1, &depend))
+					goto clean;
+
+				continue;
+			}
 		}
-		else
-		{
-			// If we do use a semaphore, insert at source.
-			// Note we do not do any checking, this is done in sem.c!
-			if (!gfx_vec_push(&pass->deps, 1, &depend))
-				goto clean;
 
-			// Plus insert a single wait command per semaphore
-			// at target. So try to find this semaphore.
-			size_t w = 0;
-			for (; w < wait->deps.size; ++w)
+		// If we do use a semaphore, insert at source.
+		// Note we do not do any checking, this is done in sem.c!
+		if (!gfx_vec_push(&pass->deps, 1, &depend))
+			goto clean;
+
+		// Plus insert a single wait command per semaphore
+		// at target. So try to find this semaphore.
+		size_t w = 0;
+		for (; w < wait->deps.size; ++w)
+		{
+			GFXDepend_* wDepend = gfx_vec_at(&wait->deps, w);
+			if (
+				GFX_INJ_IS_WAIT_(wDepend->inj) &&
+				wDepend->inj.sem == depend.inj.sem)
 			{
-				GFXDepend_* wDepend = gfx_vec_at(&wait->deps, w);
-				if (
-					GFX_INJ_IS_WAIT_(wDepend->inj) &&
-					wDepend->inj.sem == depend.inj.sem)
-				{
-					++wDepend->waits;
-					break;
-				}
+				++wDepend->waits;
+				break;
 			}
+		}
 
-			// If not found, insert new wait command.
-			if (w >= wait->deps.size)
-			{
-				depend.source = NULL; // Might serve multiple sources!
-				depend.inj = gfx_sem_wait(depend.inj.sem);
+		// If not found, insert new wait command.
+		if (w >= wait->deps.size)
+		{
+			depend.source = NULL; // Might serve multiple sources!
+			depend.inj = gfx_sem_wait(depend.inj.sem);
 
-				if (!gfx_vec_push(&wait->deps, 1, &depend))
-					goto clean;
-			}
+			if (!gfx_vec_push(&wait->deps, 1, &depend))
+				goto clean;
 		}
 	}
 
-	// Invalidate the graph, maybe new subpass dependencies.
+	// Count the newly created semaphore.
+	if (sem != NULL)
+	{
+		if (wait->type == GFX_PASS_COMPUTE_ASYNC)
+			++pass->renderer->graph.numToAsync;
+		else
+			++pass->renderer->graph.numFromAsync;
+	}
+
+	// Invalidate both passes, maybe new subpass dependencies.
 	if (numInjs > 0)
-		gfx_render_graph_invalidate_(pass->renderer);
+	{
+		gfx_render_graph_invalidate_pass_(pass);
+		gfx_render_graph_invalidate_pass_(wait);
+	}
 
 	return;
 
@@ -690,6 +824,9 @@ clean:
 	if (wait->deps.size > numWait)
 		gfx_vec_pop(&wait->deps, wait->deps.size - numWait);
 
+	// Only referenced by the dependencies we just removed.
+	gfx_destroy_sem(sem);
+
 	gfx_log_warn(
 		"Dependency injection failed, "
 		"injection commands could not be stored at pass depend.");
@@ -706,6 +843,10 @@ GFX_API void gfx_pass_undepend(GFXPass* pass, GFXPass* wait)
 	if (pass->renderer != wait->renderer)
 		return;
 
+	// Keep track of whether anything was removed.
+	const size_t numPass = pass->deps.size;
+	const size_t numWait = wait->deps.size;
+
 	// First loop over all dependencies in the source.
 	// If it is a signal command that uses a semaphore, with correct source
 	// and target, it should have a matching wait command, remove both!
@@ -728,7 +869,32 @@ GFX_API void gfx_pass_undepend(GFXPass* pass, GFXPass* wait)
 					wDepend->inj.sem == depend->inj.sem)
 				{
 					if ((--wDepend->waits) == 0)
+					{
+						// Destroy the renderer's own semaphore,
+						// after all frames are done using it.
+						if (wDepend->owned)
+						{
+							if (wait->type == GFX_PASS_COMPUTE_ASYNC)
+								--pass->renderer->graph.numToAsync;
+							else
+								--pass->renderer->graph.numFromAsync;
+
+							GFXStale_ stale = {
+								.sem = wDepend->inj.sem,
+								.vk = {
+									.framebuffer = VK_NULL_HANDLE,
+									.imageView = VK_NULL_HANDLE,
+									.bufferView = VK_NULL_HANDLE,
+									.commandPool = VK_NULL_HANDLE,
+									.descriptorPool = VK_NULL_HANDLE
+								}
+							};
+
+							gfx_push_stale_obj_(pass->renderer, &stale);
+						}
+
 						gfx_vec_erase(&wait->deps, 1, w);
+					}
 
 					break;
 				}
@@ -755,8 +921,14 @@ GFX_API void gfx_pass_undepend(GFXPass* pass, GFXPass* wait)
 		}
 	}
 
-	// Invalidate the graph, subpass dependencies are gone.
-	gfx_render_graph_invalidate_(pass->renderer);
+	// Invalidate both passes, subpass dependencies are gone.
+	// Only if anything was removed, as gfx_pass_undepend_all calls this
+	// for every pair of passes, which would invalidate the entire graph.
+	if (pass->deps.size != numPass || wait->deps.size != numWait)
+	{
+		gfx_render_graph_invalidate_pass_(pass);
+		gfx_render_graph_invalidate_pass_(wait);
+	}
 }
 
 /****************************/
@@ -8,6 +8,19 @@
 
 #include "groufix/core/objects.h"
 #include <limits.h>
+#include <stdlib.h>
+
+
+/****************************
+ * Aliasing candidate, an image attachment and its lifetime.
+ */
+typedef struct GFXAliasElem_
+{
+	size_t       index;
+	unsigned int first;
+	unsigned int last;
+
+} GFXAliasElem_;
 
 
 /****************************
@@ -42,6 +55,35 @@ static inline bool gfx_cmp_attachments_(const GFXAttachment* l,
 		(l->layers == r->layers);
 }
 
+/****************************
+ * Compares two aliasing candidates by first use, then by index.
+ */
+static int gfx_cmp_alias_elems_(const void* l, const void* r)
+{
+	const GFXAliasElem_* le = l;
+	const GFXAliasElem_* re = r;
+
+	if (le->first != re->first)
+		return (le->first > re->first) - (le->first < re->first);
+
+	return (le->index > re->index) - (le->index < re->index);
+}
+
+/****************************
+ * Checks whether an attachment needs a new backing image.
+ */
+static inline bool gfx_needs_backing_(const GFXAttach_* attach)
+{
+	return
+		// Not an image attachment, or already built!
+		// Also do nothing when any dimension is zero.
+		attach->type == GFX_ATTACH_IMAGE_ &&
+		attach->image.vk.image == VK_NULL_HANDLE &&
+		attach->image.width > 0 &&
+		attach->image.height > 0 &&
+		attach->image.depth > 0;
+}
+
 /****************************
  * Increases the attachment 'generation'; invalidating any set entries
  * that reference this attachment.
@@ -62,11 +104,13 @@ static inline void gfx_attach_gen_(GFXAttach_* attach)
 }
 
 /****************************
- * Allocates a new backing image and links it into an attachment.
- * @param attach Must be an image attachment of non-zero size.
+ * Links a backing image into an attachment, allocating a new one if needed.
+ * @param attach  Must be an image attachment of non-zero size.
+ * @param backing Backing image allocated for attach, NULL to allocate anew.
  * @return Non-zero on success.
  */
-static bool gfx_link_backing_(GFXRenderer* renderer, GFXAttach_* attach)
+static bool gfx_link_backing_(GFXRenderer* renderer, GFXAttach_* attach,
+                              GFXBacking_* backing)
 {
 	assert(renderer != NULL);
 	assert(attach != NULL);
@@ -76,8 +120,11 @@ static bool gfx_link_backing_(GFXRenderer* renderer, GFXAttach_* attach)
 	assert(attach->image.depth > 0);
 
 	// Allocate a new backing image.
-	GFXBacking_* backing = gfx_alloc_backing_(renderer->heap, &attach->image);
-	if (backing == NULL) return 0;
+	if (backing == NULL)
+		backing = gfx_alloc_backing_(renderer->heap, &attach->image);
+
+	if (backing == NULL)
+		return 0;
 
 	// We set its purge index to UINT_MAX so it never gets purged, yet.
 	backing->purge = UINT_MAX;
@@ -109,6 +156,45 @@ static void gfx_unlink_backing_(GFXRenderer* renderer, GFXAttach_* attach,
 	gfx_free_backing_(renderer->heap, backing);
 }
 
+/****************************
+ * Releases the most recent backing image of an attachment, if any,
+ * invalidating the Vulkan image of the attachment.
+ * @param attach Must be an image attachment.
+ *
+ * Does not alter the render backing state!
+ * Assumes no frame is using the backing, unless it was signaled.
+ */
+static void gfx_release_backing_(GFXRenderer* renderer, GFXAttach_* attach)
+{
+	assert(renderer != NULL);
+	assert(attach != NULL);
+	assert(attach->type == GFX_ATTACH_IMAGE_);
+
+	// Check the active backing (i.e. most recent).
+	if (attach->image.backings.head != NULL)
+	{
+		GFXBacking_* backing =
+			(GFXBacking_*)attach->image.backings.head;
+
+		// If it exists and was signaled, we cannot free it yet.
+		// Some operation might still use the resource.
+		// So we set its purge state so it gets purged whenever
+		// not active anymore (i.e. not most recent anymore).
+		if (attach->image.signaled)
+			backing->purge = renderer->current;
+		else
+			// If not signaled, just unlink & free the backing.
+			gfx_unlink_backing_(renderer, attach, backing);
+	}
+
+	// Then we invalidate the most recent image!
+	attach->image.vk.image = VK_NULL_HANDLE;
+
+	// Increase generation; image may be used in set entries,
+	// ergo we need to invalidate those entries.
+	gfx_attach_gen_(attach);
+}
+
 /****************************
  * Allocates and initializes all attachments up to and including index.
  * @param renderer Cannot be NULL.
@@ -322,32 +408,12 @@ static bool gfx_render_backing_resolve_(GFXRenderer* renderer)
 				attach->image.height != height ||
 				attach->image.depth != depth)
 			{
-				// If it is, check the active backing (i.e. most recent).
-				if (attach->image.backings.head != NULL)
-				{
-					GFXBacking_* backing =
-						(GFXBacking_*)attach->image.backings.head;
-
-					// If it exists and was signaled, we cannot free it yet.
-					// Some operation might still use the resource.
-					// So we set its purge state so it gets purged whenever
-					// not active anymore (i.e. not most recent anymore).
-					if (attach->image.signaled)
-						backing->purge = renderer->current;
-					else
-						// If not signaled, just unlink & free the backing.
-						gfx_unlink_backing_(renderer, attach, backing);
-				}
-
-				// Then we invalidate the most recent image!
-				attach->image.vk.image = VK_NULL_HANDLE;
+				// If it is, release the active backing (i.e. most recent).
+				gfx_release_backing_(renderer, attach);
+
 				attach->image.width = width;
 				attach->image.height = height;
 				attach->image.depth = depth;
-
-				// Increase generation; image may be used in set entries,
-				// ergo we need to invalidate those entries.
-				gfx_attach_gen_(attach);
 			}
 
 			// Reset signaled state, resolved.
@@ -389,25 +455,55 @@ static size_t gfx_render_backing_alloc_(GFXRenderer* renderer)
 	assert(renderer->backing.state == GFX_BACKING_VALIDATED_);
 
 	// So yeah go and make sure all attachments have an image.
+	const size_t numAttachs = renderer->backing.attachs.size;
 	size_t failed = 0;
 
-	for (size_t i = 0; i < renderer->backing.attachs.size; ++i)
+	for (size_t i = 0; i < numAttachs; ++i)
 	{
 		GFXAttach_* attach = gfx_vec_at(&renderer->backing.attachs, i);
-		if (
-			// Not an image attachment, or already built!
-			// Also do nothing when any dimension is zero.
-			attach->type != GFX_ATTACH_IMAGE_ ||
-			attach->image.vk.image != VK_NULL_HANDLE ||
-			attach->image.width == 0 ||
-			attach->image.height == 0 ||
-			attach->image.depth == 0)
+		if (!gfx_needs_backing_(attach)) continue;
+
+		// Not aliased, allocate & link the backing image!
+		if (attach->image.alias == SIZE_MAX)
 		{
+			failed += !gfx_link_backing_(renderer, attach, NULL);
 			continue;
 		}
 
-		// Allocate & link the backing image!
-		failed += !gfx_link_backing_(renderer, attach);
+		// Aliased, gather all attachments of its group that need an image,
+		// none of them are before this one, they would've been allocated.
+		// Those that still have an image keep their own memory.
+		GFXAttach_* group[numAttachs - i];
+		const GFXImageAttach_* images[numAttachs - i];
+		size_t num = 0;
+
+		for (size_t j = i; j < numAttachs; ++j)
+		{
+			GFXAttach_* other = gfx_vec_at(&renderer->backing.attachs, j);
+			if (
+				gfx_needs_backing_(other) &&
+				other->image.alias == attach->image.alias)
+			{
+				group[num] = other;
+				images[num++] = &other->image;
+			}
+		}
+
+		// Allocate & link all backing images, sharing memory.
+		// If this fails, fall back to allocating them separately.
+		GFXBacking_* backings[num];
+
+		if (num > 1 && gfx_alloc_backings_(
+			renderer->heap, num, images, backings))
+		{
+			for (size_t g = 0; g < num; ++g)
+				gfx_link_backing_(renderer, group[g], backings[g]);
+		}
+		else
+		{
+			for (size_t g = 0; g < num; ++g)
+				failed += !gfx_link_backing_(renderer, group[g], NULL);
+		}
 	}
 
 	if (failed == 0)
@@ -508,6 +604,178 @@ void gfx_render_backing_rebuild_(GFXRenderer* renderer, GFXRecreateFlags_ flags)
 	}
 }
 
+/****************************/
+void gfx_render_backing_alias_(GFXRenderer* renderer,
+                               const unsigned int* firsts,
+                               const unsigned int* lasts)
+{
+	assert(renderer != NULL);
+	assert(firsts != NULL);
+	assert(lasts != NULL);
+
+	const size_t numAttachs = renderer->backing.attachs.size;
+	if (numAttachs == 0) return;
+
+	// Gather all image attachments that may alias memory.
+	// Their memory cannot be accessed outside the render graph,
+	// i.e. by operations or other queues, as we only know their
+	// lifetimes within the graph. Transient attachments are skipped,
+	// they are lazily allocated instead.
+	GFXAliasElem_ elems[numAttachs];
+	size_t numElems = 0;
+
+	for (size_t i = 0; i < numAttachs; ++i)
+	{
+		GFXAttach_* attach = gfx_vec_at(&renderer->backing.attachs, i);
+		if (
+			attach->type == GFX_ATTACH_IMAGE_ &&
+			firsts[i] != UINT_MAX &&
+			!(attach->image.base.usage & GFX_IMAGE_TRANSIENT) &&
+			!(attach->image.base.flags &
+				(GFX_MEMORY_READ_WRITE |
+				GFX_MEMORY_COMPUTE_CONCURRENT |
+				GFX_MEMORY_TRANSFER_CONCURRENT)))
+		{
+			elems[numElems++] = (GFXAliasElem_){
+				.index = i,
+				.first = firsts[i],
+				.last = lasts[i]
+			};
+		}
+	}
+
+	// Then assign groups in order of first use, each attachment joins
+	// a group whose last use is before its own first use.
+	// Prefer groups with an equal attachment description,
+	// these have equal memory requirements, wasting nothing.
+	if (numElems > 0)
+		qsort(elems, numElems, sizeof(GFXAliasElem_), gfx_cmp_alias_elems_);
+
+	size_t alias[numAttachs];
+	size_t leaders[GFX_MAX(1, numElems)]; // First attachment of each group.
+	size_t sizes[GFX_MAX(1, numElems)];   // #attachments in each group.
+	unsigned int ends[GFX_MAX(1, numElems)]; // Last use of each group.
+	size_t numGroups = 0;
+
+	for (size_t i = 0; i < numAttachs; ++i)
+		alias[i] = SIZE_MAX;
+
+	for (size_t e = 0; e < numElems; ++e)
+	{
+		const GFXAttach_* attach =
+			gfx_vec_at(&renderer->backing.attachs, elems[e].index);
+
+		size_t group = SIZE_MAX;
+
+		for (size_t g = 0; g < numGroups; ++g)
+		{
+			const GFXAttach_* leader =
+				gfx_vec_at(&renderer->backing.attachs, leaders[g]);
+
+			// Overlapping lifetimes or different memory flags.
+			if (
+				ends[g] >= elems[e].first ||
+				leader->image.base.flags != attach->image.base.flags)
+			{
+				continue;
+			}
+
+			if (group == SIZE_MAX)
+				group = g;
+
+			if (gfx_cmp_attachments_(&leader->image.base, &attach->image.base))
+			{
+				group = g;
+				break;
+			}
+		}
+
+		// Start a new group.
+		if (group == SIZE_MAX)
+		{
+			group = numGroups++;
+			leaders[group] = elems[e].index;
+			sizes[group] = 0;
+		}
+
+		ends[group] = elems[e].last;
+		++sizes[group];
+		alias[elems[e].index] = group;
+	}
+
+	// Identify groups by their first attachment,
+	// attachments that are alone in their group do not alias.
+	for (size_t i = 0; i < numAttachs; ++i)
+		if (alias[i] != SIZE_MAX)
+			alias[i] = (sizes[alias[i]] > 1) ? leaders[alias[i]] : SIZE_MAX;
+
+	// Now release all built attachments whose memory would be shared
+	// with an attachment outside their new group, they may overlap.
+	// Memory is only shared within a group, so for each attachment,
+	// check if another built attachment of its old group moved away.
+	// Attachments that were not aliased own their memory, they can keep it,
+	// and groups only hold attachments with non-overlapping lifetimes.
+	bool release[numAttachs];
+	bool anyRelease = 0;
+
+	for (size_t i = 0; i < numAttachs; ++i)
+	{
+		const GFXAttach_* attach = gfx_vec_at(&renderer->backing.attachs, i);
+		release[i] = 0;
+
+		if (
+			attach->type != GFX_ATTACH_IMAGE_ ||
+			attach->image.alias == SIZE_MAX ||
+			attach->image.vk.image == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		for (size_t j = 0; j < numAttachs; ++j)
+		{
+			const GFXAttach_* other = gfx_vec_at(&renderer->backing.attachs, j);
+			if (
+				j != i &&
+				other->type == GFX_ATTACH_IMAGE_ &&
+				other->image.alias == attach->image.alias &&
+				other->image.vk.image != VK_NULL_HANDLE &&
+				(alias[j] != alias[i] || alias[i] == SIZE_MAX))
+			{
+				release[i] = 1;
+				anyRelease = 1;
+				break;
+			}
+		}
+	}
+
+	if (anyRelease)
+	{
+		// Before releasing, we wait until all rendering is done.
+		gfx_sync_frames_(renderer);
+
+		// Resetting pools is not thread-safe at all as sets/recorders
+		// could call the pool, so we use the renderer's lock.
+		gfx_mutex_lock_(&renderer->lock);
+		gfx_pool_reset_(&renderer->pool);
+		gfx_mutex_unlock_(&renderer->lock);
+
+		// Make sure they get rebuilt.
+		if (renderer->backing.state == GFX_BACKING_BUILT_)
+			renderer->backing.state = GFX_BACKING_VALIDATED_;
+	}
+
+	for (size_t i = 0; i < numAttachs; ++i)
+	{
+		GFXAttach_* attach = gfx_vec_at(&renderer->backing.attachs, i);
+		if (attach->type != GFX_ATTACH_IMAGE_) continue;
+
+		if (release[i])
+			gfx_release_backing_(renderer, attach);
+
+		attach->image.alias = alias[i];
+	}
+}
+
 /****************************/
 void gfx_render_backing_purge_(GFXRenderer* renderer)
 {
@@ -613,6 +881,7 @@ GFX_API bool gfx_renderer_attach(GFXRenderer* renderer,
 		.height = 0,
 		.depth = 0,
 		.signaled = 0,
+		.alias = SIZE_MAX,
 		.vk = {
 			.format = vkFmt,
 			.image = VK_NULL_HANDLE
@@ -444,6 +444,10 @@ bool gfx_frame_acquire_(GFXRenderer* renderer, GFXFrame* frame)
 
 	// Ok so before actually recording stuff we need everything to be built.
 	// These functions will not do anything if not necessary.
+	// The graph is analyzed first, the backing aliases memory of attachments
+	// based on their lifetimes in the graph.
+	gfx_render_graph_validate_(renderer);
+
 	if (
 		!gfx_render_backing_build_(renderer) ||
 		!gfx_render_graph_build_(renderer))
@@ -574,6 +578,51 @@ static bool gfx_frame_push_consume_(GFXRenderer* renderer, GFXFrame* frame,
 		NULL, NULL, &imb, injection);
 }
 
+/****************************
+ * Pushes an execution/memory barrier between the last consumption of an
+ * attachment and the first consumption of an attachment aliasing its memory.
+ * Assumes `con` and `con->out.alias` to be fully initialized.
+ * @return Zero on failure.
+ */
+static bool gfx_frame_push_alias_(GFXRenderer* renderer,
+                                  const GFXConsume_* con,
+                                  GFXInjection_* injection)
+{
+	assert(renderer != NULL);
+	assert(con != NULL);
+	assert(con->out.alias != NULL);
+	assert(injection != NULL);
+
+	GFXContext_* context = renderer->cache.context;
+	const GFXConsume_* alias = con->out.alias;
+
+	// Only image attachments can alias.
+	const GFXFormat srcFmt = ((const GFXAttach_*)gfx_vec_at(
+		&renderer->backing.attachs, alias->index))->image.base.format;
+	const GFXFormat dstFmt = ((const GFXAttach_*)gfx_vec_at(
+		&renderer->backing.attachs, con->index))->image.base.format;
+
+	const VkPipelineStageFlags srcStageMask =
+		GFX_GET_VK_PIPELINE_STAGE_(alias->mask, alias->stage, srcFmt);
+	const VkPipelineStageFlags dstStageMask =
+		GFX_GET_VK_PIPELINE_STAGE_(con->mask, con->stage, dstFmt);
+
+	// Always inject a full memory barrier, the memory is written anew.
+	// No need for a layout transition, the initial layout is undefined.
+	VkMemoryBarrier mb = {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+
+		.pNext         = NULL,
+		.srcAccessMask = GFX_GET_VK_ACCESS_FLAGS_(alias->mask, srcFmt),
+		.dstAccessMask = GFX_GET_VK_ACCESS_FLAGS_(con->mask, dstFmt)
+	};
+
+	return gfx_injection_push_(
+		GFX_MOD_VK_PIPELINE_STAGE_(srcStageMask, context),
+		GFX_MOD_VK_PIPELINE_STAGE_(dstStageMask, context),
+		&mb, NULL, NULL, injection);
+}
+
 /****************************
  * Pushes an execution/memory barrier, just as stored in a GFXDepend_ object.
  * Assumes `dep` to be fully initialized as a non-semaphore command
@@ -799,6 +848,125 @@ static bool gfx_frame_push_transition_(GFXRenderer* renderer,
 		dstStageMask, dstStageMask, NULL, NULL, &imb, injection);
 }
 
+/****************************
+ * Pushes all layout transitions of the attachments of a dynamic rendering
+ * pass, i.e. the transitions a Vulkan render pass would implicitly perform.
+ * @param rPass Cannot be NULL, must be dynamic.
+ * @param final Zero to transition into rendering, non-zero to transition out.
+ * @return Zero on failure.
+ */
+static bool gfx_frame_push_attachments_(GFXRenderer* renderer, GFXFrame* frame,
+                                        GFXRenderPass_* rPass, bool final,
+                                        GFXInjection_* injection)
+{
+	assert(renderer != NULL);
+	assert(frame != NULL);
+	assert(rPass != NULL);
+	assert(GFX_PASS_IS_DYNAMIC_(rPass));
+	assert(injection != NULL);
+
+	GFXContext_* context = renderer->cache.context;
+
+	for (size_t c = 0; c < rPass->base.consumes.size; ++c)
+	{
+		const GFXConsume_* con = gfx_vec_at(&rPass->base.consumes, c);
+		const GFXAttach_* at = gfx_vec_at(&renderer->backing.attachs, con->index);
+
+		// Only transition what is consumed as attachment,
+		// i.e. exactly what the Vulkan render pass would have described.
+		if (
+			!(con->mask &
+				(GFX_ACCESS_ATTACHMENT_READ |
+				GFX_ACCESS_ATTACHMENT_WRITE |
+				GFX_ACCESS_ATTACHMENT_RESOLVE)) ||
+			con->index >= renderer->backing.attachs.size ||
+			at->type == GFX_ATTACH_EMPTY_ ||
+			(at->type == GFX_ATTACH_WINDOW_ &&
+				con->index != rPass->out.backing))
+		{
+			continue;
+		}
+
+		const GFXFormat fmt = (at->type == GFX_ATTACH_IMAGE_) ?
+			// Pick empty format for windows, same as consumption barriers.
+			at->image.base.format : GFX_FORMAT_EMPTY;
+
+		const VkImageLayout layout = (at->type == GFX_ATTACH_IMAGE_) ?
+			GFX_GET_VK_IMAGE_LAYOUT_(con->mask, fmt) :
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		const VkImageLayout oldLayout = final ? layout : con->out.initial;
+		const VkImageLayout newLayout = final ? con->out.final : layout;
+
+		if (oldLayout == newLayout || newLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+			continue;
+
+		// Get us the VkImage handle.
+		VkImage image;
+
+		if (at->type == GFX_ATTACH_IMAGE_)
+			image = at->image.vk.image;
+		else
+		{
+			// Query the swapchain image index.
+			const uint32_t imageInd =
+				gfx_frame_get_swapchain_index_(frame, con->index);
+
+			// Validate & set, silently ignore non-existent.
+			if (at->window.window->frame.images.size <= imageInd)
+				continue;
+
+			image = *(VkImage*)gfx_vec_at(
+				&at->window.window->frame.images, imageInd);
+		}
+
+		// Similarly to subpass transitions, we use the same access/stage
+		// flags on both ends to form a dependency chain with the
+		// consumption barriers of neighbouring passes.
+		const GFXImageAspect aspect = GFX_IMAGE_ASPECT_FROM_FORMAT(fmt);
+
+		const VkAccessFlags accessMask =
+			GFX_GET_VK_ACCESS_FLAGS_(con->mask, fmt);
+		const VkPipelineStageFlags stageMask =
+			GFX_MOD_VK_PIPELINE_STAGE_(
+				GFX_GET_VK_PIPELINE_STAGE_(con->mask, con->stage, fmt), context);
+
+		VkImageMemoryBarrier imb = {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+
+			.pNext               = NULL,
+			.srcAccessMask       = accessMask,
+			.dstAccessMask       = accessMask,
+			.oldLayout           = oldLayout,
+			.newLayout           = newLayout,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image               = image,
+
+			.subresourceRange = {
+				.aspectMask =
+					// Fix aspect, cause we're nice :)
+					GFX_GET_VK_IMAGE_ASPECT_(con->view.range.aspect & aspect),
+				.baseMipLevel = con->view.range.mipmap,
+				.baseArrayLayer = con->view.range.layer,
+
+				.levelCount = con->view.range.numMipmaps == 0 ?
+					VK_REMAINING_MIP_LEVELS : con->view.range.numMipmaps,
+				.layerCount = con->view.range.numLayers == 0 ?
+					VK_REMAINING_ARRAY_LAYERS : con->view.range.numLayers
+			}
+		};
+
+		if (!gfx_injection_push_(
+			stageMask, stageMask, NULL, NULL, &imb, injection))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 /****************************
  * Records a set of passes of a virtual frame.
  * @param cmd   To record to, cannot be VK_NULL_HANDLE.
@@ -897,6 +1065,15 @@ static bool gfx_frame_record_(VkCommandBuffer cmd,
 					if (!gfx_frame_push_consume_(renderer, frame, con, injection))
 						return 0;
 				}
+
+				// Or the first consumption of an aliased attachment.
+				else if (
+					(con->out.alias != NULL) &&
+					(con->out.state & GFX_CONSUME_IS_FIRST_))
+				{
+					if (!gfx_frame_push_alias_(renderer, con, injection))
+						return 0;
+				}
 			}
 
 			// Flush depend & consumption barriers.
@@ -909,36 +1086,92 @@ static bool gfx_frame_record_(VkCommandBuffer cmd,
 		{
 			GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
 
-			// Check if it is built.
-			if (rPass->build.pass == NULL)
-				goto skip_pass;
-
-			// Check for the presence of a framebuffer.
-			VkFramebuffer framebuffer = gfx_pass_framebuffer_(rPass, frame);
-			if (framebuffer == VK_NULL_HANDLE)
-				goto skip_pass;
-
-			// Gather all necessary render pass info to record.
-			VkRenderPassBeginInfo rpbi = {
-				.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-
-				.pNext           = NULL,
-				.renderPass      = rPass->vk.pass,
-				.framebuffer     = framebuffer,
-				.clearValueCount = (uint32_t)rPass->vk.clears.size,
-				.pClearValues    = gfx_vec_at(&rPass->vk.clears, 0),
-
-				.renderArea = {
-					.offset = { 0, 0 },
-					.extent = {
-						rPass->build.fWidth,
-						rPass->build.fHeight
-					}
+			// Use dynamic rendering if warmed as such.
+			if (GFX_PASS_IS_DYNAMIC_(rPass))
+			{
+				// Get all attachments, also checks if it is built.
+				const size_t numAttachs = rPass->vk.attachs.size;
+				VkRenderingAttachmentInfo rai[numAttachs];
+
+				if (!gfx_pass_rendering_(rPass, frame, rai))
+					goto skip_pass;
+
+				// Transition all attachments into rendering,
+				// there is no render pass to do this for us.
+				if (!gfx_frame_push_attachments_(
+					renderer, frame, rPass, 0, injection))
+				{
+					return 0;
 				}
-			};
 
-			context->vk.CmdBeginRenderPass(cmd,
-				&rpbi, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+				gfx_injection_flush_(context, cmd, injection);
+
+				// Depth & stencil are the last two attachments.
+				VkRenderingAttachmentInfo* depth = rai + (numAttachs - 2);
+				VkRenderingAttachmentInfo* stencil = rai + (numAttachs - 1);
+
+				VkRenderingInfo ri = {
+					.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+
+					.pNext                = NULL,
+					.layerCount           = GFX_MAX(1, rPass->build.fLayers),
+					.viewMask             = 0,
+					.colorAttachmentCount = (uint32_t)(numAttachs - 2),
+					.pColorAttachments    = numAttachs > 2 ? rai : NULL,
+
+					// Recorders always output secondary command buffers.
+					.flags =
+						VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
+
+					.pDepthAttachment =
+						depth->imageView != VK_NULL_HANDLE ? depth : NULL,
+					.pStencilAttachment =
+						stencil->imageView != VK_NULL_HANDLE ? stencil : NULL,
+
+					.renderArea = {
+						.offset = { 0, 0 },
+						.extent = {
+							rPass->build.fWidth,
+							rPass->build.fHeight
+						}
+					}
+				};
+
+				context->vk.CmdBeginRendering(cmd, &ri);
+			}
+			else
+			{
+				// Check if it is built.
+				if (rPass->build.pass == NULL)
+					goto skip_pass;
+
+				// Check for the presence of a framebuffer.
+				VkFramebuffer framebuffer = gfx_pass_framebuffer_(rPass, frame);
+				if (framebuffer == VK_NULL_HANDLE)
+					goto skip_pass;
+
+				// Gather all necessary render pass info to record.
+				VkRenderPassBeginInfo rpbi = {
+					.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+
+					.pNext           = NULL,
+					.renderPass      = rPass->vk.pass,
+					.framebuffer     = framebuffer,
+					.clearValueCount = (uint32_t)rPass->vk.clears.size,
+					.pClearValues    = gfx_vec_at(&rPass->vk.clears, 0),
+
+					.renderArea = {
+						.offset = { 0, 0 },
+						.extent = {
+							rPass->build.fWidth,
+							rPass->build.fHeight
+						}
+					}
+				};
+
+				context->vk.CmdBeginRenderPass(cmd,
+					&rpbi, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+			}
 		}
 
 		// Then start looping over the chain again to actually record them.
@@ -984,7 +1217,25 @@ static bool gfx_frame_record_(VkCommandBuffer cmd,
 
 		// If a render pass, end as render pass.
 		if (pass->type == GFX_PASS_RENDER)
-			context->vk.CmdEndRenderPass(cmd);
+		{
+			GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
+
+			if (!GFX_PASS_IS_DYNAMIC_(rPass))
+				context->vk.CmdEndRenderPass(cmd);
+			else
+			{
+				context->vk.CmdEndRendering(cmd);
+
+				// And transition all attachments out of rendering.
+				if (!gfx_frame_push_attachments_(
+					renderer, frame, rPass, 1, injection))
+				{
+					return 0;
+				}
+
+				gfx_injection_flush_(context, cmd, injection);
+			}
+		}
 
 		// Jump to here if for any reason we do not record the pass.
 		// We always record closing signal commands, regardless of
@@ -1086,6 +1337,88 @@ static void gfx_frame_finalize_(GFXRenderer* renderer, bool success,
 		}
 }
 
+/****************************
+ * Records & submits all asynchronous compute passes of a virtual frame.
+ * @param renderer Cannot be NULL.
+ * @param frame    Cannot be NULL.
+ * @return Zero on failure.
+ */
+static bool gfx_frame_submit_compute_(GFXRenderer* renderer, GFXFrame* frame)
+{
+	assert(renderer != NULL);
+	assert(frame != NULL);
+
+	GFXContext_* context = renderer->cache.context;
+
+	// Prepare injection metadata.
+	GFXInjection_ injection = {
+		.inp = {
+			.renderer = renderer,
+			.numRefs = 0,
+			.queue = {
+				.family = renderer->compute.family,
+				.index = renderer->compute.index
+			}
+		}
+	};
+
+	gfx_injection_(&injection);
+
+	// Record compute.
+	if (!gfx_frame_record_(frame->compute.vk.cmd,
+		renderer, frame,
+		renderer->graph.firstCompute, NULL,
+		&injection))
+	{
+		goto clean;
+	}
+
+	// Lock queue and submit.
+	VkSubmitInfo si = {
+		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+
+		.pNext                = NULL,
+		.waitSemaphoreCount   = (uint32_t)injection.out.numWaits,
+		.pWaitSemaphores      = injection.out.waits,
+		.pWaitDstStageMask    = injection.out.stages,
+		.commandBufferCount   = 1,
+		.pCommandBuffers      = &frame->compute.vk.cmd,
+		.signalSemaphoreCount = (uint32_t)injection.out.numSigs,
+		.pSignalSemaphores    = injection.out.sigs
+	};
+
+	gfx_mutex_lock_(renderer->compute.lock);
+
+	GFX_VK_CHECK_(
+		context->vk.QueueSubmit(
+			renderer->compute.vk.queue, 1, &si, frame->compute.vk.done),
+		{
+			gfx_mutex_unlock_(renderer->compute.lock);
+			goto clean;
+		});
+
+	gfx_mutex_unlock_(renderer->compute.lock);
+
+	// Lastly, make all commands visible for future operations.
+	gfx_frame_finalize_(renderer, 1,
+		renderer->graph.firstCompute, NULL,
+		&injection);
+
+	// Succesfully submitted.
+	frame->submitted |= GFX_FRAME_COMPUTE_;
+
+	return 1;
+
+
+	// Cleanup on failure.
+clean:
+	gfx_frame_finalize_(renderer, 0,
+		renderer->graph.firstCompute, NULL,
+		&injection);
+
+	return 0;
+}
+
 /****************************/
 bool gfx_frame_submit_(GFXRenderer* renderer, GFXFrame* frame)
 {
@@ -1100,8 +1433,17 @@ bool gfx_frame_submit_(GFXRenderer* renderer, GFXFrame* frame)
 	const size_t culledGraphics = renderer->graph.culledRender;
 	const size_t culledCompute = renderer->graph.culledCompute;
 
+	// Asynchronous compute is submitted first if other passes wait on it,
+	// otherwise asynchronous passes wait on the other passes.
+	const bool computeFirst = renderer->graph.numFromAsync > 0;
+
 	GFXInjection_ injection;
 
+	// Record & submit to the compute queue first.
+	if (computeFirst && culledCompute < numCompute)
+		if (!gfx_frame_submit_compute_(renderer, frame))
+			goto error;
+
 	// Record & submit to the graphics queue.
 	if (culledGraphics < numGraphics)
 	{
@@ -1252,66 +1594,10 @@ bool gfx_frame_submit_(GFXRenderer* renderer, GFXFrame* frame)
 		frame->submitted |= GFX_FRAME_GRAPHICS_;
 	}
 
-	// Record & submit to the compute queue.
-	if (culledCompute < numCompute)
-	{
-		// Prepare injection metadata.
-		injection = (GFXInjection_){
-			.inp = {
-				.renderer = renderer,
-				.numRefs = 0,
-				.queue = {
-					.family = renderer->compute.family,
-					.index = renderer->compute.index
-				}
-			}
-		};
-
-		gfx_injection_(&injection);
-
-		// Record compute.
-		if (!gfx_frame_record_(frame->compute.vk.cmd,
-			renderer, frame,
-			renderer->graph.firstCompute, NULL,
-			&injection))
-		{
-			goto clean_compute;
-		}
-
-		// Lock queue and submit.
-		VkSubmitInfo si = {
-			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-
-			.pNext                = NULL,
-			.waitSemaphoreCount   = (uint32_t)injection.out.numWaits,
-			.pWaitSemaphores      = injection.out.waits,
-			.pWaitDstStageMask    = injection.out.stages,
-			.commandBufferCount   = 1,
-			.pCommandBuffers      = &frame->compute.vk.cmd,
-			.signalSemaphoreCount = (uint32_t)injection.out.numSigs,
-			.pSignalSemaphores    = injection.out.sigs
-		};
-
-		gfx_mutex_lock_(renderer->compute.lock);
-
-		GFX_VK_CHECK_(
-			context->vk.QueueSubmit(
-				renderer->compute.vk.queue, 1, &si, frame->compute.vk.done),
-			{
-				gfx_mutex_unlock_(renderer->compute.lock);
-				goto clean_compute;
-			});
-
-		gfx_mutex_unlock_(renderer->compute.lock);
-
-		// Lastly, make all commands visible for future operations.
-		gfx_frame_finalize_(renderer, 1,
-			renderer->graph.firstCompute, NULL,
-			&injection);
-
-		// Succesfully submitted.
-		frame->submitted |= GFX_FRAME_COMPUTE_;
-	}
+	// Or submit to the compute queue afterwards.
+	if (!computeFirst && culledCompute < numCompute)
+		if (!gfx_frame_submit_compute_(renderer, frame))
+			goto error;
 
 	// Post submission things:
 	// When all is submitted, spend some time flushing the cache & pool.
@@ -1324,6 +1610,9 @@ bool gfx_frame_submit_(GFXRenderer* renderer, GFXFrame* frame)
 	// Note: we do not flush the pool after synchronization to spare time!
 	gfx_pool_flush_(&renderer->pool);
 
+	// Count the submission, bindless sets use this to reuse freed slots.
+	atomic_fetch_add_explicit(&renderer->ticks, 1, memory_order_relaxed);
+
 	return 1;
 
 
@@ -1335,13 +1624,6 @@ clean_graphics:
 
 	goto error;
 
-clean_compute:
-	gfx_frame_finalize_(renderer, 0,
-		renderer->graph.firstCompute, NULL,
-		&injection);
-
-	goto error;
-
 
 	// Error on failure.
 error:
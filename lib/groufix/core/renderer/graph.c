@@ -7,6 +7,8 @@
  */
 
 #include "groufix/core/objects.h"
+#include <limits.h>
+#include <stdlib.h>
 
 
 // Check if a consumption has attachment access.
@@ -139,22 +141,125 @@ static bool gfx_check_cycles_(GFXPass* pass,
 	return 1;
 }
 
+/****************************
+ * Consumption summary of a single attachment within a subpass chain.
+ */
+typedef struct GFXChainElem_
+{
+	size_t index;   // Attachment index.
+	size_t attachs; // #passes consuming it with attachment-access.
+	size_t others;  // #passes consuming it without attachment-access.
+
+	const GFXConsume_* con; // First consumption with attachment-access.
+
+} GFXChainElem_;
+
+
+/****************************
+ * Consumption summary of an entire subpass chain.
+ * Used to score merge candidates without walking the chain.
+ */
+typedef struct GFXChain_
+{
+	GFXVec elems; // Stores GFXChainElem_, sorted on index.
+	bool   valid; // Zero if incomplete (out of memory), cannot be merged with.
+
+} GFXChain_;
+
+
+/****************************
+ * Finds a GFXChainElem_ in a vector, optionally inserts it at
+ * its correct sorted position.
+ * @param vec Assumed to be sorted and store GFXChainElem_.
+ * @return The (new) element, NULL if not found or insertion failed.
+ */
+static GFXChainElem_* gfx_find_chain_elem_(GFXVec* vec, size_t index,
+                                           bool insert)
+{
+	// Binary search to its position.
+	size_t l = 0;
+	size_t r = vec->size;
+
+	while (l < r)
+	{
+		const size_t p = (l + r) >> 1;
+		GFXChainElem_* e = gfx_vec_at(vec, p);
+
+		if (e->index < index) l = p + 1;
+		else if (e->index > index) r = p;
+		else return e;
+	}
+
+	// Insert anew.
+	GFXChainElem_ elem = {
+		.index = index,
+		.attachs = 0,
+		.others = 0,
+		.con = NULL
+	};
+
+	if (insert && gfx_vec_insert(vec, 1, &elem, l))
+		return gfx_vec_at(vec, l);
+
+	return NULL;
+}
+
+/****************************
+ * Appends the consumptions of a render pass to a subpass chain summary.
+ * @param chain Cannot be NULL.
+ * @param rPass Cannot be NULL, must be the last pass of chain.
+ *
+ * Invalidates the chain on failure.
+ */
+static void gfx_chain_append_(GFXRenderer* renderer,
+                              GFXChain_* chain, GFXRenderPass_* rPass)
+{
+	assert(renderer != NULL);
+	assert(chain != NULL);
+	assert(rPass != NULL);
+
+	if (!chain->valid) return;
+
+	for (size_t i = 0; i < rPass->base.consumes.size; ++i)
+	{
+		const GFXConsume_* con = gfx_vec_at(&rPass->base.consumes, i);
+		if (con->index >= renderer->backing.attachs.size) continue;
+
+		GFXChainElem_* elem =
+			gfx_find_chain_elem_(&chain->elems, con->index, 1);
+
+		if (elem == NULL)
+		{
+			chain->valid = 0;
+			return;
+		}
+
+		if (!GFX_CONSUME_IS_ATTACH_(con))
+			++elem->others;
+		else
+		{
+			if (elem->con == NULL) elem->con = con;
+			++elem->attachs;
+		}
+	}
+}
+
 /****************************
  * Calculates the merge score of a possible merge candidate for a render pass.
  * If the score > 0, it means this parent _can_ be submitted as subpass
  * before the pass itself, which might implicitly move it up in submission order.
  * @param rPass      Cannot be NULL, must not be culled.
  * @param rCandidate Cannot be NULL, must be a non-culled parent of a rPass.
- * @param consumes   Cannot be NULL, must be pre-initialized.
+ * @param chain      Cannot be NULL, summary of the chain of rCandidate.
  * @return Candidate's score, the higher the better, zero if not a candidate.
  *
- * consumes must hold `renderer->backing.attachs.size` pointers, for each
- * attachment it must hold the GFXConsume_* of rPass (or NULL if not consumed).
+ * Only loops over the consumptions of rPass, every lookup in the summary
+ * is logarithmic, so this does not depend on the length of the chain.
  */
 static uint64_t gfx_pass_merge_score_(GFXRenderer* renderer,
                                       GFXRenderPass_* rPass,
                                       GFXRenderPass_* rCandidate,
-                                      GFXConsume_** consumes)
+                                      GFXChain_* chain)
 {
 	assert(renderer != NULL);
 	assert(rPass != NULL);
@@ -162,7 +267,7 @@ static uint64_t gfx_pass_merge_score_(GFXRenderer* renderer,
 	assert(rCandidate != NULL);
 	assert(!rCandidate->base.culled);
 	assert(rCandidate->base.level < rPass->base.level);
-	assert(consumes != NULL);
+	assert(chain != NULL);
 
 	// The candidate may not already be merged.
 	// This would confuse all of the code.
@@ -174,6 +279,24 @@ static uint64_t gfx_pass_merge_score_(GFXRenderer* renderer,
 	// After this check rPass MUST be the _only_ non-culled child of rCandidate.
 	if (rCandidate->base.childs > 1) return 0;
 
+	// Incomplete summary, cannot tell.
+	if (!chain->valid) return 0;
+
+	// Check backing window compatibility (can only have one).
+	// The master holds the backing window of the entire chain.
+	GFXRenderPass_* master =
+		(rCandidate->out.master == NULL) ?
+		rCandidate : rCandidate->out.master;
+
+	const size_t backing = rPass->out.backing;
+
+	if (
+		backing != SIZE_MAX && master->out.backing != SIZE_MAX &&
+		backing != master->out.backing)
+	{
+		return 0;
+	}
+
 	// See if the passes have any attachments in common.
 	// We assume all attachments within a pass will resolve to have the same
 	// size, if they do not, the pass will throw warnings when building.
@@ -183,62 +306,34 @@ static uint64_t gfx_pass_merge_score_(GFXRenderer* renderer,
 	// Do not bother getting actual sizes here, way too complex, why build
 	// a Vulkan subpass if there is no overlap anyway...
 	size_t sharedAttachs = 0;
-	const size_t backing = rPass->out.backing;
-
-	// Loop over the entire chain as it currently is, beginning at master.
-	GFXRenderPass_* rCurr =
-		(rCandidate->out.master == NULL) ?
-		rCandidate : rCandidate->out.master;
 
-	for (; rCurr != NULL; rCurr = rCurr->out.next)
+	for (size_t i = 0; i < rPass->base.consumes.size; ++i)
 	{
-		// Check backing window compatibility (can only have one).
-		if (
-			backing != SIZE_MAX && rCurr->out.backing != SIZE_MAX &&
-			backing != rCurr->out.backing)
-		{
+		const GFXConsume_* con = gfx_vec_at(&rPass->base.consumes, i);
+		if (con->index >= renderer->backing.attachs.size) continue;
+
+		const GFXChainElem_* elem =
+			gfx_find_chain_elem_(&chain->elems, con->index, 0);
+
+		if (elem == NULL) continue;
+
+		// Check if either pass consumes an attachment with
+		// attachment-access while the other does not.
+		// If this is true, the passes cannot be merged into
+		// a subpass chain, as the attachment may become a
+		// preserved attachment (whilst accessing it!).
+		if (GFX_CONSUME_IS_ATTACH_(con) ? elem->others > 0 : elem->attachs > 0)
 			return 0;
-		}
 
-		// For each pass, check all consumptions.
-		for (size_t i = 0; i < rCurr->base.consumes.size; ++i)
+		// If they both consume as attachment...
+		if (GFX_CONSUME_IS_ATTACH_(con))
 		{
-			GFXConsume_* con = gfx_vec_at(&rCurr->base.consumes, i);
-			if (con->index < renderer->backing.attachs.size)
-			{
-				GFXConsume_* childCon = consumes[con->index];
-				if (childCon == NULL) continue;
-
-				// Check if either pass consumes an attachment with
-				// attachment-access while the other does not.
-				// If this is true, the passes cannot be merged into
-				// a subpass chain, as the attachment may become a
-				// preserved attachment (whilst accessing it!).
-				// Note: If consumed as non-attachment BUT also consumed as
-				// attachment in the same pass, it will not be preserved,
-				// allow this case!
-				if (
-					(GFX_CONSUME_IS_ATTACH_(con) &&
-					!GFX_CONSUME_IS_ATTACH_(childCon)) ||
-
-					(GFX_CONSUME_IS_ATTACH_(childCon) &&
-					!GFX_CONSUME_IS_ATTACH_(con)))
-				{
-					return 0;
-				}
-
-				// If they both consume as attachment...
-				if (
-					GFX_CONSUME_IS_ATTACH_(con) &&
-					GFX_CONSUME_IS_ATTACH_(childCon))
-				{
-					// Check view compatibility.
-					if (!gfx_cmp_consume_(con, childCon)) return 0;
+			// Check view compatibility.
+			// All passes in the chain are compatible with elem->con.
+			if (!gfx_cmp_consume_(elem->con, con)) return 0;
 
-					// Count consumptions for each pass.
-					++sharedAttachs;
-				}
-			}
+			// Count consumptions for each pass.
+			sharedAttachs += elem->attachs;
 		}
 	}
 
@@ -253,19 +348,22 @@ static uint64_t gfx_pass_merge_score_(GFXRenderer* renderer,
 /****************************
  * Picks a merge candidate (if any) from a pass' parents, and merge with it,
  * setting and/or updating the `out` field of both render passes.
- * consumes must hold `renderer->backing.attachs.size` pointers.
- * @param rPass    Cannot be NULL, must not be culled.
- * @param consumes Cannot be NULL.
+ * @param rPass  Cannot be NULL, must not be culled.
+ * @param chains May be NULL (out of memory), in which case nothing is merged.
+ * @param num    Cannot be NULL, number of chains initialized in chains.
  *
  * Must be called for all passes in submission order!
+ * chains must hold `renderer->graph.numRender` elements.
+ * The `out.chain` field of all master passes is used to index into chains.
  */
 static void gfx_pass_merge_(GFXRenderer* renderer,
-                            GFXRenderPass_* rPass, GFXConsume_** consumes)
+                            GFXRenderPass_* rPass,
+                            GFXChain_* chains, size_t* num)
 {
 	assert(renderer != NULL);
 	assert(rPass != NULL);
 	assert(!rPass->base.culled);
-	assert(consumes != NULL);
+	assert(num != NULL);
 
 	// Init to unmerged.
 	rPass->out.master = NULL;
@@ -274,33 +372,23 @@ static void gfx_pass_merge_(GFXRenderer* renderer,
 	rPass->out.subpasses = 1;
 
 	// Take the parent with the highest merge score.
-	// To do this, initialize the `consumes` array for this pass.
-	// Simultaneously, check if any consumption wants to clear an attachment.
+	// First check if any consumption wants to clear an attachment.
 	// If it does, the pass cannot merge into one of its parents,
 	// a Vulkan render pass can only auto-clear each attachment once.
-	bool canMerge = 1;
-
-	for (size_t i = 0; i < renderer->backing.attachs.size; ++i)
-		consumes[i] = NULL;
+	bool canMerge = chains != NULL;
 
-	for (size_t i = 0; i < rPass->base.consumes.size; ++i)
+	for (size_t i = 0; canMerge && i < rPass->base.consumes.size; ++i)
 	{
 		GFXConsume_* con = gfx_vec_at(&rPass->base.consumes, i);
-		if (con->index < renderer->backing.attachs.size)
-		{
-			consumes[con->index] = con;
-			if (con->cleared) canMerge = 0;
-		}
+		if (con->index < renderer->backing.attachs.size && con->cleared)
+			canMerge = 0;
 	}
 
-	// Done.
-	if (!canMerge) return;
-
 	// Start looping over all parents to find the best.
 	GFXRenderPass_* merge = NULL;
 	uint64_t score = 0;
 
-	for (size_t p = 0; p < rPass->base.parents.size; ++p)
+	for (size_t p = 0; canMerge && p < rPass->base.parents.size; ++p)
 	{
 		GFXRenderPass_* rCandidate =
 			*(GFXRenderPass_**)gfx_vec_at(&rPass->base.parents, p);
@@ -315,8 +403,12 @@ static void gfx_pass_merge_(GFXRenderer* renderer,
 		if (rCandidate->base.culled) continue;
 
 		// Calculate score.
-		uint64_t pScore =
-			gfx_pass_merge_score_(renderer, rPass, rCandidate, consumes);
+		GFXRenderPass_* master =
+			(rCandidate->out.master == NULL) ?
+			rCandidate : rCandidate->out.master;
+
+		uint64_t pScore = gfx_pass_merge_score_(
+			renderer, rPass, rCandidate, &chains[master->out.chain]);
 
 		// Note: if pScore == 0, it will always be rejected!
 		if (pScore > score)
@@ -339,6 +431,21 @@ static void gfx_pass_merge_(GFXRenderer* renderer,
 
 		// Increase subpass count of master.
 		++master->out.subpasses;
+
+		// And append it to the summary of the chain.
+		gfx_chain_append_(renderer, &chains[master->out.chain], rPass);
+	}
+
+	// Or start a new chain.
+	else if (chains != NULL)
+	{
+		GFXChain_* chain = &chains[*num];
+		rPass->out.chain = (*num)++;
+
+		gfx_vec_init(&chain->elems, sizeof(GFXChainElem_));
+		chain->valid = 1;
+
+		gfx_chain_append_(renderer, chain, rPass);
 	}
 }
 
@@ -347,19 +454,22 @@ static void gfx_pass_merge_(GFXRenderer* renderer,
  * Will also resolve the `out` field of all 'master' passes in the chain.
  * @param pass      Cannot be NULL, must not be culled.
  * @param consumes  Cannot be NULL, must be initialized to all NULL on first call.
+ * @param masters   Cannot be NULL, must be initialized to all NULL on first call.
  * @param ptrToNext Cannot be NULL, pointed to cannot be NULL either.
  *
  * Must be called for all passes in submission order!
- * consumes must hold `renderer->backing.attachs.size` pointers.
+ * consumes and masters must hold `renderer->backing.attachs.size` pointers,
+ * masters stores the master pass of the last consumption of each attachment.
  */
 static void gfx_pass_resolve_(GFXRenderer* renderer,
                               GFXPass* pass, GFXConsume_** consumes,
-                              GFXPass*** ptrToNext)
+                              const GFXPass** masters, GFXPass*** ptrToNext)
 {
 	assert(renderer != NULL);
 	assert(pass != NULL);
 	assert(!pass->culled);
 	assert(consumes != NULL);
+	assert(masters != NULL);
 	assert(ptrToNext != NULL && *ptrToNext != NULL);
 
 	GFXPass* subpass = pass;
@@ -387,11 +497,9 @@ static void gfx_pass_resolve_(GFXRenderer* renderer,
 	*ptrToNext = &subpass->out.nextMaster;
 
 	// And start looping over the entire subpass chain.
-	// Keep track of what consumptions have been seen in this chain.
-	const size_t numAttachs = renderer->backing.attachs.size;
-
-	bool thisChain[GFX_MAX(1, numAttachs)];
-	for (size_t i = 0; i < numAttachs; ++i) thisChain[i] = 0;
+	// Keep track of what consumptions have been seen in this chain,
+	// by marking attachments with the master, no need to reset per chain.
+	const GFXPass* master = subpass;
 
 	while (subpass != NULL)
 	{
@@ -410,6 +518,7 @@ static void gfx_pass_resolve_(GFXRenderer* renderer,
 			con->out.state = GFX_CONSUME_IS_FIRST_ | GFX_CONSUME_IS_LAST_;
 			con->out.prev = NULL;
 			con->out.next = NULL;
+			con->out.alias = NULL;
 
 			// Validate existence of the attachment.
 			if (
@@ -454,7 +563,7 @@ static void gfx_pass_resolve_(GFXRenderer* renderer,
 				prev->out.next = con;
 
 				// Set subpass chain state if previous is of the same chain.
-				if (thisChain[con->index])
+				if (masters[con->index] == master)
 				{
 					prev->out.state &= ~(unsigned int)GFX_CONSUME_IS_LAST_;
 					con->out.state &= ~(unsigned int)GFX_CONSUME_IS_FIRST_;
@@ -474,7 +583,7 @@ static void gfx_pass_resolve_(GFXRenderer* renderer,
 			// Store the consumption for this attachment so the next
 			// resolve calls have this data.
 			consumes[con->index] = con;
-			thisChain[con->index] = 1;
+			masters[con->index] = master;
 		}
 
 		// Also resolve all dependencies.
@@ -525,11 +634,254 @@ static void gfx_pass_resolve_(GFXRenderer* renderer,
 	}
 }
 
+/****************************
+ * Computes the lifetime of all attachments in recording order, so the
+ * render backing can alias the memory of attachments that do not overlap.
+ * Then links the consumptions of aliased attachments for aliasing barriers.
+ * @param renderer Cannot be NULL, its graph must be just resolved.
+ *
+ * Invalidates all passes that consume an attachment without image,
+ * as the backing may have released it.
+ */
+static void gfx_render_graph_alias_(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+
+	const size_t numAttachs = renderer->backing.attachs.size;
+	if (numAttachs == 0) return;
+
+	// Lifetimes are in indices into the chain of 'master' passes,
+	// this is the order passes are recorded in, such that all passes
+	// in a subpass chain share the same Vulkan render pass & lifetime.
+	unsigned int firsts[numAttachs];
+	unsigned int lasts[numAttachs];
+	const GFXConsume_* firstCons[numAttachs];
+	const GFXConsume_* lastCons[numAttachs];
+
+	for (size_t i = 0; i < numAttachs; ++i)
+		firsts[i] = UINT_MAX, lasts[i] = 0,
+		firstCons[i] = NULL, lastCons[i] = NULL;
+
+	unsigned int step = 0;
+
+	for (
+		GFXPass* pass = renderer->graph.out.firstMaster;
+		pass != NULL;
+		pass = pass->out.nextMaster, ++step)
+	{
+		for (
+			GFXPass* subpass = pass;
+			subpass != NULL;
+			subpass = (subpass->type == GFX_PASS_RENDER) ?
+				(GFXPass*)((GFXRenderPass_*)subpass)->out.next : NULL)
+		{
+			for (size_t c = 0; c < subpass->consumes.size; ++c)
+			{
+				const GFXConsume_* con = gfx_vec_at(&subpass->consumes, c);
+				if (con->index >= numAttachs) continue;
+
+				if (firsts[con->index] == UINT_MAX)
+					firsts[con->index] = step,
+					firstCons[con->index] = con;
+
+				lasts[con->index] = step;
+				lastCons[con->index] = con;
+			}
+		}
+	}
+
+	// Let the backing decide which attachments alias.
+	gfx_render_backing_alias_(renderer, firsts, lasts);
+
+	// Link the first consumption of each aliased attachment to the
+	// last consumption of the previous attachment in its group.
+	// Groups never overlap, so previous in order of first use.
+	// Simultaneously invalidate all passes consuming a released image.
+	size_t prevs[numAttachs]; // Indexed by group, i.e. its first attachment.
+	GFXConsume_* heads[numAttachs];
+
+	for (size_t i = 0; i < numAttachs; ++i)
+		prevs[i] = SIZE_MAX, heads[i] = NULL;
+
+	for (
+		GFXPass* pass = renderer->graph.out.firstMaster;
+		pass != NULL;
+		pass = pass->out.nextMaster)
+	{
+		for (
+			GFXPass* subpass = pass;
+			subpass != NULL;
+			subpass = (subpass->type == GFX_PASS_RENDER) ?
+				(GFXPass*)((GFXRenderPass_*)subpass)->out.next : NULL)
+		{
+			for (size_t c = 0; c < subpass->consumes.size; ++c)
+			{
+				GFXConsume_* con = gfx_vec_at(&subpass->consumes, c);
+				if (con->index >= numAttachs) continue;
+
+				const GFXAttach_* at =
+					gfx_vec_at(&renderer->backing.attachs, con->index);
+
+				if (at->type != GFX_ATTACH_IMAGE_) continue;
+
+				if (at->image.vk.image == VK_NULL_HANDLE)
+					subpass->invalid = 1;
+
+				const size_t group = at->image.alias;
+				if (group == SIZE_MAX || firstCons[con->index] != con)
+					continue;
+
+				if (prevs[group] != SIZE_MAX)
+					con->out.alias = lastCons[prevs[group]];
+				else
+					heads[group] = con;
+
+				prevs[group] = con->index;
+			}
+		}
+	}
+
+	// Wrap around: link the first attachment of each group to the last.
+	// With multiple virtual frames in flight, the next frame's first
+	// attachment overlaps this frame's last attachment in memory.
+	// Frames are submitted to the same queue in order, so the same
+	// barrier also covers consumptions of the previous submission.
+	for (size_t g = 0; g < numAttachs; ++g)
+		if (heads[g] != NULL && prevs[g] != heads[g]->index)
+			heads[g]->out.alias = lastCons[prevs[g]];
+}
+
+/****************************
+ * Combines a value into a running hash.
+ */
+static inline uint64_t gfx_hash_mix_(uint64_t hash, uint64_t value)
+{
+	return hash ^ (value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2));
+}
+
+/****************************
+ * Hashes the `out` field of a pass and all its consumptions & dependencies.
+ * Meaning everything of the analyzed output its Vulkan objects are built from.
+ * @param pass Cannot be NULL, must not be culled.
+ */
+static uint64_t gfx_pass_hash_(GFXPass* pass)
+{
+	assert(pass != NULL);
+	assert(!pass->culled);
+
+	uint64_t hash = pass->type;
+
+	if (pass->type == GFX_PASS_RENDER)
+	{
+		GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
+
+		hash = gfx_hash_mix_(hash, (uintptr_t)rPass->out.master);
+		hash = gfx_hash_mix_(hash, (uintptr_t)rPass->out.next);
+		hash = gfx_hash_mix_(hash, rPass->out.subpass);
+		hash = gfx_hash_mix_(hash, rPass->out.subpasses);
+		hash = gfx_hash_mix_(hash, rPass->out.backing);
+	}
+
+	for (size_t i = 0; i < pass->consumes.size; ++i)
+	{
+		const GFXConsume_* con = gfx_vec_at(&pass->consumes, i);
+
+		hash = gfx_hash_mix_(hash, con->out.subpass);
+		hash = gfx_hash_mix_(hash, (uint64_t)con->out.initial);
+		hash = gfx_hash_mix_(hash, (uint64_t)con->out.final);
+		hash = gfx_hash_mix_(hash, con->out.state);
+		hash = gfx_hash_mix_(hash, con->out.prev != NULL);
+		hash = gfx_hash_mix_(hash, con->out.next != NULL);
+	}
+
+	for (size_t i = 0; i < pass->deps.size; ++i)
+	{
+		const GFXDepend_* dep = gfx_vec_at(&pass->deps, i);
+
+		hash = gfx_hash_mix_(hash, dep->out.subpass);
+		hash = gfx_hash_mix_(hash, dep->out.transition);
+	}
+
+	return hash;
+}
+
+/****************************
+ * Detects all passes whose analyzed output changed, invalidating them,
+ * then destructs every subpass chain containing an invalidated pass.
+ * @param renderer Cannot be NULL, its graph must be just analyzed.
+ * @param purge    Zero to only update hashes, nothing is built yet.
+ *
+ * All other chains are left untouched, keeping their Vulkan objects.
+ */
+static void gfx_render_graph_purge_(GFXRenderer* renderer, bool purge)
+{
+	assert(renderer != NULL);
+
+	// First detect changes of all passes.
+	// Culled passes are not analyzed, they are destructed if invalidated.
+	for (
+		GFXPass* pass = (GFXPass*)renderer->graph.passes.head;
+		pass != NULL;
+		pass = (GFXPass*)pass->list.next)
+	{
+		if (pass->culled) continue;
+
+		const uint64_t hash = gfx_pass_hash_(pass);
+		if (hash != pass->out.hash) pass->invalid = 1;
+
+		pass->out.hash = hash;
+	}
+
+	// Then destruct all subpass chains with any invalidated pass.
+	// Destruct every pass in the chain, as they share the Vulkan pass.
+	// Any pass that left a chain is invalidated itself,
+	// so no destructed chain can leave a built pass behind.
+	for (
+		GFXPass* pass = renderer->graph.out.firstMaster;
+		pass != renderer->graph.firstCompute;
+		pass = pass->out.nextMaster)
+	{
+		if (!purge || pass->type != GFX_PASS_RENDER) continue;
+
+		GFXRenderPass_* subpass = (GFXRenderPass_*)pass;
+		while (subpass != NULL && !subpass->base.invalid)
+			subpass = subpass->out.next;
+
+		// Nothing changed, keep it.
+		if (subpass == NULL) continue;
+
+		for (
+			subpass = (GFXRenderPass_*)pass;
+			subpass != NULL;
+			subpass = subpass->out.next)
+		{
+			gfx_pass_destruct_(subpass);
+		}
+	}
+
+	// Lastly, destruct invalidated culled passes & reset all.
+	for (
+		GFXPass* pass = (GFXPass*)renderer->graph.passes.head;
+		pass != NULL;
+		pass = (GFXPass*)pass->list.next)
+	{
+		if (
+			purge && pass->invalid && pass->culled &&
+			pass->type == GFX_PASS_RENDER)
+		{
+			gfx_pass_destruct_((GFXRenderPass_*)pass);
+		}
+
+		pass->invalid = 0;
+	}
+}
+
 /****************************
  * Analyzes the render graph to setup all passes for correct builds. Meaning
  * the `out` field of all consumptions, dependencies and render passes are set.
  * Also resolves the 'master' chain of passes
  * and sets the `order` field of all passes :)
+ * If invalidated, destructs all passes whose output changed (and culled ones).
  * @param renderer Cannot be NULL, its graph state must not yet be validated.
  */
 static void gfx_render_graph_analyze_(GFXRenderer* renderer)
@@ -537,15 +889,20 @@ static void gfx_render_graph_analyze_(GFXRenderer* renderer)
 	assert(renderer != NULL);
 	assert(renderer->graph.state < GFX_GRAPH_VALIDATED_);
 
+	const bool purge = renderer->graph.state == GFX_GRAPH_INVALID_;
+
 	// We want to see if we can merge render passes into a chain of
 	// subpasses, useful for tiled renderers n such :)
 	// So for each pass, check its parents for possible merge candidates.
 	// We ignore non-parents, so no merging happens if no connection is
 	// indicated through the user API.
 	// Loop in submission order so parents are processed before children.
-	// Also, allocate the `consumes` for gfx_pass_(merge|resolve)_ here.
-	const size_t numAttachs = renderer->backing.attachs.size;
-	GFXConsume_* consumes[GFX_MAX(1, numAttachs)];
+	// Also, allocate the `chains` for gfx_pass_merge_ here.
+	// If this fails, nothing gets merged, which is still valid.
+	GFXChain_* chains = (renderer->graph.numRender == 0) ? NULL :
+		malloc(sizeof(GFXChain_) * renderer->graph.numRender);
+
+	size_t numChains = 0;
 
 	for (
 		GFXPass* pass = (GFXPass*)renderer->graph.passes.head;
@@ -578,15 +935,25 @@ static void gfx_render_graph_analyze_(GFXRenderer* renderer)
 		}
 
 		// Now, merge it with one of its parents.
-		gfx_pass_merge_(renderer, rPass, consumes);
+		gfx_pass_merge_(renderer, rPass, chains, &numChains);
 	}
 
+	for (size_t c = 0; c < numChains; ++c)
+		gfx_vec_clear(&chains[c].elems);
+
+	free(chains);
+
 	// Then we loop over all passes in submission order whilst
 	// keeping track of the last consumption of each attachment.
 	// This way we resolve and propogate transition and synchronization
 	// data per attachment as we go.
+	// Also, allocate the `consumes` and `masters` for gfx_pass_resolve_ here.
+	const size_t numAttachs = renderer->backing.attachs.size;
+	GFXConsume_* consumes[GFX_MAX(1, numAttachs)];
+	const GFXPass* masters[GFX_MAX(1, numAttachs)];
+
 	for (size_t i = 0; i < numAttachs; ++i)
-		consumes[i] = NULL;
+		consumes[i] = NULL, masters[i] = NULL;
 
 	// Also reset the first 'master' pass, as the chain will be resolved also.
 	renderer->graph.out.firstMaster = NULL;
@@ -604,12 +971,18 @@ static void gfx_render_graph_analyze_(GFXRenderer* renderer)
 		if (pass->culled) continue;
 
 		// Resolve!
-		gfx_pass_resolve_(renderer, pass, consumes, &ptrToNext);
+		gfx_pass_resolve_(renderer, pass, consumes, masters, &ptrToNext);
 
 		// Set order.
 		pass->order = order++;
 	}
 
+	// Alias the memory of attachments with non-overlapping lifetimes.
+	gfx_render_graph_alias_(renderer);
+
+	// Compare against the previous analysis and purge what changed.
+	gfx_render_graph_purge_(renderer, purge);
+
 	// Its now validated!
 	renderer->graph.state = GFX_GRAPH_VALIDATED_;
 }
@@ -626,6 +999,8 @@ void gfx_render_graph_init_(GFXRenderer* renderer)
 	renderer->graph.numCompute = 0;
 	renderer->graph.culledRender = 0;
 	renderer->graph.culledCompute = 0;
+	renderer->graph.numToAsync = 0;
+	renderer->graph.numFromAsync = 0;
 
 	// No graph is a valid graph.
 	renderer->graph.state = GFX_GRAPH_BUILT_;
@@ -650,6 +1025,17 @@ void gfx_render_graph_clear_(GFXRenderer* renderer)
 	gfx_list_clear(&renderer->graph.passes);
 }
 
+/****************************/
+void gfx_render_graph_validate_(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+
+	// If not valid yet, analyze the graph.
+	// This purges all invalidated passes.
+	if (renderer->graph.state < GFX_GRAPH_VALIDATED_)
+		gfx_render_graph_analyze_(renderer);
+}
+
 /****************************/
 bool gfx_render_graph_warmup_(GFXRenderer* renderer)
 {
@@ -659,11 +1045,8 @@ bool gfx_render_graph_warmup_(GFXRenderer* renderer)
 	if (renderer->graph.state >= GFX_GRAPH_WARMED_)
 		return 1;
 
-	// With the same logic as building; we destruct all things first.
-	if (renderer->graph.state == GFX_GRAPH_INVALID_)
-		gfx_render_graph_destruct_(renderer);
-
 	// If not valid yet, analyze the graph.
+	// With the same logic as building; this purges all invalidated passes.
 	if (renderer->graph.state < GFX_GRAPH_VALIDATED_)
 		gfx_render_graph_analyze_(renderer);
 
@@ -704,13 +1087,10 @@ bool gfx_render_graph_build_(GFXRenderer* renderer)
 	if (renderer->graph.state == GFX_GRAPH_BUILT_)
 		return 1;
 
-	// When the graph is not valid, it needs to be entirely rebuilt.
-	// Optimizations such as merging passes may change,
-	// we want to capture these changes.
-	if (renderer->graph.state == GFX_GRAPH_INVALID_)
-		gfx_render_graph_destruct_(renderer);
-
 	// If not valid yet, analyze the graph.
+	// Optimizations such as merging passes may change, we want to capture
+	// these changes, so this purges all passes whose output changed.
+	// All other passes remain built.
 	if (renderer->graph.state < GFX_GRAPH_VALIDATED_)
 		gfx_render_graph_analyze_(renderer);
 
@@ -804,9 +1184,34 @@ void gfx_render_graph_invalidate_(GFXRenderer* renderer)
 {
 	assert(renderer != NULL);
 
-	// Just set the flag, it is used to destruct everything at the start of
-	// the next build call. This way we can re-analyze it.
+	// Just set the flags, they are used to destruct everything at the start
+	// of the next build call. This way we can re-analyze it.
 	if (renderer->graph.state != GFX_GRAPH_EMPTY_)
+	{
+		renderer->graph.state = GFX_GRAPH_INVALID_;
+
+		for (
+			GFXPass* pass = (GFXPass*)renderer->graph.passes.head;
+			pass != NULL;
+			pass = (GFXPass*)pass->list.next)
+		{
+			pass->invalid = 1;
+		}
+	}
+}
+
+/****************************/
+void gfx_render_graph_invalidate_pass_(GFXPass* pass)
+{
+	assert(pass != NULL);
+
+	GFXRenderer* renderer = pass->renderer;
+
+	// Flag the pass so its chain is destructed on the next analysis.
+	// If culled, nothing changes until it is unculled (which invalidates).
+	pass->invalid = 1;
+
+	if (!pass->culled && renderer->graph.state != GFX_GRAPH_EMPTY_)
 		renderer->graph.state = GFX_GRAPH_INVALID_;
 }
 
@@ -1008,14 +1413,14 @@ GFX_API void gfx_erase_pass(GFXPass* pass)
 	// so no other pass references this one through its dependencies anymore.
 	gfx_pass_undepend_all(pass);
 
-	// Then, we destruct the entire render graph.
-	// We cannot only invalidate, as this pass will be destroyed.
-	// We do not just destruct this pass (or the subpass chain) as
-	// then the entire subpass chain might get destructed multiple times,
-	// which is simply inefficient.
+	// Then, we invalidate the render graph.
+	// Destroying the pass destructs it, other passes of its subpass chain
+	// get a different output and are purged on the next analysis.
+	// Until then, the graph is not validated, so nothing references this
+	// pass through the graph output (i.e. its consumptions or chain).
 	// Do this even when culled, in case it wasn't culled before!
 	if (renderer->graph.state != GFX_GRAPH_EMPTY_)
-		gfx_render_graph_destruct_(renderer);
+		renderer->graph.state = GFX_GRAPH_INVALID_;
 
 	// Unlink itself from the render graph.
 	if (renderer->graph.firstCompute == pass)
@@ -1043,8 +1448,8 @@ GFX_API void gfx_erase_pass(GFXPass* pass)
 			--renderer->graph.culledCompute;
 	}
 
-	// And finally, destroy the pass. The call to gfx_render_graph_destruct_
-	// ensures we are allowed to destroy the pass!
+	// And finally, destroy the pass. All its Vulkan objects are made stale,
+	// so pending virtual frames can still use them!
 	gfx_destroy_pass_(pass);
 }
 
@@ -1073,6 +1478,7 @@ GFX_API bool gfx_pass_set_parents(GFXPass* pass,
 	// Invalidate the graph.
 	// Order might change due to parent updates, but this does not matter
 	// for destruction, so we can get away with just invalidating the graph!
+	// Only passes whose merging or consumptions changed are purged.
 	if (renderer->graph.state != GFX_GRAPH_EMPTY_)
 		renderer->graph.state = GFX_GRAPH_INVALID_;
 
@@ -1121,10 +1527,12 @@ static void gfx_pass_set_cull_(GFXPass* pass, bool cull)
 	if (pass->culled != cull)
 	{
 		// Invalidate the graph & set the new culled state.
+		// The pass itself is always purged, as it leaves or joins the graph.
 		if (renderer->graph.state != GFX_GRAPH_EMPTY_)
 			renderer->graph.state = GFX_GRAPH_INVALID_;
 
 		pass->culled = cull;
+		pass->invalid = 1;
 
 		// Adjust the culled count.
 		size_t* culled =
@@ -11,7 +11,8 @@
 
 
 // Detect whether a render pass is warmed.
-#define GFX_PASS_IS_WARMED_(rPass) (rPass->vk.pass != VK_NULL_HANDLE)
+#define GFX_PASS_IS_WARMED_(rPass) \
+	(rPass->vk.pass != VK_NULL_HANDLE || GFX_PASS_IS_DYNAMIC_(rPass))
 
 // Detect whether a render pass is built.
 #define GFX_PASS_IS_BUILT_(rPass) (rPass->vk.frames.size > 0)
@@ -67,11 +68,24 @@ typedef struct GFXViewElem_
 typedef struct GFXFrameElem_
 {
 	VkImageView   view; // Swapchain view, may be VK_NULL_HANDLE.
-	VkFramebuffer buffer;
+	VkFramebuffer buffer; // VK_NULL_HANDLE if dynamic.
 
 } GFXFrameElem_;
 
 
+/****************************
+ * Dynamic rendering attachment element definition.
+ */
+typedef struct GFXRenderingElem_
+{
+	uint32_t view;    // Index into views, VK_ATTACHMENT_UNUSED if unused.
+	uint32_t resolve; // Index into views, VK_ATTACHMENT_UNUSED if none.
+
+	VkRenderingAttachmentInfo info; // Image views are set on retrieval.
+
+} GFXRenderingElem_;
+
+
 /****************************
  * Compares two user defined rasterization state descriptions.
  * @return Non-zero if equal.
@@ -216,10 +230,10 @@ static bool gfx_pass_consume_(GFXPass* pass, GFXConsume_* consume)
 	con->resolve = SIZE_MAX;
 
 invalidate:
-	// Changed a pass, the graph is invalidated.
-	// This makes it so the graph will destruct this pass before anything else.
-	// This also means the graph will be re-analyzed!
-	if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+	// Changed a pass, the pass is invalidated.
+	// This makes it so the graph will destruct its subpass chain,
+	// which also means the graph will be re-analyzed!
+	gfx_render_graph_invalidate_pass_(pass);
 
 	return 1;
 }
@@ -246,9 +260,10 @@ static void gfx_pass_destruct_partial_(GFXRenderPass_* rPass,
 		for (size_t i = 0; i < rPass->vk.frames.size; ++i)
 		{
 			GFXFrameElem_* elem = gfx_vec_at(&rPass->vk.frames, i);
-			gfx_push_stale_(rPass->base.renderer,
-				elem->buffer, elem->view,
-				VK_NULL_HANDLE, VK_NULL_HANDLE);
+			if (elem->buffer != VK_NULL_HANDLE || elem->view != VK_NULL_HANDLE)
+				gfx_push_stale_(rPass->base.renderer,
+					elem->buffer, elem->view,
+					VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
 		}
 
 		for (size_t i = 0; i < rPass->vk.views.size; ++i)
@@ -257,7 +272,7 @@ static void gfx_pass_destruct_partial_(GFXRenderPass_* rPass,
 			if (elem->view != VK_NULL_HANDLE)
 				gfx_push_stale_(rPass->base.renderer,
 					VK_NULL_HANDLE, elem->view,
-					VK_NULL_HANDLE, VK_NULL_HANDLE);
+					VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
 
 			// We DO NOT release rPass->vk.views.
 			// This because on-swapchain recreate, the consumptions of
@@ -281,6 +296,10 @@ static void gfx_pass_destruct_partial_(GFXRenderPass_* rPass,
 		rPass->build.pass = NULL;
 		rPass->vk.pass = VK_NULL_HANDLE;
 
+		// Same for dynamic rendering, the formats might have changed.
+		gfx_vec_release(&rPass->vk.attachs);
+		gfx_vec_release(&rPass->vk.formats);
+
 		// Increase generation; the render pass is used in pipelines,
 		// ergo we need to invalidate current pipelines using it.
 		gfx_pass_gen_(rPass);
@@ -348,6 +367,8 @@ GFXPass* gfx_create_pass_(GFXRenderer* renderer, GFXPassType type,
 	pass->order = 0;
 	pass->childs = 0;
 	pass->culled = culled;
+	pass->invalid = 1; // Never built, so no chain can keep it.
+	pass->out.hash = 0;
 
 	gfx_vec_init(&pass->consumes, sizeof(GFXConsume_));
 	gfx_vec_init(&pass->deps, sizeof(GFXDepend_));
@@ -381,6 +402,8 @@ GFXPass* gfx_create_pass_(GFXRenderer* renderer, GFXPassType type,
 		gfx_vec_init(&rPass->vk.blends, blendsSize);
 		gfx_vec_init(&rPass->vk.views, sizeof(GFXViewElem_));
 		gfx_vec_init(&rPass->vk.frames, sizeof(GFXFrameElem_));
+		gfx_vec_init(&rPass->vk.attachs, sizeof(GFXRenderingElem_));
+		gfx_vec_init(&rPass->vk.formats, sizeof(VkFormat));
 
 		// And finally some default state.
 		rPass->state.samples = 1;
@@ -459,6 +482,14 @@ void gfx_destroy_pass_(GFXPass* pass)
 	if (pass->type == GFX_PASS_RENDER)
 		gfx_pass_destruct_((GFXRenderPass_*)pass);
 
+	// Destroy all semaphores owned by the renderer, only waited upon once.
+	for (size_t d = 0; d < pass->deps.size; ++d)
+	{
+		GFXDepend_* depend = gfx_vec_at(&pass->deps, d);
+		if (GFX_INJ_IS_WAIT_(depend->inj) && depend->owned)
+			gfx_destroy_sem(depend->inj.sem);
+	}
+
 	// Destroy the rest.
 	gfx_vec_clear(&pass->parents);
 	gfx_vec_clear(&pass->consumes);
@@ -494,6 +525,57 @@ VkFramebuffer gfx_pass_framebuffer_(GFXRenderPass_* rPass, GFXFrame* frame)
 		((GFXFrameElem_*)gfx_vec_at(&rPass->vk.frames, image))->buffer;
 }
 
+/****************************/
+bool gfx_pass_rendering_(GFXRenderPass_* rPass, GFXFrame* frame,
+                         VkRenderingAttachmentInfo* attachs)
+{
+	assert(rPass != NULL);
+	assert(rPass->base.type == GFX_PASS_RENDER);
+	assert(!rPass->base.culled);
+	assert(rPass->out.master == NULL);
+	assert(GFX_PASS_IS_DYNAMIC_(rPass));
+	assert(frame != NULL);
+	assert(attachs != NULL);
+
+	// Same as framebuffers, either a single frame or one per swapchain image.
+	const uint32_t image = (rPass->vk.frames.size == 1) ? 0 :
+		gfx_frame_get_swapchain_index_(frame, rPass->out.backing);
+
+	// Validate, also implicitly checks if the pass is built.
+	if (rPass->vk.frames.size <= image)
+		return 0;
+
+	const GFXFrameElem_* frameElem = gfx_vec_at(&rPass->vk.frames, image);
+
+	// Copy all attachment info & fill in the image views,
+	// the swapchain view is the only one that is not stored in `views`.
+	for (size_t i = 0; i < rPass->vk.attachs.size; ++i)
+	{
+		const GFXRenderingElem_* elem = gfx_vec_at(&rPass->vk.attachs, i);
+		attachs[i] = elem->info;
+
+		if (elem->view != VK_ATTACHMENT_UNUSED)
+		{
+			const GFXViewElem_* view =
+				gfx_vec_at(&rPass->vk.views, elem->view);
+
+			attachs[i].imageView = (view->view != VK_NULL_HANDLE) ?
+				view->view : frameElem->view;
+		}
+
+		if (elem->resolve != VK_ATTACHMENT_UNUSED)
+		{
+			const GFXViewElem_* view =
+				gfx_vec_at(&rPass->vk.views, elem->resolve);
+
+			attachs[i].resolveImageView = (view->view != VK_NULL_HANDLE) ?
+				view->view : frameElem->view;
+		}
+	}
+
+	return 1;
+}
+
 /****************************
  * Filters all consumed attachments into framebuffer views.
  * Meaning the `vk.views` field (excluding image view) of rPass are set.
@@ -642,6 +724,130 @@ static uint32_t gfx_pass_find_attachment_(GFXRenderPass_* rPass, size_t index)
 	return VK_ATTACHMENT_UNUSED;
 }
 
+/****************************
+ * Outputs all dynamic rendering attachments & formats,
+ * meaning the `vk.attachs` and `vk.formats` fields of rPass are set.
+ * @param rPass    Cannot be NULL, must be a single non-merged pass.
+ * @param ad       Attachment descriptions, as would build the render pass.
+ * @param colors   Color references (VkAttachmentReference), cannot be NULL.
+ * @param resolves Resolve references (VkAttachmentReference), cannot be NULL.
+ * @param depSten  Depth/stencil reference, cannot be NULL.
+ * @return Zero on failure.
+ */
+static bool gfx_pass_warmup_dynamic_(GFXRenderPass_* rPass,
+                                     const VkAttachmentDescription* ad,
+                                     GFXVec* colors, GFXVec* resolves,
+                                     const VkAttachmentReference* depSten)
+{
+	assert(rPass != NULL);
+	assert(rPass->base.type == GFX_PASS_RENDER);
+	assert(rPass->out.master == NULL);
+	assert(rPass->out.next == NULL);
+	assert(colors != NULL);
+	assert(resolves != NULL);
+	assert(depSten != NULL);
+
+	GFXRenderer* rend = rPass->base.renderer;
+
+	// Output all color attachments, followed by depth and stencil.
+	// This is the exact order in which they are passed to Vulkan.
+	const size_t numColors = colors->size;
+
+	if (
+		!gfx_vec_reserve(&rPass->vk.attachs, numColors + 2) ||
+		!gfx_vec_reserve(&rPass->vk.formats, numColors + 2))
+	{
+		gfx_vec_release(&rPass->vk.attachs);
+		gfx_vec_release(&rPass->vk.formats);
+		return 0;
+	}
+
+	for (size_t i = 0; i < numColors + 2; ++i)
+	{
+		const bool isColor = i < numColors;
+		const bool isStencil = i > numColors;
+
+		const VkAttachmentReference* ref =
+			isColor ? gfx_vec_at(colors, i) : depSten;
+		const VkAttachmentReference* resolveRef =
+			isColor ? gfx_vec_at(resolves, i) : NULL;
+
+		GFXRenderingElem_ elem = {
+			.view    = VK_ATTACHMENT_UNUSED,
+			.resolve = VK_ATTACHMENT_UNUSED,
+			.info    = {
+				.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+
+				.pNext              = NULL,
+				.imageView          = VK_NULL_HANDLE,
+				.imageLayout        = VK_IMAGE_LAYOUT_UNDEFINED,
+				.resolveMode        = VK_RESOLVE_MODE_NONE,
+				.resolveImageView   = VK_NULL_HANDLE,
+				.resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+				.loadOp             = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+				.storeOp            = VK_ATTACHMENT_STORE_OP_DONT_CARE
+			}
+		};
+
+		VkFormat format = VK_FORMAT_UNDEFINED;
+
+		if (ref->attachment != VK_ATTACHMENT_UNUSED)
+		{
+			const GFXConsume_* con = ((GFXViewElem_*)gfx_vec_at(
+				&rPass->vk.views, ref->attachment))->consume;
+			const GFXAttach_* at =
+				gfx_vec_at(&rend->backing.attachs, con->index);
+
+			// Pick empty format for windows, i.e. a color format.
+			const GFXFormat fmt = (at->type == GFX_ATTACH_IMAGE_) ?
+				at->image.base.format : GFX_FORMAT_EMPTY;
+
+			// Depth and stencil share a view, only output the aspects
+			// that are both present in the format and actually viewed.
+			const GFXImageAspect aspect =
+				isColor ? GFX_IMAGE_COLOR :
+				isStencil ? GFX_IMAGE_STENCIL : GFX_IMAGE_DEPTH;
+
+			if (
+				isColor ||
+				(aspect & con->view.range.aspect &
+					GFX_IMAGE_ASPECT_FROM_FORMAT(fmt)))
+			{
+				const VkAttachmentDescription* desc = ad + ref->attachment;
+
+				elem.view = ref->attachment;
+				elem.info.imageLayout = ref->layout;
+				elem.info.clearValue = con->clear.vk;
+
+				elem.info.loadOp =
+					isStencil ? desc->stencilLoadOp : desc->loadOp;
+				elem.info.storeOp =
+					isStencil ? desc->stencilStoreOp : desc->storeOp;
+
+				format = desc->format;
+
+				if (resolveRef != NULL &&
+					resolveRef->attachment != VK_ATTACHMENT_UNUSED)
+				{
+					// Integer formats cannot be averaged.
+					elem.resolve = resolveRef->attachment;
+					elem.info.resolveImageLayout = resolveRef->layout;
+					elem.info.resolveMode =
+						(fmt.type & (GFX_UINT | GFX_SINT)) ?
+						VK_RESOLVE_MODE_SAMPLE_ZERO_BIT :
+						VK_RESOLVE_MODE_AVERAGE_BIT;
+				}
+			}
+		}
+
+		// Already reserved!
+		gfx_vec_push(&rPass->vk.attachs, 1, &elem);
+		gfx_vec_push(&rPass->vk.formats, 1, &format);
+	}
+
+	return 1;
+}
+
 /****************************/
 bool gfx_pass_warmup_(GFXRenderPass_* rPass)
 {
@@ -1061,6 +1267,26 @@ bool gfx_pass_warmup_(GFXRenderPass_* rPass)
 		rPreserve += ssd->preserveAttachmentCount;
 	}
 
+	// If not merged with any other pass and there are no input attachments,
+	// we do not need a Vulkan render pass at all, use dynamic rendering!
+	// Pipelines are then built using the attachment formats instead.
+	if (
+		(context->features & GFX_SUPPORT_DYNAMIC_RENDERING_) &&
+		rPass->out.subpasses == 1 && inputs.size == 0)
+	{
+		if (!gfx_pass_warmup_dynamic_(rPass, ad, &colors, &resolves, depStens))
+			goto clean;
+
+		// Clean temporary memory!
+		gfx_vec_clear(&inputs);
+		gfx_vec_clear(&colors);
+		gfx_vec_clear(&resolves);
+		gfx_vec_clear(&preserves);
+		gfx_vec_clear(&dependencies);
+
+		return 1;
+	}
+
 	// Store the clear values of the first consumptions at master.
 	if (!gfx_vec_reserve(&rPass->vk.clears, numViews))
 		goto clean;
@@ -1257,6 +1483,7 @@ bool gfx_pass_build_(GFXRenderPass_* rPass)
 
 	// Ok now we need to create all the framebuffers.
 	// We either have one for each window image, or just a single one.
+	// If using dynamic rendering, we only create the swapchain views.
 	// Reserve the exact amount, it's probably not gonna change.
 	const size_t frames =
 		(backingInd != SIZE_MAX) ?
@@ -1310,6 +1537,13 @@ bool gfx_pass_build_(GFXRenderPass_* rPass)
 			views[backingInd] = elem.view;
 		}
 
+		// No framebuffer necessary for dynamic rendering.
+		if (GFX_PASS_IS_DYNAMIC_(rPass))
+		{
+			gfx_vec_push(&rPass->vk.frames, 1, &elem);
+			continue;
+		}
+
 		// Create a Vulkan framebuffer.
 		VkFramebufferCreateInfo fci = {
 			.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
@@ -1393,6 +1627,8 @@ void gfx_pass_destruct_(GFXRenderPass_* rPass)
 	gfx_vec_clear(&rPass->vk.blends);
 	gfx_vec_clear(&rPass->vk.views);
 	gfx_vec_clear(&rPass->vk.frames);
+	gfx_vec_clear(&rPass->vk.attachs);
+	gfx_vec_clear(&rPass->vk.formats);
 }
 
 /****************************/
@@ -1520,7 +1756,7 @@ GFX_API void gfx_pass_clear(GFXPass* pass, size_t index,
 			con->clear.gfx = value; // Type-punned into a VkClearValue!
 
 			// Same as gfx_pass_consume_, invalidate for destruction.
-			if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+			gfx_render_graph_invalidate_pass_(pass);
 			break;
 		}
 	}
@@ -1553,7 +1789,7 @@ GFX_API void gfx_pass_blend(GFXPass* pass, size_t index,
 			con->alpha = alpha;
 
 			// Same as gfx_pass_consume_, invalidate for destruction.
-			if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+			gfx_render_graph_invalidate_pass_(pass);
 			break;
 		}
 	}
@@ -1583,7 +1819,7 @@ GFX_API void gfx_pass_resolve(GFXPass* pass, size_t index, size_t resolve)
 			con->resolve = resolve;
 
 			// Same as gfx_pass_consume_, invalidate for destruction.
-			if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+			gfx_render_graph_invalidate_pass_(pass);
 			break;
 		}
 	}
@@ -1604,7 +1840,7 @@ GFX_API void gfx_pass_release(GFXPass* pass, size_t index)
 			con->resolve = SIZE_MAX;
 
 			// Same as below, invalidate for destruction.
-			if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+			gfx_render_graph_invalidate_pass_(pass);
 		}
 	}
 
@@ -1617,7 +1853,7 @@ GFX_API void gfx_pass_release(GFXPass* pass, size_t index)
 			gfx_vec_erase(&pass->consumes, 1, i-1);
 
 			// Same as gfx_pass_consume_, invalidate for destruction.
-			if (!pass->culled) gfx_render_graph_invalidate_(pass->renderer);
+			gfx_render_graph_invalidate_pass_(pass);
 			break;
 		}
 	}
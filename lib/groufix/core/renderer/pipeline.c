@@ -6,7 +6,33 @@
  * www     : <www.vuzzel.nl>
  */
 
+#include "groufix/core/jobs.h"
 #include "groufix/core/objects.h"
+#include <stdlib.h>
+
+
+/****************************
+ * Prebuilt renderable pipeline definition.
+ */
+typedef struct GFXPermElem_
+{
+	uintptr_t pipeline; // NULL if not built.
+	uint32_t  gen;      // Pass build generation when built.
+
+} GFXPermElem_;
+
+
+/****************************
+ * Prebuild job definition, for either a renderable or computable.
+ */
+typedef struct GFXPrebuildJob_
+{
+	GFXRenderable* renderable; // May be NULL.
+	GFXComputable* computable; // May be NULL.
+	const size_t*  perms;      // NULL for all permutations.
+	atomic_bool    failed;
+
+} GFXPrebuildJob_;
 
 
 /****************************
@@ -85,7 +111,16 @@ bool gfx_renderable_pipeline_(GFXRenderable* renderable,
 		return 0;
 	}
 
-	if (rPass->build.pass == NULL)
+	if (renderable->permutation >= tech->numPerms)
+	{
+		gfx_log_warn("Invalid permutation while building pipeline.");
+		return 0;
+	}
+
+	// If dynamic rendering, the pass is hashed by its formats instead.
+	const bool dynamic = GFX_PASS_IS_DYNAMIC_(rPass);
+
+	if (rPass->build.pass == NULL && !dynamic)
 	{
 		gfx_log_warn("Pass not warmed while building pipeline.");
 		return 0;
@@ -290,8 +325,9 @@ bool gfx_renderable_pipeline_(GFXRenderable* renderable,
 	VkPipelineShaderStageCreateInfo pstci[GFX_MAX(1, numShaders)];
 	VkSpecializationInfo si[GFX_NUM_SHADER_STAGES_];
 	VkSpecializationMapEntry sme[GFX_MAX(1, numConsts)];
+	GFXConstantElem_ scd[GFX_MAX(1, numConsts)];
 
-	gfx_tech_get_constants_(tech, si, sme);
+	gfx_tech_get_constants_(tech, renderable->permutation, si, sme, scd);
 
 	for (uint32_t s = 0; s < numShaders; ++s)
 	{
@@ -337,16 +373,35 @@ bool gfx_renderable_pipeline_(GFXRenderable* renderable,
 			.inputRate = prim->bindings[i].rate
 		};
 
+	// Build dynamic rendering info.
+	// Formats are stored as all colors, followed by depth & stencil.
+	const size_t numFormats = rPass->vk.formats.size;
+	const VkFormat* formats = gfx_vec_at(&rPass->vk.formats, 0);
+
+	VkPipelineRenderingCreateInfo prci = {
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+
+		.pNext                   = NULL,
+		.viewMask                = 0,
+		.colorAttachmentCount    = dynamic ? (uint32_t)(numFormats - 2) : 0,
+		.pColorAttachmentFormats = numFormats > 2 ? formats : NULL,
+
+		.depthAttachmentFormat = dynamic ?
+			formats[numFormats - 2] : VK_FORMAT_UNDEFINED,
+		.stencilAttachmentFormat = dynamic ?
+			formats[numFormats - 1] : VK_FORMAT_UNDEFINED
+	};
+
 	VkGraphicsPipelineCreateInfo gpci = {
 		.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
 
-		.pNext               = NULL,
+		.pNext               = dynamic ? &prci : NULL,
 		.flags               = 0,
 		.stageCount          = numShaders,
 		.pStages             = pstci,
 		.layout              = tech->vk.layout,
-		.renderPass          = rPass->vk.pass,
-		.subpass             = rPass->out.subpass,
+		.renderPass          = dynamic ? VK_NULL_HANDLE : rPass->vk.pass,
+		.subpass             = dynamic ? 0 : rPass->out.subpass,
 		.basePipelineHandle  = VK_NULL_HANDLE,
 		.basePipelineIndex   = -1,
 		.pRasterizationState = &prsci,
@@ -440,6 +495,14 @@ bool gfx_renderable_pipeline_(GFXRenderable* renderable,
 		renderable->pipeline = (uintptr_t)(void*)*elem;
 		renderable->gen = GFX_PASS_GEN_(rPass);
 
+		// Keep the prebuilt pipeline up to date.
+		if (renderable->perms != NULL)
+			((GFXPermElem_*)renderable->perms)[renderable->permutation] =
+				(GFXPermElem_){
+					.pipeline = renderable->pipeline,
+					.gen = renderable->gen
+				};
+
 		gfx_renderable_unlock_(renderable);
 
 		return 1;
@@ -485,6 +548,12 @@ bool gfx_computable_pipeline_(GFXComputable* computable,
 		return 0;
 	}
 
+	if (computable->permutation >= tech->numPerms)
+	{
+		gfx_log_warn("Invalid permutation while building pipeline.");
+		return 0;
+	}
+
 	handles[0] = shader->handle;
 	handles[1] = (uintptr_t)(void*)tech->layout;
 
@@ -492,8 +561,9 @@ bool gfx_computable_pipeline_(GFXComputable* computable,
 	const size_t numConsts = tech->constants.size;
 	VkSpecializationInfo si[GFX_NUM_SHADER_STAGES_];
 	VkSpecializationMapEntry sme[GFX_MAX(1, numConsts)];
+	GFXConstantElem_ scd[GFX_MAX(1, numConsts)];
 
-	gfx_tech_get_constants_(tech, si, sme);
+	gfx_tech_get_constants_(tech, computable->permutation, si, sme, scd);
 
 	VkComputePipelineCreateInfo cpci = {
 		.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
@@ -586,6 +656,8 @@ GFX_API bool gfx_renderable(GFXRenderable* renderable,
 	renderable->technique = tech;
 	renderable->primitive = prim;
 	renderable->state = state;
+	renderable->permutation = 0;
+	renderable->perms = NULL;
 
 	atomic_store_explicit(&renderable->lock, 0, memory_order_relaxed);
 	renderable->pipeline = (uintptr_t)NULL;
@@ -625,6 +697,143 @@ GFX_API bool gfx_renderable_warmup(GFXRenderable* renderable)
 	return 1;
 }
 
+/****************************/
+GFX_API void gfx_renderable_permute(GFXRenderable* renderable, size_t perm)
+{
+	assert(renderable != NULL);
+	assert(perm < renderable->technique->numPerms);
+
+	// Select the permutation and its prebuilt pipeline,
+	// the pass generation is still checked when retrieved.
+	const GFXPermElem_* pElem = renderable->perms != NULL ?
+		(GFXPermElem_*)renderable->perms + perm : NULL;
+
+	renderable->permutation = perm;
+
+	atomic_store_explicit(&renderable->lock, 0, memory_order_relaxed);
+	renderable->pipeline = pElem != NULL ? pElem->pipeline : (uintptr_t)NULL;
+	renderable->gen = pElem != NULL ? pElem->gen : 0;
+}
+
+/****************************
+ * Job function to prebuild pipelines of permutations.
+ * @param ptr Must be a GFXPrebuildJob_*.
+ */
+static void gfx_prebuild_job_(size_t worker, size_t first, size_t count,
+                              void* ptr)
+{
+	GFXPrebuildJob_* job = ptr;
+
+	for (size_t i = first; i < first + count; ++i)
+	{
+		const size_t perm = job->perms != NULL ? job->perms[i] : i;
+		GFXCacheElem_* elem;
+
+		// Build for a copy with no prebuilt pipelines,
+		// so the original is never accessed by multiple threads.
+		if (job->renderable != NULL)
+		{
+			GFXRenderable* rend = job->renderable;
+			GFXRenderable copy;
+
+			gfx_renderable(&copy,
+				rend->pass, rend->technique, rend->primitive, rend->state);
+
+			copy.permutation = perm;
+
+			if (!gfx_renderable_pipeline_(&copy, &elem, 0))
+				atomic_store_explicit(&job->failed, 1, memory_order_relaxed);
+			else
+				((GFXPermElem_*)rend->perms)[perm] = (GFXPermElem_){
+					.pipeline = copy.pipeline,
+					.gen = copy.gen
+				};
+		}
+		else
+		{
+			GFXComputable* comp = job->computable;
+			GFXComputable copy;
+
+			gfx_computable(&copy, comp->technique);
+			copy.permutation = perm;
+
+			if (!gfx_computable_pipeline_(&copy, &elem, 0))
+				atomic_store_explicit(&job->failed, 1, memory_order_relaxed);
+			else
+				((uintptr_t*)comp->perms)[perm] = (uintptr_t)(void*)elem;
+		}
+	}
+}
+
+/****************************/
+GFX_API bool gfx_renderable_prebuild_block(GFXRenderable* renderable,
+                                     size_t numPerms, const size_t* perms)
+{
+	assert(renderable != NULL);
+	assert(numPerms == 0 || perms != NULL);
+
+	GFXRenderer* renderer = renderable->pass->renderer;
+	GFXTechnique* tech = renderable->technique;
+
+	// Allocate all prebuilt pipelines.
+	if (renderable->perms == NULL)
+	{
+		renderable->perms = calloc(tech->numPerms, sizeof(GFXPermElem_));
+		if (renderable->perms == NULL)
+		{
+			gfx_log_error(
+				"Could not prebuild renderable; "
+				"failed to allocate permutations.");
+
+			return 0;
+		}
+	}
+
+	// Same as gfx_renderable_warmup, we need the Vulkan render pass.
+	gfx_mutex_lock_(&renderer->reentrantLock);
+	bool success = gfx_render_graph_warmup_(renderer);
+	gfx_mutex_unlock_(&renderer->reentrantLock);
+
+	if (!success)
+	{
+		gfx_log_error("Could not prebuild renderable; graph warmup failed.");
+		return 0;
+	}
+
+	// Build them all in parallel.
+	GFXPrebuildJob_ job = {
+		.renderable = renderable,
+		.computable = NULL,
+		.perms = numPerms > 0 ? perms : NULL
+	};
+
+	atomic_store_explicit(&job.failed, 0, memory_order_relaxed);
+	gfx_job_for(numPerms > 0 ? numPerms : tech->numPerms, 1,
+		gfx_prebuild_job_, &job);
+
+	if (atomic_load_explicit(&job.failed, memory_order_relaxed))
+	{
+		gfx_log_error("Could not prebuild renderable; pipelines not built.");
+		return 0;
+	}
+
+	// Select the current permutation's prebuilt pipeline.
+	gfx_renderable_permute(renderable, renderable->permutation);
+
+	return 1;
+}
+
+/****************************/
+GFX_API void gfx_renderable_clear(GFXRenderable* renderable)
+{
+	assert(renderable != NULL);
+
+	free(renderable->perms);
+	renderable->perms = NULL;
+
+	gfx_renderable_permute(renderable, 0);
+}
+
 /****************************/
 GFX_API bool gfx_computable(GFXComputable* computable,
                             GFXTechnique* tech)
@@ -643,6 +852,8 @@ GFX_API bool gfx_computable(GFXComputable* computable,
 
 	// Init computable, store NULL as pipeline.
 	computable->technique = tech;
+	computable->permutation = 0;
+	computable->perms = NULL;
 	atomic_store_explicit(
 		&computable->pipeline, (uintptr_t)NULL, memory_order_relaxed);
 
@@ -663,3 +874,75 @@ GFX_API bool gfx_computable_warmup(GFXComputable* computable)
 
 	return 1;
 }
+
+/****************************/
+GFX_API void gfx_computable_permute(GFXComputable* computable, size_t perm)
+{
+	assert(computable != NULL);
+	assert(perm < computable->technique->numPerms);
+
+	// Select the permutation and its prebuilt pipeline.
+	computable->permutation = perm;
+	atomic_store_explicit(
+		&computable->pipeline,
+		computable->perms != NULL ?
+			((uintptr_t*)computable->perms)[perm] : (uintptr_t)NULL,
+		memory_order_relaxed);
+}
+
+/****************************/
+GFX_API bool gfx_computable_prebuild_block(GFXComputable* computable,
+                                     size_t numPerms, const size_t* perms)
+{
+	assert(computable != NULL);
+	assert(numPerms == 0 || perms != NULL);
+
+	GFXTechnique* tech = computable->technique;
+
+	// Allocate all prebuilt pipelines.
+	if (computable->perms == NULL)
+	{
+		computable->perms = calloc(tech->numPerms, sizeof(uintptr_t));
+		if (computable->perms == NULL)
+		{
+			gfx_log_error(
+				"Could not prebuild computable; "
+				"failed to allocate permutations.");
+
+			return 0;
+		}
+	}
+
+	// Build them all in parallel.
+	GFXPrebuildJob_ job = {
+		.renderable = NULL,
+		.computable = computable,
+		.perms = numPerms > 0 ? perms : NULL
+	};
+
+	atomic_store_explicit(&job.failed, 0, memory_order_relaxed);
+	gfx_job_for(numPerms > 0 ? numPerms : tech->numPerms, 1,
+		gfx_prebuild_job_, &job);
+
+	if (atomic_load_explicit(&job.failed, memory_order_relaxed))
+	{
+		gfx_log_error("Could not prebuild computable; pipelines not built.");
+		return 0;
+	}
+
+	// Select the current permutation's prebuilt pipeline.
+	gfx_computable_permute(computable, computable->permutation);
+
+	return 1;
+}
+
+/****************************/
+GFX_API void gfx_computable_clear(GFXComputable* computable)
+{
+	assert(computable != NULL);
+
+	free(computable->perms);
+	computable->perms = NULL;
+
+	gfx_computable_permute(computable, 0);
+}
@@ -8,6 +8,7 @@
 
 #include "groufix/core/objects.h"
 #include <stdlib.h>
+#include <string.h>
 
 
 // Indirect command size compatibility.
@@ -57,6 +58,130 @@ typedef struct GFXCmdElem_
 } GFXCmdElem_;
 
 
+/****************************
+ * Static recording set element definition.
+ */
+typedef struct GFXStaticSet_
+{
+	GFXSet*       set;
+	GFXPoolElem_* elem;
+	uint64_t      hash; // Set key hash when recorded.
+
+} GFXStaticSet_;
+
+
+/****************************
+ * Deferred command type.
+ */
+typedef enum GFXDeferType_
+{
+	GFX_DEFER_DRAW_,
+	GFX_DEFER_DRAW_INDEXED_,
+	GFX_DEFER_DRAW_INDIRECT_,
+	GFX_DEFER_DRAW_INDEXED_INDIRECT_,
+	GFX_DEFER_DRAW_INDIRECT_COUNT_,
+	GFX_DEFER_DRAW_INDEXED_INDIRECT_COUNT_
+
+} GFXDeferType_;
+
+
+/****************************
+ * Deferred command element definition.
+ */
+typedef struct GFXDeferCmd_
+{
+	GFXDeferType_ type;
+	uint32_t      group;
+	size_t        seq; // Order of recording.
+
+	// Sorted state.
+	GFXCacheElem_*     pipeline;
+	const GFXHashKey_* bind; // May be NULL.
+	GFXPrimitive*      primitive; // May be NULL.
+
+	// Unsorted state.
+	size_t      push; // Offset into data (or SIZE_MAX).
+	GFXViewport viewport;
+	GFXScissor  scissor;
+	float       lineWidth;
+
+	union {
+		struct {
+			uint32_t count;
+			uint32_t instances;
+			uint32_t first;
+			int32_t  vertexOffset;
+			uint32_t firstInstance;
+
+		} direct;
+
+		struct {
+			VkBuffer     buffer;
+			VkDeviceSize offset;
+			uint32_t     count; // Maximum count if a count buffer is used.
+			uint32_t     stride;
+
+			VkBuffer     countBuffer;
+			VkDeviceSize countOffset;
+
+		} indirect;
+	};
+
+} GFXDeferCmd_;
+
+
+/****************************
+ * Deferred push constant state definition.
+ */
+typedef struct GFXDeferPush_
+{
+	GFXTechnique* technique;
+	uint32_t      size;
+	char          bytes[];
+
+} GFXDeferPush_;
+
+
+/****************************
+ * Deferred bound set definition, resolved when bound.
+ */
+typedef struct GFXDeferSet_
+{
+	GFXSet*       set;
+	GFXPoolElem_* elem;
+	size_t        push; // Offset of push set entries into data (or SIZE_MAX).
+
+} GFXDeferSet_;
+
+
+/****************************
+ * Parallel render recording job.
+ */
+typedef struct GFXRenderJob_
+{
+	GFXRecorder*  recorder;
+	GFXPass*      pass;
+	VkFramebuffer framebuffer;
+	atomic_bool   failed;
+
+	void (*cb)(GFXRecorder*, size_t, size_t, void*);
+	void* ptr;
+
+} GFXRenderJob_;
+
+
+/****************************
+ * Range of work items of a parallel render recording job.
+ */
+typedef struct GFXRenderChunk_
+{
+	GFXRenderJob_* job;
+	size_t         first;
+	size_t         count;
+
+} GFXRenderChunk_;
+
+
 /****************************
  * Compares two user defined viewport descriptions.
  * @return Non-zero if equal.
@@ -270,929 +395,2362 @@ static void gfx_recorder_bind_primitive_(GFXRecorder* recorder,
 }
 
 /****************************
- * Claims (or creates) a command buffer from the current recording pool.
- * To unclaim, the current pool's used count should be decreased.
- * @param recorder Cannot be NULL.
- * @param type     Type of the pass, to inform pool selection.
- * @return The command buffer, NULL on failure.
+ * Computes where a primitive starts relative to the bindings of another,
+ * such that both can be drawn with the same vertex & index buffer bindings.
+ * @param base   Cannot be NULL.
+ * @param prim   Cannot be NULL.
+ * @param vertex Cannot be NULL, outputs the vertex offset.
+ * @param index  Cannot be NULL, outputs the first index.
+ * @return Zero if prim cannot be drawn using the bindings of base.
  */
-static VkCommandBuffer gfx_recorder_claim_(GFXRecorder* recorder,
-                                           GFXPassType type)
+static bool gfx_recorder_rebase_(GFXPrimitive* base, GFXPrimitive* prim,
+                                 uint32_t* vertex, uint32_t* index)
 {
-	assert(recorder != NULL);
+	assert(base != NULL);
+	assert(prim != NULL);
+	assert(vertex != NULL);
+	assert(index != NULL);
 
-	GFXContext_* context = recorder->context;
+	GFXPrimitive_* bPrim = (GFXPrimitive_*)base;
+	GFXPrimitive_* pPrim = (GFXPrimitive_*)prim;
 
-	// Select recorder pool.
-	GFXRecorderPool_* pool = &recorder->pools[
-		type != GFX_PASS_COMPUTE_ASYNC ?
-			recorder->current * 2 :
-			recorder->current * 2 + 1];
+	*vertex = 0;
+	*index = 0;
 
-	// If we still have enough command buffers, return the next one.
-	if (pool->used < pool->vk.cmds.size)
-		// Immediately increase used counter.
-		return *(VkCommandBuffer*)gfx_vec_at(&pool->vk.cmds, pool->used++);
+	if (base == prim)
+		return 1;
 
-	// Otherwise, allocate a new one.
-	if (!gfx_vec_push(&pool->vk.cmds, 1, NULL))
-		return NULL;
+	if (
+		bPrim->numBindings != pPrim->numBindings ||
+		(base->numIndices > 0) != (prim->numIndices > 0) ||
+		base->indexSize != prim->indexSize)
+	{
+		return 0;
+	}
 
-	VkCommandBufferAllocateInfo cbai = {
-		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	// All vertex bindings must be offset by the same #vertices.
+	bool offset = 0;
 
-		.pNext              = NULL,
-		.commandPool        = pool->vk.pool,
-		.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
-		.commandBufferCount = 1
-	};
+	for (size_t b = 0; b < bPrim->numBindings; ++b)
+	{
+		const GFXPrimBuffer_* bBind = &bPrim->bindings[b];
+		const GFXPrimBuffer_* pBind = &pPrim->bindings[b];
 
-	VkCommandBuffer* cmd = gfx_vec_at(&pool->vk.cmds, pool->used);
-	GFX_VK_CHECK_(
-		context->vk.AllocateCommandBuffers(
-			context->vk.device, &cbai, cmd),
+		if (
+			bBind->buffer != pBind->buffer ||
+			bBind->stride != pBind->stride ||
+			bBind->rate != pBind->rate ||
+			bBind->offset > pBind->offset)
 		{
-			gfx_vec_pop(&pool->vk.cmds, 1);
-			return NULL;
-		});
+			return 0;
+		}
 
-	// Increase used counter & return.
-	++pool->used;
-	return *cmd;
-}
+		const uint64_t diff = pBind->offset - bBind->offset;
 
-/****************************
- * Outputs a command buffer of a specific submission order.
- * @param recorder Cannot be NULL.
- * @return Zero on failure.
- */
-static bool gfx_recorder_output_(GFXRecorder* recorder,
-                                 unsigned int order, VkCommandBuffer cmd)
-{
-	// Find the right spot to insert at.
-	// We assume the most prevelant way of recording stuff is in submission
-	// order. Which would make backwards linear search perfect.
-	size_t loc;
-	for (loc = recorder->out.cmds.size; loc > 0; --loc)
+		// Instance rate bindings cannot be offset at all.
+		if (bBind->rate != VK_VERTEX_INPUT_RATE_VERTEX || bBind->stride == 0)
+		{
+			if (diff != 0) return 0;
+			continue;
+		}
+
+		if (
+			diff % bBind->stride != 0 ||
+			diff / bBind->stride > INT32_MAX ||
+			(offset && diff / bBind->stride != *vertex))
+		{
+			return 0;
+		}
+
+		*vertex = (uint32_t)(diff / bBind->stride);
+		offset = 1;
+	}
+
+	// And the index buffer by a whole #indices.
+	if (base->numIndices > 0)
 	{
-		unsigned int cOrder =
-			((GFXCmdElem_*)gfx_vec_at(&recorder->out.cmds, loc-1))->order;
+		GFXUnpackRef_ bIndex = gfx_ref_unpack_(gfx_ref_prim_indices(base));
+		GFXUnpackRef_ pIndex = gfx_ref_unpack_(gfx_ref_prim_indices(prim));
 
-		if (cOrder <= order)
-			break;
+		if (
+			bIndex.obj.buffer != pIndex.obj.buffer ||
+			bIndex.value > pIndex.value ||
+			(pIndex.value - bIndex.value) % (uint64_t)base->indexSize != 0 ||
+			(pIndex.value - bIndex.value) / (uint64_t)base->indexSize > UINT32_MAX)
+		{
+			return 0;
+		}
+
+		*index = (uint32_t)(
+			(pIndex.value - bIndex.value) / (uint64_t)base->indexSize);
 	}
 
-	// Insert at found position.
-	GFXCmdElem_ elem = {
-		.order = order,
-		.cmd = cmd
+	return 1;
+}
+
+/****************************
+ * Keeps track of a set bound during a static recording.
+ * @param recorder Cannot be NULL, assumed to be in a static recording.
+ * @param set      Cannot be NULL.
+ * @param elem     Cannot be NULL, as returned by gfx_set_get_.
+ */
+static void gfx_recorder_static_track_(GFXRecorder* recorder,
+                                       GFXSet* set, GFXPoolElem_* elem)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.stat != NULL);
+	assert(set != NULL);
+	assert(elem != NULL);
+
+	GFXStaticSet_ sElem = {
+		.set = set,
+		.elem = elem,
+		.hash = atomic_load_explicit(&set->hash, memory_order_relaxed)
 	};
 
-	return gfx_vec_insert(&recorder->out.cmds, 1, &elem, loc);
+	// If we cannot track it, we cannot reuse the recording.
+	if (!gfx_vec_push(&recorder->inp.stat->sets, 1, &sElem))
+		recorder->inp.stat->valid = 0;
 }
 
-/****************************/
-bool gfx_recorder_reset_(GFXRecorder* recorder)
+/****************************
+ * Records a bind command, skipping any leading sets that are already bound.
+ * @param recorder Cannot be NULL, assumed to not be deferring.
+ * @param elems    Resolved Vulkan descriptor sets, NULL to resolve sets.
+ * @param pushes   Push set update data, NULL to take it from sets.
+ * @see gfx_cmd_bind.
+ *
+ * If elems is given, pushes must be given as well and vice versa.
+ * Both are indexed the same as sets, pushes is only read for the push set.
+ */
+static void gfx_recorder_bind_(GFXRecorder* recorder, GFXTechnique* technique,
+                               size_t firstSet,
+                               size_t numSets, size_t numDynamics,
+                               GFXSet** sets,
+                               GFXPoolElem_** elems, const void** pushes,
+                               const uint32_t* offsets)
 {
 	assert(recorder != NULL);
+	assert(technique != NULL);
+	assert(sets != NULL);
+	assert((elems == NULL) == (pushes == NULL));
 
 	GFXContext_* context = recorder->context;
 
-	// Clear output.
-	gfx_vec_release(&recorder->out.cmds);
-
-	// Set new current recording pools.
-	recorder->current = recorder->renderer->current;
-
-	// Then reset both graphics & compute.
-	GFXRecorderPool_* pools = &recorder->pools[recorder->current * 2];
-
-	for (unsigned int p = 0; p < 2; ++p)
+	// Initialize bound set state.
+	if (recorder->state.sets.size < technique->numSets)
 	{
-		// If the pool did not use some command buffers, free them.
-		if (pools[p].used < pools[p].vk.cmds.size)
-		{
-			uint32_t unused =
-				(uint32_t)(pools[p].vk.cmds.size - pools[p].used);
+		const size_t elems =
+			technique->numSets - recorder->state.sets.size;
 
-			context->vk.FreeCommandBuffers(context->vk.device,
-				pools[p].vk.pool, unused,
-				gfx_vec_at(&pools[p].vk.cmds, pools[p].used));
+		if (!gfx_vec_push(&recorder->state.sets, elems, NULL))
+		{
+			gfx_log_error(
+				"Could not initialize bound set state during bind command; "
+				"command not recorded.");
 
-			gfx_vec_pop(&pools[p].vk.cmds, (size_t)unused);
+			return;
 		}
 
-		// Try to reset the command pool.
-		GFX_VK_CHECK_(context->vk.ResetCommandPool(
-			context->vk.device, pools[p].vk.pool, 0), return 0);
+		// Initialize all to none bound.
+		for (size_t i = 0; i < elems; ++i)
+		{
+			GFXSetElem_* elem = gfx_vec_at(
+				&recorder->state.sets, recorder->state.sets.size - i - 1);
 
-		// No command buffers are in use anymore.
-		pools[p].used = 0;
+			elem->setLayout = NULL;
+			elem->set = NULL;
+			elem->elem = NULL;
+			elem->numDynamics = 0;
+		}
 	}
 
-	return 1;
-}
+	// We want to skip binding any leading descriptor sets that were already
+	// bound. In order to do so we need to keep track of Vulkan's bound
+	// descriptor set state. So keep track of what descriptor sets will be
+	// disturbed according to Vulkan.
+	size_t disturbedFrom = recorder->state.sets.size;
 
-/****************************/
-void gfx_recorder_record_(GFXRecorder* recorder,
-                          unsigned int order, VkCommandBuffer cmd)
-{
-	assert(recorder != NULL);
-	assert(cmd != NULL);
+	// If incompatible push constant ranges, all get disturbed!
+	if (
+		recorder->state.pushSize != technique->pushSize ||
+		recorder->state.pushStages != technique->pushStages)
+	{
+		disturbedFrom = 0;
+	}
 
-	GFXContext_* context = recorder->context;
+	// Start looping over all relevant sets and get Vulkan descriptor sets.
+	// And keep track of the number of sets/offsets we can skip binding for.
+	// And count the number of dynamic offsets that we need to bind.
+	VkDescriptorSet dSets[numSets];
+	GFXPoolElem_* pElems[numSets];
+	size_t skipSets = 0;
+	size_t skipOffsets = 0;
+	size_t numOffsets = 0;
 
-	// Do a binary search to find the left-most command buffer of this order.
-	size_t l = 0;
-	size_t r = recorder->out.cmds.size;
+	size_t offsetInd = 0; // In the input `offsets` array.
+	size_t bOffsetInd = 0; // In currently bound offsets.
+	size_t tOffsetInd = 0; // Resulting offset index of trailing sets.
 
-	while (l < r)
+	for (size_t s = 0; s < firstSet + numSets; ++s)
 	{
-		const size_t p = (l + r) >> 1;
-		const GFXCmdElem_* e = gfx_vec_at(&recorder->out.cmds, p);
+		GFXSetElem_* bound = gfx_vec_at(&recorder->state.sets, s);
+		uint32_t* bOffsets = gfx_vec_at(&recorder->state.offsets, bOffsetInd);
+		bOffsetInd += bound->numDynamics;
+		tOffsetInd += technique->sets[s].numDynamics;
 
-		if (e->order < order) l = p + 1;
-		else r = p;
-	}
+		// Check if sets get disturbed from here, if not already.
+		// Note this will also disturb if nothing is bound yet.
+		if (
+			disturbedFrom > s &&
+			bound->setLayout != technique->sets[s].setLayout)
+		{
+			disturbedFrom = s;
+		}
 
-	// Then find the right-most command buffer of this order.
-	while (r < recorder->out.cmds.size)
-	{
-		const GFXCmdElem_* e = gfx_vec_at(&recorder->out.cmds, r);
-		if (e->order > order) break;
-		else ++r;
-	}
+		// If we're not binding this set, done.
+		if (s < firstSet)
+			continue;
 
-	// Finally record them all into the given command buffer.
-	if (r > l)
-	{
-		VkCommandBuffer buffs[r-l];
-		for (size_t i = l; i < r; ++i) buffs[i-l] =
-			((GFXCmdElem_*)gfx_vec_at(&recorder->out.cmds, i))->cmd;
+		// We ARE binding this set.
+		// Validate against the given technique.
+		const size_t setInd = s - firstSet;
 
-		context->vk.CmdExecuteCommands(cmd, (uint32_t)(r-l), buffs);
-	}
-}
+		if (sets[setInd]->setLayout != technique->sets[s].setLayout)
+		{
+			gfx_log_error(
+				"Set not compatible with technique during bind command; "
+				"command not recorded.");
 
-/****************************/
-GFX_API GFXRecorder* gfx_renderer_add_recorder(GFXRenderer* renderer)
-{
-	assert(renderer != NULL);
-	assert(!renderer->recording);
+			return;
+		}
 
-	GFXContext_* context = renderer->cache.context;
+		// We want to check if we can skip binding this set.
+		// For this it must not be disturbed and all previous passes
+		// must be skipped too!
+		// Push sets are never skipped, their resources may have been set
+		// since the last push, which is not tracked by any bound state.
+		bool maybeSkip =
+			disturbedFrom > s && skipSets == setInd && !sets[setInd]->push;
 
-	// Allocate a new recorder.
-	GFXRecorder* rec = malloc(
-		sizeof(GFXRecorder) +
-		sizeof(GFXRecorderPool_) * renderer->numFrames * 2);
+		// Plus all bound offsets must be the same!
+		if (maybeSkip)
+			for (size_t d = 0; d < sets[setInd]->numDynamics; ++d)
+			{
+				const uint32_t newOffset = (offsetInd + d < numDynamics) ?
+					offsets[offsetInd + d] : 0;
 
-	if (rec == NULL)
-		goto error;
+				if (bOffsets[d] != newOffset)
+				{
+					maybeSkip = 0;
+					break;
+				}
+			}
 
-	// Create two command pools for each frame.
-	// One for the graphics family and one for the compute family.
-	VkCommandPoolCreateInfo gcpci = {
-		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		offsetInd += sets[setInd]->numDynamics;
 
-		.pNext            = NULL,
-		.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-		.queueFamilyIndex = renderer->graphics.family
-	};
+		// Get the Vulkan descriptor set.
+		GFXPoolElem_* elem;
 
-	VkCommandPoolCreateInfo ccpci = {
-		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		if (elems != NULL)
+		{
+			// Already resolved, only skip if the same was already bound.
+			elem = elems[setInd];
 
-		.pNext            = NULL,
-		.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-		.queueFamilyIndex = renderer->compute.family
-	};
+			if (recorder->inp.stat != NULL)
+				gfx_recorder_static_track_(recorder, sets[setInd], elem);
 
-	for (unsigned int i = 0; i < renderer->numFrames; ++i)
-	{
-		// Graphics pool.
-		GFX_VK_CHECK_(
-			context->vk.CreateCommandPool(
-				context->vk.device, &gcpci, NULL, &rec->pools[i*2].vk.pool),
-			{
-				goto destroy_prev_pools;
-			});
+			if (maybeSkip && bound->elem == elem)
+				goto skip;
+		}
+		else if (bound->set == sets[setInd] && !sets[setInd]->push)
+		{
+			// Early skip if the same exact GFXSet was already bound.
+			// We do not have to worry about making sure to call gfx_set_get_
+			// to ensure pool elements aren't accidentally purged, the bound
+			// state is reset in every call to gfx_recorder_(render|compute),
+			// meaning this element must have been retrieved before!
+			if (maybeSkip)
+				goto skip;
 
-		// Compute pool.
-		GFX_VK_CHECK_(
-			context->vk.CreateCommandPool(
-				context->vk.device, &ccpci, NULL, &rec->pools[i*2+1].vk.pool),
+			// Not skippable, but still skip gfx_set_get_!
+			elem = bound->elem;
+		}
+		else
+		{
+			// Get the Vulkan descriptor set from the pool.
+			elem = gfx_set_get_(sets[setInd], &recorder->sub);
+			if (elem == NULL)
 			{
-				// Destroy graphics, then clean the rest.
-				context->vk.DestroyCommandPool(
-					context->vk.device, rec->pools[i*2].vk.pool, NULL);
+				gfx_log_error(
+					"Failed to get Vulkan descriptor set during bind command; "
+					"command not recorded.");
 
-				goto destroy_prev_pools;
-			});
+				return;
+			}
 
-		continue; // Success!
+			// Static recordings must be able to check it later on.
+			if (recorder->inp.stat != NULL)
+				gfx_recorder_static_track_(recorder, sets[setInd], elem);
 
-	destroy_prev_pools:
-		// If it failed, destroy all previous pools.
-		for (; i > 0; --i)
-		{
-			context->vk.DestroyCommandPool(
-				context->vk.device, rec->pools[i*2-1].vk.pool, NULL);
-			context->vk.DestroyCommandPool(
-				context->vk.device, rec->pools[i*2-2].vk.pool, NULL);
+			// Late skip if the same Vulkan descriptor set was already bound.
+			if (maybeSkip && bound->elem == elem)
+				goto skip;
 		}
 
-		free(rec);
-		goto error;
+		// We REALLY are binding this set, set values.
+		dSets[setInd] = elem->vk.set;
+		pElems[setInd] = elem;
+		numOffsets += sets[setInd]->numDynamics;
+
+		continue;
+
+		// Jump to here to skip binding this set.
+	skip:
+		skipSets += 1;
+		skipOffsets += sets[setInd]->numDynamics;
 	}
 
-	// Initialize the rest of the pools.
-	rec->renderer = renderer;
-	rec->context = context;
-	rec->inp.pass = NULL;
-	rec->inp.cmd = NULL;
-	gfx_vec_init(&rec->state.sets, sizeof(GFXSetElem_));
-	gfx_vec_init(&rec->state.offsets, sizeof(uint32_t));
-	gfx_vec_init(&rec->out.cmds, sizeof(GFXCmdElem_));
+	// Super early return, apparently we are going to skip all sets.
+	// i.e. we are not going to bind anything new; done.
+	if (skipSets >= numSets)
+		return;
 
-	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	// Initialize bound dynamic offset state.
+	// Just allocate missing values, no need to initialize them.
+	// Only happens when something got disturbed.
+	// If anything is disturbed, trailing offsets will be unused.
+	if (
+		tOffsetInd > recorder->state.offsets.size &&
+		!gfx_vec_push(
+			&recorder->state.offsets,
+			tOffsetInd - recorder->state.offsets.size,
+			NULL))
 	{
-		rec->pools[i*2].used = 0;
-		rec->pools[i*2+1].used = 0;
-		gfx_vec_init(&rec->pools[i*2].vk.cmds, sizeof(VkCommandBuffer));
-		gfx_vec_init(&rec->pools[i*2+1].vk.cmds, sizeof(VkCommandBuffer));
+		gfx_log_error(
+			"Could not initialize bound offset state during bind command; "
+			"command not recorded.");
+
+		return;
 	}
 
-	// Take the renderer's current frame index and use it for the recorder's
-	// current frame index. Does not have to be atomic, as this could only
-	// go wrong during gfx_frame_submit, but we are not allowed to call
-	// this function until the frame is submitted anyway, so we're good.
-	rec->current = renderer->current;
+	// Now we have validated everything, set new bound state.
+	recorder->state.pushSize = technique->pushSize;
+	recorder->state.pushStages = technique->pushStages;
 
-	// Init subordinate & link the recorder into the renderer.
-	// Modifying the renderer, lock!
-	// Also using this lock for access to the pool!
-	gfx_mutex_lock_(&renderer->lock);
+	offsetInd = 0; // In the input `offsets` array.
+	bOffsetInd = 0; // In newly bound offsets.
 
-	gfx_pool_sub_(&renderer->pool, &rec->sub);
-	gfx_list_insert_after(&renderer->recorders, &rec->list, NULL);
+	for (size_t s = 0; s < recorder->state.sets.size; ++s)
+	{
+		GFXSetElem_* bound = gfx_vec_at(&recorder->state.sets, s);
+		uint32_t* bOffsets = gfx_vec_at(&recorder->state.offsets, bOffsetInd);
 
-	gfx_mutex_unlock_(&renderer->lock);
+		// Sets before or after the given range.
+		if (s < firstSet)
+		{
+			// If disturbed, invalidate the bound data.
+			if (disturbedFrom <= s)
+			{
+				bound->setLayout = NULL;
+				bound->set = NULL;
+				bound->elem = NULL;
+				bound->numDynamics = technique->sets[s].numDynamics;
+			}
+		}
 
-	return rec;
+		// Sets within the given range.
+		else if (s < firstSet + numSets)
+		{
+			// Update bound data if not skipping.
+			const size_t setInd = s - firstSet;
+
+			if (setInd >= skipSets)
+			{
+				bound->setLayout = sets[setInd]->setLayout;
+				bound->set = sets[setInd];
+				bound->elem = pElems[setInd];
+				bound->numDynamics = sets[setInd]->numDynamics;
 
+				for (size_t d = 0; d < bound->numDynamics; ++d)
+					bOffsets[d] = (offsetInd + d < numDynamics) ?
+						offsets[offsetInd + d] : 0;
+			}
 
-	// Error on failure.
-error:
-	gfx_log_error("Could not add a new recorder to a renderer.");
-	return NULL;
-}
+			offsetInd += sets[setInd]->numDynamics;
+		}
 
-/****************************/
-GFX_API void gfx_erase_recorder(GFXRecorder* recorder)
-{
-	assert(recorder != NULL);
-	assert(!recorder->renderer->recording);
+		// Sets after the given range.
+		// Simply completely invalidate if disturbed.
+		else if (disturbedFrom <= s)
+		{
+			bound->setLayout = NULL;
+			bound->set = NULL;
+			bound->elem = NULL;
+			bound->numDynamics = 0;
+		}
 
-	GFXRenderer* renderer = recorder->renderer;
+		// Apparently nothing got disturbed, we're done.
+		else break;
 
-	// Unlink itself from the renderer & undo subordinate.
-	// Locking for renderer and access to the pool!
-	gfx_mutex_lock_(&renderer->lock);
+		// Use newly bound number of dynamics to advance.
+		bOffsetInd += bound->numDynamics;
+	}
 
-	gfx_list_erase(&renderer->recorders, &recorder->list);
-	gfx_pool_unsub_(&renderer->pool, &recorder->sub);
+	// Record the bind command.
+	const VkPipelineBindPoint bindPoint =
+		technique->shaders[GFX_GET_SHADER_STAGE_INDEX_(GFX_STAGE_COMPUTE)] == NULL ?
+		VK_PIPELINE_BIND_POINT_GRAPHICS :
+		VK_PIPELINE_BIND_POINT_COMPUTE;
 
-	gfx_mutex_unlock_(&renderer->lock);
+	// If enough dynamic offsets are given, just pass that array.
+	// If not, create a new array, set all trailing 'empty' offsets to 0.
+	uint32_t offs[GFX_MAX(1, numOffsets)];
+	const uint32_t* bindOffsets = offsets + skipOffsets;
 
-	// We need to make the command pools stale,
-	// as its command buffers might still be in use by pending virtual frames!
-	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	if (numOffsets > 0 && numDynamics < skipOffsets + numOffsets)
 	{
-		// Graphics & compute pools.
-		gfx_push_stale_(renderer,
-			VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
-			recorder->pools[i*2].vk.pool);
-		gfx_push_stale_(renderer,
-			VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
-			recorder->pools[i*2+1].vk.pool);
+		for (size_t d = 0; d < numOffsets; ++d)
+			offs[d] = (skipOffsets + d < numDynamics) ?
+				offsets[skipOffsets + d] : 0;
+
+		bindOffsets = offs;
 	}
 
-	// Free all the memory.
-	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	// The push descriptor set cannot be bound with the others,
+	// so split the range of sets around it.
+	const size_t bindFirst = firstSet + skipSets;
+	const size_t bindEnd = firstSet + numSets;
+	const size_t pushSet = technique->pushSet;
+
+	if (pushSet < bindFirst || pushSet >= bindEnd)
 	{
-		gfx_vec_clear(&recorder->pools[i*2].vk.cmds);
-		gfx_vec_clear(&recorder->pools[i*2+1].vk.cmds);
-	}
+		context->vk.CmdBindDescriptorSets(recorder->inp.cmd,
+			bindPoint, technique->vk.layout,
+			(uint32_t)bindFirst,
+			(uint32_t)(bindEnd - bindFirst),
+			dSets + skipSets,
+			(uint32_t)numOffsets, bindOffsets);
 
-	gfx_vec_clear(&recorder->state.sets);
-	gfx_vec_clear(&recorder->state.offsets);
-	gfx_vec_clear(&recorder->out.cmds);
-	free(recorder);
+		return;
+	}
+
+	// Push sets cannot have dynamic offsets,
+	// so just count the offsets of all sets before it.
+	size_t preOffsets = 0;
+	for (size_t s = bindFirst; s < pushSet; ++s)
+		preOffsets += sets[s - firstSet]->numDynamics;
+
+	if (pushSet > bindFirst)
+		context->vk.CmdBindDescriptorSets(recorder->inp.cmd,
+			bindPoint, technique->vk.layout,
+			(uint32_t)bindFirst,
+			(uint32_t)(pushSet - bindFirst),
+			dSets + skipSets,
+			(uint32_t)preOffsets, bindOffsets);
+
+	// No template means nothing to push (e.g. only immutable samplers).
+	GFXSet* push = sets[pushSet - firstSet];
+
+	if (technique->vk.push != VK_NULL_HANDLE)
+		context->vk.CmdPushDescriptorSetWithTemplateKHR(recorder->inp.cmd,
+			technique->vk.push, technique->vk.layout,
+			(uint32_t)pushSet,
+			pushes != NULL ?
+				pushes[pushSet - firstSet] : &push->first->vk.update);
+
+	if (pushSet + 1 < bindEnd)
+		context->vk.CmdBindDescriptorSets(recorder->inp.cmd,
+			bindPoint, technique->vk.layout,
+			(uint32_t)(pushSet + 1),
+			(uint32_t)(bindEnd - pushSet - 1),
+			dSets + (pushSet + 1 - firstSet),
+			(uint32_t)(numOffsets - preOffsets), bindOffsets + preOffsets);
 }
 
-/****************************/
-GFX_API GFXRenderer* gfx_recorder_get_renderer(GFXRecorder* recorder)
+/****************************
+ * Resets the deferred state of a recorder, to start deferring commands.
+ * @param recorder Cannot be NULL.
+ */
+static void gfx_recorder_defer_reset_(GFXRecorder* recorder)
 {
 	assert(recorder != NULL);
 
-	return recorder->renderer;
+	recorder->defer.dirty = 0;
+	recorder->defer.pushed = 0;
+	recorder->defer.group = 0;
+	recorder->defer.technique = NULL;
+	recorder->defer.bind = NULL;
+	recorder->defer.push = SIZE_MAX;
+
+	gfx_vec_release(&recorder->defer.cmds);
+	gfx_vec_release(&recorder->defer.data);
+	gfx_vec_release(&recorder->defer.sets);
+	gfx_vec_release(&recorder->defer.offsets);
+	gfx_map_clear(&recorder->defer.binds);
 }
 
-/****************************/
-GFX_API void gfx_recorder_render(GFXRecorder* recorder, GFXPass* pass,
-                                 void (*cb)(GFXRecorder*, void*),
-                                 void* ptr)
+/****************************
+ * Copies the update entries of a push set into the deferred data,
+ * as they may be modified before being emitted.
+ * @param recorder   Cannot be NULL, assumed to be deferring.
+ * @param set        Cannot be NULL, must be a push set.
+ * @param numEntries Number of update entries of set.
+ * @param push       Cannot be NULL, previous offset into data (or SIZE_MAX),
+ *                   reused if equal, outputs the new offset (or SIZE_MAX).
+ * @return Zero on failure.
+ */
+static bool gfx_recorder_defer_entries_(GFXRecorder* recorder, GFXSet* set,
+                                        size_t numEntries, size_t* push)
 {
 	assert(recorder != NULL);
-	assert(recorder->renderer->recording);
-	assert(pass != NULL);
-	assert(pass->renderer == recorder->renderer);
-	assert(cb != NULL);
+	assert(set != NULL);
+	assert(set->push);
+	assert(push != NULL);
 
-	GFXRenderer* rend = recorder->renderer;
-	GFXContext_* context = recorder->context;
+	GFXVec* vec = &recorder->defer.data;
+	const size_t size = sizeof(GFXSetEntry_) * numEntries;
 
-	// Ignore if pass is culled.
-	if (pass->culled) return;
+	if (numEntries == 0)
+	{
+		*push = SIZE_MAX;
+		return 1;
+	}
 
-	// The pass must be a render pass.
-	GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
-	if (pass->type != GFX_PASS_RENDER) goto error;
+	// Reuse the previous copy if nothing changed.
+	if (*push != SIZE_MAX && memcmp(gfx_vec_at(vec, *push), set->first, size) == 0)
+		return 1;
 
-	// Check for the presence of a framebuffer.
-	VkFramebuffer framebuffer = gfx_pass_framebuffer_(rPass, rend->public);
-	if (framebuffer == VK_NULL_HANDLE) goto error;
+	const size_t at = GFX_ALIGN_UP(vec->size, alignof(GFXSetEntry_));
+	if (!gfx_vec_push(vec, (at - vec->size) + size, NULL))
+		return 0;
 
-	// Then, claim a command buffer to use.
-	VkCommandBuffer cmd = gfx_recorder_claim_(recorder, pass->type);
-	if (cmd == NULL) goto error;
+	memcpy(gfx_vec_at(vec, at), set->first, size);
+	*push = at;
 
-	// Start recording with it.
-	VkCommandBufferBeginInfo cbbi = {
-		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+	return 1;
+}
 
-		.pNext = NULL,
-		.flags =
-			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
-			VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+/****************************
+ * Updates the deferred bound set state, mimicking Vulkan's disturbance rules.
+ * @param recorder Cannot be NULL, assumed to be deferring.
+ * @see gfx_cmd_bind.
+ */
+static void gfx_recorder_defer_bind_(GFXRecorder* recorder,
+                                     GFXTechnique* technique,
+                                     size_t firstSet,
+                                     size_t numSets, size_t numDynamics,
+                                     GFXSet** sets,
+                                     const uint32_t* offsets)
+{
+	assert(recorder != NULL);
+	assert(technique != NULL);
+	assert(sets != NULL);
 
-		.pInheritanceInfo = (VkCommandBufferInheritanceInfo[]){{
-			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+	// Validate against the given technique.
+	for (size_t s = 0; s < numSets; ++s)
+		if (sets[s]->setLayout != technique->sets[firstSet + s].setLayout)
+		{
+			gfx_log_error(
+				"Set not compatible with technique during bind command; "
+				"command not recorded.");
 
-			.pNext       = NULL,
-			.renderPass  = rPass->vk.pass,
-			.subpass     = rPass->out.subpass,
-			.framebuffer = framebuffer,
+			return;
+		}
 
-			.occlusionQueryEnable = VK_FALSE,
-			.queryFlags           = 0,
-			.pipelineStatistics   = 0
-		}}
-	};
+	// Resolve all sets now, they may be modified before being emitted.
+	// Compare against the currently bound sets to reuse push set copies.
+	GFXDeferSet_ dSets[numSets];
 
-	GFX_VK_CHECK_(
-		context->vk.BeginCommandBuffer(cmd, &cbbi),
-		goto error);
+	for (size_t s = 0; s < numSets; ++s)
+	{
+		const GFXDeferSet_* bound =
+			(recorder->defer.technique != NULL &&
+			firstSet + s < recorder->defer.sets.size) ?
+				gfx_vec_at(&recorder->defer.sets, firstSet + s) : NULL;
 
-	// Set viewport, scissor & line width state.
-	VkViewport viewport = gfx_get_viewport_(
-		&rPass->state.viewport, rPass->build.fWidth, rPass->build.fHeight);
-	VkRect2D scissor = gfx_get_scissor_(
-		&rPass->state.scissor, rPass->build.fWidth, rPass->build.fHeight);
+		dSets[s].set = sets[s];
+		dSets[s].elem = gfx_set_get_(sets[s], &recorder->sub);
+		dSets[s].push = (bound != NULL && bound->set == sets[s]) ?
+			bound->push : SIZE_MAX;
 
-	recorder->state.viewport = rPass->state.viewport;
-	recorder->state.scissor = rPass->state.scissor;
-	recorder->state.lineWidth = 1.0f; // Also set a default line width.
+		if (dSets[s].elem == NULL)
+		{
+			gfx_log_error(
+				"Failed to get Vulkan descriptor set during bind command; "
+				"command not recorded.");
 
-	context->vk.CmdSetViewport(cmd, 0, 1, &viewport);
-	context->vk.CmdSetScissor(cmd, 0, 1, &scissor);
-	context->vk.CmdSetLineWidth(cmd, recorder->state.lineWidth);
+			return;
+		}
 
-	// Set recording input & state, record, unset input & reset state.
-	recorder->inp.pass = pass;
-	recorder->inp.cmd = cmd;
+		if (sets[s]->push && !gfx_recorder_defer_entries_(recorder,
+			sets[s], technique->sets[firstSet + s].numEntries, &dSets[s].push))
+		{
+			gfx_log_error(
+				"Could not defer push set entries during bind command; "
+				"command not recorded.");
 
-	recorder->state.pipeline = NULL;
-	recorder->state.primitive = NULL;
-	recorder->state.pushSize = 0;
-	recorder->state.pushStages = 0;
+			return;
+		}
+	}
 
-	cb(recorder, ptr);
+	// On a technique switch, keep all leading compatible sets,
+	// any sets after the first incompatible one get disturbed.
+	GFXTechnique* prev = recorder->defer.technique;
 
-	recorder->inp.pass = NULL;
-	recorder->inp.cmd = NULL;
+	if (prev != technique)
+	{
+		size_t keepSets = 0;
+		size_t keepOffsets = 0;
 
-	gfx_vec_release(&recorder->state.sets);
-	gfx_vec_release(&recorder->state.offsets);
+		if (
+			prev != NULL &&
+			prev->pushSize == technique->pushSize &&
+			prev->pushStages == technique->pushStages)
+		{
+			while (
+				keepSets < prev->numSets &&
+				keepSets < technique->numSets &&
+				prev->sets[keepSets].setLayout ==
+					technique->sets[keepSets].setLayout)
+			{
+				keepOffsets += technique->sets[keepSets++].numDynamics;
+			}
+		}
 
-	// End recording.
-	GFX_VK_CHECK_(
-		context->vk.EndCommandBuffer(cmd),
-		goto error);
+		size_t totalOffsets = 0;
+		for (size_t s = 0; s < technique->numSets; ++s)
+			totalOffsets += technique->sets[s].numDynamics;
 
-	// Now insert the command buffer in its correct position.
-	// Which is in submission order of the passes.
-	if (!gfx_recorder_output_(recorder, pass->order, cmd))
-		goto error;
+		// Drop all disturbed sets & reinitialize to none bound.
+		GFXVec* bSets = &recorder->defer.sets;
+		GFXVec* bOffsets = &recorder->defer.offsets;
 
-	return;
+		if (bSets->size > keepSets)
+			gfx_vec_pop(bSets, bSets->size - keepSets);
+		if (bOffsets->size > keepOffsets)
+			gfx_vec_pop(bOffsets, bOffsets->size - keepOffsets);
 
+		if (
+			(technique->numSets > keepSets &&
+			!gfx_vec_push(bSets, technique->numSets - keepSets, NULL)) ||
+			(totalOffsets > keepOffsets &&
+			!gfx_vec_push(bOffsets, totalOffsets - keepOffsets, NULL)))
+		{
+			gfx_log_error(
+				"Could not initialize deferred bound set state during bind "
+				"command; command not recorded.");
 
-	// Error on failure.
-error:
-	gfx_log_error("Recorder failed to record render commands.");
-}
+			// Nothing is bound anymore.
+			gfx_vec_release(bSets);
+			gfx_vec_release(bOffsets);
 
-/****************************/
-GFX_API void gfx_recorder_compute(GFXRecorder* recorder, GFXPass* pass,
-                                  void (*cb)(GFXRecorder*, void*),
-                                  void* ptr)
-{
-	assert(recorder != NULL);
-	assert(recorder->renderer->recording);
-	assert(pass != NULL);
-	assert(pass->renderer == recorder->renderer);
-	assert(cb != NULL);
+			recorder->defer.technique = NULL;
+			recorder->defer.bind = NULL;
+			recorder->defer.dirty = 0;
 
-	GFXContext_* context = recorder->context;
+			return;
+		}
 
-	// Ignore if pass is culled.
-	if (pass->culled) return;
+		for (size_t s = keepSets; s < technique->numSets; ++s)
+			*(GFXDeferSet_*)gfx_vec_at(bSets, s) = (GFXDeferSet_){
+				.set = NULL,
+				.elem = NULL,
+				.push = SIZE_MAX
+			};
 
-	// The pass must be a compute pass.
-	if (pass->type == GFX_PASS_RENDER) goto error;
+		for (size_t d = keepOffsets; d < totalOffsets; ++d)
+			*(uint32_t*)gfx_vec_at(bOffsets, d) = 0;
 
-	// Then, claim a command buffer to use.
-	VkCommandBuffer cmd = gfx_recorder_claim_(recorder, pass->type);
-	if (cmd == NULL) goto error;
+		recorder->defer.technique = technique;
+	}
 
-	// Start recording with it.
-	VkCommandBufferBeginInfo cbbi = {
-		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+	// Set the new bound sets & dynamic offsets.
+	size_t bOffsetInd = 0; // In bound offsets.
+	size_t offsetInd = 0; // In the input `offsets` array.
 
-		.pNext = NULL,
-		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	for (size_t s = 0; s < firstSet; ++s)
+		bOffsetInd += technique->sets[s].numDynamics;
 
-		.pInheritanceInfo = (VkCommandBufferInheritanceInfo[]){{
-			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+	for (size_t s = 0; s < numSets; ++s)
+	{
+		uint32_t* bOffsets =
+			gfx_vec_at(&recorder->defer.offsets, bOffsetInd);
 
-			.pNext       = NULL,
-			.renderPass  = VK_NULL_HANDLE,
-			.subpass     = 0,
-			.framebuffer = VK_NULL_HANDLE,
+		*(GFXDeferSet_*)gfx_vec_at(&recorder->defer.sets, firstSet + s) =
+			dSets[s];
 
-			.occlusionQueryEnable = VK_FALSE,
-			.queryFlags           = 0,
-			.pipelineStatistics   = 0
-		}}
-	};
+		for (size_t d = 0; d < sets[s]->numDynamics; ++d)
+			bOffsets[d] = (offsetInd + d < numDynamics) ?
+				offsets[offsetInd + d] : 0;
 
-	GFX_VK_CHECK_(
-		context->vk.BeginCommandBuffer(cmd, &cbbi),
-		goto error);
+		offsetInd += sets[s]->numDynamics;
+		bOffsetInd += sets[s]->numDynamics;
+	}
 
-	// Set recording input & state, record, unset input & reset state.
-	recorder->inp.pass = pass;
-	recorder->inp.cmd = cmd;
+	recorder->defer.dirty = 1;
+}
 
-	recorder->state.pipeline = NULL;
-	recorder->state.primitive = NULL;
-	recorder->state.pushSize = 0;
-	recorder->state.pushStages = 0;
+/****************************
+ * Updates the deferred push constant state.
+ * @param recorder Cannot be NULL, assumed to be deferring.
+ * @return Zero on failure.
+ * @see gfx_cmd_push.
+ */
+static bool gfx_recorder_defer_push_(GFXRecorder* recorder,
+                                     GFXTechnique* technique,
+                                     uint32_t offset,
+                                     uint32_t size, const void* data)
+{
+	assert(recorder != NULL);
+	assert(technique != NULL);
+	assert(data != NULL);
 
-	cb(recorder, ptr);
+	GFXVec* vec = &recorder->defer.data;
+	const size_t prev = recorder->defer.push;
 
-	recorder->inp.pass = NULL;
-	recorder->inp.cmd = NULL;
+	// Copy-on-write, as deferred commands may reference the current state.
+	if (
+		prev == SIZE_MAX || recorder->defer.pushed ||
+		((GFXDeferPush_*)gfx_vec_at(vec, prev))->technique != technique)
+	{
+		const size_t at = GFX_ALIGN_UP(vec->size, alignof(GFXDeferPush_));
+		const size_t grow =
+			(at - vec->size) + sizeof(GFXDeferPush_) + technique->pushSize;
 
-	gfx_vec_release(&recorder->state.sets);
-	gfx_vec_release(&recorder->state.offsets);
+		if (!gfx_vec_push(vec, grow, NULL))
+			return 0;
 
-	// End recording.
-	GFX_VK_CHECK_(
-		context->vk.EndCommandBuffer(cmd),
-		goto error);
+		GFXDeferPush_* push = gfx_vec_at(vec, at);
+		push->technique = technique;
+		push->size = technique->pushSize;
+		memset(push->bytes, 0, push->size);
 
-	// Now insert the command buffer in its correct position.
-	// Which is in submission order of the passes.
-	if (!gfx_recorder_output_(recorder, pass->order, cmd))
-		goto error;
+		// Carry over previously pushed values.
+		if (prev != SIZE_MAX)
+		{
+			const GFXDeferPush_* pPush = gfx_vec_at(vec, prev);
+			memcpy(push->bytes, pPush->bytes, GFX_MIN(pPush->size, push->size));
+		}
 
-	return;
+		recorder->defer.push = at;
+		recorder->defer.pushed = 0;
+	}
 
+	GFXDeferPush_* push = gfx_vec_at(vec, recorder->defer.push);
+	memcpy(push->bytes + offset, data, size);
 
-	// Error on failure.
-error:
-	gfx_log_error("Recorder failed to record compute commands.");
+	return 1;
 }
 
-/****************************/
-GFX_API unsigned int gfx_recorder_get_frame_index(GFXRecorder* recorder)
+/****************************
+ * Retrieves a (deduplicated) snapshot of the deferred bound set state.
+ * @param recorder Cannot be NULL, assumed to be deferring.
+ * @return NULL on failure.
+ *
+ * Equal states result in equal pointers, so they can be sorted on.
+ */
+static const GFXHashKey_* gfx_recorder_defer_key_(GFXRecorder* recorder)
 {
 	assert(recorder != NULL);
+	assert(recorder->defer.technique != NULL);
+
+	GFXTechnique* technique = recorder->defer.technique;
+	GFXVec* sets = &recorder->defer.sets;
+	GFXVec* offsets = &recorder->defer.offsets;
+	GFXVec* scratch = &recorder->defer.key;
+
+	// Build the key: { GFXTechnique*, GFXDeferSet_[], uint32_t[] }.
+	// This includes the resolved sets, so modified sets compare unequal.
+	const size_t len =
+		sizeof(GFXTechnique*) +
+		sizeof(GFXDeferSet_) * sets->size +
+		sizeof(uint32_t) * offsets->size;
+
+	gfx_vec_release(scratch);
+	if (!gfx_vec_push(scratch, sizeof(GFXHashKey_) + len, NULL))
+		return NULL;
 
-	return recorder->current;
-}
+	GFXHashKey_* key = gfx_vec_at(scratch, 0);
+	key->len = len;
 
-/****************************/
-GFX_API GFXPass* gfx_recorder_get_pass(GFXRecorder* recorder)
-{
-	assert(recorder != NULL);
+	char* bytes = key->bytes;
+	memcpy(bytes, &technique, sizeof(GFXTechnique*));
+	bytes += sizeof(GFXTechnique*);
+	memcpy(bytes, sets->data, sizeof(GFXDeferSet_) * sets->size);
+	bytes += sizeof(GFXDeferSet_) * sets->size;
 
-	return recorder->inp.pass;
-}
+	if (offsets->size > 0)
+		memcpy(bytes, offsets->data, sizeof(uint32_t) * offsets->size);
 
-/****************************/
-GFX_API void gfx_recorder_get_size(GFXRecorder* recorder,
-                                   uint32_t* width, uint32_t* height, uint32_t* layers)
-{
-	assert(recorder != NULL);
-	assert(width != NULL);
-	assert(height != NULL);
-	assert(layers != NULL);
+	// Find or insert it.
+	const uint64_t hash = gfx_hash_murmur3_(key);
+	void* node = gfx_map_hsearch(&recorder->defer.binds, key, hash);
 
-	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
-		*width = ((GFXRenderPass_*)recorder->inp.pass)->build.fWidth,
-		*height = ((GFXRenderPass_*)recorder->inp.pass)->build.fHeight,
-		*layers = ((GFXRenderPass_*)recorder->inp.pass)->build.fLayers;
-	else
-		// Output 0,0,0 if no associated pass.
-		*width = 0,
-		*height = 0,
-		*layers = 0;
+	if (node == NULL)
+		node = gfx_map_hinsert(&recorder->defer.binds,
+			NULL, sizeof(GFXHashKey_) + len, key, hash);
+
+	return node == NULL ? NULL : gfx_map_key(&recorder->defer.binds, node);
 }
 
-/****************************/
-GFX_API void gfx_pass_get_size(GFXPass* pass,
-                               uint32_t* width, uint32_t* height, uint32_t* layers)
+/****************************
+ * Defers a draw command, capturing all current state.
+ * @param recorder   Cannot be NULL, assumed to be deferring.
+ * @param renderable Cannot be NULL, assumed to be validated.
+ * @param cmd        Cannot be NULL, type and arguments must be set.
+ */
+static void gfx_recorder_defer_(GFXRecorder* recorder,
+                                GFXRenderable* renderable, GFXDeferCmd_* cmd)
 {
-	assert(pass != NULL);
-	assert(width != NULL);
-	assert(height != NULL);
-	assert(layers != NULL);
+	assert(recorder != NULL);
+	assert(renderable != NULL);
+	assert(cmd != NULL);
 
-	if (!pass->culled && pass->type == GFX_PASS_RENDER)
-		*width = ((GFXRenderPass_*)pass)->build.fWidth,
-		*height = ((GFXRenderPass_*)pass)->build.fHeight,
-		*layers = ((GFXRenderPass_*)pass)->build.fLayers;
-	else
-		*width = 0,
-		*height = 0,
-		*layers = 0;
-}
+	// Get pipeline from renderable.
+	if (!gfx_renderable_pipeline_(renderable, &cmd->pipeline, 0))
+	{
+		gfx_log_error(
+			"Failed to get Vulkan graphics pipeline during draw command; "
+			"command not recorded.");
 
-/****************************/
-GFX_API GFXViewport gfx_recorder_get_viewport(GFXRecorder* recorder)
-{
-	assert(recorder != NULL);
+		return;
+	}
 
-	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
-		return recorder->state.viewport;
-	else
-		return (GFXViewport){
-			.size = GFX_SIZE_ABSOLUTE,
-			.x = 0.0f,
-			.y = 0.0f,
-			.width = 0.0f,
-			.height = 0.0f,
-			.minDepth = 0.0f,
-			.maxDepth = 0.0f
-		};
+	// Snapshot the bound set state if it changed.
+	if (recorder->defer.dirty)
+	{
+		const GFXHashKey_* bind = gfx_recorder_defer_key_(recorder);
+		if (bind == NULL) goto error;
+
+		recorder->defer.bind = bind;
+		recorder->defer.dirty = 0;
+	}
+
+	cmd->group = recorder->defer.group;
+	cmd->seq = recorder->defer.cmds.size;
+	cmd->bind = recorder->defer.bind;
+	cmd->primitive = renderable->primitive;
+	cmd->push = recorder->defer.push;
+	cmd->viewport = recorder->state.viewport;
+	cmd->scissor = recorder->state.scissor;
+	cmd->lineWidth = recorder->state.lineWidth;
+
+	if (!gfx_vec_push(&recorder->defer.cmds, 1, cmd))
+		goto error;
+
+	// The push state is now referenced.
+	recorder->defer.pushed = 1;
+
+	return;
+
+
+	// Error on failure.
+error:
+	gfx_log_error(
+		"Could not defer draw command; command not recorded.");
 }
 
-/****************************/
-GFX_API GFXScissor gfx_recorder_get_scissor(GFXRecorder* recorder)
+/****************************
+ * Compares two deferred commands, to sort them on state.
+ */
+static int gfx_recorder_defer_cmp_(const void* l, const void* r)
 {
-	assert(recorder != NULL);
+	const GFXDeferCmd_* cl = l;
+	const GFXDeferCmd_* cr = r;
 
-	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
-		return recorder->state.scissor;
-	else
-		return (GFXScissor){
-			.size = GFX_SIZE_ABSOLUTE,
-			.x = 0,
-			.y = 0,
-			.width = 0,
-			.height = 0
-		};
+	// Never sort across groups.
+	if (cl->group != cr->group)
+		return cl->group < cr->group ? -1 : 1;
+
+	// Then pipeline, bound sets & primitive.
+	if (cl->pipeline != cr->pipeline)
+		return (uintptr_t)cl->pipeline < (uintptr_t)cr->pipeline ? -1 : 1;
+
+	if (cl->bind != cr->bind)
+		return (uintptr_t)cl->bind < (uintptr_t)cr->bind ? -1 : 1;
+
+	if (cl->primitive != cr->primitive)
+		return (uintptr_t)cl->primitive < (uintptr_t)cr->primitive ? -1 : 1;
+
+	// Keep it stable.
+	return (cl->seq > cr->seq) - (cl->seq < cr->seq);
 }
 
-/****************************/
-GFX_API float gfx_recorder_get_line_width(GFXRecorder* recorder)
+/****************************
+ * Counts the number of binds needed to record deferred commands in order.
+ * @param recorder Cannot be NULL.
+ */
+static uint64_t gfx_recorder_defer_count_(GFXRecorder* recorder)
 {
 	assert(recorder != NULL);
 
-	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
-		return recorder->state.lineWidth;
-	else
-		return 0.0f;
+	uint64_t binds = 0;
+	const GFXDeferCmd_* prev = NULL;
+
+	for (size_t c = 0; c < recorder->defer.cmds.size; ++c)
+	{
+		const GFXDeferCmd_* cmd = gfx_vec_at(&recorder->defer.cmds, c);
+
+		binds += (prev == NULL || prev->pipeline != cmd->pipeline);
+		binds += cmd->bind != NULL &&
+			(prev == NULL || prev->bind != cmd->bind);
+		binds += cmd->primitive != NULL &&
+			(prev == NULL || prev->primitive != cmd->primitive);
+
+		prev = cmd;
+	}
+
+	return binds;
 }
 
-/****************************/
-GFX_API void gfx_cmd_bind(GFXRecorder* recorder, GFXTechnique* technique,
-                          size_t firstSet,
-                          size_t numSets, size_t numDynamics,
-                          GFXSet** sets,
-                          const uint32_t* offsets)
+/****************************
+ * Binds a deferred bound set state snapshot.
+ * @param recorder Cannot be NULL, assumed to not be deferring.
+ * @param key      Cannot be NULL, as returned by gfx_recorder_defer_key_.
+ */
+static void gfx_recorder_emit_bind_(GFXRecorder* recorder,
+                                    const GFXHashKey_* key)
 {
 	assert(recorder != NULL);
-	assert(recorder->inp.cmd != NULL);
-	assert(technique != NULL);
-	assert(technique->renderer == recorder->renderer);
-	assert(firstSet < technique->numSets);
-	assert(numSets > 0);
-	assert(numSets <= technique->numSets - firstSet);
-	assert(sets != NULL);
-	assert(numDynamics == 0 || offsets != NULL);
+	assert(key != NULL);
 
-	GFXContext_* context = recorder->context;
+	GFXTechnique* technique;
+	memcpy(&technique, key->bytes, sizeof(GFXTechnique*));
 
-	// Check technique.
-	if (technique->layout == NULL)
-	{
-		gfx_log_error(
-			"Technique not locked during bind command; "
-			"command not recorded.");
+	const GFXDeferSet_* dSets =
+		(const GFXDeferSet_*)(key->bytes + sizeof(GFXTechnique*));
+	const uint32_t* offsets =
+		(const uint32_t*)(dSets + technique->numSets);
 
-		return;
-	}
+	// Unpack the resolved sets.
+	GFXSet* sets[technique->numSets];
+	GFXPoolElem_* elems[technique->numSets];
+	const void* pushes[technique->numSets];
 
-	// Initialize bound set state.
-	if (recorder->state.sets.size < technique->numSets)
+	for (size_t s = 0; s < technique->numSets; ++s)
 	{
-		const size_t elems =
-			technique->numSets - recorder->state.sets.size;
+		sets[s] = dSets[s].set;
+		elems[s] = dSets[s].elem;
+		pushes[s] = dSets[s].push == SIZE_MAX ? NULL :
+			&((GFXSetEntry_*)gfx_vec_at(
+				&recorder->defer.data, dSets[s].push))->vk.update;
+	}
 
-		if (!gfx_vec_push(&recorder->state.sets, elems, NULL))
+	// Bind each contiguous range of bound sets.
+	for (size_t s = 0, o = 0; s < technique->numSets; )
+	{
+		if (sets[s] == NULL)
 		{
-			gfx_log_error(
-				"Could not initialize bound set state during bind command; "
-				"command not recorded.");
-
-			return;
+			o += technique->sets[s++].numDynamics;
+			continue;
 		}
 
-		// Initialize all to none bound.
-		for (size_t i = 0; i < elems; ++i)
-		{
-			GFXSetElem_* elem = gfx_vec_at(
-				&recorder->state.sets, recorder->state.sets.size - i - 1);
+		size_t e = s;
+		size_t numDynamics = 0;
 
-			elem->setLayout = NULL;
-			elem->set = NULL;
-			elem->elem = NULL;
-			elem->numDynamics = 0;
-		}
-	}
+		while (e < technique->numSets && sets[e] != NULL)
+			numDynamics += technique->sets[e++].numDynamics;
 
-	// We want to skip binding any leading descriptor sets that were already
-	// bound. In order to do so we need to keep track of Vulkan's bound
-	// descriptor set state. So keep track of what descriptor sets will be
-	// disturbed according to Vulkan.
-	size_t disturbedFrom = recorder->state.sets.size;
+		// Relies on gfx_recorder_bind_ to skip already bound sets.
+		gfx_recorder_bind_(recorder, technique,
+			s, e - s, numDynamics,
+			sets + s, elems + s, pushes + s, offsets + o);
 
-	// If incompatible push constant ranges, all get disturbed!
-	if (
-		recorder->state.pushSize != technique->pushSize ||
-		recorder->state.pushStages != technique->pushStages)
-	{
-		disturbedFrom = 0;
+		o += numDynamics;
+		s = e;
 	}
+}
 
-	// Start looping over all relevant sets and get Vulkan descriptor sets.
-	// And keep track of the number of sets/offsets we can skip binding for.
-	// And count the number of dynamic offsets that we need to bind.
-	VkDescriptorSet dSets[numSets];
-	GFXPoolElem_* pElems[numSets];
-	size_t skipSets = 0;
-	size_t skipOffsets = 0;
-	size_t numOffsets = 0;
-
-	size_t offsetInd = 0; // In the input `offsets` array.
-	size_t bOffsetInd = 0; // In currently bound offsets.
-	size_t tOffsetInd = 0; // Resulting offset index of trailing sets.
+/****************************
+ * Sorts and records all deferred commands to the current recording.
+ * @param recorder Cannot be NULL, assumed to be deferring.
+ *
+ * Relies on the state being reset to what it was before deferring.
+ */
+static void gfx_recorder_emit_(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+	assert(recorder->defer.active);
 
-	for (size_t s = 0; s < firstSet + numSets; ++s)
-	{
-		GFXSetElem_* bound = gfx_vec_at(&recorder->state.sets, s);
-		uint32_t* bOffsets = gfx_vec_at(&recorder->state.offsets, bOffsetInd);
-		bOffsetInd += bound->numDynamics;
-		tOffsetInd += technique->sets[s].numDynamics;
+	GFXContext_* context = recorder->context;
+	GFXVec* cmds = &recorder->defer.cmds;
 
-		// Check if sets get disturbed from here, if not already.
-		// Note this will also disturb if nothing is bound yet.
-		if (
-			disturbedFrom > s &&
-			bound->setLayout != technique->sets[s].setLayout)
-		{
-			disturbedFrom = s;
-		}
+	// Stop deferring so we can use the regular commands.
+	recorder->defer.active = 0;
 
-		// If we're not binding this set, done.
-		if (s < firstSet)
-			continue;
+	if (cmds->size == 0)
+		return;
 
-		// We ARE binding this set.
-		// Validate against the given technique.
-		const size_t setInd = s - firstSet;
+	// Sort all commands, count the binds before and after.
+	const uint64_t binds = gfx_recorder_defer_count_(recorder);
 
-		if (sets[setInd]->setLayout != technique->sets[s].setLayout)
-		{
-			gfx_log_error(
-				"Set not compatible with technique during bind command; "
-				"command not recorded.");
+	qsort(cmds->data, cmds->size, sizeof(GFXDeferCmd_),
+		gfx_recorder_defer_cmp_);
 
-			return;
-		}
+	recorder->defer.saved += binds - gfx_recorder_defer_count_(recorder);
 
-		// We want to check if we can skip binding this set.
-		// For this it must not be disturbed and all previous passes
-		// must be skipped too!
-		bool maybeSkip = disturbedFrom > s && skipSets == setInd;
+	// Record all commands, skipping redundant state changes.
+	const GFXDeferCmd_* prev = NULL;
 
-		// Plus all bound offsets must be the same!
-		if (maybeSkip)
-			for (size_t d = 0; d < sets[setInd]->numDynamics; ++s)
-			{
-				const uint32_t newOffset = (offsetInd + d < numDynamics) ?
-					offsets[offsetInd + d] : 0;
+	for (size_t c = 0; c < cmds->size; ++c)
+	{
+		const GFXDeferCmd_* cmd = gfx_vec_at(cmds, c);
 
-				if (bOffsets[d] != newOffset)
-				{
-					maybeSkip = 0;
-					break;
-				}
-			}
+		gfx_cmd_set_viewport(recorder, cmd->viewport);
+		gfx_cmd_set_scissor(recorder, cmd->scissor);
+		gfx_cmd_set_line_width(recorder, cmd->lineWidth);
 
-		offsetInd += sets[setInd]->numDynamics;
+		const bool rebind =
+			cmd->bind != NULL && (prev == NULL || prev->bind != cmd->bind);
 
-		// Get the Vulkan descriptor set.
-		GFXPoolElem_* elem;
+		if (rebind)
+			gfx_recorder_emit_bind_(recorder, cmd->bind);
 
-		if (bound->set == sets[setInd])
+		// Re-push after binding, it may have disturbed push constants.
+		if (cmd->push != SIZE_MAX &&
+			(rebind || prev == NULL || prev->push != cmd->push))
 		{
-			// Early skip if the same exact GFXSet was already bound.
-			// We do not have to worry about making sure to call gfx_set_get_
-			// to ensure pool elements aren't accidentally purged, the bound
-			// state is reset in every call to gfx_recorder_(render|compute),
-			// meaning this element must have been retrieved before!
-			if (maybeSkip)
-				goto skip;
+			GFXDeferPush_* push = gfx_vec_at(&recorder->defer.data, cmd->push);
+			gfx_cmd_push(recorder, push->technique, 0, push->size, push->bytes);
+		}
 
-			// Not skippable, but still skip gfx_set_get_!
-			elem = bound->elem;
+		if (recorder->state.pipeline != cmd->pipeline)
+		{
+			recorder->state.pipeline = cmd->pipeline;
+			context->vk.CmdBindPipeline(recorder->inp.cmd,
+				VK_PIPELINE_BIND_POINT_GRAPHICS, cmd->pipeline->vk.pipeline);
 		}
-		else
+
+		if (cmd->primitive != NULL)
+			gfx_recorder_bind_primitive_(recorder, cmd->primitive);
+
+		switch (cmd->type)
 		{
-			// Get the Vulkan descriptor set from the pool.
-			elem = gfx_set_get_(sets[setInd], &recorder->sub);
-			if (elem == NULL)
-			{
-				gfx_log_error(
-					"Failed to get Vulkan descriptor set during bind command; "
-					"command not recorded.");
+		case GFX_DEFER_DRAW_:
+			context->vk.CmdDraw(recorder->inp.cmd,
+				cmd->direct.count, cmd->direct.instances,
+				cmd->direct.first, cmd->direct.firstInstance);
+			break;
 
-				return;
-			}
+		case GFX_DEFER_DRAW_INDEXED_:
+			context->vk.CmdDrawIndexed(recorder->inp.cmd,
+				cmd->direct.count, cmd->direct.instances,
+				cmd->direct.first, cmd->direct.vertexOffset,
+				cmd->direct.firstInstance);
+			break;
 
-			// Late skip if the same Vulkan descriptor set was already bound.
-			if (maybeSkip && bound->elem == elem)
-				goto skip;
-		}
+		case GFX_DEFER_DRAW_INDIRECT_:
+			context->vk.CmdDrawIndirect(recorder->inp.cmd,
+				cmd->indirect.buffer, cmd->indirect.offset,
+				cmd->indirect.count, cmd->indirect.stride);
+			break;
 
-		// We REALLY are binding this set, set values.
-		dSets[setInd] = elem->vk.set;
-		pElems[setInd] = elem;
-		numOffsets += sets[setInd]->numDynamics;
+		case GFX_DEFER_DRAW_INDEXED_INDIRECT_:
+			context->vk.CmdDrawIndexedIndirect(recorder->inp.cmd,
+				cmd->indirect.buffer, cmd->indirect.offset,
+				cmd->indirect.count, cmd->indirect.stride);
+			break;
 
-		continue;
+		case GFX_DEFER_DRAW_INDIRECT_COUNT_:
+			context->vk.CmdDrawIndirectCount(recorder->inp.cmd,
+				cmd->indirect.buffer, cmd->indirect.offset,
+				cmd->indirect.countBuffer, cmd->indirect.countOffset,
+				cmd->indirect.count, cmd->indirect.stride);
+			break;
 
-		// Jump to here to skip binding this set.
-	skip:
-		skipSets += 1;
-		skipOffsets += sets[setInd]->numDynamics;
+		case GFX_DEFER_DRAW_INDEXED_INDIRECT_COUNT_:
+			context->vk.CmdDrawIndexedIndirectCount(recorder->inp.cmd,
+				cmd->indirect.buffer, cmd->indirect.offset,
+				cmd->indirect.countBuffer, cmd->indirect.countOffset,
+				cmd->indirect.count, cmd->indirect.stride);
+			break;
+		}
+
+		prev = cmd;
 	}
+}
+
+/****************************
+ * Retrieves the next static recording of a pass for the current frame.
+ * @param recorder Cannot be NULL.
+ * @param pass     Cannot be NULL, must be a render pass.
+ * @return NULL on failure.
+ *
+ * Creates a new (invalid) recording if the pass has no more unused ones.
+ */
+static GFXRecorderStatic_* gfx_recorder_static_(GFXRecorder* recorder,
+                                                GFXPass* pass)
+{
+	assert(recorder != NULL);
+	assert(pass != NULL);
+
+	GFXContext_* context = recorder->context;
+	GFXRecorderPool_* pool = &recorder->pools[recorder->current * 2];
+
+	// Find the first unused recording of this pass.
+	for (size_t s = 0; s < pool->statics.size; ++s)
+	{
+		GFXRecorderStatic_* stat = gfx_vec_at(&pool->statics, s);
+		if (stat->pass == pass && !stat->used)
+		{
+			stat->used = 1;
+			return stat;
+		}
+	}
+
+	// Create the static command pool if there is none yet.
+	// Its command buffers are individually reset when re-recorded.
+	if (pool->vk.statics == VK_NULL_HANDLE)
+	{
+		VkCommandPoolCreateInfo cpci = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+
+			.pNext            = NULL,
+			.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+			.queueFamilyIndex = recorder->renderer->graphics.family
+		};
+
+		GFX_VK_CHECK_(
+			context->vk.CreateCommandPool(
+				context->vk.device, &cpci, NULL, &pool->vk.statics),
+			return NULL);
+	}
+
+	// Allocate a new command buffer for a new recording.
+	GFXRecorderStatic_ stat = {
+		.pass = pass,
+		.gen = 0,
+		.valid = 0,
+		.used = 1
+	};
+
+	VkCommandBufferAllocateInfo cbai = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+
+		.pNext              = NULL,
+		.commandPool        = pool->vk.statics,
+		.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+		.commandBufferCount = 1
+	};
+
+	GFX_VK_CHECK_(
+		context->vk.AllocateCommandBuffers(
+			context->vk.device, &cbai, &stat.vk.cmd),
+		return NULL);
+
+	gfx_vec_init(&stat.sets, sizeof(GFXStaticSet_));
+
+	if (!gfx_vec_push(&pool->statics, 1, &stat))
+	{
+		context->vk.FreeCommandBuffers(
+			context->vk.device, pool->vk.statics, 1, &stat.vk.cmd);
+
+		return NULL;
+	}
+
+	return gfx_vec_at(&pool->statics, pool->statics.size - 1);
+}
+
+/****************************
+ * Checks whether a static recording can be reused as-is.
+ * @param recorder Cannot be NULL.
+ * @param stat     Cannot be NULL.
+ * @return Non-zero if it can be reused.
+ *
+ * Retrieves all bound sets again, keeping their descriptor sets alive.
+ */
+static bool gfx_recorder_static_check_(GFXRecorder* recorder,
+                                       GFXRecorderStatic_* stat)
+{
+	assert(recorder != NULL);
+	assert(stat != NULL);
+
+	if (!stat->valid || stat->gen != GFX_PASS_GEN_(stat->pass))
+		return 0;
+
+	// The viewport & scissor are recorded as absolute values,
+	// which change on resize without changing the build generation.
+	GFXRenderPass_* rPass = (GFXRenderPass_*)stat->pass;
+
+	VkViewport viewport = gfx_get_viewport_(
+		&rPass->state.viewport, rPass->build.fWidth, rPass->build.fHeight);
+	VkRect2D scissor = gfx_get_scissor_(
+		&rPass->state.scissor, rPass->build.fWidth, rPass->build.fHeight);
+
+	if (
+		memcmp(&viewport, &stat->vk.viewport, sizeof(VkViewport)) != 0 ||
+		memcmp(&scissor, &stat->vk.scissor, sizeof(VkRect2D)) != 0)
+	{
+		return 0;
+	}
+
+	for (size_t s = 0; s < stat->sets.size; ++s)
+	{
+		GFXStaticSet_* sElem = gfx_vec_at(&stat->sets, s);
+
+		// Get first, this may update attachments & thus its hash.
+		if (gfx_set_get_(sElem->set, &recorder->sub) != sElem->elem)
+			return 0;
+
+		if (atomic_load_explicit(
+			&sElem->set->hash, memory_order_relaxed) != sElem->hash)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/****************************
+ * Claims (or creates) a command buffer from the current recording pool.
+ * To unclaim, the current pool's used count should be decreased.
+ * @param recorder Cannot be NULL.
+ * @param type     Type of the pass, to inform pool selection.
+ * @return The command buffer, NULL on failure.
+ */
+static VkCommandBuffer gfx_recorder_claim_(GFXRecorder* recorder,
+                                           GFXPassType type)
+{
+	assert(recorder != NULL);
+
+	GFXContext_* context = recorder->context;
+
+	// Select recorder pool.
+	GFXRecorderPool_* pool = &recorder->pools[
+		type != GFX_PASS_COMPUTE_ASYNC ?
+			recorder->current * 2 :
+			recorder->current * 2 + 1];
+
+	// If we still have enough command buffers, return the next one.
+	if (pool->used < pool->vk.cmds.size)
+		// Immediately increase used counter.
+		return *(VkCommandBuffer*)gfx_vec_at(&pool->vk.cmds, pool->used++);
+
+	// Otherwise, allocate a new one.
+	if (!gfx_vec_push(&pool->vk.cmds, 1, NULL))
+		return NULL;
+
+	VkCommandBufferAllocateInfo cbai = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+
+		.pNext              = NULL,
+		.commandPool        = pool->vk.pool,
+		.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+		.commandBufferCount = 1
+	};
+
+	VkCommandBuffer* cmd = gfx_vec_at(&pool->vk.cmds, pool->used);
+	GFX_VK_CHECK_(
+		context->vk.AllocateCommandBuffers(
+			context->vk.device, &cbai, cmd),
+		{
+			gfx_vec_pop(&pool->vk.cmds, 1);
+			return NULL;
+		});
+
+	// Increase used counter & return.
+	++pool->used;
+	return *cmd;
+}
+
+/****************************
+ * Outputs a command buffer of a specific submission order.
+ * @param recorder Cannot be NULL.
+ * @return Zero on failure.
+ */
+static bool gfx_recorder_output_(GFXRecorder* recorder,
+                                 unsigned int order, VkCommandBuffer cmd)
+{
+	// Find the right spot to insert at.
+	// We assume the most prevelant way of recording stuff is in submission
+	// order. Which would make backwards linear search perfect.
+	size_t loc;
+	for (loc = recorder->out.cmds.size; loc > 0; --loc)
+	{
+		unsigned int cOrder =
+			((GFXCmdElem_*)gfx_vec_at(&recorder->out.cmds, loc-1))->order;
+
+		if (cOrder <= order)
+			break;
+	}
+
+	// Insert at found position.
+	GFXCmdElem_ elem = {
+		.order = order,
+		.cmd = cmd
+	};
+
+	return gfx_vec_insert(&recorder->out.cmds, 1, &elem, loc);
+}
+
+/****************************
+ * Retrieves the framebuffer to record a render pass with.
+ * @param recorder    Cannot be NULL.
+ * @param pass        Cannot be NULL.
+ * @param framebuffer Output framebuffer, cannot be NULL.
+ * @return Zero if the pass is not a render pass or is not built.
+ *
+ * Outputs VK_NULL_HANDLE for dynamic rendering.
+ */
+static bool gfx_recorder_framebuffer_(GFXRecorder* recorder, GFXPass* pass,
+                                      VkFramebuffer* framebuffer)
+{
+	assert(recorder != NULL);
+	assert(pass != NULL);
+	assert(framebuffer != NULL);
+
+	*framebuffer = VK_NULL_HANDLE;
+
+	// The pass must be a render pass.
+	GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
+	if (pass->type != GFX_PASS_RENDER) return 0;
+
+	// Check for the presence of a framebuffer.
+	// Dynamic rendering has none, check if it is built instead.
+	if (GFX_PASS_IS_DYNAMIC_(rPass))
+		return rPass->vk.frames.size > 0;
+
+	*framebuffer = gfx_pass_framebuffer_(rPass, recorder->renderer->public);
+	return *framebuffer != VK_NULL_HANDLE;
+}
+
+/****************************
+ * Records render commands into a secondary command buffer.
+ * @param recorder    Cannot be NULL.
+ * @param pass        Cannot be NULL, must be a built render pass.
+ * @param cmd         Command buffer to record into, cannot be NULL.
+ * @param framebuffer Framebuffer to inherit, may be VK_NULL_HANDLE.
+ * @param stat        Static recording being recorded, may be NULL.
+ * @param cb          Callback, cannot be NULL.
+ * @return Zero on failure.
+ */
+static bool gfx_recorder_render_(GFXRecorder* recorder, GFXPass* pass,
+                                 VkCommandBuffer cmd, VkFramebuffer framebuffer,
+                                 GFXRecorderStatic_* stat,
+                                 void (*cb)(GFXRecorder*, void*),
+                                 void* ptr)
+{
+	assert(recorder != NULL);
+	assert(pass != NULL);
+	assert(pass->type == GFX_PASS_RENDER);
+	assert(cmd != NULL);
+	assert(cb != NULL);
+
+	GFXContext_* context = recorder->context;
+	GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
+	const bool dynamic = GFX_PASS_IS_DYNAMIC_(rPass);
+
+	// Start recording with it.
+	// Formats are stored as all colors, followed by depth & stencil.
+	const size_t numFormats = rPass->vk.formats.size;
+	const VkFormat* formats = gfx_vec_at(&rPass->vk.formats, 0);
+
+	VkCommandBufferInheritanceRenderingInfo cbiri = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+
+		.pNext                   = NULL,
+		.flags                   = 0,
+		.viewMask                = 0,
+		.colorAttachmentCount    = dynamic ? (uint32_t)(numFormats - 2) : 0,
+		.pColorAttachmentFormats = numFormats > 2 ? formats : NULL,
+
+		.depthAttachmentFormat = dynamic ?
+			formats[numFormats - 2] : VK_FORMAT_UNDEFINED,
+		.stencilAttachmentFormat = dynamic ?
+			formats[numFormats - 1] : VK_FORMAT_UNDEFINED,
+
+		.rasterizationSamples =
+			GFX_GET_VK_SAMPLE_COUNT_(rPass->state.samples)
+	};
+
+	VkCommandBufferBeginInfo cbbi = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+
+		.pNext = NULL,
+		.flags =
+			(stat == NULL ? VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT : 0) |
+			VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+
+		.pInheritanceInfo = (VkCommandBufferInheritanceInfo[]){{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+
+			.pNext       = dynamic ? &cbiri : NULL,
+			.renderPass  = rPass->vk.pass,
+			.subpass     = rPass->out.subpass,
+			.framebuffer = framebuffer,
+
+			.occlusionQueryEnable = VK_FALSE,
+			.queryFlags           = 0,
+			.pipelineStatistics   = 0
+		}}
+	};
+
+	GFX_VK_CHECK_(
+		context->vk.BeginCommandBuffer(cmd, &cbbi),
+		return 0);
+
+	// Set viewport, scissor & line width state.
+	VkViewport viewport = gfx_get_viewport_(
+		&rPass->state.viewport, rPass->build.fWidth, rPass->build.fHeight);
+	VkRect2D scissor = gfx_get_scissor_(
+		&rPass->state.scissor, rPass->build.fWidth, rPass->build.fHeight);
+
+	recorder->state.viewport = rPass->state.viewport;
+	recorder->state.scissor = rPass->state.scissor;
+	recorder->state.lineWidth = 1.0f; // Also set a default line width.
+
+	context->vk.CmdSetViewport(cmd, 0, 1, &viewport);
+	context->vk.CmdSetScissor(cmd, 0, 1, &scissor);
+	context->vk.CmdSetLineWidth(cmd, recorder->state.lineWidth);
+
+	if (stat != NULL)
+		stat->vk.viewport = viewport,
+		stat->vk.scissor = scissor;
+
+	// Set recording input & state, record, unset input & reset state.
+	recorder->inp.pass = pass;
+	recorder->inp.cmd = cmd;
+	recorder->inp.stat = stat;
+
+	recorder->state.pipeline = NULL;
+	recorder->state.primitive = NULL;
+	recorder->state.pushSize = 0;
+	recorder->state.pushStages = 0;
+
+	// If deferred, capture all commands so we can sort them afterwards.
+	if (recorder->defer.enabled)
+	{
+		gfx_recorder_defer_reset_(recorder);
+		recorder->defer.active = 1;
+	}
+
+	cb(recorder, ptr);
+
+	if (recorder->defer.active)
+	{
+		// Restore the actually recorded state, then sort & record.
+		recorder->state.viewport = rPass->state.viewport;
+		recorder->state.scissor = rPass->state.scissor;
+		recorder->state.lineWidth = 1.0f;
+
+		gfx_recorder_emit_(recorder);
+	}
+
+	recorder->inp.pass = NULL;
+	recorder->inp.cmd = NULL;
+	recorder->inp.stat = NULL;
+
+	gfx_vec_release(&recorder->state.sets);
+	gfx_vec_release(&recorder->state.offsets);
+
+	// End recording.
+	GFX_VK_CHECK_(
+		context->vk.EndCommandBuffer(cmd),
+		return 0);
+
+	return 1;
+}
+
+/****************************
+ * Render callback for a range of work items, calls the user callback.
+ * @param ptr Must be a GFXRenderChunk_*.
+ */
+static void gfx_recorder_chunk_(GFXRecorder* recorder, void* ptr)
+{
+	GFXRenderChunk_* chunk = ptr;
+	GFXRenderJob_* job = chunk->job;
+
+	job->cb(recorder, chunk->first, chunk->count, job->ptr);
+}
+
+/****************************
+ * Job function of a parallel render recording job.
+ * Records into a command buffer of the worker's recorder,
+ * which is output with the first work item as order.
+ * @param ptr Must be a GFXRenderJob_*.
+ */
+static void gfx_recorder_job_(size_t worker, size_t first, size_t count,
+                              void* ptr)
+{
+	GFXRenderJob_* job = ptr;
+	GFXRecorder* recorder =
+		*(GFXRecorder**)gfx_vec_at(&job->recorder->workers, worker);
+
+	GFXRenderChunk_ chunk = {
+		.job = job,
+		.first = first,
+		.count = count
+	};
+
+	VkCommandBuffer cmd = gfx_recorder_claim_(recorder, GFX_PASS_RENDER);
+
+	if (
+		cmd == NULL ||
+		!gfx_recorder_render_(recorder, job->pass, cmd, job->framebuffer,
+			NULL, gfx_recorder_chunk_, &chunk) ||
+		!gfx_recorder_output_(recorder, (unsigned int)first, cmd))
+	{
+		atomic_store_explicit(&job->failed, 1, memory_order_relaxed);
+	}
+}
+
+/****************************
+ * Records an indirect draw with its draw count read from a buffer.
+ * @param recorder   Cannot be NULL.
+ * @param renderable Cannot be NULL.
+ * @param indexed    Non-zero to record an indexed draw.
+ * @see gfx_cmd_draw(_indexed)_from_count.
+ */
+static void gfx_recorder_draw_count_(GFXRecorder* recorder,
+                                     GFXRenderable* renderable, bool indexed,
+                                     uint32_t maxCount, uint32_t stride,
+                                     GFXBufferRef ref, GFXBufferRef countRef)
+{
+	GFXContext_* context = recorder->context;
+
+	// Check if the device can draw indirect counts at all.
+	if (!(context->features & GFX_SUPPORT_INDIRECT_COUNT_))
+	{
+		gfx_log_error(
+			"Indirect draw counts are not supported by the device; "
+			"command not recorded.");
+
+		return;
+	}
+
+	// Unpack references & validate.
+	GFXUnpackRef_ unp = gfx_ref_unpack_(ref);
+	GFXUnpackRef_ countUnp = gfx_ref_unpack_(countRef);
+
+	if (unp.obj.buffer == NULL || countUnp.obj.buffer == NULL)
+	{
+		gfx_log_error(
+			"Failed to retrieve indirect buffer during draw command; "
+			"command not recorded.");
+
+		return;
+	}
+
+	// Defer the draw command if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_(recorder, renderable, &(GFXDeferCmd_){
+			.type = indexed ?
+				GFX_DEFER_DRAW_INDEXED_INDIRECT_COUNT_ :
+				GFX_DEFER_DRAW_INDIRECT_COUNT_,
+			.indirect = {
+				.buffer = unp.obj.buffer->vk.buffer,
+				.offset = unp.value,
+				.count = maxCount,
+				.stride = stride,
+				.countBuffer = countUnp.obj.buffer->vk.buffer,
+				.countOffset = countUnp.value
+			}
+		});
+
+		return;
+	}
+
+	// Bind pipeline.
+	if (!gfx_recorder_bind_renderable_(recorder, renderable))
+	{
+		gfx_log_error(
+			"Failed to get Vulkan graphics pipeline during draw command; "
+			"command not recorded.");
 
-	// Super early return, apparently we are going to skip all sets.
-	// i.e. we are not going to bind anything new; done.
-	if (skipSets >= numSets)
 		return;
+	}
+
+	// Bind primitive.
+	if (renderable->primitive != NULL)
+		gfx_recorder_bind_primitive_(recorder, renderable->primitive);
+
+	// Record the draw command.
+	if (indexed)
+		context->vk.CmdDrawIndexedIndirectCount(recorder->inp.cmd,
+			unp.obj.buffer->vk.buffer, unp.value,
+			countUnp.obj.buffer->vk.buffer, countUnp.value,
+			maxCount, stride);
+	else
+		context->vk.CmdDrawIndirectCount(recorder->inp.cmd,
+			unp.obj.buffer->vk.buffer, unp.value,
+			countUnp.obj.buffer->vk.buffer, countUnp.value,
+			maxCount, stride);
+}
+
+/****************************/
+bool gfx_recorder_reset_(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	GFXContext_* context = recorder->context;
+
+	// Clear output & statistics.
+	gfx_vec_release(&recorder->out.cmds);
+	recorder->defer.saved = 0;
+
+	// Set new current recording pools.
+	recorder->current = recorder->renderer->current;
+
+	// Then reset both graphics & compute.
+	GFXRecorderPool_* pools = &recorder->pools[recorder->current * 2];
+
+	// Static recordings are not reset, they are just not used yet.
+	for (size_t s = 0; s < pools[0].statics.size; ++s)
+		((GFXRecorderStatic_*)gfx_vec_at(&pools[0].statics, s))->used = 0;
+
+	for (unsigned int p = 0; p < 2; ++p)
+	{
+		// If the pool did not use some command buffers, free them.
+		if (pools[p].used < pools[p].vk.cmds.size)
+		{
+			uint32_t unused =
+				(uint32_t)(pools[p].vk.cmds.size - pools[p].used);
+
+			context->vk.FreeCommandBuffers(context->vk.device,
+				pools[p].vk.pool, unused,
+				gfx_vec_at(&pools[p].vk.cmds, pools[p].used));
+
+			gfx_vec_pop(&pools[p].vk.cmds, (size_t)unused);
+		}
+
+		// Try to reset the command pool.
+		GFX_VK_CHECK_(context->vk.ResetCommandPool(
+			context->vk.device, pools[p].vk.pool, 0), return 0);
+
+		// No command buffers are in use anymore.
+		pools[p].used = 0;
+	}
+
+	// And reset all worker recorders.
+	for (size_t w = 0; w < recorder->workers.size; ++w)
+		if (!gfx_recorder_reset_(*(GFXRecorder**)gfx_vec_at(&recorder->workers, w)))
+			return 0;
+
+	return 1;
+}
+
+/****************************/
+void gfx_recorder_record_(GFXRecorder* recorder,
+                          unsigned int order, VkCommandBuffer cmd)
+{
+	assert(recorder != NULL);
+	assert(cmd != NULL);
+
+	GFXContext_* context = recorder->context;
+
+	// Do a binary search to find the left-most command buffer of this order.
+	size_t l = 0;
+	size_t r = recorder->out.cmds.size;
+
+	while (l < r)
+	{
+		const size_t p = (l + r) >> 1;
+		const GFXCmdElem_* e = gfx_vec_at(&recorder->out.cmds, p);
+
+		if (e->order < order) l = p + 1;
+		else r = p;
+	}
+
+	// Then find the right-most command buffer of this order.
+	while (r < recorder->out.cmds.size)
+	{
+		const GFXCmdElem_* e = gfx_vec_at(&recorder->out.cmds, r);
+		if (e->order > order) break;
+		else ++r;
+	}
+
+	// Finally record them all into the given command buffer.
+	if (r > l)
+	{
+		VkCommandBuffer buffs[r-l];
+		for (size_t i = l; i < r; ++i) buffs[i-l] =
+			((GFXCmdElem_*)gfx_vec_at(&recorder->out.cmds, i))->cmd;
+
+		context->vk.CmdExecuteCommands(cmd, (uint32_t)(r-l), buffs);
+	}
+}
+
+/****************************
+ * Creates a new recorder, without linking it into the renderer.
+ * @param renderer Cannot be NULL.
+ * @return NULL on failure.
+ *
+ * Can be called during recording, but only for worker recorders.
+ */
+static GFXRecorder* gfx_recorder_create_(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+
+	GFXContext_* context = renderer->cache.context;
+
+	// Allocate a new recorder.
+	GFXRecorder* rec = malloc(
+		sizeof(GFXRecorder) +
+		sizeof(GFXRecorderPool_) * renderer->numFrames * 2);
+
+	if (rec == NULL)
+		return NULL;
+
+	// Create two command pools for each frame.
+	// One for the graphics family and one for the compute family.
+	VkCommandPoolCreateInfo gcpci = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+
+		.pNext            = NULL,
+		.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = renderer->graphics.family
+	};
+
+	VkCommandPoolCreateInfo ccpci = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+
+		.pNext            = NULL,
+		.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = renderer->compute.family
+	};
+
+	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	{
+		// Graphics pool.
+		GFX_VK_CHECK_(
+			context->vk.CreateCommandPool(
+				context->vk.device, &gcpci, NULL, &rec->pools[i*2].vk.pool),
+			{
+				goto destroy_prev_pools;
+			});
+
+		// Compute pool.
+		GFX_VK_CHECK_(
+			context->vk.CreateCommandPool(
+				context->vk.device, &ccpci, NULL, &rec->pools[i*2+1].vk.pool),
+			{
+				// Destroy graphics, then clean the rest.
+				context->vk.DestroyCommandPool(
+					context->vk.device, rec->pools[i*2].vk.pool, NULL);
+
+				goto destroy_prev_pools;
+			});
+
+		continue; // Success!
+
+	destroy_prev_pools:
+		// If it failed, destroy all previous pools.
+		for (; i > 0; --i)
+		{
+			context->vk.DestroyCommandPool(
+				context->vk.device, rec->pools[i*2-1].vk.pool, NULL);
+			context->vk.DestroyCommandPool(
+				context->vk.device, rec->pools[i*2-2].vk.pool, NULL);
+		}
+
+		free(rec);
+		return NULL;
+	}
+
+	// Initialize the rest of the pools.
+	rec->renderer = renderer;
+	rec->context = context;
+	rec->inp.pass = NULL;
+	rec->inp.cmd = NULL;
+	rec->inp.stat = NULL;
+	rec->isStatic = 0;
+	gfx_vec_init(&rec->workers, sizeof(GFXRecorder*));
+	gfx_vec_init(&rec->state.sets, sizeof(GFXSetElem_));
+	gfx_vec_init(&rec->state.offsets, sizeof(uint32_t));
+	gfx_vec_init(&rec->out.cmds, sizeof(GFXCmdElem_));
+
+	rec->defer.enabled = 0;
+	rec->defer.active = 0;
+	rec->defer.saved = 0;
+	gfx_vec_init(&rec->defer.cmds, sizeof(GFXDeferCmd_));
+	gfx_vec_init(&rec->defer.data, sizeof(char));
+	gfx_vec_init(&rec->defer.sets, sizeof(GFXDeferSet_));
+	gfx_vec_init(&rec->defer.offsets, sizeof(uint32_t));
+	gfx_vec_init(&rec->defer.key, sizeof(char));
+	gfx_map_init(&rec->defer.binds, 0, gfx_hash_murmur3_, gfx_hash_cmp_);
+
+	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	{
+		rec->pools[i*2].used = 0;
+		rec->pools[i*2+1].used = 0;
+		rec->pools[i*2].vk.statics = VK_NULL_HANDLE;
+		rec->pools[i*2+1].vk.statics = VK_NULL_HANDLE;
+		gfx_vec_init(&rec->pools[i*2].statics, sizeof(GFXRecorderStatic_));
+		gfx_vec_init(&rec->pools[i*2+1].statics, sizeof(GFXRecorderStatic_));
+		gfx_vec_init(&rec->pools[i*2].vk.cmds, sizeof(VkCommandBuffer));
+		gfx_vec_init(&rec->pools[i*2+1].vk.cmds, sizeof(VkCommandBuffer));
+	}
+
+	// Take the renderer's current frame index and use it for the recorder's
+	// current frame index. Does not have to be atomic, as this could only
+	// go wrong during gfx_frame_submit, but we are not allowed to call
+	// this function until the frame is submitted anyway, so we're good.
+	rec->current = renderer->current;
+
+	// Init subordinate, using the renderer's lock for access to the pool!
+	gfx_mutex_lock_(&renderer->lock);
+	gfx_pool_sub_(&renderer->pool, &rec->sub);
+	gfx_mutex_unlock_(&renderer->lock);
+
+	return rec;
+}
+
+/****************************
+ * Destroys a recorder (and its worker recorders), must be unlinked.
+ * @param recorder Cannot be NULL.
+ */
+static void gfx_recorder_destroy_(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	GFXRenderer* renderer = recorder->renderer;
+
+	// Destroy all worker recorders first.
+	for (size_t w = 0; w < recorder->workers.size; ++w)
+		gfx_recorder_destroy_(*(GFXRecorder**)gfx_vec_at(&recorder->workers, w));
+
+	// Undo subordinate, locking for access to the pool!
+	gfx_mutex_lock_(&renderer->lock);
+	gfx_pool_unsub_(&renderer->pool, &recorder->sub);
+	gfx_mutex_unlock_(&renderer->lock);
+
+	// We need to make the command pools stale,
+	// as its command buffers might still be in use by pending virtual frames!
+	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	{
+		// Graphics & compute pools.
+		gfx_push_stale_(renderer,
+			VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
+			recorder->pools[i*2].vk.pool, VK_NULL_HANDLE);
+		gfx_push_stale_(renderer,
+			VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
+			recorder->pools[i*2+1].vk.pool, VK_NULL_HANDLE);
+
+		// And the static pool.
+		if (recorder->pools[i*2].vk.statics != VK_NULL_HANDLE)
+			gfx_push_stale_(renderer,
+				VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
+				recorder->pools[i*2].vk.statics, VK_NULL_HANDLE);
+	}
+
+	// Free all the memory.
+	for (unsigned int i = 0; i < renderer->numFrames; ++i)
+	{
+		GFXVec* statics = &recorder->pools[i*2].statics;
+		for (size_t s = 0; s < statics->size; ++s)
+			gfx_vec_clear(&((GFXRecorderStatic_*)gfx_vec_at(statics, s))->sets);
+
+		gfx_vec_clear(&recorder->pools[i*2].statics);
+		gfx_vec_clear(&recorder->pools[i*2+1].statics);
+		gfx_vec_clear(&recorder->pools[i*2].vk.cmds);
+		gfx_vec_clear(&recorder->pools[i*2+1].vk.cmds);
+	}
+
+	gfx_vec_clear(&recorder->workers);
+	gfx_vec_clear(&recorder->state.sets);
+	gfx_vec_clear(&recorder->state.offsets);
+	gfx_vec_clear(&recorder->out.cmds);
+	gfx_vec_clear(&recorder->defer.cmds);
+	gfx_vec_clear(&recorder->defer.data);
+	gfx_vec_clear(&recorder->defer.sets);
+	gfx_vec_clear(&recorder->defer.offsets);
+	gfx_vec_clear(&recorder->defer.key);
+	gfx_map_clear(&recorder->defer.binds);
+	free(recorder);
+}
+
+/****************************/
+GFX_API GFXRecorder* gfx_renderer_add_recorder(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+	assert(!renderer->recording);
+
+	GFXRecorder* rec = gfx_recorder_create_(renderer);
+	if (rec == NULL)
+	{
+		gfx_log_error("Could not add a new recorder to a renderer.");
+		return NULL;
+	}
+
+	// Link the recorder into the renderer.
+	// Modifying the renderer, lock!
+	gfx_mutex_lock_(&renderer->lock);
+	gfx_list_insert_after(&renderer->recorders, &rec->list, NULL);
+	gfx_mutex_unlock_(&renderer->lock);
+
+	return rec;
+}
+
+/****************************/
+GFX_API void gfx_erase_recorder(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+	assert(!recorder->renderer->recording);
+
+	GFXRenderer* renderer = recorder->renderer;
+
+	// Unlink itself from the renderer.
+	// Modifying the renderer, lock!
+	gfx_mutex_lock_(&renderer->lock);
+	gfx_list_erase(&renderer->recorders, &recorder->list);
+	gfx_mutex_unlock_(&renderer->lock);
+
+	gfx_recorder_destroy_(recorder);
+}
+
+/****************************/
+GFX_API GFXRenderer* gfx_recorder_get_renderer(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	return recorder->renderer;
+}
+
+/****************************/
+GFX_API void gfx_recorder_render(GFXRecorder* recorder, GFXPass* pass,
+                                 void (*cb)(GFXRecorder*, void*),
+                                 void* ptr)
+{
+	assert(recorder != NULL);
+	assert(recorder->renderer->recording);
+	assert(pass != NULL);
+	assert(pass->renderer == recorder->renderer);
+	assert(cb != NULL);
+
+	GFXRenderPass_* rPass = (GFXRenderPass_*)pass;
+	GFXRecorderStatic_* stat = NULL;
+
+	// Ignore if pass is culled.
+	if (pass->culled) return;
 
-	// Initialize bound dynamic offset state.
-	// Just allocate missing values, no need to initialize them.
-	// Only happens when something got disturbed.
-	// If anything is disturbed, trailing offsets will be unused.
-	if (
-		tOffsetInd > recorder->state.offsets.size &&
-		!gfx_vec_push(
-			&recorder->state.offsets,
-			tOffsetInd - recorder->state.offsets.size,
-			NULL))
+	// Get the framebuffer to inherit.
+	VkFramebuffer framebuffer;
+	if (!gfx_recorder_framebuffer_(recorder, pass, &framebuffer))
+		goto error;
+
+	// Then, claim a command buffer to use.
+	// If static, try to reuse a previous recording instead.
+	VkCommandBuffer cmd;
+
+	if (recorder->isStatic)
 	{
-		gfx_log_error(
-			"Could not initialize bound offset state during bind command; "
-			"command not recorded.");
+		stat = gfx_recorder_static_(recorder, pass);
+		if (stat == NULL) goto error;
 
-		return;
+		if (gfx_recorder_static_check_(recorder, stat))
+		{
+			if (!gfx_recorder_output_(recorder, pass->order, stat->vk.cmd))
+				goto error;
+
+			return;
+		}
+
+		// Re-record, without inheriting a framebuffer,
+		// so it can be reused with any (swapchain) framebuffer.
+		cmd = stat->vk.cmd;
+		framebuffer = VK_NULL_HANDLE;
+
+		gfx_vec_release(&stat->sets);
+		stat->gen = GFX_PASS_GEN_(rPass);
+		stat->valid = 1;
+	}
+	else
+	{
+		cmd = gfx_recorder_claim_(recorder, pass->type);
+		if (cmd == NULL) goto error;
 	}
 
-	// Now we have validated everything, set new bound state.
-	recorder->state.pushSize = technique->pushSize;
-	recorder->state.pushStages = technique->pushStages;
+	// Record & insert the command buffer in its correct position.
+	// Which is in submission order of the passes.
+	if (!gfx_recorder_render_(recorder, pass, cmd, framebuffer, stat, cb, ptr))
+		goto error;
 
-	offsetInd = 0; // In the input `offsets` array.
-	bOffsetInd = 0; // In newly bound offsets.
+	if (!gfx_recorder_output_(recorder, pass->order, cmd))
+		goto error;
 
-	for (size_t s = 0; s < recorder->state.sets.size; ++s)
+	return;
+
+
+	// Error on failure.
+error:
+	if (stat != NULL) stat->valid = 0;
+	gfx_log_error("Recorder failed to record render commands.");
+}
+
+/****************************/
+GFX_API void gfx_recorder_render_range(GFXRecorder* recorder, GFXPass* pass,
+                                       size_t numItems, size_t grain,
+                                       void (*cb)(GFXRecorder*, size_t, size_t, void*),
+                                       void* ptr)
+{
+	assert(recorder != NULL);
+	assert(recorder->renderer->recording);
+	assert(pass != NULL);
+	assert(pass->renderer == recorder->renderer);
+	assert(numItems <= UINT32_MAX);
+	assert(cb != NULL);
+
+	// Ignore if pass is culled or there is nothing to record.
+	if (pass->culled || numItems == 0) return;
+
+	GFXRenderJob_ job = {
+		.recorder = recorder,
+		.pass = pass,
+		.cb = cb,
+		.ptr = ptr
+	};
+
+	atomic_init(&job.failed, 0);
+
+	// Get the framebuffer to inherit.
+	if (!gfx_recorder_framebuffer_(recorder, pass, &job.framebuffer))
+		goto error;
+
+	// Make sure there is a recorder for each worker.
+	// These record into their own command pools, so they can run in parallel.
+	const size_t numWorkers = gfx_job_get_num_workers();
+
+	while (recorder->workers.size < numWorkers)
 	{
-		GFXSetElem_* bound = gfx_vec_at(&recorder->state.sets, s);
-		uint32_t* bOffsets = gfx_vec_at(&recorder->state.offsets, bOffsetInd);
+		GFXRecorder* rec = gfx_recorder_create_(recorder->renderer);
+		if (rec == NULL) goto error;
 
-		// Sets before or after the given range.
-		if (s < firstSet)
+		if (!gfx_vec_push(&recorder->workers, 1, &rec))
 		{
-			// If disturbed, invalidate the bound data.
-			if (disturbedFrom <= s)
+			gfx_recorder_destroy_(rec);
+			goto error;
+		}
+	}
+
+	for (size_t w = 0; w < numWorkers; ++w)
+	{
+		GFXRecorder* rec = *(GFXRecorder**)gfx_vec_at(&recorder->workers, w);
+		rec->defer.enabled = recorder->defer.enabled;
+	}
+
+	// Record all work items in parallel.
+	gfx_job_for(numItems, grain, gfx_recorder_job_, &job);
+
+	{
+		// Stitch all command buffers back together in order of work items.
+		// The output of each worker is already sorted, so merge them.
+		size_t heads[numWorkers];
+		for (size_t w = 0; w < numWorkers; ++w) heads[w] = 0;
+
+		while (1)
+		{
+			const GFXCmdElem_* next = NULL;
+			size_t nextWorker = 0;
+
+			for (size_t w = 0; w < numWorkers; ++w)
 			{
-				bound->setLayout = NULL;
-				bound->set = NULL;
-				bound->elem = NULL;
-				bound->numDynamics = technique->sets[s].numDynamics;
+				GFXRecorder* rec = *(GFXRecorder**)gfx_vec_at(&recorder->workers, w);
+				if (heads[w] >= rec->out.cmds.size) continue;
+
+				const GFXCmdElem_* elem = gfx_vec_at(&rec->out.cmds, heads[w]);
+				if (next == NULL || elem->order < next->order)
+					next = elem, nextWorker = w;
 			}
+
+			if (next == NULL) break;
+			++heads[nextWorker];
+
+			// Equal orders are inserted in call order, so this keeps them sorted.
+			if (!gfx_recorder_output_(recorder, pass->order, next->cmd))
+				atomic_store_explicit(&job.failed, 1, memory_order_relaxed);
+		}
+	}
+
+	// Clear worker output & gather statistics.
+	for (size_t w = 0; w < numWorkers; ++w)
+	{
+		GFXRecorder* rec = *(GFXRecorder**)gfx_vec_at(&recorder->workers, w);
+		gfx_vec_release(&rec->out.cmds);
+
+		recorder->defer.saved += rec->defer.saved;
+		rec->defer.saved = 0;
+	}
+
+	if (!atomic_load_explicit(&job.failed, memory_order_relaxed))
+		return;
+
+
+	// Error on failure.
+error:
+	gfx_log_error("Recorder failed to record render commands in parallel.");
+}
+
+/****************************/
+GFX_API void gfx_recorder_compute(GFXRecorder* recorder, GFXPass* pass,
+                                  void (*cb)(GFXRecorder*, void*),
+                                  void* ptr)
+{
+	assert(recorder != NULL);
+	assert(recorder->renderer->recording);
+	assert(pass != NULL);
+	assert(pass->renderer == recorder->renderer);
+	assert(cb != NULL);
+
+	GFXContext_* context = recorder->context;
+
+	// Ignore if pass is culled.
+	if (pass->culled) return;
+
+	// The pass must be a compute pass.
+	if (pass->type == GFX_PASS_RENDER) goto error;
+
+	// Then, claim a command buffer to use.
+	VkCommandBuffer cmd = gfx_recorder_claim_(recorder, pass->type);
+	if (cmd == NULL) goto error;
+
+	// Start recording with it.
+	VkCommandBufferBeginInfo cbbi = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+
+		.pNext = NULL,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+
+		.pInheritanceInfo = (VkCommandBufferInheritanceInfo[]){{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+
+			.pNext       = NULL,
+			.renderPass  = VK_NULL_HANDLE,
+			.subpass     = 0,
+			.framebuffer = VK_NULL_HANDLE,
+
+			.occlusionQueryEnable = VK_FALSE,
+			.queryFlags           = 0,
+			.pipelineStatistics   = 0
+		}}
+	};
+
+	GFX_VK_CHECK_(
+		context->vk.BeginCommandBuffer(cmd, &cbbi),
+		goto error);
+
+	// Set recording input & state, record, unset input & reset state.
+	recorder->inp.pass = pass;
+	recorder->inp.cmd = cmd;
+
+	recorder->state.pipeline = NULL;
+	recorder->state.primitive = NULL;
+	recorder->state.pushSize = 0;
+	recorder->state.pushStages = 0;
+
+	cb(recorder, ptr);
+
+	recorder->inp.pass = NULL;
+	recorder->inp.cmd = NULL;
+
+	gfx_vec_release(&recorder->state.sets);
+	gfx_vec_release(&recorder->state.offsets);
+
+	// End recording.
+	GFX_VK_CHECK_(
+		context->vk.EndCommandBuffer(cmd),
+		goto error);
+
+	// Now insert the command buffer in its correct position.
+	// Which is in submission order of the passes.
+	if (!gfx_recorder_output_(recorder, pass->order, cmd))
+		goto error;
+
+	return;
+
+
+	// Error on failure.
+error:
+	gfx_log_error("Recorder failed to record compute commands.");
+}
+
+/****************************/
+GFX_API void gfx_recorder_set_deferred(GFXRecorder* recorder, bool deferred)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.pass == NULL);
+
+	recorder->defer.enabled = deferred;
+}
+
+/****************************/
+GFX_API uint64_t gfx_recorder_get_saved_binds(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	return recorder->defer.saved;
+}
+
+/****************************/
+GFX_API void gfx_recorder_set_static(GFXRecorder* recorder, bool isStatic)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.pass == NULL);
+
+	recorder->isStatic = isStatic;
+}
+
+/****************************/
+GFX_API void gfx_recorder_invalidate(GFXRecorder* recorder, GFXPass* pass)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.pass == NULL);
+
+	// Invalidate for all virtual frames.
+	for (unsigned int i = 0; i < recorder->renderer->numFrames; ++i)
+	{
+		GFXVec* statics = &recorder->pools[i*2].statics;
+
+		for (size_t s = 0; s < statics->size; ++s)
+		{
+			GFXRecorderStatic_* stat = gfx_vec_at(statics, s);
+			if (pass == NULL || stat->pass == pass) stat->valid = 0;
 		}
+	}
+}
+
+/****************************/
+GFX_API unsigned int gfx_recorder_get_frame_index(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	return recorder->current;
+}
+
+/****************************/
+GFX_API GFXPass* gfx_recorder_get_pass(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+
+	return recorder->inp.pass;
+}
+
+/****************************/
+GFX_API void gfx_recorder_get_size(GFXRecorder* recorder,
+                                   uint32_t* width, uint32_t* height, uint32_t* layers)
+{
+	assert(recorder != NULL);
+	assert(width != NULL);
+	assert(height != NULL);
+	assert(layers != NULL);
+
+	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
+		*width = ((GFXRenderPass_*)recorder->inp.pass)->build.fWidth,
+		*height = ((GFXRenderPass_*)recorder->inp.pass)->build.fHeight,
+		*layers = ((GFXRenderPass_*)recorder->inp.pass)->build.fLayers;
+	else
+		// Output 0,0,0 if no associated pass.
+		*width = 0,
+		*height = 0,
+		*layers = 0;
+}
+
+/****************************/
+GFX_API void gfx_pass_get_size(GFXPass* pass,
+                               uint32_t* width, uint32_t* height, uint32_t* layers)
+{
+	assert(pass != NULL);
+	assert(width != NULL);
+	assert(height != NULL);
+	assert(layers != NULL);
 
-		// Sets within the given range.
-		else if (s < firstSet + numSets)
-		{
-			// Update bound data if not skipping.
-			const size_t setInd = s - firstSet;
+	if (!pass->culled && pass->type == GFX_PASS_RENDER)
+		*width = ((GFXRenderPass_*)pass)->build.fWidth,
+		*height = ((GFXRenderPass_*)pass)->build.fHeight,
+		*layers = ((GFXRenderPass_*)pass)->build.fLayers;
+	else
+		*width = 0,
+		*height = 0,
+		*layers = 0;
+}
 
-			if (setInd >= skipSets)
-			{
-				bound->setLayout = sets[setInd]->setLayout;
-				bound->set = sets[setInd];
-				bound->elem = pElems[setInd];
-				bound->numDynamics = sets[setInd]->numDynamics;
+/****************************/
+GFX_API GFXViewport gfx_recorder_get_viewport(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
 
-				for (size_t d = 0; d < bound->numDynamics; ++d)
-					bOffsets[d] = (offsetInd + d < numDynamics) ?
-						offsets[offsetInd + d] : 0;
-			}
+	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
+		return recorder->state.viewport;
+	else
+		return (GFXViewport){
+			.size = GFX_SIZE_ABSOLUTE,
+			.x = 0.0f,
+			.y = 0.0f,
+			.width = 0.0f,
+			.height = 0.0f,
+			.minDepth = 0.0f,
+			.maxDepth = 0.0f
+		};
+}
 
-			offsetInd += sets[setInd]->numDynamics;
-		}
+/****************************/
+GFX_API GFXScissor gfx_recorder_get_scissor(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
 
-		// Sets after the given range.
-		// Simply completely invalidate if disturbed.
-		else if (disturbedFrom <= s)
-		{
-			bound->setLayout = NULL;
-			bound->set = NULL;
-			bound->elem = NULL;
-			bound->numDynamics = 0;
-		}
+	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
+		return recorder->state.scissor;
+	else
+		return (GFXScissor){
+			.size = GFX_SIZE_ABSOLUTE,
+			.x = 0,
+			.y = 0,
+			.width = 0,
+			.height = 0
+		};
+}
 
-		// Apparently nothing got disturbed, we're done.
-		else break;
+/****************************/
+GFX_API float gfx_recorder_get_line_width(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
 
-		// Use newly bound number of dynamics to advance.
-		bOffsetInd += bound->numDynamics;
-	}
+	if (recorder->inp.pass && recorder->inp.pass->type == GFX_PASS_RENDER)
+		return recorder->state.lineWidth;
+	else
+		return 0.0f;
+}
 
-	// Record the bind command.
-	const VkPipelineBindPoint bindPoint =
-		technique->shaders[GFX_GET_SHADER_STAGE_INDEX_(GFX_STAGE_COMPUTE)] == NULL ?
-		VK_PIPELINE_BIND_POINT_GRAPHICS :
-		VK_PIPELINE_BIND_POINT_COMPUTE;
+/****************************/
+GFX_API void gfx_cmd_bind(GFXRecorder* recorder, GFXTechnique* technique,
+                          size_t firstSet,
+                          size_t numSets, size_t numDynamics,
+                          GFXSet** sets,
+                          const uint32_t* offsets)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.cmd != NULL);
+	assert(technique != NULL);
+	assert(technique->renderer == recorder->renderer);
+	assert(firstSet < technique->numSets);
+	assert(numSets > 0);
+	assert(numSets <= technique->numSets - firstSet);
+	assert(sets != NULL);
+	assert(numDynamics == 0 || offsets != NULL);
 
-	if (numOffsets == 0 || numDynamics >= skipOffsets + numOffsets)
+	// Check technique.
+	if (technique->layout == NULL)
 	{
-		// If enough dynamic offsets are given, just pass that array.
-		context->vk.CmdBindDescriptorSets(recorder->inp.cmd,
-			bindPoint, technique->vk.layout,
-			(uint32_t)(firstSet + skipSets),
-			(uint32_t)(numSets - skipSets),
-			dSets + skipSets,
-			(uint32_t)numOffsets, offsets + skipOffsets);
+		gfx_log_error(
+			"Technique not locked during bind command; "
+			"command not recorded.");
+
+		return;
 	}
-	else
-	{
-		// If not, create a new array,
-		// set all trailing 'empty' offsets to 0.
-		uint32_t offs[GFX_MAX(1, numOffsets)];
 
-		for (size_t d = 0; d < numOffsets; ++d)
-			offs[d] = (skipOffsets + d < numDynamics) ?
-				offsets[skipOffsets + d] : 0;
+	// Only update the deferred state if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_bind_(recorder, technique,
+			firstSet, numSets, numDynamics, sets, offsets);
 
-		context->vk.CmdBindDescriptorSets(recorder->inp.cmd,
-			bindPoint, technique->vk.layout,
-			(uint32_t)(firstSet + skipSets),
-			(uint32_t)(numSets - skipSets),
-			dSets + skipSets,
-			(uint32_t)numOffsets, offs);
+		return;
 	}
+
+	gfx_recorder_bind_(recorder, technique,
+		firstSet, numSets, numDynamics, sets, NULL, NULL, offsets);
 }
 
 /****************************/
@@ -1226,6 +2784,16 @@ GFX_API void gfx_cmd_push(GFXRecorder* recorder, GFXTechnique* technique,
 	if (size == 0)
 		size = technique->pushSize - offset;
 
+	// Only update the deferred state if deferring.
+	if (recorder->defer.active)
+	{
+		if (!gfx_recorder_defer_push_(recorder, technique, offset, size, data))
+			gfx_log_error(
+				"Could not defer push command; command not recorded.");
+
+		return;
+	}
+
 	// Record the push command.
 	context->vk.CmdPushConstants(recorder->inp.cmd,
 		technique->vk.layout,
@@ -1257,6 +2825,23 @@ GFX_API void gfx_cmd_draw(GFXRecorder* recorder, GFXRenderable* renderable,
 	if (vertices == 0)
 		vertices = renderable->primitive->numVertices - firstVertex;
 
+	// Defer the draw command if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_(recorder, renderable, &(GFXDeferCmd_){
+			.type = GFX_DEFER_DRAW_,
+			.direct = {
+				.count = vertices,
+				.instances = instances,
+				.first = firstVertex,
+				.vertexOffset = 0,
+				.firstInstance = firstInstance
+			}
+		});
+
+		return;
+	}
+
 	// Bind pipeline.
 	if (!gfx_recorder_bind_renderable_(recorder, renderable))
 	{
@@ -1301,6 +2886,23 @@ GFX_API void gfx_cmd_draw_indexed(GFXRecorder* recorder, GFXRenderable* renderab
 	if (indices == 0)
 		indices = renderable->primitive->numIndices - firstIndex;
 
+	// Defer the draw command if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_(recorder, renderable, &(GFXDeferCmd_){
+			.type = GFX_DEFER_DRAW_INDEXED_,
+			.direct = {
+				.count = indices,
+				.instances = instances,
+				.first = firstIndex,
+				.vertexOffset = vertexOffset,
+				.firstInstance = firstInstance
+			}
+		});
+
+		return;
+	}
+
 	// Bind pipeline.
 	if (!gfx_recorder_bind_renderable_(recorder, renderable))
 	{
@@ -1369,6 +2971,22 @@ GFX_API void gfx_cmd_draw_from(GFXRecorder* recorder, GFXRenderable* renderable,
 		return;
 	}
 
+	// Defer the draw command if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_(recorder, renderable, &(GFXDeferCmd_){
+			.type = GFX_DEFER_DRAW_INDIRECT_,
+			.indirect = {
+				.buffer = unp.obj.buffer->vk.buffer,
+				.offset = unp.value,
+				.count = count,
+				.stride = stride
+			}
+		});
+
+		return;
+	}
+
 	// Bind pipeline.
 	if (!gfx_recorder_bind_renderable_(recorder, renderable))
 	{
@@ -1420,6 +3038,22 @@ GFX_API void gfx_cmd_draw_indexed_from(GFXRecorder* recorder, GFXRenderable* ren
 		return;
 	}
 
+	// Defer the draw command if deferring.
+	if (recorder->defer.active)
+	{
+		gfx_recorder_defer_(recorder, renderable, &(GFXDeferCmd_){
+			.type = GFX_DEFER_DRAW_INDEXED_INDIRECT_,
+			.indirect = {
+				.buffer = unp.obj.buffer->vk.buffer,
+				.offset = unp.value,
+				.count = count,
+				.stride = stride
+			}
+		});
+
+		return;
+	}
+
 	// Bind pipeline.
 	if (!gfx_recorder_bind_renderable_(recorder, renderable))
 	{
@@ -1439,6 +3073,196 @@ GFX_API void gfx_cmd_draw_indexed_from(GFXRecorder* recorder, GFXRenderable* ren
 		unp.obj.buffer->vk.buffer, unp.value, count, stride);
 }
 
+/****************************/
+GFX_API void gfx_cmd_draw_from_count(GFXRecorder* recorder, GFXRenderable* renderable,
+                                     uint32_t maxCount, uint32_t stride,
+                                     GFXBufferRef ref, GFXBufferRef countRef)
+{
+	assert(GFX_REF_IS_BUFFER(ref));
+	assert(GFX_REF_IS_BUFFER(countRef));
+	assert(recorder != NULL);
+	assert(recorder->inp.pass != NULL);
+	assert(recorder->inp.pass->type == GFX_PASS_RENDER);
+	assert(recorder->inp.cmd != NULL);
+	assert(renderable != NULL);
+	assert(renderable->pass == recorder->inp.pass);
+	assert(renderable->technique != NULL);
+	assert(stride == 0 ||
+		(stride % 4 == 0 && stride >= sizeof(GFXDrawCmd)));
+
+	// Tightly packed if asked.
+	if (stride == 0) stride = sizeof(GFXDrawCmd);
+
+	gfx_recorder_draw_count_(recorder, renderable, 0,
+		maxCount, stride, ref, countRef);
+}
+
+/****************************/
+GFX_API void gfx_cmd_draw_indexed_from_count(GFXRecorder* recorder, GFXRenderable* renderable,
+                                             uint32_t maxCount, uint32_t stride,
+                                             GFXBufferRef ref, GFXBufferRef countRef)
+{
+	assert(GFX_REF_IS_BUFFER(ref));
+	assert(GFX_REF_IS_BUFFER(countRef));
+	assert(recorder != NULL);
+	assert(recorder->inp.pass != NULL);
+	assert(recorder->inp.pass->type == GFX_PASS_RENDER);
+	assert(recorder->inp.cmd != NULL);
+	assert(renderable != NULL);
+	assert(renderable->pass == recorder->inp.pass);
+	assert(renderable->technique != NULL);
+	assert(stride == 0 ||
+		(stride % 4 == 0 && stride >= sizeof(GFXDrawIndexedCmd)));
+
+	// Tightly packed if asked.
+	if (stride == 0) stride = sizeof(GFXDrawIndexedCmd);
+
+	gfx_recorder_draw_count_(recorder, renderable, 1,
+		maxCount, stride, ref, countRef);
+}
+
+/****************************/
+GFX_API void gfx_cmd_draw_batch(GFXRecorder* recorder,
+                                size_t numDraws, const GFXBatchDraw* draws)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.pass != NULL);
+	assert(recorder->inp.pass->type == GFX_PASS_RENDER);
+	assert(recorder->inp.cmd != NULL);
+	assert(numDraws > 0);
+	assert(draws != NULL);
+
+	GFXRenderer* renderer = recorder->renderer;
+	GFXContext_* context = recorder->context;
+	const GFXDevice_* device = renderer->heap->allocator.device;
+
+	// Check if we can batch at all,
+	// deferred commands are sorted separately & static recordings
+	// cannot reference the per-frame buffer.
+	// Each multi-draw is limited to maxIndirectCount draws.
+	const uint32_t maxCount = device->base.limits.maxIndirectCount;
+
+	bool batch =
+		!recorder->defer.active &&
+		recorder->inp.stat == NULL &&
+		device->base.features.indirectMultiDraw &&
+		maxCount > 1;
+
+	for (size_t d = 0; batch && d < numDraws; ++d)
+		if (draws[d].firstInstance > 0)
+			batch = device->base.features.indirectFirstInstance;
+
+	// Claim space for all draw commands.
+	// Indexed commands are the largest, so allocate for those.
+	uint64_t offset = UINT64_MAX;
+
+	if (batch && gfx_stream_init_(renderer))
+		offset = gfx_stream_alloc_(renderer,
+			recorder->current, sizeof(GFXDrawIndexedCmd) * numDraws);
+
+	if (offset == UINT64_MAX)
+	{
+		for (size_t d = 0; d < numDraws; ++d)
+			gfx_cmd_draw_prim(recorder,
+				draws[d].renderable,
+				draws[d].instances, draws[d].firstInstance);
+
+		return;
+	}
+
+	VkBuffer buffer = ((GFXBuffer_*)renderer->stream.buffer)->vk.buffer;
+
+	// Record a multi-draw for every run of compatible draws.
+	for (size_t d = 0; d < numDraws; )
+	{
+		GFXRenderable* base = draws[d].renderable;
+
+		assert(base != NULL);
+		assert(base->pass == recorder->inp.pass);
+		assert(base->technique != NULL);
+		assert(base->primitive != NULL);
+
+		// Bind pipeline.
+		if (!gfx_recorder_bind_renderable_(recorder, base))
+		{
+			gfx_log_error(
+				"Failed to get Vulkan graphics pipeline during draw command; "
+				"command not recorded.");
+
+			++d;
+			continue;
+		}
+
+		// Bind primitive.
+		gfx_recorder_bind_primitive_(recorder, base->primitive);
+
+		// Write all draw commands to the (coherent) mapped buffer.
+		const bool indexed = base->primitive->numIndices > 0;
+		const uint64_t first = offset;
+		uint32_t count = 0;
+
+		for (; d < numDraws; ++d)
+		{
+			GFXRenderable* rend = draws[d].renderable;
+			GFXPrimitive* prim = rend->primitive;
+			GFXCacheElem_* elem;
+			uint32_t vertex;
+			uint32_t index;
+
+			assert(rend->pass == recorder->inp.pass);
+			assert(prim != NULL);
+			assert(draws[d].instances > 0);
+
+			// Stop the run if full or not compatible.
+			if (count >= maxCount || (count > 0 && (
+				!gfx_renderable_pipeline_(rend, &elem, 0) ||
+				elem != recorder->state.pipeline)))
+			{
+				break;
+			}
+
+			if (!gfx_recorder_rebase_(base->primitive, prim, &vertex, &index))
+				break;
+
+			void* ptr = renderer->stream.ptr + offset;
+
+			if (indexed)
+			{
+				*(GFXDrawIndexedCmd*)ptr = (GFXDrawIndexedCmd){
+					.indices = prim->numIndices,
+					.instances = draws[d].instances,
+					.firstIndex = index,
+					.vertexOffset = (int32_t)vertex,
+					.firstInstance = draws[d].firstInstance
+				};
+
+				offset += sizeof(GFXDrawIndexedCmd);
+			}
+			else
+			{
+				*(GFXDrawCmd*)ptr = (GFXDrawCmd){
+					.vertices = prim->numVertices,
+					.instances = draws[d].instances,
+					.firstVertex = vertex,
+					.firstInstance = draws[d].firstInstance
+				};
+
+				offset += sizeof(GFXDrawCmd);
+			}
+
+			++count;
+		}
+
+		// Record the draw command.
+		if (indexed)
+			context->vk.CmdDrawIndexedIndirect(recorder->inp.cmd,
+				buffer, first, count, sizeof(GFXDrawIndexedCmd));
+		else
+			context->vk.CmdDrawIndirect(recorder->inp.cmd,
+				buffer, first, count, sizeof(GFXDrawCmd));
+	}
+}
+
 /****************************/
 GFX_API void gfx_cmd_dispatch(GFXRecorder* recorder, GFXComputable* computable,
                               uint32_t xCount, uint32_t yCount, uint32_t zCount)
@@ -1556,7 +3380,11 @@ GFX_API void gfx_cmd_set_viewport(GFXRecorder* recorder, GFXViewport viewport)
 	GFXRenderPass_* rPass = (GFXRenderPass_*)recorder->inp.pass;
 
 	// Compare & set viewport state.
-	if (!gfx_cmp_viewports_(&recorder->state.viewport, &viewport))
+	// If deferring, the state is captured & set by deferred commands.
+	if (recorder->defer.active)
+		recorder->state.viewport = viewport;
+
+	else if (!gfx_cmp_viewports_(&recorder->state.viewport, &viewport))
 	{
 		VkViewport vkViewport = gfx_get_viewport_(
 			&viewport, rPass->build.fWidth, rPass->build.fHeight);
@@ -1578,7 +3406,10 @@ GFX_API void gfx_cmd_set_scissor(GFXRecorder* recorder, GFXScissor scissor)
 	GFXRenderPass_* rPass = (GFXRenderPass_*)recorder->inp.pass;
 
 	// Compare & set scissor state.
-	if (!gfx_cmp_scissors_(&recorder->state.scissor, &scissor))
+	if (recorder->defer.active)
+		recorder->state.scissor = scissor;
+
+	else if (!gfx_cmp_scissors_(&recorder->state.scissor, &scissor))
 	{
 		VkRect2D vkScissor = gfx_get_scissor_(
 			&scissor, rPass->build.fWidth, rPass->build.fHeight);
@@ -1599,9 +3430,25 @@ GFX_API void gfx_cmd_set_line_width(GFXRecorder* recorder, float lineWidth)
 	GFXContext_* context = recorder->context;
 
 	// Compare & set line width state.
-	if (recorder->state.lineWidth != lineWidth)
+	if (recorder->defer.active)
+		recorder->state.lineWidth = lineWidth;
+
+	else if (recorder->state.lineWidth != lineWidth)
 	{
 		context->vk.CmdSetLineWidth(recorder->inp.cmd, lineWidth);
 		recorder->state.lineWidth = lineWidth;
 	}
 }
+
+/****************************/
+GFX_API void gfx_cmd_group(GFXRecorder* recorder)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.pass != NULL);
+	assert(recorder->inp.pass->type == GFX_PASS_RENDER);
+	assert(recorder->inp.cmd != NULL);
+
+	// Only relevant when deferring.
+	if (recorder->defer.active)
+		++recorder->defer.group;
+}
@@ -88,6 +88,44 @@
 	GFX_ENTRY_HASH_SIZE_(binding->type) * (size_t)(entry - binding->entries))
 
 
+// Dirty binding bitmask.
+#define GFX_DIRTY_WORDS_(numBindings) \
+	(((numBindings) + 63) >> 6)
+
+#define GFX_DIRTY_SET_(set, b) \
+	((set)->dirty[(b) >> 6] |= (uint64_t)1 << ((b) & 63))
+
+#define GFX_DIRTY_GET_(set, b) \
+	((set)->dirty[(b) >> 6] & ((uint64_t)1 << ((b) & 63)))
+
+
+// Uniform streaming ring, size of each region (one per virtual frame).
+#define GFX_STREAM_SIZE_ ((uint64_t)1 << 22)
+
+// Stream head packing, { uint32_t tick, uint32_t offset }.
+#define GFX_STREAM_PACK_(tick, offset) \
+	(((uint64_t)(tick) << 32) | (uint64_t)(offset))
+
+#define GFX_STREAM_TICK_(head) \
+	((uint32_t)((head) >> 32))
+
+#define GFX_STREAM_OFFSET_(head) \
+	((uint32_t)((head) & UINT32_MAX))
+
+
+// Slot free list packing, { uint32_t tag, uint32_t slot }.
+#define GFX_SLOTS_NONE_ UINT32_MAX
+
+#define GFX_SLOTS_PACK_(tag, slot) \
+	(((uint64_t)(tag) << 32) | (uint64_t)(slot))
+
+#define GFX_SLOTS_TAG_(head) \
+	((uint32_t)((head) >> 32))
+
+#define GFX_SLOTS_SLOT_(head) \
+	((uint32_t)((head) & UINT32_MAX))
+
+
 // Hash writers.
 #define GFX_WRITE_HASH_(hash, value) \
 	do { \
@@ -112,7 +150,8 @@ static void gfx_make_stale_(GFXSet* set,
 	// gfx_push_stale_ expects at least one resource!
 	if (imageView != VK_NULL_HANDLE || bufferView != VK_NULL_HANDLE)
 		gfx_push_stale_(set->renderer,
-			VK_NULL_HANDLE, imageView, bufferView, VK_NULL_HANDLE);
+			VK_NULL_HANDLE, imageView, bufferView,
+			VK_NULL_HANDLE, VK_NULL_HANDLE);
 }
 
 /****************************
@@ -191,15 +230,119 @@ static bool gfx_make_view_(GFXContext_* context,
 	return 1;
 }
 
+/****************************
+ * Writes the Vulkan update info of a single descriptor to the set's own
+ * Vulkan descriptor set, only valid for bindless sets.
+ * Empty descriptors are skipped, as bindless sets may be partially bound.
+ */
+static void gfx_set_write_(GFXSet* set,
+                           GFXSetBinding_* binding, GFXSetEntry_* entry)
+{
+	GFXContext_* context = set->renderer->cache.context;
+
+	// Check for empty descriptors.
+	if (
+		(GFX_DESCRIPTOR_IS_BUFFER_(binding->type) &&
+			entry->vk.update.buffer.buffer == VK_NULL_HANDLE) ||
+		(GFX_DESCRIPTOR_IS_IMAGE_(binding->type) &&
+			entry->vk.update.image.imageView == VK_NULL_HANDLE) ||
+		(GFX_DESCRIPTOR_IS_SAMPLER_(binding->type) &&
+			entry->vk.update.image.sampler == VK_NULL_HANDLE) ||
+		(GFX_DESCRIPTOR_IS_VIEW_(binding->type) &&
+			entry->vk.update.view == VK_NULL_HANDLE))
+	{
+		return;
+	}
+
+	VkWriteDescriptorSet wds = {
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+
+		.pNext            = NULL,
+		.dstSet           = set->elem.vk.set,
+		.dstBinding       = (uint32_t)(binding - set->bindings),
+		.dstArrayElement  = (uint32_t)(entry - binding->entries),
+		.descriptorCount  = 1,
+		.descriptorType   = binding->type,
+		.pImageInfo       = &entry->vk.update.image,
+		.pBufferInfo      = &entry->vk.update.buffer,
+		.pTexelBufferView = &entry->vk.update.view
+	};
+
+	context->vk.UpdateDescriptorSets(
+		context->vk.device, 1, &wds, 0, NULL);
+}
+
+/****************************
+ * Recomputes the hash blocks overlapping a byte range of the set's key,
+ * then updates the stored hash of the entire key.
+ * @param offset Offset into key->bytes.
+ */
+static void gfx_set_rehash_(GFXSet* set, size_t offset, size_t len)
+{
+	if (len == 0)
+		return;
+
+	const size_t first = offset / GFX_HASH_BLOCK_SIZE_;
+	const size_t last = (offset + len - 1) / GFX_HASH_BLOCK_SIZE_;
+
+	// Swap out the block hashes in the sum, unsigned wrap-around is fine.
+	for (size_t b = first; b <= last; ++b)
+	{
+		const uint32_t hash = gfx_hash_block_(set->key, b);
+		set->sum += (uint64_t)hash - (uint64_t)set->blocks[b];
+		set->blocks[b] = hash;
+	}
+
+	atomic_store_explicit(&set->hash,
+		gfx_hash_fold_(set->key->len, set->sum), memory_order_relaxed);
+}
+
+/****************************
+ * Rehashes the key portions of all dirty bindings & clears the bitmask.
+ * Bindless and push sets are never in the renderer's pool,
+ * so their key is never hashed at all.
+ *
+ * This does not write any descriptors! Pooled descriptor sets are shared
+ * by all sets with an equal key and may still be in flight, so they are
+ * never patched; a changed key resolves to another pooled descriptor set,
+ * which is written in its entirety by gfx_pool_get_ if not yet cached.
+ */
+static void gfx_set_flush_(GFXSet* set)
+{
+	const bool hashed = !GFX_SET_IS_BINDLESS_(set) && !set->push;
+
+	for (size_t w = 0; w < GFX_DIRTY_WORDS_(set->numBindings); ++w)
+	{
+		if (set->dirty[w] == 0)
+			continue;
+
+		const size_t end = GFX_MIN((w + 1) << 6, set->numBindings);
+		if (hashed) for (size_t b = w << 6; b < end; ++b)
+		{
+			GFXSetBinding_* binding = &set->bindings[b];
+			if (!GFX_DIRTY_GET_(set, b) || binding->entries == NULL)
+				continue;
+
+			gfx_set_rehash_(set,
+				(size_t)(binding->hash - set->key->bytes),
+				GFX_ENTRY_HASH_SIZE_(binding->type) * binding->count);
+		}
+
+		set->dirty[w] = 0;
+	}
+}
+
 /****************************
  * Overwrites the Vulkan update info with the current groufix update info.
  * Assumes all relevant data is initialized and valid.
  * Will ignore valid empty values in the groufix update info.
+ * Marks the binding as dirty, call gfx_set_flush_ afterwards!
  */
 static void gfx_set_update_(GFXSet* set,
                             GFXSetBinding_* binding, GFXSetEntry_* entry)
 {
 	char* hash = GFX_ENTRY_GET_HASH_(binding, entry);
+	GFX_DIRTY_SET_(set, (size_t)(binding - set->bindings));
 
 	// Update buffer info.
 	if (GFX_DESCRIPTOR_IS_BUFFER_(binding->type))
@@ -350,6 +493,10 @@ static void gfx_set_update_(GFXSet* set,
 			GFX_WRITE_HASH_(hash, bvci.range);
 		}
 	}
+
+	// Bindless sets are updated in-place.
+	if (GFX_SET_IS_BINDLESS_(set))
+		gfx_set_write_(set, binding, entry);
 }
 
 /****************************
@@ -465,6 +612,11 @@ static void gfx_set_update_attachs_(GFXSet* set)
 			GFX_WRITE_HASH_(hash, ivci.subresourceRange.layerCount);
 			GFX_WRITE_HASH_(hash, layout);
 
+			// Only rehash the portion of the key we just wrote.
+			if (!set->push) gfx_set_rehash_(set,
+				(size_t)(GFX_ENTRY_GET_HASH_(binding, entry) - set->key->bytes),
+				GFX_ENTRY_HASH_SIZE_(binding->type));
+
 			// Update the stored build generation last!
 			gen = success ? GFX_ATTACH_GEN_(attach) : 0;
 			atomic_store_explicit(&entry->gen, gen, memory_order_relaxed);
@@ -486,13 +638,25 @@ GFXPoolElem_* gfx_set_get_(GFXSet* set, GFXPoolSub_* sub)
 	assert(set != NULL);
 	assert(sub != NULL);
 
+	// Bindless sets own their descriptor set, it is always up to date.
+	if (GFX_SET_IS_BINDLESS_(set))
+	{
+		atomic_store_explicit(&set->used, 1, memory_order_relaxed);
+		return &set->elem;
+	}
+
 	// Update referenced renderer attachments!
 	gfx_set_update_attachs_(set);
 
+	// Push sets have no descriptor set, their update info is pushed as-is.
+	if (set->push)
+		return &set->elem;
+
 	// Get the descriptor set.
 	GFXPoolElem_* elem = gfx_pool_get_(
 		&set->renderer->pool, sub,
 		set->setLayout, set->key,
+		atomic_load_explicit(&set->hash, memory_order_relaxed),
 		set->first != NULL ? &set->first->vk.update : NULL);
 
 	// Make sure to set the used flag on success.
@@ -508,6 +672,10 @@ GFXPoolElem_* gfx_set_get_(GFXSet* set, GFXPoolSub_* sub)
  */
 static void gfx_set_recycle_(GFXSet* set)
 {
+	// Bindless and push sets are never in the renderer's pool.
+	if (GFX_SET_IS_BINDLESS_(set) || set->push)
+		return;
+
 	// Only recycle if the set has been used & reset used flag.
 	if (atomic_exchange_explicit(&set->used, 0, memory_order_relaxed))
 	{
@@ -525,7 +693,10 @@ static void gfx_set_recycle_(GFXSet* set)
 		// Just like making things stale, this should be a rare path to
 		// go down to and aggressive locking is fine.
 		gfx_mutex_lock_(&renderer->lock);
-		gfx_pool_recycle_(&renderer->pool, set->key, renderer->numFrames);
+		gfx_pool_recycle_(&renderer->pool,
+			set->key,
+			atomic_load_explicit(&set->hash, memory_order_relaxed),
+			renderer->numFrames);
 		gfx_mutex_unlock_(&renderer->lock);
 	}
 }
@@ -624,6 +795,21 @@ static bool gfx_set_resources_(GFXSet* set, bool update, bool* changed,
 			continue;
 		}
 
+		// And a bindless check, attachments would need to be re-written
+		// every time they are rebuilt, but we want to be lock-free.
+		if (res->ref.type == GFX_REF_ATTACHMENT && GFX_SET_IS_BINDLESS_(set))
+		{
+			gfx_log_warn(
+				"Could not set descriptor resource "
+				"(binding=%"GFX_PRIs", index=%"GFX_PRIs") of a set, "
+				"renderer attachment reference cannot be used in a "
+				"bindless set.",
+				res->binding, res->index);
+
+			success = 0;
+			continue;
+		}
+
 		// If equal (including offset & size), just skip it, not a failure.
 		if (
 			GFX_UNPACK_REF_IS_EQUAL_(cur, new) &&
@@ -639,7 +825,9 @@ static bool gfx_set_resources_(GFXSet* set, bool update, bool* changed,
 		if (res->ref.type == GFX_REF_ATTACHMENT) ++set->numAttachs;
 
 		// Set the new reference & update.
+		// The binding is not streamed anymore, gfx_set_stream resets it.
 		*changed = 1;
+		binding->stream = 0;
 		entry->ref = res->ref;
 		atomic_store_explicit(&entry->gen, 0, memory_order_relaxed);
 
@@ -992,6 +1180,112 @@ static bool gfx_set_samplers_(GFXSet* set, bool update,
 	return success;
 }
 
+/****************************
+ * Initializes a set as bindless, i.e. creates its own Vulkan descriptor pool
+ * & set and a slot allocator for each runtime-sized array.
+ * @param tSet Set index within the technique.
+ * @return Zero on failure.
+ */
+static bool gfx_set_init_bindless_(GFXSet* set,
+                                   GFXTechnique* technique, size_t tSet)
+{
+	GFXContext_* context = set->renderer->cache.context;
+
+	// Allocate a slot allocator for all runtime-sized arrays.
+	// Remember the count of the last non-empty binding, which might be
+	// of variable descriptor count.
+	uint32_t varCount = 0;
+
+	for (size_t b = 0; b < set->numBindings; ++b)
+	{
+		GFXSetBinding_* binding = &set->bindings[b];
+		if (binding->count == 0) continue;
+
+		varCount = 0;
+		if (!gfx_tech_is_bindless_(technique, tSet, b)) continue;
+
+		binding->slots = malloc(
+			sizeof(GFXSetSlots_) +
+			sizeof(binding->slots->slots[0]) * binding->count);
+
+		if (binding->slots == NULL)
+			goto clean;
+
+		atomic_store_explicit(&binding->slots->free,
+			GFX_SLOTS_PACK_(0, GFX_SLOTS_NONE_), memory_order_relaxed);
+		atomic_store_explicit(&binding->slots->used,
+			0, memory_order_relaxed);
+
+		varCount = (uint32_t)binding->count;
+	}
+
+	// Create a descriptor pool fitting exactly one set.
+	VkDescriptorPoolSize sizes[GFX_NUM_DESCRIPTOR_TYPES_];
+	uint32_t numSizes = 0;
+
+	for (size_t t = 0; t < GFX_NUM_DESCRIPTOR_TYPES_; ++t)
+		if (set->setLayout->descriptors[t] > 0)
+			sizes[numSizes++] = (VkDescriptorPoolSize){
+				.type = (VkDescriptorType)t,
+				.descriptorCount = set->setLayout->descriptors[t]
+			};
+
+	VkDescriptorPoolCreateInfo dpci = {
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+
+		.pNext         = NULL,
+		.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+		.maxSets       = 1,
+		.poolSizeCount = numSizes,
+		.pPoolSizes    = sizes
+	};
+
+	GFX_VK_CHECK_(
+		context->vk.CreateDescriptorPool(
+			context->vk.device, &dpci, NULL, &set->vk.pool),
+		goto clean);
+
+	// Allocate the one descriptor set.
+	// If the layout has no variable count binding, the count is ignored.
+	VkDescriptorSetVariableDescriptorCountAllocateInfo dsvdcai = {
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+
+		.pNext              = NULL,
+		.descriptorSetCount = 1,
+		.pDescriptorCounts  = &varCount
+	};
+
+	VkDescriptorSetAllocateInfo dsai = {
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+
+		.pNext              = &dsvdcai,
+		.descriptorPool     = set->vk.pool,
+		.descriptorSetCount = 1,
+		.pSetLayouts        = &set->setLayout->vk.setLayout
+	};
+
+	GFX_VK_CHECK_(
+		context->vk.AllocateDescriptorSets(
+			context->vk.device, &dsai, &set->elem.vk.set),
+		goto clean);
+
+	return 1;
+
+
+	// Cleanup on failure.
+clean:
+	context->vk.DestroyDescriptorPool(
+		context->vk.device, set->vk.pool, NULL);
+
+	set->vk.pool = VK_NULL_HANDLE;
+
+	for (size_t b = 0; b < set->numBindings; ++b)
+		free(set->bindings[b].slots),
+		set->bindings[b].slots = NULL;
+
+	return 0;
+}
+
 /****************************/
 GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
                                      GFXTechnique* technique, size_t set,
@@ -1036,10 +1330,21 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 			(GFX_IMAGE_HASH_SIZE_ + GFX_SAMPLER_HASH_SIZE_)),
 			GFX_VIEW_HASH_SIZE_);
 
+	const size_t maxKeyLen =
+		sizeof(GFXCacheElem_*) + numEntries * maxHashSize;
+
+	const size_t keySize = GFX_ALIGN_UP(
+		updateSize + sizeof(GFXHashKey_) + maxKeyLen,
+		alignof(uint64_t));
+
+	const size_t numWords = GFX_DIRTY_WORDS_(numBindings);
+	const size_t numBlocks =
+		(maxKeyLen + GFX_HASH_BLOCK_SIZE_ - 1) / GFX_HASH_BLOCK_SIZE_;
+
 	GFXSet* aset = malloc(
-		updateSize +
-		sizeof(GFXHashKey_) +
-		sizeof(GFXCacheElem_*) + numEntries * maxHashSize);
+		keySize +
+		sizeof(uint64_t) * numWords +
+		sizeof(uint32_t) * numBlocks);
 
 	if (aset == NULL)
 		goto error;
@@ -1050,6 +1355,13 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 	aset->numAttachs = 0;
 	aset->numDynamics = technique->sets[set].numDynamics;
 	aset->numBindings = numBindings;
+	aset->push = (set == technique->pushSet);
+	aset->vk.pool = VK_NULL_HANDLE;
+
+	// Push sets hand out an element without descriptor set.
+	aset->elem.block = NULL;
+	aset->elem.vk.set = VK_NULL_HANDLE;
+	atomic_store_explicit(&aset->elem.gen, 0, memory_order_relaxed);
 
 	atomic_store_explicit(&aset->used, 0, memory_order_relaxed);
 
@@ -1060,6 +1372,13 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 	memcpy(key->bytes, &aset->setLayout, sizeof(GFXCacheElem_*));
 	memset(key->bytes + sizeof(GFXCacheElem_*), 0, numEntries * maxHashSize);
 
+	// Setup incremental hashing, all blocks are hashed at the end.
+	aset->dirty = (uint64_t*)((char*)aset + keySize);
+	aset->blocks = (uint32_t*)(aset->dirty + numWords);
+	aset->sum = 0;
+	memset(aset->dirty, 0, sizeof(uint64_t) * numWords);
+	memset(aset->blocks, 0, sizeof(uint32_t) * numBlocks);
+
 	// Get all the bindings.
 	aset->first = numEntries > 0 ?
 		(GFXSetEntry_*)((char*)aset + structSize) : NULL;
@@ -1078,7 +1397,9 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 			entries = binding->count;
 
 		binding->entries = entries > 0 ? entryPtr : NULL;
+		binding->slots = NULL;
 		binding->hash = entries > 0 ? hashPtr : NULL;
+		binding->stream = 0;
 
 		const size_t hashLen = GFX_ENTRY_HASH_SIZE_(binding->type) * entries;
 		entryPtr += entries;
@@ -1126,6 +1447,15 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 		}
 	}
 
+	// If bindless, get our own descriptor set before any updates,
+	// as those will write to it immediately.
+	if (technique->sets[set].bindless)
+		if (!gfx_set_init_bindless_(aset, technique, set))
+		{
+			free(aset);
+			goto error;
+		}
+
 	// And finally, before finishing up, set all initial resources, groups,
 	// views and samplers. Let individual resources and views overwrite groups.
 	bool changed; // Placeholder.
@@ -1149,6 +1479,10 @@ GFX_API GFXSet* gfx_renderer_add_set(GFXRenderer* renderer,
 			gfx_set_update_(aset, binding, &binding->entries[e]);
 	}
 
+	// Everything is dirty, hash the entire key at once.
+	memset(aset->dirty, 0, sizeof(uint64_t) * numWords);
+	gfx_set_rehash_(aset, 0, key->len);
+
 	// Link the set into the renderer.
 	// Modifying the renderer, lock!
 	gfx_mutex_lock_(&renderer->lock);
@@ -1197,6 +1531,17 @@ GFX_API void gfx_erase_set(GFXSet* set)
 	// none of the resources may be referenced anymore!
 	gfx_set_recycle_(set);
 
+	// If bindless, make our own descriptor pool stale.
+	if (GFX_SET_IS_BINDLESS_(set))
+	{
+		gfx_push_stale_(renderer,
+			VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE,
+			VK_NULL_HANDLE, set->vk.pool);
+
+		for (size_t b = 0; b < set->numBindings; ++b)
+			free(set->bindings[b].slots);
+	}
+
 	free(set);
 }
 
@@ -1316,6 +1661,311 @@ GFX_API size_t gfx_set_get_num_dynamics(GFXSet* set)
 	return set->numDynamics;
 }
 
+/****************************/
+GFX_API size_t gfx_set_alloc(GFXSet* set, size_t binding)
+{
+	assert(set != NULL);
+
+	if (binding >= set->numBindings || set->bindings[binding].slots == NULL)
+	{
+		gfx_log_warn(
+			"Could not allocate descriptor slot (binding=%"GFX_PRIs") "
+			"of a set, not a runtime-sized array.",
+			binding);
+
+		return SIZE_MAX;
+	}
+
+	GFXSetBinding_* bind = &set->bindings[binding];
+	GFXSetSlots_* slots = bind->slots;
+
+	// First try to pop a freed slot, but only if no virtual frame can still
+	// be using it. The free list is LIFO, so if the head was freed too
+	// recently, all other freed slots might be too, do not bother.
+	const uint32_t now = (uint32_t)atomic_load_explicit(
+		&set->renderer->ticks, memory_order_relaxed);
+
+	uint_fast64_t head = atomic_load_explicit(
+		&slots->free, memory_order_acquire);
+
+	while (GFX_SLOTS_SLOT_(head) != GFX_SLOTS_NONE_)
+	{
+		const uint32_t slot = GFX_SLOTS_SLOT_(head);
+		const uint32_t tick = (uint32_t)atomic_load_explicit(
+			&slots->slots[slot].tick, memory_order_relaxed);
+
+		if (now - tick <= set->renderer->numFrames)
+			break;
+
+		// The tag protects against ABA, so `next` may be stale here.
+		const uint32_t next = (uint32_t)atomic_load_explicit(
+			&slots->slots[slot].next, memory_order_relaxed);
+
+		if (atomic_compare_exchange_weak_explicit(&slots->free,
+			&head, GFX_SLOTS_PACK_(GFX_SLOTS_TAG_(head) + 1, next),
+			memory_order_acquire, memory_order_acquire))
+		{
+			return slot;
+		}
+	}
+
+	// Otherwise claim a never used slot.
+	uint_fast32_t used = atomic_load_explicit(
+		&slots->used, memory_order_relaxed);
+
+	while (used < bind->count)
+		if (atomic_compare_exchange_weak_explicit(&slots->used,
+			&used, used + 1,
+			memory_order_relaxed, memory_order_relaxed))
+		{
+			return used;
+		}
+
+	gfx_log_warn(
+		"Could not allocate descriptor slot (binding=%"GFX_PRIs") "
+		"of a set, capacity of %"GFX_PRIs" reached.",
+		binding, bind->count);
+
+	return SIZE_MAX;
+}
+
+/****************************/
+GFX_API void gfx_set_free(GFXSet* set, size_t binding, size_t index)
+{
+	assert(set != NULL);
+	assert(binding < set->numBindings);
+	assert(set->bindings[binding].slots != NULL);
+	assert(index < set->bindings[binding].count);
+
+	GFXSetSlots_* slots = set->bindings[binding].slots;
+
+	// Remember when it was freed, so it is not reused too soon.
+	atomic_store_explicit(&slots->slots[index].tick,
+		atomic_load_explicit(&set->renderer->ticks, memory_order_relaxed),
+		memory_order_relaxed);
+
+	// Push it onto the free list.
+	uint_fast64_t head = atomic_load_explicit(
+		&slots->free, memory_order_relaxed);
+
+	do
+	{
+		atomic_store_explicit(&slots->slots[index].next,
+			GFX_SLOTS_SLOT_(head), memory_order_relaxed);
+	}
+	while (!atomic_compare_exchange_weak_explicit(&slots->free,
+		&head, GFX_SLOTS_PACK_(GFX_SLOTS_TAG_(head) + 1, index),
+		memory_order_release, memory_order_relaxed));
+}
+
+/****************************/
+bool gfx_stream_init_(GFXRenderer* renderer)
+{
+	assert(renderer != NULL);
+
+	// Allocating the ring modifies the renderer, lock!
+	gfx_mutex_lock_(&renderer->lock);
+
+	if (renderer->stream.buffer != NULL)
+		goto unlock;
+
+	// Dynamic offsets are 32 bits, the entire ring must be addressable.
+	const uint64_t size = GFX_STREAM_SIZE_ * renderer->numFrames;
+	if (size > UINT32_MAX)
+		goto unlock;
+
+	// Align pushes to satisfy both uniform and storage buffers,
+	// which also satisfies indirect commands (4 bytes).
+	const GFXDevice_* device = renderer->heap->allocator.device;
+
+	renderer->stream.align = GFX_MAX(
+		device->base.limits.minUniformBufferAlign,
+		device->base.limits.minStorageBufferAlign);
+
+	GFXBuffer* buffer = gfx_alloc_buffer(renderer->heap,
+		GFX_MEMORY_HOST_VISIBLE | GFX_MEMORY_DEVICE_LOCAL | GFX_MEMORY_WRITE,
+		GFX_BUFFER_UNIFORM | GFX_BUFFER_STORAGE | GFX_BUFFER_INDIRECT,
+		size);
+
+	if (buffer == NULL)
+		goto unlock;
+
+	// Keep it mapped for its entire lifetime.
+	renderer->stream.ptr = gfx_map(gfx_ref_buffer(buffer));
+	if (renderer->stream.ptr == NULL)
+	{
+		gfx_free_buffer(buffer);
+		goto unlock;
+	}
+
+	renderer->stream.buffer = buffer;
+	renderer->stream.size = GFX_STREAM_SIZE_;
+
+unlock:
+	gfx_mutex_unlock_(&renderer->lock);
+
+	return renderer->stream.buffer != NULL;
+}
+
+/****************************/
+uint64_t gfx_stream_alloc_(GFXRenderer* renderer,
+                           unsigned int frame, uint64_t size)
+{
+	assert(renderer != NULL);
+	assert(renderer->stream.buffer != NULL);
+	assert(frame < renderer->numFrames);
+
+	// Suballocate from the region of the given virtual frame.
+	// The first push of every frame resets the offset, which is safe as the
+	// previous frame using this region must be done rendering.
+	const uint32_t tick = (uint32_t)atomic_load_explicit(
+		&renderer->ticks, memory_order_relaxed);
+	const uint64_t range = GFX_ALIGN_UP(size, renderer->stream.align);
+
+	uint_fast64_t head = atomic_load_explicit(
+		&renderer->stream.head, memory_order_relaxed);
+	uint64_t offset;
+
+	do
+	{
+		offset = (GFX_STREAM_TICK_(head) == tick) ?
+			GFX_STREAM_OFFSET_(head) : 0;
+
+		if (offset + range > renderer->stream.size)
+			return UINT64_MAX;
+	}
+	while (!atomic_compare_exchange_weak_explicit(&renderer->stream.head,
+		&head, GFX_STREAM_PACK_(tick, offset + range),
+		memory_order_relaxed, memory_order_relaxed));
+
+	return offset + renderer->stream.size * frame;
+}
+
+/****************************/
+GFX_API bool gfx_set_stream(GFXSet* set, size_t binding)
+{
+	assert(set != NULL);
+	assert(!set->renderer->recording);
+
+	GFXRenderer* renderer = set->renderer;
+
+	// Check if the binding is a non-empty dynamic buffer with known size.
+	if (!gfx_set_is_binding_dynamic(set, binding))
+	{
+		gfx_log_error(
+			"Could not stream descriptor binding (binding=%"GFX_PRIs") "
+			"of a set, not a dynamic buffer.",
+			binding);
+
+		return 0;
+	}
+
+	GFXSetBinding_* bind = &set->bindings[binding];
+	if (bind->entries == NULL || bind->size == 0)
+	{
+		gfx_log_error(
+			"Could not stream descriptor binding (binding=%"GFX_PRIs") "
+			"of a set, unknown block size.",
+			binding);
+
+		return 0;
+	}
+
+	if (!gfx_stream_init_(renderer))
+	{
+		gfx_log_error(
+			"Could not stream descriptor binding (binding=%"GFX_PRIs") "
+			"of a set, failed to allocate the renderer's ring.",
+			binding);
+
+		return 0;
+	}
+
+	// Point all descriptors at the start of the ring,
+	// the range resolves to the block size of the binding.
+	bool success = 1;
+
+	for (size_t i = 0; i < bind->count; ++i)
+	{
+		bool changed; // Placeholder.
+		GFXSetResource res = {
+			.binding = binding,
+			.index = i,
+			.ref = gfx_ref_buffer(renderer->stream.buffer)
+		};
+
+		if (!gfx_set_resources_(set, 1, &changed, 1, &res))
+			success = 0;
+	}
+
+	// Only rehash what was modified.
+	gfx_set_flush_(set);
+	bind->stream = success;
+
+	return success;
+}
+
+/****************************/
+GFX_API uint32_t gfx_set_push_uniform(GFXRecorder* recorder,
+                                      GFXSet* set, size_t binding,
+                                      const void* data, size_t size)
+{
+	assert(recorder != NULL);
+	assert(recorder->inp.cmd != NULL);
+	assert(set != NULL);
+	assert(set->renderer == recorder->renderer);
+	assert(binding < set->numBindings);
+	assert(data != NULL);
+	assert(size > 0);
+
+	GFXRenderer* renderer = set->renderer;
+	GFXSetBinding_* bind = &set->bindings[binding];
+
+	// Static recordings are reused across frames,
+	// the returned offset would outlive the ring's data.
+	if (recorder->inp.stat != NULL)
+	{
+		gfx_log_error(
+			"Could not push uniform data to descriptor binding "
+			"(binding=%"GFX_PRIs") of a set, "
+			"cannot push during a static recording.",
+			binding);
+
+		return UINT32_MAX;
+	}
+
+	if (!bind->stream || size > bind->size)
+	{
+		gfx_log_warn(
+			"Could not push uniform data to descriptor binding "
+			"(binding=%"GFX_PRIs") of a set, %s.",
+			binding,
+			!bind->stream ? "binding is not streamed" : "exceeds block size");
+
+		return UINT32_MAX;
+	}
+
+	// Suballocate from the region of the current virtual frame.
+	// The descriptor range is the block size, so reserve all of it.
+	const uint64_t offset = gfx_stream_alloc_(
+		renderer, recorder->current, (uint64_t)bind->size);
+
+	if (offset == UINT64_MAX)
+	{
+		gfx_log_warn(
+			"Could not push uniform data to descriptor binding "
+			"(binding=%"GFX_PRIs") of a set, ring is full.",
+			binding);
+
+		return UINT32_MAX;
+	}
+
+	// Write to the persistently mapped (coherent) memory.
+	memcpy(renderer->stream.ptr + offset, data, size);
+
+	return (uint32_t)offset;
+}
+
 /****************************/
 GFX_API bool gfx_set_resources(GFXSet* set,
                                size_t numResources, const GFXSetResource* resources)
@@ -1323,7 +1973,11 @@ GFX_API bool gfx_set_resources(GFXSet* set,
 	// Relies on stand-in function for asserts.
 
 	bool changed; // Placeholder.
-	return gfx_set_resources_(set, 1, &changed, numResources, resources);
+	bool success = gfx_set_resources_(set, 1, &changed, numResources, resources);
+
+	// Only rehash what was modified.
+	gfx_set_flush_(set);
+	return success;
 }
 
 /****************************/
@@ -1332,7 +1986,11 @@ GFX_API bool gfx_set_groups(GFXSet* set,
 {
 	// Relies on stand-in function for asserts.
 
-	return gfx_set_groups_(set, 1, numGroups, groups);
+	bool success = gfx_set_groups_(set, 1, numGroups, groups);
+
+	// Only rehash what was modified.
+	gfx_set_flush_(set);
+	return success;
 }
 
 /****************************/
@@ -1342,7 +2000,11 @@ GFX_API bool gfx_set_views(GFXSet* set,
 	// Relies on stand-in function for asserts.
 
 	bool changed; // Placeholder.
-	return gfx_set_views_(set, 1, &changed, numViews, views);
+	bool success = gfx_set_views_(set, 1, &changed, numViews, views);
+
+	// Only rehash what was modified.
+	gfx_set_flush_(set);
+	return success;
 }
 
 /****************************/
@@ -1351,5 +2013,9 @@ GFX_API bool gfx_set_samplers(GFXSet* set,
 {
 	// Relies on stand-in function for asserts.
 
-	return gfx_set_samplers_(set, 1, numSamplers, samplers);
+	bool success = gfx_set_samplers_(set, 1, numSamplers, samplers);
+
+	// Only rehash what was modified.
+	gfx_set_flush_(set);
+	return success;
 }
@@ -11,6 +11,13 @@
 #include <string.h>
 
 
+// Default #descriptors of a runtime-sized (i.e. bindless) array.
+#define GFX_DEF_BINDLESS_CAPACITY_ 1024
+
+// Guaranteed minimum of maxPushDescriptors.
+#define GFX_MAX_PUSH_DESCRIPTORS_ 32
+
+
 // Get Vulkan descriptor type.
 #define GFX_GET_VK_DESCRIPTOR_TYPE_(type, dynamic) \
 	((type) == GFX_SHADER_BUFFER_UNIFORM_ ? (dynamic ? \
@@ -37,16 +44,16 @@
 
 
 /****************************
- * Technique constant element definition.
+ * Technique constant permutation domain definition.
  */
-typedef struct GFXConstantElem_
+typedef struct GFXDomainElem_
 {
-	uint32_t    stage; // Shader stage index.
-	uint32_t    id;
-	size_t      size;
-	GFXConstant value;
+	uint32_t       id;
+	GFXShaderStage stage;
+	size_t         stride; // Permutation index stride.
+	GFXVec         values; // Stores GFXConstant.
 
-} GFXConstantElem_;
+} GFXDomainElem_;
 
 
 /****************************
@@ -71,6 +78,31 @@ typedef struct GFXBindingElem_
 } GFXBindingElem_;
 
 
+/****************************
+ * Technique bindless binding element definition.
+ */
+typedef struct GFXBindlessElem_
+{
+	size_t set;
+	size_t binding;
+	size_t capacity;
+
+} GFXBindlessElem_;
+
+
+/****************************
+ * Technique descriptor counts, to validate bindless limits with.
+ */
+typedef struct GFXDescriptorCount_
+{
+	uint64_t storageBuffers;
+	uint64_t sampledImages; // Includes uniform texel buffers.
+	uint64_t storageImages; // Includes storage texel buffers.
+	uint64_t samplers;
+
+} GFXDescriptorCount_;
+
+
 /****************************
  * Compares two shader resources, ignoring the location/set/id and binding.
  * @return Non-zero if equal.
@@ -179,6 +211,61 @@ static bool gfx_find_binding_elem_(GFXVec* vec, size_t set, size_t binding,
 	return 0;
 }
 
+/****************************
+ * Finds a GFXBindlessElem_ in a vector, optionally inserts it at
+ * its correct sorted position.
+ * @param vec Assumed to be sorted and store GFXBindlessElem_.
+ * @return Index of the (new) element, SIZE_MAX on failure.
+ */
+static size_t gfx_find_bindless_elem_(GFXVec* vec, size_t set, size_t binding,
+                                      bool insert)
+{
+	// Binary search to its position.
+	size_t l = 0;
+	size_t r = vec->size;
+
+	while (l < r)
+	{
+		const size_t p = (l + r) >> 1;
+		GFXBindlessElem_* e = gfx_vec_at(vec, p);
+
+		const bool lesser = e->set < set ||
+			(e->set == set && e->binding < binding);
+		const bool greater = e->set > set ||
+			(e->set == set && e->binding > binding);
+
+		if (lesser) l = p + 1;
+		else if (greater) r = p;
+		else return p;
+	}
+
+	// Insert anew.
+	GFXBindlessElem_ elem = {
+		.set = set,
+		.binding = binding,
+		.capacity = GFX_DEF_BINDLESS_CAPACITY_
+	};
+
+	if (insert && gfx_vec_insert(vec, 1, &elem, l))
+		return l;
+
+	return SIZE_MAX;
+}
+
+/****************************
+ * Retrieves the capacity of a runtime-sized (i.e. bindless) array.
+ * @return The set capacity or GFX_DEF_BINDLESS_CAPACITY_ if not set.
+ */
+static size_t gfx_tech_get_capacity_(GFXTechnique* technique,
+                                     size_t set, size_t binding)
+{
+	const size_t ind = gfx_find_bindless_elem_(
+		&technique->bindless, set, binding, 0);
+
+	return (ind == SIZE_MAX) ? GFX_DEF_BINDLESS_CAPACITY_ :
+		((GFXBindlessElem_*)gfx_vec_at(&technique->bindless, ind))->capacity;
+}
+
 /****************************
  * Retrieves a shader resource from a technique by set/binding number.
  * Unknown what shader will be referenced, technique is assumed to be validated.
@@ -215,15 +302,31 @@ static GFXShaderResource_* gfx_tech_get_resource_(GFXTechnique* technique,
 	return NULL;
 }
 
+/****************************
+ * Clears all permutation domains of a technique.
+ */
+static void gfx_tech_clear_domains_(GFXTechnique* technique)
+{
+	for (size_t d = 0; d < technique->domains.size; ++d)
+		gfx_vec_clear(
+			&((GFXDomainElem_*)gfx_vec_at(&technique->domains, d))->values);
+
+	gfx_vec_clear(&technique->domains);
+	technique->numPerms = 1;
+}
+
 /****************************/
-void gfx_tech_get_constants_(GFXTechnique* technique,
+void gfx_tech_get_constants_(GFXTechnique* technique, size_t perm,
                              VkSpecializationInfo* infos,
-                             VkSpecializationMapEntry* entries)
+                             VkSpecializationMapEntry* entries,
+                             GFXConstantElem_* data)
 {
 	assert(technique != NULL);
 	assert(technique->layout != NULL); // Must be locked.
+	assert(perm < technique->numPerms);
 	assert(infos != NULL);
 	assert(technique->constants.size == 0 || entries != NULL);
+	assert(technique->constants.size == 0 || data != NULL);
 
 	// Init info structs to empty.
 	for (size_t s = 0; s < GFX_NUM_SHADER_STAGES_; ++s)
@@ -237,6 +340,27 @@ void gfx_tech_get_constants_(GFXTechnique* technique,
 	// No constants, done.
 	if (technique->constants.size == 0) return;
 
+	// Copy all constants & substitute the values of the permutation.
+	// Each domain selects its value by the permutation's 'digit'.
+	memcpy(data,
+		gfx_vec_at(&technique->constants, 0),
+		sizeof(GFXConstantElem_) * technique->constants.size);
+
+	for (size_t d = 0; d < technique->domains.size; ++d)
+	{
+		GFXDomainElem_* domain = gfx_vec_at(&technique->domains, d);
+		const GFXConstant* value = gfx_vec_at(&domain->values,
+			(perm / domain->stride) % domain->values.size);
+
+		for (size_t c = 0; c < technique->constants.size; ++c)
+			if (
+				data[c].id == domain->id &&
+				(domain->stage & ((uint32_t)1 << data[c].stage)))
+			{
+				data[c].value = *value;
+			}
+	}
+
 	// Loop over all constants, count & output them;
 	// They are already sorted correctly.
 	uint32_t currStage = UINT32_MAX;
@@ -244,7 +368,7 @@ void gfx_tech_get_constants_(GFXTechnique* technique,
 
 	for (size_t c = 0; c < technique->constants.size; ++c)
 	{
-		GFXConstantElem_* elem = gfx_vec_at(&technique->constants, c);
+		GFXConstantElem_* elem = data + c;
 		infos[elem->stage].mapEntryCount += 1;
 		infos[elem->stage].dataSize += sizeof(GFXConstantElem_);
 
@@ -302,14 +426,28 @@ bool gfx_tech_get_set_binding_(GFXTechnique* technique,
 
 	out->type = GFX_GET_VK_DESCRIPTOR_TYPE_(res->type, isDynamic);
 	out->viewType = res->viewType;
-	out->count = res->count;
 	out->size = res->size;
 
+	// Runtime-sized arrays get their bindless capacity.
+	out->count = (res->count == 0) ?
+		gfx_tech_get_capacity_(technique, set, binding) : res->count;
+
 	// Just as during locking,
 	// check if it contains more than an immutable sampler.
 	return !isImmutable || res->type != GFX_SHADER_SAMPLER_;
 }
 
+/****************************/
+bool gfx_tech_is_bindless_(GFXTechnique* technique, size_t set, size_t binding)
+{
+	assert(technique != NULL);
+	assert(technique->layout != NULL); // Must be locked.
+	assert(set < technique->numSets);
+
+	GFXShaderResource_* res = gfx_tech_get_resource_(technique, set, binding);
+	return res != NULL && res->count == 0;
+}
+
 /****************************/
 GFX_API GFXTechnique* gfx_renderer_add_tech(GFXRenderer* renderer,
                                             size_t numShaders, GFXShader** shaders)
@@ -447,8 +585,11 @@ GFX_API GFXTechnique* gfx_renderer_add_tech(GFXRenderer* renderer,
 	tech->numSets = maxSets;
 	tech->pushSize = 0;
 	tech->pushStages = 0;
+	tech->pushSet = SIZE_MAX;
+	tech->numPerms = 1;
 	tech->layout = NULL;
 	tech->vk.layout = VK_NULL_HANDLE;
+	tech->vk.push = VK_NULL_HANDLE;
 	memcpy(tech->shaders, shads, sizeof(shads));
 
 	for (size_t l = 0; l < tech->numSets; ++l)
@@ -456,9 +597,11 @@ GFX_API GFXTechnique* gfx_renderer_add_tech(GFXRenderer* renderer,
 		tech->sets[l].numBindings = 0;
 
 	gfx_vec_init(&tech->constants, sizeof(GFXConstantElem_));
+	gfx_vec_init(&tech->domains, sizeof(GFXDomainElem_));
 	gfx_vec_init(&tech->samplers, sizeof(GFXSamplerElem_));
 	gfx_vec_init(&tech->immutable, sizeof(GFXBindingElem_));
 	gfx_vec_init(&tech->dynamic, sizeof(GFXBindingElem_));
+	gfx_vec_init(&tech->bindless, sizeof(GFXBindlessElem_));
 
 	// Loop over ALL shaders once more to get the #bindings for each set.
 	// Again, we want to count empty bindings too,
@@ -517,10 +660,18 @@ GFX_API void gfx_erase_tech(GFXTechnique* technique)
 	gfx_mutex_unlock_(&renderer->lock);
 
 	// Destroy itself.
+	// The push descriptor template is only read when recording.
+	GFXContext_* context = renderer->cache.context;
+
+	context->vk.DestroyDescriptorUpdateTemplate(
+		context->vk.device, technique->vk.push, NULL);
+
+	gfx_tech_clear_domains_(technique);
 	gfx_vec_clear(&technique->constants);
 	gfx_vec_clear(&technique->samplers);
 	gfx_vec_clear(&technique->immutable);
 	gfx_vec_clear(&technique->dynamic);
+	gfx_vec_clear(&technique->bindless);
 
 	free(technique);
 }
@@ -606,7 +757,9 @@ GFX_API size_t gfx_tech_get_binding_size(GFXTechnique* technique,
 	GFXShaderResource_* res =
 		gfx_tech_get_resource_(technique, set, binding);
 
-	return (res == NULL) ? 0 : res->count;
+	// Runtime-sized arrays report their bindless capacity.
+	return (res == NULL) ? 0 : (res->count == 0) ?
+		gfx_tech_get_capacity_(technique, set, binding) : res->count;
 }
 
 /****************************/
@@ -721,6 +874,105 @@ GFX_API bool gfx_tech_constant(GFXTechnique* technique,
 	return success;
 }
 
+/****************************/
+GFX_API bool gfx_tech_permute(GFXTechnique* technique,
+                              size_t numDomains, const GFXConstantDomain* domains)
+{
+	assert(technique != NULL);
+	assert(numDomains == 0 || domains != NULL);
+
+	// Skip if already locked.
+	if (technique->layout != NULL)
+		return 0;
+
+	// Replace all previous domains.
+	gfx_tech_clear_domains_(technique);
+
+	if (numDomains == 0)
+		return 1;
+
+	if (!gfx_vec_reserve(&technique->domains, numDomains))
+		goto error;
+
+	for (size_t d = 0; d < numDomains; ++d)
+	{
+		assert(domains[d].numValues > 0);
+		assert(domains[d].values != NULL);
+
+		// Guard against overflowing the permutation index.
+		if (technique->numPerms > SIZE_MAX / domains[d].numValues)
+		{
+			gfx_log_error(
+				"Could not set specialization constant permutations of a "
+				"technique; too many permutations.");
+
+			goto clean;
+		}
+
+		// Set the first value as 'default' constant,
+		// which also makes sure the constant exists & has a size.
+		if (!gfx_tech_constant(technique,
+			domains[d].id, domains[d].stage,
+			domains[d].size, domains[d].values[0]))
+		{
+			goto error;
+		}
+
+		GFXDomainElem_ elem = {
+			.id = domains[d].id,
+			.stage = domains[d].stage,
+			.stride = technique->numPerms
+		};
+
+		gfx_vec_init(&elem.values, sizeof(GFXConstant));
+		if (!gfx_vec_push(&elem.values, domains[d].numValues, domains[d].values))
+			goto error;
+
+		gfx_vec_push(&technique->domains, 1, &elem); // Reserved.
+		technique->numPerms *= domains[d].numValues;
+	}
+
+	return 1;
+
+
+	// Error on failure.
+error:
+	gfx_log_error(
+		"Could not set specialization constant permutations of a technique.");
+clean:
+	gfx_tech_clear_domains_(technique);
+
+	return 0;
+}
+
+/****************************/
+GFX_API size_t gfx_tech_get_num_permutations(GFXTechnique* technique)
+{
+	assert(technique != NULL);
+
+	return technique->numPerms;
+}
+
+/****************************/
+GFX_API size_t gfx_tech_get_permutation(GFXTechnique* technique,
+                                        const size_t* values)
+{
+	assert(technique != NULL);
+	assert(technique->domains.size == 0 || values != NULL);
+
+	size_t perm = 0;
+
+	for (size_t d = 0; d < technique->domains.size; ++d)
+	{
+		GFXDomainElem_* domain = gfx_vec_at(&technique->domains, d);
+		assert(values[d] < domain->values.size);
+
+		perm += values[d] * domain->stride;
+	}
+
+	return perm;
+}
+
 /****************************/
 GFX_API bool gfx_tech_samplers(GFXTechnique* technique,
                                size_t set,
@@ -821,6 +1073,17 @@ GFX_API bool gfx_tech_immutable(GFXTechnique* technique,
 		return 0;
 	}
 
+	if (res->count == 0)
+	{
+		gfx_log_warn(
+			"Could not set an immutable descriptor resource "
+			"(set=%"GFX_PRIs", binding=%"GFX_PRIs") of a technique, "
+			"is a runtime-sized array.",
+			set, binding);
+
+		return 0;
+	}
+
 	// Insert the binding element.
 	return gfx_find_binding_elem_(&technique->immutable, set, binding, 1);
 }
@@ -857,6 +1120,178 @@ GFX_API bool gfx_tech_dynamic(GFXTechnique* technique,
 	return gfx_find_binding_elem_(&technique->dynamic, set, binding, 1);
 }
 
+/****************************/
+GFX_API bool gfx_tech_bindless(GFXTechnique* technique,
+                               size_t set, size_t binding, size_t capacity)
+{
+	assert(technique != NULL);
+	assert(set < technique->numSets);
+	assert(capacity > 0);
+
+	// Skip if already locked.
+	if (technique->layout != NULL)
+		return 0;
+
+	// Check if this resource is a runtime-sized array.
+	GFXShaderResource_* res =
+		gfx_tech_get_resource_(technique, set, binding);
+
+	if (res == NULL || res->count != 0 || capacity >= UINT32_MAX)
+	{
+		gfx_log_warn(
+			"Could not set the capacity of a bindless descriptor resource "
+			"(set=%"GFX_PRIs", binding=%"GFX_PRIs") of a technique, "
+			"not a runtime-sized array.",
+			set, binding);
+
+		return 0;
+	}
+
+	// Insert the bindless element & set its capacity.
+	const size_t ind = gfx_find_bindless_elem_(
+		&technique->bindless, set, binding, 1);
+
+	if (ind == SIZE_MAX)
+		return 0;
+
+	((GFXBindlessElem_*)gfx_vec_at(&technique->bindless, ind))->capacity =
+		capacity;
+
+	return 1;
+}
+
+/****************************/
+GFX_API bool gfx_tech_push(GFXTechnique* technique, size_t set)
+{
+	assert(technique != NULL);
+	assert(set < technique->numSets);
+
+	// Skip if already locked.
+	if (technique->layout != NULL)
+		return 0;
+
+	// Check if push descriptors are supported.
+	if (!(technique->renderer->cache.context->features &
+		GFX_SUPPORT_PUSH_DESCRIPTOR_))
+	{
+		gfx_log_warn(
+			"Could not push descriptor set (set=%"GFX_PRIs") "
+			"of a technique, push descriptors not supported by the device.",
+			set);
+
+		return 0;
+	}
+
+	// Vulkan only allows one push descriptor set per pipeline layout.
+	if (technique->pushSet != SIZE_MAX && technique->pushSet != set)
+	{
+		gfx_log_warn(
+			"Could not push descriptor set (set=%"GFX_PRIs") "
+			"of a technique, set %"GFX_PRIs" is already pushed.",
+			set, technique->pushSet);
+
+		return 0;
+	}
+
+	technique->pushSet = set;
+
+	return 1;
+}
+
+/****************************
+ * Adds the descriptors of a resource to a descriptor count.
+ * @param count Cannot be NULL.
+ * @param res   Cannot be NULL.
+ * @param num   Number of descriptors the resource holds.
+ */
+static void gfx_tech_count_(GFXDescriptorCount_* count,
+                            const GFXShaderResource_* res, size_t num)
+{
+	assert(count != NULL);
+	assert(res != NULL);
+
+	switch (res->type)
+	{
+	case GFX_SHADER_BUFFER_STORAGE_:
+		count->storageBuffers += num;
+		break;
+
+	case GFX_SHADER_BUFFER_UNIFORM_TEXEL_:
+	case GFX_SHADER_IMAGE_SAMPLED_:
+		count->sampledImages += num;
+		break;
+
+	case GFX_SHADER_BUFFER_STORAGE_TEXEL_:
+	case GFX_SHADER_IMAGE_STORAGE_:
+		count->storageImages += num;
+		break;
+
+	case GFX_SHADER_IMAGE_AND_SAMPLER_:
+		count->sampledImages += num;
+		count->samplers += num;
+		break;
+
+	case GFX_SHADER_SAMPLER_:
+		count->samplers += num;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/****************************
+ * Validates descriptor counts against the bindless limits of a device.
+ * @param device Cannot be NULL.
+ * @param count  Cannot be NULL.
+ * @param stage  Shader stage the count is of, 0 for the entire technique.
+ * @return Zero if any limit is exceeded.
+ */
+static bool gfx_tech_check_bindless_(const GFXDevice_* device,
+                                     const GFXDescriptorCount_* count,
+                                     GFXShaderStage stage)
+{
+	assert(device != NULL);
+	assert(count != NULL);
+
+	const uint64_t maxStorageBuffers = stage == 0 ?
+		device->base.limits.maxBoundBindlessStorageBuffers :
+		device->base.limits.maxPerStageBindlessStorageBuffers;
+	const uint64_t maxSampledImages = stage == 0 ?
+		device->base.limits.maxBoundBindlessSampledImages :
+		device->base.limits.maxPerStageBindlessSampledImages;
+	const uint64_t maxStorageImages = stage == 0 ?
+		device->base.limits.maxBoundBindlessStorageImages :
+		device->base.limits.maxPerStageBindlessStorageImages;
+	const uint64_t maxSamplers = stage == 0 ?
+		device->base.limits.maxBoundBindlessSamplers :
+		device->base.limits.maxPerStageBindlessSamplers;
+
+	if (
+		count->storageBuffers <= maxStorageBuffers &&
+		count->sampledImages <= maxSampledImages &&
+		count->storageImages <= maxStorageImages &&
+		count->samplers <= maxSamplers)
+	{
+		return 1;
+	}
+
+	gfx_log_error(
+		"Technique with runtime-sized descriptor arrays exceeds the "
+		"bindless limits of the device (%s): "
+		"%"PRIu64"/%"PRIu64" storage buffers, "
+		"%"PRIu64"/%"PRIu64" sampled images, "
+		"%"PRIu64"/%"PRIu64" storage images, "
+		"%"PRIu64"/%"PRIu64" samplers.",
+		stage == 0 ? "all stages" : "per stage",
+		count->storageBuffers, maxStorageBuffers,
+		count->sampledImages, maxSampledImages,
+		count->storageImages, maxStorageImages,
+		count->samplers, maxSamplers);
+
+	return 0;
+}
+
 /****************************/
 GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 {
@@ -885,11 +1320,24 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 	gfx_vec_init(&samplers, sizeof(VkSampler));
 	gfx_vec_init(&samplerHandles, sizeof(uintptr_t));
 
+	// And update template entries of the push descriptor set.
+	GFXVec pushEntries;
+	gfx_vec_init(&pushEntries, sizeof(VkDescriptorUpdateTemplateEntry));
+
+	// Count descriptors of each stage & of the entire technique,
+	// if any set is bindless, these are limited by its update-after-bind
+	// limits, which count descriptors of all sets.
+	GFXDescriptorCount_ counts[GFX_NUM_SHADER_STAGES_ + 1];
+	memset(counts, 0, sizeof(counts));
+	bool anyBindless = 0;
+
 	// Loop over all sets.
 	for (size_t set = 0; set < technique->numSets; ++set)
 	{
 		size_t numEntries = 0;
 		size_t numDynamics = 0;
+		bool bindless = 0;
+		bool lastRuntime = 0;
 
 		// Loop over all bindings of this set.
 		// NOTE: _Always_ true!
@@ -932,19 +1380,41 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 			if (done) break;
 
 			// If an empty resource, skip it.
-			// Do not fret; this does not skip 'unsized' (i.e. variable sized)
-			// storage buffers. The _last element_ of this resource would have
+			if (cur == NULL) continue;
+
+			// A count of zero means a runtime-sized array, which makes
+			// this set bindless, i.e. it is updated in-place.
+			// Note that this is not an 'unsized' (i.e. variable sized)
+			// storage buffer, the _last element_ of that resource would have
 			// a count of zero, not the resource itself :)
-			if (cur == NULL || cur->count == 0) continue;
+			const bool isRuntime = (cur->count == 0);
+
+			if (isRuntime &&
+				!(renderer->cache.context->features & GFX_SUPPORT_BINDLESS_))
+			{
+				gfx_log_error(
+					"Runtime-sized descriptor array "
+					"(set=%"GFX_PRIs", binding=%"GFX_PRIs") not supported "
+					"by the device, descriptor indexing is required.",
+					set, binding);
+
+				goto reset;
+			}
+
+			bindless = bindless || isRuntime;
+			lastRuntime = isRuntime;
 
 			// Push the resource as a binding.
 			const bool isDynamic =
 				gfx_find_binding_elem_(&technique->dynamic, set, binding, 0);
 
+			const size_t count = isRuntime ?
+				gfx_tech_get_capacity_(technique, set, binding) : cur->count;
+
 			VkDescriptorSetLayoutBinding dslb = {
 				.binding            = (uint32_t)binding,
 				.descriptorType     = GFX_GET_VK_DESCRIPTOR_TYPE_(cur->type, isDynamic),
-				.descriptorCount    = (uint32_t)cur->count,
+				.descriptorCount    = (uint32_t)count,
 				.stageFlags         = GFX_GET_VK_SHADER_STAGE_(stages),
 				.pImmutableSamplers = NULL
 			};
@@ -953,7 +1423,18 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 				goto reset;
 
 			if (isDynamic)
-				numDynamics += cur->count;
+				numDynamics += count;
+
+			// Count its descriptors.
+			for (size_t s = 0; s < GFX_NUM_SHADER_STAGES_; ++s)
+				if (
+					technique->shaders[s] != NULL &&
+					(technique->shaders[s]->stage & stages))
+				{
+					gfx_tech_count_(counts + s, cur, count);
+				}
+
+			gfx_tech_count_(counts + GFX_NUM_SHADER_STAGES_, cur, count);
 		}
 
 		// Loop over all bindings again to create immutable samplers.
@@ -1010,12 +1491,104 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 				dslb->pImmutableSamplers = gfx_vec_at(&samplers, samOffs[b]);
 			}
 
+		// If this is the push descriptor set, validate it & output
+		// update template entries, exactly like the cache would.
+		const bool isPush = (set == technique->pushSet);
+
+		if (isPush)
+		{
+			size_t numDescriptors = 0;
+			for (size_t b = 0; b < bindings.size; ++b)
+				numDescriptors += ((VkDescriptorSetLayoutBinding*)
+					gfx_vec_at(&bindings, b))->descriptorCount;
+
+			if (bindless || numDynamics > 0 ||
+				numDescriptors > GFX_MAX_PUSH_DESCRIPTORS_)
+			{
+				gfx_log_error(
+					"Push descriptor set (set=%"GFX_PRIs") cannot contain "
+					"runtime-sized arrays, dynamic buffers or more than "
+					"%d descriptors.",
+					set, GFX_MAX_PUSH_DESCRIPTORS_);
+
+				goto reset;
+			}
+
+			size_t offset = 0;
+
+			for (size_t b = 0; b < bindings.size; ++b)
+			{
+				VkDescriptorSetLayoutBinding* dslb = gfx_vec_at(&bindings, b);
+				if (immutable[b] && dslb->descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER)
+					continue;
+
+				VkDescriptorUpdateTemplateEntry dute = {
+					.dstBinding      = dslb->binding,
+					.dstArrayElement = 0,
+					.descriptorCount = dslb->descriptorCount,
+					.descriptorType  = dslb->descriptorType,
+					.offset          = offset,
+					.stride          = renderer->cache.templateStride
+				};
+
+				if (!gfx_vec_push(&pushEntries, 1, &dute))
+					goto reset;
+
+				offset +=
+					renderer->cache.templateStride *
+					dslb->descriptorCount;
+			}
+		}
+
+		// If bindless, all bindings can be updated after binding and may be
+		// partially bound, a trailing runtime-sized array is variable sized.
+		VkDescriptorBindingFlags flags[GFX_MAX(1, bindings.size)];
+
+		if (bindless) for (size_t b = 0; b < bindings.size; ++b)
+		{
+			VkDescriptorSetLayoutBinding* dslb = gfx_vec_at(&bindings, b);
+
+			if (
+				dslb->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+				dslb->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+				dslb->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ||
+				dslb->descriptorType == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT)
+			{
+				gfx_log_error(
+					"Descriptor resource (set=%"GFX_PRIs", binding=%"PRIu32") "
+					"cannot be a uniform buffer, dynamic buffer or attachment input, "
+					"as it is part of a bindless set.",
+					set, dslb->binding);
+
+				goto reset;
+			}
+
+			flags[b] =
+				VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+				VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+				VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+				((b + 1 == bindings.size && lastRuntime) ?
+					VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT : 0);
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo dslbfci = {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+
+			.pNext         = NULL,
+			.bindingCount  = (uint32_t)bindings.size,
+			.pBindingFlags = flags
+		};
+
 		// Create the actual descriptor set layout.
 		VkDescriptorSetLayoutCreateInfo dslci = {
 			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
 
-			.pNext        = NULL,
-			.flags        = 0,
+			.pNext        = bindless ? &dslbfci : NULL,
+			.flags        =
+				(bindless ?
+					VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0) |
+				(isPush ?
+					VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0),
 			.bindingCount = (uint32_t)bindings.size,
 
 			.pBindings = bindings.size > 0 ?
@@ -1034,6 +1607,8 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 		// And set descriptor layout info!
 		technique->sets[set].numEntries = numEntries;
 		technique->sets[set].numDynamics = numDynamics;
+		technique->sets[set].bindless = bindless;
+		anyBindless = anyBindless || bindless;
 
 		// Keep memory for next set!
 		gfx_vec_release(&bindings);
@@ -1046,6 +1621,28 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 	gfx_vec_clear(&samplers);
 	gfx_vec_clear(&samplerHandles);
 
+	// Validate bindless capacities, reject rather than clamp,
+	// shaders may index up to the capacity they were given.
+	if (anyBindless)
+	{
+		const GFXDevice_* device = renderer->heap->allocator.device;
+
+		for (size_t s = 0; s < GFX_NUM_SHADER_STAGES_; ++s)
+			if (
+				technique->shaders[s] != NULL &&
+				!gfx_tech_check_bindless_(
+					device, counts + s, technique->shaders[s]->stage))
+			{
+				goto reset;
+			}
+
+		if (!gfx_tech_check_bindless_(
+			device, counts + GFX_NUM_SHADER_STAGES_, 0))
+		{
+			goto reset;
+		}
+	}
+
 	// Create pipeline layout.
 	// We use a scope here so the gotos above are allowed.
 	{
@@ -1083,6 +1680,39 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 	// Set `vk.layout` for locality!
 	technique->vk.layout = technique->layout->vk.layout;
 
+	// Create the push descriptor update template,
+	// unlike for normal sets, this requires the pipeline layout.
+	if (pushEntries.size > 0)
+	{
+		GFXContext_* context = renderer->cache.context;
+
+		VkDescriptorUpdateTemplateCreateInfo dutci = {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+
+			.pNext                      = NULL,
+			.flags                      = 0,
+			.descriptorUpdateEntryCount = (uint32_t)pushEntries.size,
+			.pDescriptorUpdateEntries   = gfx_vec_at(&pushEntries, 0),
+			.descriptorSetLayout        = VK_NULL_HANDLE,
+			.pipelineLayout             = technique->vk.layout,
+			.set                        = (uint32_t)technique->pushSet,
+
+			.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR,
+
+			.pipelineBindPoint =
+				technique->shaders[GFX_GET_SHADER_STAGE_INDEX_(GFX_STAGE_COMPUTE)] == NULL ?
+				VK_PIPELINE_BIND_POINT_GRAPHICS :
+				VK_PIPELINE_BIND_POINT_COMPUTE
+		};
+
+		GFX_VK_CHECK_(
+			context->vk.CreateDescriptorUpdateTemplate(
+				context->vk.device, &dutci, NULL, &technique->vk.push),
+			goto reset);
+
+		gfx_vec_clear(&pushEntries);
+	}
+
 	// And finally, get rid of the samplers, once we've successfully locked
 	// we already created and used all samplers and cannot unlock.
 	gfx_vec_clear(&technique->samplers);
@@ -1093,10 +1723,13 @@ GFX_API bool gfx_tech_lock(GFXTechnique* technique)
 	// Reset on failure.
 reset:
 	technique->layout = NULL;
+	technique->vk.layout = VK_NULL_HANDLE;
+	technique->vk.push = VK_NULL_HANDLE;
 
 	gfx_vec_clear(&bindings);
 	gfx_vec_clear(&samplers);
 	gfx_vec_clear(&samplerHandles);
+	gfx_vec_clear(&pushEntries);
 
 	for (size_t s = 0; s < technique->numSets; ++s)
 		technique->sets[s].setLayout = NULL;
@@ -6,9 +6,11 @@
  * www     : <www.vuzzel.nl>
  */
 
+#include "groufix/core/jobs.h"
 #include "groufix/core/objects.h"
 #include "shaderc/shaderc.h"
 #include "spirv_cross_c.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -17,6 +19,21 @@
 static_assert(sizeof(uint32_t) == 4, "SPIR-V words must be 4 bytes.");
 
 
+// Binary shader container identification & version.
+#define GFX_SHADER_BIN_MAGIC_ 0x53584647 // 'GFXS'.
+#define GFX_SHADER_BIN_VERSION_ 2
+#define GFX_SHADER_BIN_RESOURCE_SIZE_ 32
+
+// On-disk cache file identification & version.
+#define GFX_SHADER_CACHE_MAGIC_ 0x43584647 // 'GFXC'.
+#define GFX_SHADER_CACHE_VERSION_ 3
+#define GFX_SHADER_CACHE_EXT_ ".gfxc"
+
+// FNV-1a (64 bits) parameters.
+#define GFX_FNV_OFFSET_ 0xcbf29ce484222325
+#define GFX_FNV_PRIME_ 0x100000001b3
+
+
 #define GFX_GET_LANGUAGE_STRING_(language) \
 	((language) == GFX_GLSL ? "glsl" : \
 	(language) == GFX_HLSL ? "hlsl" : "*")
@@ -75,10 +92,74 @@ static_assert(sizeof(uint32_t) == 4, "SPIR-V words must be 4 bytes.");
 
 #define GFX_SET_SHADERC_LIMIT_(shc, vk) \
 	do { \
+		const int gfx_limit_ = (int)pdp.limits.vk; \
 		shaderc_compile_options_set_limit(options, \
-			shaderc_limit_##shc, (int)pdp.limits.vk); \
+			shaderc_limit_##shc, gfx_limit_); \
+		key = gfx_fnv1a_(key, sizeof(gfx_limit_), &gfx_limit_); \
 	} while (0)
 
+#define GFX_BIN_WRITE_(dst, src, size) \
+	do { \
+		if ((size) > 0 && \
+			gfx_io_write(dst, src, size) != (long long)(size)) \
+		{ \
+			goto clean; \
+		} \
+	} while (0)
+
+#define GFX_BIN_READ_U32_(dst) \
+	do { \
+		if ((size_t)(end - ptr) < 4) \
+			goto clean; \
+		dst = (uint32_t)gfx_bin_get_(ptr, 4); \
+		ptr += 4; \
+	} while (0)
+
+#define GFX_BIN_READ_U64_(dst) \
+	do { \
+		if ((size_t)(end - ptr) < 8) \
+			goto clean; \
+		dst = gfx_bin_get_(ptr, 8); \
+		ptr += 8; \
+	} while (0)
+
+#define GFX_BIN_WRITE_U32_(dst, val) \
+	do { \
+		unsigned char gfx_bin_buf_[4]; \
+		gfx_bin_put_(gfx_bin_buf_, 4, (uint32_t)(val)); \
+		GFX_BIN_WRITE_(dst, gfx_bin_buf_, 4); \
+	} while (0)
+
+#define GFX_BIN_WRITE_U64_(dst, val) \
+	do { \
+		unsigned char gfx_bin_buf_[8]; \
+		gfx_bin_put_(gfx_bin_buf_, 8, (uint64_t)(val)); \
+		GFX_BIN_WRITE_(dst, gfx_bin_buf_, 8); \
+	} while (0)
+
+
+/****************************
+ * Include dependency, as recorded while compiling.
+ */
+typedef struct GFXShaderDep_
+{
+	char*    name;
+	uint64_t hash; // Of the included content.
+
+} GFXShaderDep_;
+
+
+/****************************
+ * Includer data to pass to shaderc.
+ */
+typedef struct GFXShaderIncluder_
+{
+	const GFXIncluder* inc;
+	GFXVec*            deps; // Stores GFXShaderDep_, NULL to not record.
+	bool               failed; // Non-zero if a dependency was not recorded.
+
+} GFXShaderIncluder_;
+
 
 /****************************
  * Default shaderc include error.
@@ -93,6 +174,127 @@ const static shaderc_include_result gfx_shaderc_def_error_ = {
 };
 
 
+/****************************
+ * FNV-1a (64 bits) hash, to incrementally build on-disk cache keys with.
+ * @param hash Hash to continue, GFX_FNV_OFFSET_ to start a new one.
+ * @return The new hash.
+ */
+static uint64_t gfx_fnv1a_(uint64_t hash, size_t len, const void* data)
+{
+	const unsigned char* bytes = data;
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= GFX_FNV_PRIME_;
+	}
+
+	return hash;
+}
+
+/****************************
+ * Records an include dependency of a shader being compiled.
+ * On failure, sInc->failed is set.
+ */
+static void gfx_shader_add_dep_(GFXShaderIncluder_* sInc, const char* name,
+                                size_t len, const void* content)
+{
+	// Includes may be resolved many times, only record the first.
+	for (size_t d = 0; d < sInc->deps->size; ++d)
+		if (strcmp(((GFXShaderDep_*)gfx_vec_at(sInc->deps, d))->name, name) == 0)
+			return;
+
+	GFXShaderDep_ dep = {
+		.name = malloc(strlen(name) + 1),
+		.hash = gfx_fnv1a_(GFX_FNV_OFFSET_, len, content)
+	};
+
+	if (dep.name == NULL)
+		goto fail;
+
+	strcpy(dep.name, name);
+
+	if (!gfx_vec_push(sInc->deps, 1, &dep))
+	{
+		free(dep.name);
+		goto fail;
+	}
+
+	return;
+
+
+	// Failed to record.
+fail:
+	sInc->failed = 1;
+}
+
+/****************************
+ * Frees all recorded include dependencies & clears the vector.
+ */
+static void gfx_shader_clear_deps_(GFXVec* deps)
+{
+	for (size_t d = 0; d < deps->size; ++d)
+		free(((GFXShaderDep_*)gfx_vec_at(deps, d))->name);
+
+	gfx_vec_clear(deps);
+}
+
+/****************************
+ * Resolves and hashes the current content of an include dependency.
+ * @return Zero if it could not be resolved.
+ */
+static bool gfx_shader_hash_dep_(const GFXIncluder* inc, const char* name,
+                                 uint64_t* hash)
+{
+	const GFXReader* str = gfx_io_resolve(inc, name);
+	if (str == NULL) return 0;
+
+	const void* content;
+	long long len = gfx_io_raw_init(&content, str);
+
+	if (len <= 0)
+	{
+		gfx_io_release(inc, str);
+		return 0;
+	}
+
+	*hash = gfx_fnv1a_(GFX_FNV_OFFSET_, (size_t)len, content);
+
+	gfx_io_raw_clear(&content, str);
+	gfx_io_release(inc, str);
+
+	return 1;
+}
+
+/****************************
+ * Builds the filename of an on-disk cache file.
+ * @param suffix Appended to the filename, cannot be NULL.
+ * @return Must call free(), NULL on failure.
+ */
+static char* gfx_shader_cache_name_(uint64_t key, const char* suffix)
+{
+	const char* path = groufix_.shaders.path;
+	const size_t pathLen = strlen(path);
+
+	// Insert a separator if the path does not end with one.
+	const bool sep =
+		pathLen > 0 &&
+		path[pathLen-1] != '/' &&
+		path[pathLen-1] != '\\';
+
+	const size_t len =
+		pathLen + (sep ? 1 : 0) + 16 +
+		strlen(GFX_SHADER_CACHE_EXT_) + strlen(suffix) + 1;
+
+	char* name = malloc(len);
+	if (name == NULL) return NULL;
+
+	snprintf(name, len, "%s%s%016"PRIx64"%s%s",
+		path, sep ? "/" : "", key, GFX_SHADER_CACHE_EXT_, suffix);
+
+	return name;
+}
+
 /****************************
  * Callback for SPIRV-Cross errors.
  */
@@ -109,7 +311,8 @@ static shaderc_include_result* gfx_shaderc_resolve_(void* ptr, const char* req,
                                                     int type, const char* src,
                                                     size_t depth)
 {
-	const GFXIncluder* inc = ptr;
+	GFXShaderIncluder_* sInc = ptr;
+	const GFXIncluder* inc = sInc->inc;
 
 	// Allocate new source name so we can return it.
 	const size_t sourceLen = strlen(req);
@@ -155,6 +358,10 @@ static shaderc_include_result* gfx_shaderc_resolve_(void* ptr, const char* req,
 	len = gfx_io_read(str, content, (size_t)len);
 	if (len <= 0) goto clean_content;
 
+	// Record it as a dependency for the on-disk cache.
+	if (sInc->deps != NULL)
+		gfx_shader_add_dep_(sInc, req, (size_t)len, content);
+
 	// Release the stream & output.
 	gfx_io_release(inc, str);
 
@@ -561,12 +768,13 @@ error:
 /****************************
  * Creates a new shader module & metadata to actually use.
  * shader->vk.module must be NULL, no prior shader module must be created.
- * @param shader Cannot be NULL.
- * @param size   Must be a multiple of sizeof(uint32_t).
- * @return Zero on failure.
+ * @param shader  Cannot be NULL.
+ * @param size    Must be a multiple of sizeof(uint32_t).
+ * @param reflect Zero if shader->reflect is already populated.
+ * @return Zero on failure, shader->reflect is cleared on failure.
  */
 static bool gfx_shader_build_(GFXShader* shader,
-                              size_t size, const uint32_t* code)
+                              size_t size, const uint32_t* code, bool reflect)
 {
 	assert(shader != NULL);
 	assert(shader->vk.module == VK_NULL_HANDLE);
@@ -575,7 +783,7 @@ static bool gfx_shader_build_(GFXShader* shader,
 	GFXContext_* context = shader->context;
 
 	// First perform reflection.
-	if (!gfx_shader_reflect_(shader, size, code))
+	if (reflect && !gfx_shader_reflect_(shader, size, code))
 		goto clean_reflect;
 
 	// Then create the Vulkan shader module.
@@ -631,6 +839,494 @@ clean_reflect:
 	return 0;
 }
 
+/****************************
+ * Reads a little-endian unsigned integer from a binary stream.
+ * @param src   Cannot be NULL, must hold at least `bytes` bytes.
+ * @param bytes Must be <= 8.
+ */
+static inline uint64_t gfx_bin_get_(const void* src, size_t bytes)
+{
+	const unsigned char* bytesPtr = src;
+	uint64_t val = 0;
+
+	for (size_t b = 0; b < bytes; ++b)
+		val |= (uint64_t)bytesPtr[b] << (8 * b);
+
+	return val;
+}
+
+/****************************
+ * Writes a little-endian unsigned integer to a binary buffer.
+ * @param dst   Cannot be NULL, must hold at least `bytes` bytes.
+ * @param bytes Must be <= 8.
+ */
+static inline void gfx_bin_put_(void* dst, size_t bytes, uint64_t val)
+{
+	unsigned char* bytesPtr = dst;
+
+	for (size_t b = 0; b < bytes; ++b)
+		bytesPtr[b] = (unsigned char)(val >> (8 * b));
+}
+
+/****************************
+ * Checks whether a resource type is an image with a defined view type.
+ */
+static inline bool gfx_bin_has_view_(int type)
+{
+	return
+		type == GFX_SHADER_IMAGE_AND_SAMPLER_ ||
+		type == GFX_SHADER_IMAGE_SAMPLED_ ||
+		type == GFX_SHADER_IMAGE_STORAGE_;
+}
+
+/****************************
+ * Builds a shader from a binary shader container.
+ * Container layout (all integers little-endian):
+ *  header: magic, version, resource size, stage (uint32_t).
+ *  push constant block size (uint32_t).
+ *  #locations, #sets, #bindings, #constants (uint64_t).
+ *  per resource: id, binding (uint32_t), count, size (uint64_t),
+ *   view type, type (uint32_t), unused fields are written as 0.
+ *  SPIR-V bytecode size (uint64_t) & the bytecode words (uint32_t).
+ * @param shader Cannot be NULL, must not have a shader module yet.
+ * @param out    Optional SPIR-V bytecode output stream.
+ * @return Non-zero if built, zero if not a (valid) container.
+ *
+ * Every value is validated, any corrupt container is rejected.
+ */
+static bool gfx_shader_read_bin_(GFXShader* shader,
+                                 size_t len, const void* bin,
+                                 const GFXWriter* out)
+{
+	assert(shader != NULL);
+	assert(shader->vk.module == VK_NULL_HANDLE);
+
+	const char* ptr = bin;
+	const char* end = ptr + len;
+
+	GFXShaderResource_* resources = NULL;
+	uint32_t* code = NULL;
+	bool success = 0;
+
+	// Validate the header.
+	uint32_t header[4];
+	for (size_t h = 0; h < 4; ++h)
+		GFX_BIN_READ_U32_(header[h]);
+
+	if (
+		header[0] != GFX_SHADER_BIN_MAGIC_ ||
+		header[1] != GFX_SHADER_BIN_VERSION_ ||
+		header[2] != GFX_SHADER_BIN_RESOURCE_SIZE_ ||
+		header[3] != (uint32_t)shader->stage)
+	{
+		goto clean;
+	}
+
+	// Read reflection metadata.
+	// Check each count separately so the sum cannot overflow.
+	uint32_t push;
+	uint64_t counts[4];
+
+	GFX_BIN_READ_U32_(push);
+	for (size_t c = 0; c < 4; ++c)
+		GFX_BIN_READ_U64_(counts[c]);
+
+	const uint64_t maxResources =
+		(uint64_t)(end - ptr) / GFX_SHADER_BIN_RESOURCE_SIZE_;
+
+	if (
+		counts[0] > maxResources || counts[1] > maxResources ||
+		counts[2] > maxResources || counts[3] > maxResources)
+	{
+		goto clean;
+	}
+
+	const uint64_t numResources = counts[0] + counts[2] + counts[3];
+	if (numResources > maxResources)
+		goto clean;
+
+	if (numResources > 0)
+	{
+		resources = malloc(sizeof(GFXShaderResource_) * numResources);
+		if (resources == NULL) goto clean;
+	}
+
+	// Read & validate all resources, in the order reflection outputs them:
+	// vert/frag io, then bindings sorted by set/binding, then constants.
+	uint64_t numSets = 0;
+
+	for (uint64_t r = 0; r < numResources; ++r)
+	{
+		uint32_t id, binding, viewType, type;
+		uint64_t count, size;
+
+		GFX_BIN_READ_U32_(id);
+		GFX_BIN_READ_U32_(binding);
+		GFX_BIN_READ_U64_(count);
+		GFX_BIN_READ_U64_(size);
+		GFX_BIN_READ_U32_(viewType);
+		GFX_BIN_READ_U32_(type);
+
+		const bool isLocation = r < counts[0];
+		const bool isConstant = r >= counts[0] + counts[2];
+		const bool isBinding = !isLocation && !isConstant;
+
+		if (
+			count > SIZE_MAX || size > SIZE_MAX ||
+			viewType > GFX_VIEW_3D ||
+			(!gfx_bin_has_view_((int)type) && viewType != 0) ||
+			(isLocation &&
+				type != GFX_SHADER_VERTEX_INPUT_ &&
+				type != GFX_SHADER_FRAGMENT_OUTPUT_) ||
+			(isBinding &&
+				(type < GFX_SHADER_BUFFER_UNIFORM_ ||
+				type > GFX_SHADER_ATTACHMENT_INPUT_)) ||
+			(isConstant &&
+				type != GFX_SHADER_CONSTANT_))
+		{
+			goto clean;
+		}
+
+		// Bindings must be sorted, count the sets they use.
+		if (isBinding && r > counts[0])
+		{
+			const GFXShaderResource_* bef = resources + (r-1);
+
+			if (bef->set > id || (bef->set == id && bef->binding > binding))
+				goto clean;
+
+			if (bef->set < id)
+				++numSets;
+		}
+		else if (isBinding)
+			++numSets;
+
+		resources[r] = (GFXShaderResource_){
+			.id = id,
+			.binding = binding,
+			.count = (size_t)count,
+			.size = (size_t)size,
+			.viewType = (GFXViewType)viewType,
+			.type = type
+		};
+	}
+
+	if (numSets != counts[1])
+		goto clean;
+
+	// Read the SPIR-V bytecode, copy so it is properly aligned.
+	uint64_t size;
+	GFX_BIN_READ_U64_(size);
+
+	if (
+		size == 0 || size % sizeof(uint32_t) != 0 ||
+		size > (uint64_t)(end - ptr))
+	{
+		goto clean;
+	}
+
+	code = malloc((size_t)size);
+	if (code == NULL) goto clean;
+
+	for (size_t w = 0; w < (size_t)size / sizeof(uint32_t); ++w)
+		GFX_BIN_READ_U32_(code[w]);
+
+	// Build the shader with the given reflection metadata.
+	// On failure, the metadata (and resources) are freed by build.
+	shader->reflect.push = push;
+	shader->reflect.locations = (size_t)counts[0];
+	shader->reflect.sets = (size_t)counts[1];
+	shader->reflect.bindings = (size_t)counts[2];
+	shader->reflect.constants = (size_t)counts[3];
+	shader->reflect.resources = resources;
+
+	resources = NULL;
+	success = gfx_shader_build_(shader, (size_t)size, code, 0);
+
+	// Stream out the SPIR-V bytecode, like a compile would.
+	if (success && out != NULL && gfx_io_write(out, code, (size_t)size) > 0)
+		gfx_log_info(
+			"Written SPIR-V to stream (%"GFX_PRIs" bytes).",
+			(size_t)size);
+
+
+	// Cleanup.
+clean:
+	free(resources);
+	free(code);
+
+	return success;
+}
+
+/****************************
+ * Writes a built shader as binary shader container.
+ * @see gfx_shader_read_bin_ for the layout.
+ * @param shader Cannot be NULL, must be built.
+ * @param dst    Cannot be NULL.
+ * @param size   Must be a multiple of sizeof(uint32_t).
+ * @param code   SPIR-V bytecode the shader was built from.
+ * @return Zero on failure.
+ */
+static bool gfx_shader_write_bin_(GFXShader* shader, const GFXWriter* dst,
+                                  size_t size, const void* code)
+{
+	assert(shader != NULL);
+	assert(dst != NULL);
+	assert(size % sizeof(uint32_t) == 0);
+
+	const size_t locations = shader->reflect.locations;
+	const size_t bindings = shader->reflect.bindings;
+	const size_t numResources =
+		locations + bindings + shader->reflect.constants;
+
+	GFX_BIN_WRITE_U32_(dst, GFX_SHADER_BIN_MAGIC_);
+	GFX_BIN_WRITE_U32_(dst, GFX_SHADER_BIN_VERSION_);
+	GFX_BIN_WRITE_U32_(dst, GFX_SHADER_BIN_RESOURCE_SIZE_);
+	GFX_BIN_WRITE_U32_(dst, shader->stage);
+
+	GFX_BIN_WRITE_U32_(dst, shader->reflect.push);
+	GFX_BIN_WRITE_U64_(dst, locations);
+	GFX_BIN_WRITE_U64_(dst, shader->reflect.sets);
+	GFX_BIN_WRITE_U64_(dst, bindings);
+	GFX_BIN_WRITE_U64_(dst, shader->reflect.constants);
+
+	// Write each field, leaving out those that reflection left undefined.
+	for (size_t r = 0; r < numResources; ++r)
+	{
+		const GFXShaderResource_* res = shader->reflect.resources + r;
+		const bool isBinding = r >= locations && r < locations + bindings;
+
+		GFX_BIN_WRITE_U32_(dst, res->id);
+		GFX_BIN_WRITE_U32_(dst, isBinding ? res->binding : 0);
+		GFX_BIN_WRITE_U64_(dst, res->count);
+		GFX_BIN_WRITE_U64_(dst,
+			res->type != GFX_SHADER_CONSTANT_ ? res->size : 0);
+		GFX_BIN_WRITE_U32_(dst,
+			gfx_bin_has_view_(res->type) ? res->viewType : 0);
+		GFX_BIN_WRITE_U32_(dst, res->type);
+	}
+
+	// Write the SPIR-V bytecode, in chunks of words.
+	const uint32_t* words = code;
+	const size_t numWords = size / sizeof(uint32_t);
+
+	GFX_BIN_WRITE_U64_(dst, size);
+
+	for (size_t w = 0; w < numWords; )
+	{
+		unsigned char chunk[1024];
+		size_t c = 0;
+
+		for (; w < numWords && c < sizeof(chunk); ++w, c += 4)
+			gfx_bin_put_(chunk + c, 4, words[w]);
+
+		GFX_BIN_WRITE_(dst, chunk, c);
+	}
+
+	return 1;
+
+
+	// Failure.
+clean:
+	return 0;
+}
+
+/****************************
+ * Attempts to load a shader from the on-disk cache.
+ * Validates all recorded include dependencies against their current content.
+ * Cache file layout (all integers little-endian):
+ *  header: magic, version, #dependencies (uint32_t), key (uint64_t).
+ *  per dependency: name length (uint32_t), name, content hash (uint64_t).
+ *  a binary shader container.
+ * @param shader Cannot be NULL, must not have a shader module yet.
+ * @param inc    Includer to resolve dependencies with, may be NULL.
+ * @param out    Optional SPIR-V bytecode output stream.
+ * @param bin    Optional binary shader container output stream.
+ * @return Non-zero if loaded & built.
+ */
+static bool gfx_shader_cache_load_(GFXShader* shader, uint64_t key,
+                                   const GFXIncluder* inc,
+                                   const GFXWriter* out, const GFXWriter* bin)
+{
+	assert(shader != NULL);
+	assert(groufix_.shaders.path != NULL);
+
+	char* name = gfx_shader_cache_name_(key, "");
+	if (name == NULL) return 0;
+
+	// Open & read the entire file, silently fail if it does not exist.
+	GFXFile file;
+	bool opened = gfx_file_init(&file, name, "rb");
+	free(name);
+
+	if (!opened) return 0;
+
+	const void* raw;
+	long long len = gfx_io_raw_init(&raw, &file.reader);
+
+	if (len <= 0)
+	{
+		gfx_file_clear(&file);
+		return 0;
+	}
+
+	const char* ptr = raw;
+	const char* end = ptr + len;
+	bool success = 0;
+
+	// Validate the header.
+	uint32_t header[3];
+	uint64_t fileKey;
+
+	for (size_t h = 0; h < 3; ++h)
+		GFX_BIN_READ_U32_(header[h]);
+
+	GFX_BIN_READ_U64_(fileKey);
+
+	if (
+		header[0] != GFX_SHADER_CACHE_MAGIC_ ||
+		header[1] != GFX_SHADER_CACHE_VERSION_ ||
+		fileKey != key)
+	{
+		goto clean;
+	}
+
+	// Validate all include dependencies, if any include changed,
+	// consider it a miss, it will be overwritten after compiling.
+	for (uint32_t d = 0; d < header[2]; ++d)
+	{
+		uint32_t nameLen;
+		uint64_t hash, curHash;
+
+		GFX_BIN_READ_U32_(nameLen);
+
+		const char* depName = ptr;
+		if (
+			nameLen == 0 ||
+			(size_t)(end - ptr) < nameLen ||
+			depName[nameLen-1] != '\0')
+		{
+			goto clean;
+		}
+
+		ptr += nameLen;
+		GFX_BIN_READ_U64_(hash);
+
+		if (
+			inc == NULL ||
+			!gfx_shader_hash_dep_(inc, depName, &curHash) ||
+			curHash != hash)
+		{
+			gfx_log_debug(
+				"Cached %s shader invalidated by include: %s.",
+				GFX_GET_STAGE_STRING_(shader->stage), depName);
+
+			goto clean;
+		}
+	}
+
+	// The rest is a binary shader container.
+	success = gfx_shader_read_bin_(shader, (size_t)(end - ptr), ptr, out);
+
+	// Which we can stream out as is.
+	if (success && bin != NULL && gfx_io_write(bin, ptr, (size_t)(end - ptr)) > 0)
+		gfx_log_info(
+			"Written binary shader to stream (%"GFX_PRIs" bytes).",
+			(size_t)(end - ptr));
+
+
+	// Cleanup.
+clean:
+	gfx_io_raw_clear(&raw, &file.reader);
+	gfx_file_clear(&file);
+
+	return success;
+}
+
+/****************************
+ * Stores a built shader in the on-disk cache.
+ * Writes to a temporary file first, so no partial files are ever read.
+ * @see gfx_shader_cache_load_ for the layout.
+ * @param shader Cannot be NULL, must be built.
+ * @param deps   Recorded include dependencies, stores GFXShaderDep_.
+ * @param size   Must be a multiple of sizeof(uint32_t).
+ */
+static void gfx_shader_cache_store_(GFXShader* shader, uint64_t key,
+                                    const GFXVec* deps,
+                                    size_t size, const void* code)
+{
+	assert(shader != NULL);
+	assert(deps != NULL);
+	assert(groufix_.shaders.path != NULL);
+
+	// Make the temporary file unique to this shader,
+	// in case the same shader is compiled concurrently.
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), ".%"PRIuPTR".tmp", shader->handle);
+
+	char* name = gfx_shader_cache_name_(key, "");
+	char* temp = gfx_shader_cache_name_(key, suffix);
+
+	if (name == NULL || temp == NULL)
+		goto clean_names;
+
+	GFXFile file;
+	if (!gfx_file_init(&file, temp, "wb"))
+		goto clean_names;
+
+	// Write the header.
+	GFX_BIN_WRITE_U32_(&file.writer, GFX_SHADER_CACHE_MAGIC_);
+	GFX_BIN_WRITE_U32_(&file.writer, GFX_SHADER_CACHE_VERSION_);
+	GFX_BIN_WRITE_U32_(&file.writer, deps->size);
+	GFX_BIN_WRITE_U64_(&file.writer, key);
+
+	// Write all include dependencies.
+	for (size_t d = 0; d < deps->size; ++d)
+	{
+		const GFXShaderDep_* dep = gfx_vec_at(deps, d);
+		const uint32_t nameLen = (uint32_t)strlen(dep->name) + 1;
+
+		GFX_BIN_WRITE_U32_(&file.writer, nameLen);
+		GFX_BIN_WRITE_(&file.writer, dep->name, nameLen);
+		GFX_BIN_WRITE_U64_(&file.writer, dep->hash);
+	}
+
+	// And the binary shader container.
+	if (!gfx_shader_write_bin_(shader, &file.writer, size, code))
+		goto clean;
+
+	// Close & move it in place.
+	// Remove the destination first, rename may not overwrite.
+	gfx_file_clear(&file);
+	remove(name);
+
+	if (rename(temp, name) != 0)
+	{
+		remove(temp);
+		gfx_log_warn(
+			"Could not store %s shader in cache: %s.",
+			GFX_GET_STAGE_STRING_(shader->stage), name);
+	}
+
+	free(name);
+	free(temp);
+
+	return;
+
+
+	// Cleanup on failure.
+clean:
+	gfx_file_clear(&file);
+	remove(temp);
+clean_names:
+	gfx_log_warn(
+		"Could not store %s shader in cache.",
+		GFX_GET_STAGE_STRING_(shader->stage));
+
+	free(name);
+	free(temp);
+}
+
 /****************************
  * Generates a unique-ish 'ID' for the shader to use as hashable cache handles.
  */
@@ -711,13 +1407,19 @@ GFX_API GFXDevice* gfx_shader_get_device(GFXShader* shader)
 	return (GFXDevice*)shader->device;
 }
 
-/****************************/
-GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
-                                bool optimize,
+/****************************
+ * Compiles a shader using an existing shaderc compiler.
+ * @see gfx_shader_compile_bin.
+ * @param compiler Cannot be NULL, may be reused for other shaders.
+ */
+static bool gfx_shader_compile_(GFXShader* shader, shaderc_compiler_t compiler,
+                                GFXShaderLanguage language, bool optimize,
                                 const GFXReader* src, const GFXIncluder* inc,
-                                const GFXWriter* out, const GFXWriter* err)
+                                const GFXWriter* out, const GFXWriter* bin,
+                                const GFXWriter* err)
 {
 	assert(shader != NULL);
+	assert(compiler != NULL);
 	assert(src != NULL);
 
 	GFXDevice_* device = shader->device;
@@ -739,21 +1441,52 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 		return 0;
 	}
 
-	// Create compiler and compile options.
-	// We create new resources for every shader,
-	// this presumably makes it pretty much thread-safe.
-	shaderc_compiler_t compiler =
-		shaderc_compiler_initialize();
+	// Start building the on-disk cache key.
+	// Contains everything that influences the output, GPU limits are
+	// appended when they are set.
+	// Note: include dependencies are validated when loading from the cache.
+	const bool cache = groufix_.shaders.path != NULL;
+#if !defined (NDEBUG)
+	const bool debug = 1;
+#else
+	const bool debug = 0;
+#endif
+
+	// Omits patch version, same as the compiler's target environment.
+	const uint32_t api = VK_MAKE_API_VERSION(0,
+		VK_API_VERSION_MAJOR(device->api),
+		VK_API_VERSION_MINOR(device->api), 0);
+
+	uint64_t key = GFX_FNV_OFFSET_;
+	key = gfx_fnv1a_(key, sizeof(shader->stage), &shader->stage);
+	key = gfx_fnv1a_(key, sizeof(language), &language);
+	key = gfx_fnv1a_(key, sizeof(optimize), &optimize);
+	key = gfx_fnv1a_(key, sizeof(debug), &debug);
+	key = gfx_fnv1a_(key, sizeof(api), &api);
+	key = gfx_fnv1a_(key, (size_t)len, source);
+
+	// Include dependencies to store in the cache.
+	GFXVec deps;
+	gfx_vec_init(&deps, sizeof(GFXShaderDep_));
+
+	GFXShaderIncluder_ sInc = {
+		.inc = inc,
+		.deps = cache ? &deps : NULL,
+		.failed = 0
+	};
+
+	// Create compile options.
+	// The compiler is given, options are specific to every shader.
 	shaderc_compile_options_t options =
 		shaderc_compile_options_initialize();
 
-	if (compiler == NULL || options == NULL)
+	if (options == NULL)
 	{
 		gfx_log_error(
 			"Could not initialize resources to compile %s shader.",
 			GFX_GET_STAGE_STRING_(shader->stage));
 
-		goto clean_compiler;
+		goto clean_options;
 	}
 
 	// Set source language.
@@ -780,7 +1513,7 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 			options,
 			gfx_shaderc_resolve_,
 			gfx_shaderc_release_,
-			(GFXIncluder*)inc);
+			&sInc);
 
 	// Add all these options only if we compile for this specific platform.
 	// This will enable optimization for the target API and GPU limits.
@@ -834,6 +1567,30 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 			maxComputeWorkGroupSize[2]);
 	}
 
+	// Try to load it from the on-disk cache first.
+	if (cache)
+	{
+		if (gfx_shader_cache_load_(shader, key, inc, out, bin))
+		{
+			atomic_fetch_add_explicit(
+				&groufix_.shaders.hits, 1, memory_order_relaxed);
+
+			gfx_log_debug(
+				"Loaded %s shader from cache (%016"PRIx64").",
+				GFX_GET_STAGE_STRING_(shader->stage), key);
+
+			shaderc_compile_options_release(options);
+
+			gfx_shader_clear_deps_(&deps);
+			gfx_io_raw_clear(&source, src);
+
+			return 1;
+		}
+
+		atomic_fetch_add_explicit(
+			&groufix_.shaders.misses, 1, memory_order_relaxed);
+	}
+
 	// Compile the shader.
 	shaderc_compilation_result_t result = shaderc_compile_into_spv(
 		compiler, (const char*)source, (size_t)len,
@@ -893,7 +1650,7 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 			size);
 
 	// Lastly, attempt to build the shader module.
-	if (!gfx_shader_build_(shader, wordSize, (const uint32_t*)bytes))
+	if (!gfx_shader_build_(shader, wordSize, (const uint32_t*)bytes, 1))
 	{
 		gfx_log_error(
 			"Failed to load compiled %s shader.",
@@ -902,11 +1659,23 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 		goto clean_result;
 	}
 
+	// Stream out the binary shader container, now we have reflection.
+	if (bin != NULL && gfx_shader_write_bin_(shader, bin, wordSize, bytes))
+		gfx_log_info(
+			"Written binary shader to stream (%"GFX_PRIs" bytes).",
+			wordSize);
+
+	// Store it in the on-disk cache,
+	// unless we failed to record all include dependencies.
+	if (cache && !sInc.failed)
+		gfx_shader_cache_store_(
+			shader, key, &deps, wordSize, (const uint32_t*)bytes);
+
 	// Get rid of the resources and return.
 	shaderc_result_release(result);
-	shaderc_compiler_release(compiler);
 	shaderc_compile_options_release(options);
 
+	gfx_shader_clear_deps_(&deps);
 	gfx_io_raw_clear(&source, src);
 
 	return 1;
@@ -915,15 +1684,211 @@ GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
 	// Cleanup on failure.
 clean_result:
 	shaderc_result_release(result);
-clean_compiler:
-	shaderc_compiler_release(compiler);
+clean_options:
 	shaderc_compile_options_release(options);
 
+	gfx_shader_clear_deps_(&deps);
 	gfx_io_raw_clear(&source, src);
 
 	return 0;
 }
 
+/****************************
+ * Shared state of a batch of shaders to compile.
+ */
+typedef struct GFXShaderBatch_
+{
+	GFXShader**            shaders;
+	const GFXShaderSource* sources;
+	bool*                  results; // May be NULL.
+
+	shaderc_compiler_t* compilers; // One for each job worker, lazily created.
+	atomic_size_t       compiled;  // #successfully compiled shaders.
+
+} GFXShaderBatch_;
+
+
+/****************************
+ * Shader compile job, compiles a range of shaders of a batch.
+ * Uses a single shaderc compiler for each worker.
+ * @param ptr Must be a GFXShaderBatch_*.
+ */
+static void gfx_shader_batch_job_(size_t worker, size_t first, size_t count,
+                                  void* ptr)
+{
+	GFXShaderBatch_* batch = ptr;
+
+	// No two concurrent invocations share a worker,
+	// so we can safely create its compiler on first use.
+	if (batch->compilers[worker] == NULL)
+	{
+		batch->compilers[worker] = shaderc_compiler_initialize();
+		if (batch->compilers[worker] == NULL)
+		{
+			gfx_log_error("Could not initialize resources to compile shaders.");
+			return;
+		}
+	}
+
+	for (size_t s = first; s < first + count; ++s)
+	{
+		const GFXShaderSource* source = batch->sources + s;
+
+		const bool result = gfx_shader_compile_(
+			batch->shaders[s], batch->compilers[worker],
+			source->language, source->optimize,
+			source->src, source->inc,
+			source->out, source->bin, source->err);
+
+		if (batch->results != NULL)
+			batch->results[s] = result;
+		if (result)
+			atomic_fetch_add(&batch->compiled, 1);
+	}
+}
+
+/****************************/
+GFX_API bool gfx_shader_compile(GFXShader* shader, GFXShaderLanguage language,
+                                bool optimize,
+                                const GFXReader* src, const GFXIncluder* inc,
+                                const GFXWriter* out, const GFXWriter* err)
+{
+	assert(shader != NULL);
+	assert(src != NULL);
+
+	return gfx_shader_compile_bin(
+		shader, language, optimize, src, inc, out, NULL, err);
+}
+
+/****************************/
+GFX_API bool gfx_shader_compile_bin(GFXShader* shader, GFXShaderLanguage language,
+                                    bool optimize,
+                                    const GFXReader* src, const GFXIncluder* inc,
+                                    const GFXWriter* out, const GFXWriter* bin,
+                                    const GFXWriter* err)
+{
+	assert(shader != NULL);
+	assert(src != NULL);
+
+	// Create a compiler for just this shader.
+	shaderc_compiler_t compiler = shaderc_compiler_initialize();
+	if (compiler == NULL)
+	{
+		gfx_log_error(
+			"Could not initialize resources to compile %s shader.",
+			GFX_GET_STAGE_STRING_(shader->stage));
+
+		return 0;
+	}
+
+	const bool result = gfx_shader_compile_(
+		shader, compiler, language, optimize, src, inc, out, bin, err);
+
+	shaderc_compiler_release(compiler);
+
+	return result;
+}
+
+/****************************/
+GFX_API size_t gfx_shaders_compile(size_t numShaders, GFXShader** shaders,
+                                   const GFXShaderSource* sources,
+                                   bool* results)
+{
+	assert(numShaders == 0 || shaders != NULL);
+	assert(numShaders == 0 || sources != NULL);
+
+	if (numShaders == 0)
+		return 0;
+
+	if (results != NULL)
+		for (size_t s = 0; s < numShaders; ++s)
+			results[s] = 0;
+
+	// Compile on all job workers, each worker creates its own compiler.
+	// Shaders take long to compile, so distribute them one by one.
+	const size_t numWorkers = gfx_job_get_num_workers();
+	shaderc_compiler_t compilers[numWorkers];
+
+	for (size_t w = 0; w < numWorkers; ++w)
+		compilers[w] = NULL;
+
+	GFXShaderBatch_ batch = {
+		.shaders = shaders,
+		.sources = sources,
+		.results = results,
+		.compilers = compilers
+	};
+
+	atomic_store(&batch.compiled, 0);
+	gfx_job_for(numShaders, 1, gfx_shader_batch_job_, &batch);
+
+	size_t used = 0;
+	for (size_t w = 0; w < numWorkers; ++w)
+		if (compilers[w] != NULL)
+			shaderc_compiler_release(compilers[w]), ++used;
+
+	// Report & return.
+	const size_t compiled = atomic_load(&batch.compiled);
+
+	if (compiled < numShaders) gfx_log_error(
+		"Failed to compile %"GFX_PRIs" of %"GFX_PRIs" shaders.",
+		numShaders - compiled, numShaders);
+	else gfx_log_debug(
+		"Successfully compiled %"GFX_PRIs" shaders on %"GFX_PRIs" workers.",
+		numShaders, used);
+
+	return compiled;
+}
+
+/****************************/
+GFX_API bool gfx_shader_cache(const char* path)
+{
+	assert(atomic_load(&groufix_.initialized));
+
+	// Report on the previous cache directory.
+	uint64_t hits, misses;
+	gfx_shader_cache_stats(&hits, &misses);
+
+	if (hits + misses > 0) gfx_log_info(
+		"Shader cache (%s): %"PRIu64" hits, %"PRIu64" misses "
+		"(%.1f%% hit rate).",
+		groufix_.shaders.path, hits, misses,
+		100.0 * (double)hits / (double)(hits + misses));
+
+	free(groufix_.shaders.path);
+	groufix_.shaders.path = NULL;
+
+	atomic_store_explicit(&groufix_.shaders.hits, 0, memory_order_relaxed);
+	atomic_store_explicit(&groufix_.shaders.misses, 0, memory_order_relaxed);
+
+	// Disable if no path.
+	if (path == NULL)
+		return 1;
+
+	char* copy = malloc(strlen(path) + 1);
+	if (copy == NULL)
+	{
+		gfx_log_error("Could not set shader cache directory: %s.", path);
+		return 0;
+	}
+
+	strcpy(copy, path);
+	groufix_.shaders.path = copy;
+
+	return 1;
+}
+
+/****************************/
+GFX_API void gfx_shader_cache_stats(uint64_t* hits, uint64_t* misses)
+{
+	assert(atomic_load(&groufix_.initialized));
+	assert(hits != NULL);
+	assert(misses != NULL);
+
+	*hits = atomic_load_explicit(&groufix_.shaders.hits, memory_order_relaxed);
+	*misses = atomic_load_explicit(&groufix_.shaders.misses, memory_order_relaxed);
+}
+
 /****************************/
 GFX_API bool gfx_shader_load(GFXShader* shader, const GFXReader* src)
 {
@@ -947,12 +1912,26 @@ GFX_API bool gfx_shader_load(GFXShader* shader, const GFXReader* src)
 		return 0;
 	}
 
-	// Attempt to build the shader module.
-	// Round the size to a multiple of 4 just in case it isn't.
-	const size_t wordSize =
-		((size_t)len / sizeof(uint32_t)) * sizeof(uint32_t);
+	// Check if it is a binary shader container,
+	// if so, we can skip reflection entirely.
+	uint32_t magic = 0;
+	if ((size_t)len >= sizeof(magic))
+		memcpy(&magic, source, sizeof(magic));
+
+	bool built;
+
+	if (magic == GFX_SHADER_BIN_MAGIC_)
+		built = gfx_shader_read_bin_(shader, (size_t)len, source, NULL);
+	else
+	{
+		// Attempt to build the shader module.
+		// Round the size to a multiple of 4 just in case it isn't.
+		const size_t wordSize =
+			((size_t)len / sizeof(uint32_t)) * sizeof(uint32_t);
+
+		built = gfx_shader_build_(shader, wordSize, source, 1);
+	}
 
-	bool built = gfx_shader_build_(shader, wordSize, source);
 	if (!built)
 		gfx_log_error(
 			"Failed to load %s shader.",
@@ -14,12 +14,33 @@
 
 #if defined (GFX_UNIX)
 	#include <pthread.h>
+	#include <unistd.h>
 #elif defined (GFX_WIN32)
+	#include <handleapi.h>
 	#include <processthreadsapi.h>
 	#include <synchapi.h>
+	#include <sysinfoapi.h>
 #endif
 
 
+/**
+ * Thread handle & entry point return type.
+ * Entry points must be declared as:
+ *  GFXThreadRet_ GFX_THREAD_CALL_ name(void* arg);
+ */
+#if defined (GFX_UNIX)
+	typedef pthread_t GFXThread_;
+	typedef void*     GFXThreadRet_;
+	#define GFX_THREAD_CALL_
+#elif defined (GFX_WIN32)
+	typedef HANDLE GFXThread_;
+	typedef DWORD  GFXThreadRet_;
+	#define GFX_THREAD_CALL_ WINAPI
+#endif
+
+typedef GFXThreadRet_ (GFX_THREAD_CALL_ *GFXThreadFunc_)(void*);
+
+
 /**
  * Thread local data key.
  */
@@ -50,6 +71,74 @@
 #endif
 
 
+/**
+ * Condition variable.
+ */
+#if defined (GFX_UNIX)
+	typedef pthread_cond_t     GFXCond_;
+#elif defined (GFX_WIN32)
+	typedef CONDITION_VARIABLE GFXCond_;
+#endif
+
+
+/****************************
+ * Threads.
+ ****************************/
+
+/**
+ * Creates & starts a new thread.
+ * Must eventually be joined with gfx_thread_join_.
+ * @param thread Cannot be NULL.
+ * @param func   Entry point, cannot be NULL.
+ * @return Non-zero on success.
+ */
+static inline bool gfx_thread_init_(GFXThread_* thread,
+                                    GFXThreadFunc_ func, void* arg)
+{
+#if defined (GFX_UNIX)
+	return !pthread_create(thread, NULL, func, arg);
+
+#elif defined (GFX_WIN32)
+	*thread = CreateThread(NULL, 0, func, arg, 0, NULL);
+	return *thread != NULL;
+
+#endif
+}
+
+/**
+ * Blocks until a thread has terminated & frees its resources.
+ */
+static inline void gfx_thread_join_(GFXThread_ thread)
+{
+#if defined (GFX_UNIX)
+	pthread_join(thread, NULL);
+
+#elif defined (GFX_WIN32)
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+
+#endif
+}
+
+/**
+ * Retrieves the number of logical processors, i.e. useful #threads.
+ * @return At least 1.
+ */
+static inline size_t gfx_thread_concurrency_(void)
+{
+#if defined (GFX_UNIX)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (size_t)count : 1;
+
+#elif defined (GFX_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+
+#endif
+}
+
+
 /****************************
  * Thread local data key.
  ****************************/
@@ -337,4 +426,87 @@ static inline void gfx_rwlock_wunlock_(GFXRWLock_* lock)
 }
 
 
+
+/****************************
+ * Condition variable.
+ ****************************/
+
+/**
+ * Initializes a condition variable.
+ * The object pointed to by cond cannot be moved or copied!
+ * @return Non-zero on success.
+ */
+static inline bool gfx_cond_init_(GFXCond_* cond)
+{
+#if defined (GFX_UNIX)
+	return !pthread_cond_init(cond, NULL);
+
+#elif defined (GFX_WIN32)
+	InitializeConditionVariable(cond);
+	return 1;
+
+#endif
+}
+
+/**
+ * Clears a condition variable.
+ * Clearing a condition variable that is waited on is undefined behaviour.
+ */
+static inline void gfx_cond_clear_(GFXCond_* cond)
+{
+#if defined (GFX_UNIX)
+	pthread_cond_destroy(cond);
+
+#elif defined (GFX_WIN32)
+	/* No-op */
+
+#endif
+}
+
+/**
+ * Atomically releases the mutex & blocks until the condition is signaled.
+ * The mutex must be owned by the calling thread and is owned again on return.
+ *
+ * Spurious wakeups may occur, always wait in a loop!
+ */
+static inline void gfx_cond_wait_(GFXCond_* cond, GFXMutex_* mutex)
+{
+#if defined (GFX_UNIX)
+	pthread_cond_wait(cond, mutex);
+
+#elif defined (GFX_WIN32)
+	SleepConditionVariableSRW(cond, mutex, INFINITE, 0);
+
+#endif
+}
+
+/**
+ * Unblocks at least one of the threads waiting on the condition.
+ */
+static inline void gfx_cond_signal_(GFXCond_* cond)
+{
+#if defined (GFX_UNIX)
+	pthread_cond_signal(cond);
+
+#elif defined (GFX_WIN32)
+	WakeConditionVariable(cond);
+
+#endif
+}
+
+/**
+ * Unblocks all threads waiting on the condition.
+ */
+static inline void gfx_cond_broadcast_(GFXCond_* cond)
+{
+#if defined (GFX_UNIX)
+	pthread_cond_broadcast(cond);
+
+#elif defined (GFX_WIN32)
+	WakeAllConditionVariable(cond);
+
+#endif
+}
+
+
 #endif
@@ -0,0 +1,412 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#include "groufix/drawers/cull.h"
+#include "groufix/containers/io.h"
+#include "groufix/core/log.h"
+#include <math.h>
+#include <string.h>
+
+
+// Compute shader workgroup size.
+#define GFX_CULL_GROUP_SIZE_ 64
+
+// #uint32_t counters before the draw commands of each frame.
+#define GFX_CULL_COUNTERS_ 4
+
+// Size of the output of a single frame, in bytes.
+#define GFX_CULL_FRAME_SIZE_(numInstances) \
+	(sizeof(uint32_t) * GFX_CULL_COUNTERS_ + \
+	sizeof(GFXDrawIndexedCmd) * (uint64_t)(numInstances))
+
+
+/****************************
+ * Instance as uploaded to the GPU (std430 layout).
+ */
+typedef struct GFXCullData_
+{
+	float sphere[4];  // { center, radius }.
+	float extents[4]; // { extents, unused }.
+
+	GFXDrawIndexedCmd cmd;
+	uint32_t          pad[3];
+
+} GFXCullData_;
+
+
+static_assert(
+	sizeof(GFXCullData_) == 64,
+	"sizeof(GFXCullData_) must equal 64 (std430 layout).");
+
+
+/****************************
+ * Push constants of the compute shader (std430 layout).
+ */
+typedef struct GFXCullPush_
+{
+	float    planes[6][4];
+	uint32_t numInstances;
+	uint32_t base; // Offset of this frame's output, in #uint32_t.
+
+} GFXCullPush_;
+
+
+/****************************
+ * Compute shader GLSL source to cull with.
+ *
+ * Every visible instance appends its draw command to the output of the
+ * current frame, counted by an atomic counter. The last workgroup to finish
+ * (counted by a second counter) publishes the draw count and resets both
+ * counters for the next time this frame is used.
+ */
+static const char* gfx_cull_comp_glsl_ =
+	"#version 450\n"
+	"layout(local_size_x = 64) in;\n"
+	"struct Instance {\n"
+	"  vec4 sphere;\n"
+	"  vec4 extents;\n"
+	"  uint indices, instances, firstIndex;\n"
+	"  int  vertexOffset;\n"
+	"  uint firstInstance, pad0, pad1, pad2;\n"
+	"};\n"
+	"layout(set = 0, binding = 0, std430) readonly buffer Instances {\n"
+	"  Instance instances[];\n"
+	"};\n"
+	"layout(set = 0, binding = 1, std430) coherent buffer Output {\n"
+	"  uint data[];\n"
+	"};\n"
+	"layout(push_constant) uniform Push {\n"
+	"  vec4 planes[6];\n"
+	"  uint numInstances;\n"
+	"  uint base;\n"
+	"} push;\n"
+	"void main() {\n"
+	"  uint i = gl_GlobalInvocationID.x;\n"
+	"  if (i < push.numInstances) {\n"
+	"    Instance inst = instances[i];\n"
+	"    bool visible = true;\n"
+	"    for (int p = 0; p < 6; ++p) {\n"
+	"      vec4 pl = push.planes[p];\n"
+	"      float d = dot(pl.xyz, inst.sphere.xyz) + pl.w +\n"
+	"        dot(abs(pl.xyz), inst.extents.xyz) + inst.sphere.w;\n"
+	"      visible = visible && (d >= 0.0);\n"
+	"    }\n"
+	"    if (visible) {\n"
+	"      uint o = push.base + 4u + 5u * atomicAdd(data[push.base], 1u);\n"
+	"      data[o + 0u] = inst.indices;\n"
+	"      data[o + 1u] = inst.instances;\n"
+	"      data[o + 2u] = inst.firstIndex;\n"
+	"      data[o + 3u] = uint(inst.vertexOffset);\n"
+	"      data[o + 4u] = inst.firstInstance;\n"
+	"    }\n"
+	"  }\n"
+	"  memoryBarrierBuffer();\n"
+	"  barrier();\n"
+	"  if (gl_LocalInvocationIndex == 0u &&\n"
+	"    atomicAdd(data[push.base + 1u], 1u) == gl_NumWorkGroups.x - 1u)\n"
+	"  {\n"
+	"    data[push.base + 2u] = atomicExchange(data[push.base], 0u);\n"
+	"    atomicExchange(data[push.base + 1u], 0u);\n"
+	"  }\n"
+	"}\n";
+
+
+/****************************
+ * Frees all uploaded instance data of a drawer.
+ * @param drawer Cannot be NULL.
+ */
+static void gfx_cull_free_(GFXCullDrawer* drawer)
+{
+	assert(drawer != NULL);
+
+	if (drawer->set != NULL) gfx_erase_set(drawer->set);
+	gfx_free_buffer(drawer->instances);
+	gfx_free_buffer(drawer->out);
+
+	drawer->numInstances = 0;
+	drawer->instances = NULL;
+	drawer->out = NULL;
+	drawer->set = NULL;
+}
+
+/****************************/
+GFX_API bool gfx_cull_init(GFXCullDrawer* drawer, GFXRenderer* renderer,
+                           GFXPass* compute, GFXPass* render, GFXHeap* heap)
+{
+	assert(drawer != NULL);
+	assert(renderer != NULL);
+	assert(compute != NULL);
+	assert(gfx_pass_get_renderer(compute) == renderer);
+	assert(gfx_pass_get_type(compute) == GFX_PASS_COMPUTE_INLINE);
+	assert(render == NULL || gfx_pass_get_renderer(render) == renderer);
+	assert(render == NULL || gfx_pass_get_type(render) == GFX_PASS_RENDER);
+
+	GFXDevice* dev = gfx_renderer_get_device(renderer);
+
+	// Visible instances are drawn with a GPU-side draw count,
+	// without support there is nothing this drawer can draw.
+	if (!dev->features.indirectCount)
+	{
+		gfx_log_error(
+			"Could not initialize a new GPU culling drawer; "
+			"indirect draw counts are not supported by the device.");
+
+		return 0;
+	}
+
+	// Use the renderer's heap if none is given.
+	if (heap == NULL)
+		heap = gfx_renderer_get_heap(renderer);
+
+	drawer->heap = heap;
+	drawer->renderer = renderer;
+	drawer->compute = compute;
+	drawer->render = render;
+
+	drawer->numInstances = 0;
+	drawer->instances = NULL;
+	drawer->out = NULL;
+	drawer->set = NULL;
+
+	// Create & compile the compute shader.
+	GFXShader* shader = gfx_create_shader(GFX_STAGE_COMPUTE, dev);
+	if (shader == NULL)
+		goto clean;
+
+	GFXStringReader str;
+	if (!gfx_shader_compile(shader, GFX_GLSL, 1,
+		gfx_string_reader(&str, gfx_cull_comp_glsl_), NULL, NULL, NULL))
+	{
+		goto clean;
+	}
+
+	// Create a technique & computable.
+	GFXTechnique* tech =
+		gfx_renderer_add_tech(renderer, 1, &shader);
+	if (tech == NULL)
+		goto clean;
+
+	if (!gfx_tech_lock(tech))
+		goto clean_tech;
+
+	if (!gfx_computable(&drawer->computable, tech))
+		goto clean_tech;
+
+	drawer->shader = shader;
+	drawer->tech = tech;
+
+	// Make culling results visible to the indirect draw.
+	// No resource is given, so this survives re-uploading.
+	if (render != NULL)
+		gfx_pass_depend(compute, render, 1, (GFXInject[]){
+			gfx_sigf(
+				GFX_ACCESS_STORAGE_READ_WRITE, GFX_STAGE_COMPUTE,
+				GFX_ACCESS_INDIRECT_READ, GFX_STAGE_ANY)
+		});
+
+	return 1;
+
+
+	// Cleanup on failure.
+clean_tech:
+	gfx_erase_tech(tech);
+clean:
+	gfx_destroy_shader(shader);
+	gfx_log_error("Could not initialize a new GPU culling drawer.");
+
+	return 0;
+}
+
+/****************************/
+GFX_API void gfx_cull_clear(GFXCullDrawer* drawer)
+{
+	assert(drawer != NULL);
+
+	gfx_cull_free_(drawer);
+
+	gfx_erase_tech(drawer->tech);
+	gfx_destroy_shader(drawer->shader);
+
+	// Leave all values, drawer is invalidated.
+}
+
+/****************************/
+GFX_API bool gfx_cull_upload(GFXCullDrawer* drawer,
+                             uint32_t numInstances,
+                             const GFXCullInstance* instances)
+{
+	assert(drawer != NULL);
+	assert(numInstances == 0 || instances != NULL);
+
+	const unsigned int numFrames =
+		gfx_renderer_get_num_frames(drawer->renderer);
+
+	// Free the old data first.
+	gfx_cull_free_(drawer);
+
+	if (numInstances == 0)
+		return 1;
+
+	// Allocate host visible buffers so we can write to them directly,
+	// the output buffer must be zero-initialized for the counters.
+	drawer->instances = gfx_alloc_buffer(drawer->heap,
+		GFX_MEMORY_HOST_VISIBLE | GFX_MEMORY_DEVICE_LOCAL,
+		GFX_BUFFER_STORAGE,
+		sizeof(GFXCullData_) * (uint64_t)numInstances);
+
+	drawer->out = gfx_alloc_buffer(drawer->heap,
+		GFX_MEMORY_HOST_VISIBLE | GFX_MEMORY_DEVICE_LOCAL,
+		GFX_BUFFER_STORAGE | GFX_BUFFER_INDIRECT,
+		GFX_CULL_FRAME_SIZE_(numInstances) * numFrames);
+
+	if (drawer->instances == NULL || drawer->out == NULL)
+		goto clean;
+
+	GFXCullData_* data = gfx_map(gfx_ref_buffer(drawer->instances));
+	if (data == NULL)
+		goto clean;
+
+	for (uint32_t i = 0; i < numInstances; ++i)
+		data[i] = (GFXCullData_){
+			.sphere = {
+				instances[i].center[0],
+				instances[i].center[1],
+				instances[i].center[2],
+				instances[i].radius
+			},
+			.extents = {
+				instances[i].extents[0],
+				instances[i].extents[1],
+				instances[i].extents[2],
+				0.0f
+			},
+			.cmd = instances[i].cmd
+		};
+
+	gfx_unmap(gfx_ref_buffer(drawer->instances));
+
+	void* out = gfx_map(gfx_ref_buffer(drawer->out));
+	if (out == NULL)
+		goto clean;
+
+	memset(out, 0, GFX_CULL_FRAME_SIZE_(numInstances) * numFrames);
+	gfx_unmap(gfx_ref_buffer(drawer->out));
+
+	// Create a set referencing both buffers.
+	drawer->set = gfx_renderer_add_set(drawer->renderer, drawer->tech, 0,
+		2, 0, 0, 0,
+		(GFXSetResource[]){
+			{ .binding = 0, .index = 0, .ref = gfx_ref_buffer(drawer->instances) },
+			{ .binding = 1, .index = 0, .ref = gfx_ref_buffer(drawer->out) }
+		},
+		NULL, NULL, NULL);
+
+	if (drawer->set == NULL)
+		goto clean;
+
+	drawer->numInstances = numInstances;
+
+	return 1;
+
+
+	// Cleanup on failure.
+clean:
+	gfx_cull_free_(drawer);
+	gfx_log_error("Could not upload instances to a GPU culling drawer.");
+
+	return 0;
+}
+
+/****************************/
+GFX_API void gfx_cmd_cull(GFXRecorder* recorder,
+                          GFXCullDrawer* drawer, const float* viewProj)
+{
+	assert(recorder != NULL);
+	assert(drawer != NULL);
+	assert(gfx_recorder_get_pass(recorder) == drawer->compute);
+	assert(viewProj != NULL);
+
+	if (drawer->numInstances == 0)
+		return;
+
+	const unsigned int frame = gfx_recorder_get_frame_index(recorder);
+
+	GFXCullPush_ push = {
+		.numInstances = drawer->numInstances,
+		.base = (uint32_t)(
+			GFX_CULL_FRAME_SIZE_(drawer->numInstances) /
+			sizeof(uint32_t) * frame)
+	};
+
+	// Extract the frustum planes from the (column-major) matrix,
+	// each plane is a combination of the rows of the matrix.
+	// Vulkan clips to -w <= x,y <= w and 0 <= z <= w.
+	const float* m = viewProj;
+
+	for (size_t c = 0; c < 4; ++c)
+	{
+		const float r0 = m[c*4 + 0];
+		const float r1 = m[c*4 + 1];
+		const float r2 = m[c*4 + 2];
+		const float r3 = m[c*4 + 3];
+
+		push.planes[0][c] = r3 + r0;
+		push.planes[1][c] = r3 - r0;
+		push.planes[2][c] = r3 + r1;
+		push.planes[3][c] = r3 - r1;
+		push.planes[4][c] = r2;
+		push.planes[5][c] = r3 - r2;
+	}
+
+	// Normalize so distances are in world space, to compare to bounds.
+	for (size_t p = 0; p < 6; ++p)
+	{
+		const float len = sqrtf(
+			push.planes[p][0] * push.planes[p][0] +
+			push.planes[p][1] * push.planes[p][1] +
+			push.planes[p][2] * push.planes[p][2]);
+
+		const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+
+		for (size_t c = 0; c < 4; ++c)
+			push.planes[p][c] *= inv;
+	}
+
+	// Cull all instances.
+	const uint32_t groups =
+		(drawer->numInstances + GFX_CULL_GROUP_SIZE_ - 1) / GFX_CULL_GROUP_SIZE_;
+
+	gfx_cmd_bind(recorder, drawer->tech, 0, 1, 0, &drawer->set, NULL);
+	gfx_cmd_push(recorder, drawer->tech, 0, sizeof(push), &push);
+	gfx_cmd_dispatch(recorder, &drawer->computable, groups, 1, 1);
+}
+
+/****************************/
+GFX_API void gfx_cmd_draw_cull(GFXRecorder* recorder,
+                               GFXCullDrawer* drawer, GFXRenderable* renderable)
+{
+	assert(recorder != NULL);
+	assert(drawer != NULL);
+	assert(drawer->render == NULL ||
+		gfx_recorder_get_pass(recorder) == drawer->render);
+	assert(renderable != NULL);
+
+	if (drawer->numInstances == 0)
+		return;
+
+	const unsigned int frame = gfx_recorder_get_frame_index(recorder);
+	const uint64_t base = GFX_CULL_FRAME_SIZE_(drawer->numInstances) * frame;
+
+	// Draw count is the third counter, the commands follow all counters.
+	gfx_cmd_draw_indexed_from_count(recorder, renderable,
+		drawer->numInstances, sizeof(GFXDrawIndexedCmd),
+		gfx_ref_buffer_at(drawer->out,
+			base + sizeof(uint32_t) * GFX_CULL_COUNTERS_),
+		gfx_ref_buffer_at(drawer->out,
+			base + sizeof(uint32_t) * 2));
+}
@@ -6,17 +6,59 @@
  * www     : <www.vuzzel.nl>
  */
 
+#include "groufix/core/jobs.h"
 #include "groufix/drawers/list.h"
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined (__AVX__)
+	#include <immintrin.h>
+#elif defined (__SSE__)
+	#include <xmmintrin.h>
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+	#include <arm_neon.h>
+#endif
+
+
+// Minimum #visible elements to radix sort in parallel.
+#define GFX_DRAW_LIST_PARALLEL_MIN_ 65536
+
+// Maximum #changed elements & #moves to re-sort with insertion.
+#define GFX_DRAW_LIST_INSERT_MAX_ 16
+#define GFX_DRAW_LIST_INSERT_MOVES_ 1024
+
+// Target #chunks per worker & minimum #visible elements per chunk,
+// when recording in parallel.
+#define GFX_DRAW_LIST_CHUNKS_ 4
+#define GFX_DRAW_LIST_CHUNK_MIN_ 256
+
+// Radix sort digit size & #digits.
+#define GFX_RADIX_BITS_ 8
+#define GFX_RADIX_SIZE_ (1u << GFX_RADIX_BITS_)
+#define GFX_RADIX_PASSES_ (64 / GFX_RADIX_BITS_)
+
+// Retrieve a radix sort digit from a key.
+#define GFX_RADIX_DIGIT_(key, pass) \
+	(size_t)(((key) >> ((pass) * GFX_RADIX_BITS_)) & (GFX_RADIX_SIZE_ - 1))
+
+// Offset of the sort key & size of a draw item before its element data.
+#define GFX_KEY_OFFSET_ \
+	GFX_ALIGN_UP(sizeof(size_t), alignof(uint64_t))
+
+#define GFX_HEADER_SIZE_ \
+	GFX_ALIGN_UP(GFX_KEY_OFFSET_ + sizeof(uint64_t), alignof(max_align_t))
 
 // Retrieve the position (into inds OR next item) from a draw item.
 #define GFX_GET_POSITION_(item) (*(size_t*)item)
 
+// Retrieve the sort key from a draw item.
+#define GFX_GET_KEY_(item) \
+	(*(uint64_t*)((char*)item + GFX_KEY_OFFSET_))
+
 // Retrieve the element data from a draw item.
 #define GFX_GET_ELEMENT_(item) \
-	(void*)((char*)item + \
-		GFX_ALIGN_UP(sizeof(size_t), alignof(max_align_t)))
+	(void*)((char*)item + GFX_HEADER_SIZE_)
 
 // Helper to directly get element data from position into inds.
 #define GFX_GET_ELEMENT_FROM_POS_(list, pos) \
@@ -24,6 +66,69 @@
 		gfx_vec_at(&list->items, *(size_t*)gfx_vec_at(&list->inds, pos)))
 
 
+/****************************
+ * Radix sort element definition.
+ */
+typedef struct GFXDrawSort_
+{
+	uint64_t key;
+	size_t   ind; // Index into items.
+
+} GFXDrawSort_;
+
+
+/****************************
+ * Bounds of 8 consecutive draw items (SoA), AABB extents and sphere radius.
+ * Unbounded items have an infinite radius, free items a negative infinite.
+ */
+typedef struct GFXDrawBounds_
+{
+	float cx[8], cy[8], cz[8];
+	float ex[8], ey[8], ez[8];
+	float r[8];
+
+} GFXDrawBounds_;
+
+
+/****************************
+ * View frustum, normalized { nx, ny, nz, w } planes, pointing inwards.
+ */
+typedef struct GFXDrawFrustum_
+{
+	float planes[6][4];
+	float absPlanes[6][3]; // Absolute { nx, ny, nz } of all planes.
+
+} GFXDrawFrustum_;
+
+
+/****************************
+ * Parallel recording (job) state definition.
+ */
+typedef struct GFXDrawRender_
+{
+	GFXDrawList* list;
+	const size_t* bounds; // First visible position of each chunk (+ end).
+	void* ptr;
+
+} GFXDrawRender_;
+
+
+/****************************
+ * Radix sort (job) state definition.
+ */
+typedef struct GFXDrawRadix_
+{
+	GFXDrawList*  list;
+	GFXDrawSort_* src;
+	GFXDrawSort_* dst;
+
+	size_t       numChunks;
+	unsigned int pass;
+	size_t*      counts; // GFX_RADIX_SIZE_ for each chunk.
+
+} GFXDrawRadix_;
+
+
 /****************************
  * Swaps the positions of two draw items.
  */
@@ -97,6 +202,607 @@ static void gfx_draw_list_qsort_(GFXDrawList* list, size_t l, size_t r)
 		gfx_draw_list_qsort_(list, gt, r);
 }
 
+/****************************
+ * Radix sort job, gathers the keys of a range of visible positions.
+ * @param ptr Must be a GFXDrawRadix_*.
+ */
+static void gfx_draw_list_gather_(size_t worker, size_t first, size_t count,
+                                  void* ptr)
+{
+	GFXDrawRadix_* radix = ptr;
+	GFXDrawList* list = radix->list;
+
+	const size_t* inds = gfx_vec_at(&list->inds, 0);
+
+	for (size_t p = first; p < first + count; ++p)
+	{
+		radix->src[p].ind = inds[p];
+		radix->src[p].key = GFX_GET_KEY_(gfx_vec_at(&list->items, inds[p]));
+	}
+}
+
+/****************************
+ * Radix sort job, counts the digits of a range of chunks.
+ * @param ptr Must be a GFXDrawRadix_*.
+ */
+static void gfx_draw_list_count_(size_t worker, size_t first, size_t count,
+                                 void* ptr)
+{
+	GFXDrawRadix_* radix = ptr;
+	const size_t n = radix->list->numVisible;
+
+	for (size_t c = first; c < first + count; ++c)
+	{
+		size_t* counts = radix->counts + c * GFX_RADIX_SIZE_;
+		memset(counts, 0, sizeof(size_t) * GFX_RADIX_SIZE_);
+
+		const size_t end = n * (c + 1) / radix->numChunks;
+		for (size_t p = n * c / radix->numChunks; p < end; ++p)
+			++counts[GFX_RADIX_DIGIT_(radix->src[p].key, radix->pass)];
+	}
+}
+
+/****************************
+ * Radix sort job, scatters a range of chunks to their sorted position.
+ * radix->counts must hold the output offset of each digit of each chunk.
+ * @param ptr Must be a GFXDrawRadix_*.
+ */
+static void gfx_draw_list_scatter_(size_t worker, size_t first, size_t count,
+                                   void* ptr)
+{
+	GFXDrawRadix_* radix = ptr;
+	const size_t n = radix->list->numVisible;
+
+	for (size_t c = first; c < first + count; ++c)
+	{
+		size_t* offsets = radix->counts + c * GFX_RADIX_SIZE_;
+
+		const size_t end = n * (c + 1) / radix->numChunks;
+		for (size_t p = n * c / radix->numChunks; p < end; ++p)
+		{
+			const GFXDrawSort_ elem = radix->src[p];
+			radix->dst[offsets[GFX_RADIX_DIGIT_(elem.key, radix->pass)]++] = elem;
+		}
+	}
+}
+
+/****************************
+ * Radix sort job, writes a range of sorted indices back into the list.
+ * @param ptr Must be a GFXDrawRadix_*.
+ */
+static void gfx_draw_list_write_(size_t worker, size_t first, size_t count,
+                                 void* ptr)
+{
+	GFXDrawRadix_* radix = ptr;
+	GFXDrawList* list = radix->list;
+
+	size_t* inds = gfx_vec_at(&list->inds, 0);
+
+	for (size_t p = first; p < first + count; ++p)
+	{
+		inds[p] = radix->src[p].ind;
+		GFX_GET_POSITION_(gfx_vec_at(&list->items, inds[p])) = p;
+	}
+}
+
+/****************************
+ * Runs a radix sort job, in parallel if there are multiple chunks.
+ */
+static void gfx_draw_list_run_(GFXDrawRadix_* radix, size_t numItems,
+                               size_t grain, GFXJobFunc func)
+{
+	if (radix->numChunks > 1)
+		gfx_job_for(numItems, grain, func, radix);
+	else
+		func(0, 0, numItems, radix);
+}
+
+/****************************
+ * Least significant digit radix sort of all visible indices by key.
+ * Assumes list->key != NULL.
+ * @return Zero if out of memory, the list is left untouched.
+ *
+ * Only sorts in parallel if list->parallel is set and the list is large.
+ */
+static bool gfx_draw_list_rsort_(GFXDrawList* list)
+{
+	const size_t n = list->numVisible;
+
+	// Make room for two (ping-pong) arrays of keys.
+	gfx_vec_release(&list->sorts);
+	if (!gfx_vec_push(&list->sorts, n * 2, NULL))
+		return 0;
+
+	size_t counts[GFX_RADIX_SIZE_];
+
+	GFXDrawRadix_ radix = {
+		.list = list,
+		.src = gfx_vec_at(&list->sorts, 0),
+		.dst = gfx_vec_at(&list->sorts, n),
+		.numChunks = 1,
+		.counts = counts
+	};
+
+	// Split into chunks, each chunk has its own digit counts.
+	// If that fails, we can still sort in a single chunk.
+	if (list->parallel && n >= GFX_DRAW_LIST_PARALLEL_MIN_)
+	{
+		const size_t numChunks = gfx_job_get_num_workers();
+		size_t* chunkCounts =
+			malloc(sizeof(size_t) * GFX_RADIX_SIZE_ * numChunks);
+
+		if (chunkCounts != NULL)
+		{
+			radix.numChunks = numChunks;
+			radix.counts = chunkCounts;
+		}
+	}
+
+	gfx_draw_list_run_(&radix, n, 0, gfx_draw_list_gather_);
+
+	for (radix.pass = 0; radix.pass < GFX_RADIX_PASSES_; ++radix.pass)
+	{
+		gfx_draw_list_run_(&radix, radix.numChunks, 1, gfx_draw_list_count_);
+
+		// Turn counts into output offsets, in order of digit, then chunk.
+		// If all keys share the same digit, skip this pass.
+		size_t offset = 0;
+		bool skip = 0;
+
+		for (size_t d = 0; d < GFX_RADIX_SIZE_; ++d)
+		{
+			const size_t start = offset;
+
+			for (size_t c = 0; c < radix.numChunks; ++c)
+			{
+				size_t* count = radix.counts + c * GFX_RADIX_SIZE_ + d;
+				const size_t num = *count;
+
+				*count = offset;
+				offset += num;
+			}
+
+			skip = skip || (offset - start == n);
+		}
+
+		if (skip) continue;
+
+		gfx_draw_list_run_(&radix, radix.numChunks, 1, gfx_draw_list_scatter_);
+
+		GFXDrawSort_* src = radix.src;
+		radix.src = radix.dst;
+		radix.dst = src;
+	}
+
+	gfx_draw_list_run_(&radix, n, 0, gfx_draw_list_write_);
+
+	if (radix.counts != counts)
+		free(radix.counts);
+
+	return 1;
+}
+
+/****************************
+ * Returns whether the element of one item sorts before that of another.
+ * Assumes list->cmp != NULL or list->key != NULL.
+ * @param lInd Index into items.
+ * @param rInd Index into items.
+ */
+static inline bool gfx_draw_list_less_(GFXDrawList* list,
+                                       size_t lInd, size_t rInd)
+{
+	void* lItem = gfx_vec_at(&list->items, lInd);
+	void* rItem = gfx_vec_at(&list->items, rInd);
+
+	return list->key != NULL ?
+		GFX_GET_KEY_(lItem) < GFX_GET_KEY_(rItem) :
+		list->cmp(GFX_GET_ELEMENT_(lItem), GFX_GET_ELEMENT_(rItem)) < 0;
+}
+
+/****************************
+ * Stable merge sort of sort elements by their item's element.
+ * @param elems Elements to sort.
+ * @param tmp   Scratch space, must be able to hold n elements.
+ */
+static void gfx_draw_list_msort_(GFXDrawList* list,
+                                 GFXDrawSort_* elems, GFXDrawSort_* tmp,
+                                 size_t n)
+{
+	if (n < 2) return;
+
+	const size_t h = n >> 1;
+	gfx_draw_list_msort_(list, elems, tmp, h);
+	gfx_draw_list_msort_(list, elems + h, tmp, n - h);
+
+	// Merge both halves into tmp, the remainder of the right half
+	// is already in place, so only copy what was merged.
+	size_t l = 0, r = h, o = 0;
+
+	while (l < h && r < n)
+		tmp[o++] = gfx_draw_list_less_(list, elems[r].ind, elems[l].ind) ?
+			elems[r++] : elems[l++];
+
+	while (l < h)
+		tmp[o++] = elems[l++];
+
+	memcpy(elems, tmp, sizeof(GFXDrawSort_) * o);
+}
+
+/****************************
+ * Re-sorts all changed items by moving them one position at a time.
+ * All unchanged visible items must be in sorted order.
+ * @param moves Maximum #moves to make.
+ * @return Zero if it ran out of moves, unchanged items are still sorted.
+ *
+ * Repeats until no items move, as unsorted changed items may block others.
+ */
+static bool gfx_draw_list_insert_(GFXDrawList* list, size_t moves)
+{
+	const size_t n = list->numVisible;
+	bool moved = 1;
+
+	while (moved)
+	{
+		moved = 0;
+
+		for (size_t c = 0; c < list->changed.size; ++c)
+		{
+			const size_t ind = *(size_t*)gfx_vec_at(&list->changed, c);
+			size_t pos = GFX_GET_POSITION_(gfx_vec_at(&list->items, ind));
+
+			if (pos >= n) continue; // Invisible.
+
+			// Move left while the previous item sorts after it.
+			while (pos > 0 && gfx_draw_list_less_(list,
+				ind, *(size_t*)gfx_vec_at(&list->inds, pos - 1)))
+			{
+				if (moves-- == 0) return 0;
+
+				gfx_draw_list_swap_(list, pos - 1, pos);
+				--pos;
+				moved = 1;
+			}
+
+			// Move right while the next item sorts before it.
+			while (pos + 1 < n && gfx_draw_list_less_(list,
+				*(size_t*)gfx_vec_at(&list->inds, pos + 1), ind))
+			{
+				if (moves-- == 0) return 0;
+
+				gfx_draw_list_swap_(list, pos, pos + 1);
+				++pos;
+				moved = 1;
+			}
+		}
+	}
+
+	return 1;
+}
+
+/****************************
+ * Re-sorts all changed items by sorting them & merging them back in.
+ * All unchanged visible items must be in sorted order.
+ * @return Zero if out of memory, the list is left untouched.
+ */
+static bool gfx_draw_list_merge_(GFXDrawList* list)
+{
+	const size_t n = list->numVisible;
+	const size_t numChanged = list->changed.size;
+
+	// Make room for the output, changed items & merge sort scratch.
+	gfx_vec_release(&list->sorts);
+	if (!gfx_vec_push(&list->sorts, n + numChanged * 2, NULL))
+		return 0;
+
+	GFXDrawSort_* out = gfx_vec_at(&list->sorts, 0);
+	GFXDrawSort_* elems = out + n;
+	size_t* inds = gfx_vec_at(&list->inds, 0);
+	size_t k = 0;
+
+	// Gather all visible changed items & mark them by position,
+	// so they are skipped below & duplicates are ignored.
+	for (size_t c = 0; c < numChanged; ++c)
+	{
+		const size_t ind = *(size_t*)gfx_vec_at(&list->changed, c);
+		void* item = gfx_vec_at(&list->items, ind);
+
+		if (GFX_GET_POSITION_(item) >= n) continue;
+
+		GFX_GET_POSITION_(item) = SIZE_MAX;
+		elems[k++].ind = ind;
+	}
+
+	gfx_draw_list_msort_(list, elems, elems + numChanged, k);
+
+	// Merge them with all unchanged items, which are still sorted.
+	size_t c = 0, o = 0;
+
+	for (size_t p = 0; p < n; ++p)
+	{
+		const size_t ind = inds[p];
+		if (GFX_GET_POSITION_(gfx_vec_at(&list->items, ind)) == SIZE_MAX)
+			continue;
+
+		while (c < k && gfx_draw_list_less_(list, elems[c].ind, ind))
+			out[o++] = elems[c++];
+
+		out[o++].ind = ind;
+	}
+
+	while (c < k)
+		out[o++] = elems[c++];
+
+	// Write back the merged indices & positions.
+	for (size_t p = 0; p < n; ++p)
+	{
+		inds[p] = out[p].ind;
+		GFX_GET_POSITION_(gfx_vec_at(&list->items, inds[p])) = p;
+	}
+
+	return 1;
+}
+
+/****************************
+ * Sets the bounds of a draw item.
+ * @param ind Index into items, must be covered by list->bounds.
+ */
+static void gfx_draw_list_set_bounds_(GFXDrawList* list, size_t ind,
+                                      const float* center,
+                                      const float* extents, float radius)
+{
+	GFXDrawBounds_* bounds = gfx_vec_at(&list->bounds, ind >> 3);
+	const size_t l = ind & 7;
+
+	bounds->cx[l] = center[0];
+	bounds->cy[l] = center[1];
+	bounds->cz[l] = center[2];
+	bounds->ex[l] = extents[0];
+	bounds->ey[l] = extents[1];
+	bounds->ez[l] = extents[2];
+	bounds->r[l] = radius;
+}
+
+/****************************
+ * Makes sure list->bounds covers a given number of draw items.
+ * @return Zero on failure.
+ *
+ * Newly covered items are unbounded, or never visible if free.
+ * Trailing lanes of the last block are never visible either.
+ */
+static bool gfx_draw_list_cover_(GFXDrawList* list, size_t numItems)
+{
+	const size_t numBlocks = (numItems + 7) >> 3;
+	const size_t first = list->bounds.size;
+
+	if (first >= numBlocks)
+		return 1;
+
+	if (!gfx_vec_push(&list->bounds, numBlocks - first, NULL))
+		return 0;
+
+	const float zero[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (size_t i = first << 3; i < numBlocks << 3; ++i)
+		gfx_draw_list_set_bounds_(list, i, zero, zero,
+			i < numItems ? INFINITY : -INFINITY);
+
+	for (size_t f = list->free; f != SIZE_MAX;
+		f = GFX_GET_POSITION_(gfx_vec_at(&list->items, f)))
+	{
+		if (f >= first << 3)
+			gfx_draw_list_set_bounds_(list, f, zero, zero, -INFINITY);
+	}
+
+	return 1;
+}
+
+/****************************
+ * Tests 8 draw items against all planes of a view frustum.
+ * @return Visibility bitmask, bit i is set if item i intersects the frustum.
+ */
+static uint8_t gfx_draw_list_cull_block_(const GFXDrawBounds_* b,
+                                         const GFXDrawFrustum_* frustum)
+{
+	const float (*planes)[4] = frustum->planes;
+	const float (*absPlanes)[3] = frustum->absPlanes;
+
+	// Per plane: n.c + w + |n|.e + r >= 0.
+#if defined (__AVX__)
+	const __m256 cx = _mm256_loadu_ps(b->cx);
+	const __m256 cy = _mm256_loadu_ps(b->cy);
+	const __m256 cz = _mm256_loadu_ps(b->cz);
+	const __m256 ex = _mm256_loadu_ps(b->ex);
+	const __m256 ey = _mm256_loadu_ps(b->ey);
+	const __m256 ez = _mm256_loadu_ps(b->ez);
+	const __m256 r = _mm256_loadu_ps(b->r);
+
+	__m256 in = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+	for (size_t p = 0; p < 6; ++p)
+	{
+		__m256 d = _mm256_add_ps(r, _mm256_set1_ps(planes[p][3]));
+		d = _mm256_add_ps(d, _mm256_mul_ps(cx, _mm256_set1_ps(planes[p][0])));
+		d = _mm256_add_ps(d, _mm256_mul_ps(cy, _mm256_set1_ps(planes[p][1])));
+		d = _mm256_add_ps(d, _mm256_mul_ps(cz, _mm256_set1_ps(planes[p][2])));
+		d = _mm256_add_ps(d, _mm256_mul_ps(ex, _mm256_set1_ps(absPlanes[p][0])));
+		d = _mm256_add_ps(d, _mm256_mul_ps(ey, _mm256_set1_ps(absPlanes[p][1])));
+		d = _mm256_add_ps(d, _mm256_mul_ps(ez, _mm256_set1_ps(absPlanes[p][2])));
+
+		in = _mm256_and_ps(in, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+	}
+
+	return (uint8_t)_mm256_movemask_ps(in);
+
+#elif defined (__SSE__)
+	uint8_t mask = 0;
+
+	for (size_t h = 0; h < 8; h += 4)
+	{
+		const __m128 cx = _mm_loadu_ps(b->cx + h);
+		const __m128 cy = _mm_loadu_ps(b->cy + h);
+		const __m128 cz = _mm_loadu_ps(b->cz + h);
+		const __m128 ex = _mm_loadu_ps(b->ex + h);
+		const __m128 ey = _mm_loadu_ps(b->ey + h);
+		const __m128 ez = _mm_loadu_ps(b->ez + h);
+		const __m128 r = _mm_loadu_ps(b->r + h);
+
+		__m128 in = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+
+		for (size_t p = 0; p < 6; ++p)
+		{
+			__m128 d = _mm_add_ps(r, _mm_set1_ps(planes[p][3]));
+			d = _mm_add_ps(d, _mm_mul_ps(cx, _mm_set1_ps(planes[p][0])));
+			d = _mm_add_ps(d, _mm_mul_ps(cy, _mm_set1_ps(planes[p][1])));
+			d = _mm_add_ps(d, _mm_mul_ps(cz, _mm_set1_ps(planes[p][2])));
+			d = _mm_add_ps(d, _mm_mul_ps(ex, _mm_set1_ps(absPlanes[p][0])));
+			d = _mm_add_ps(d, _mm_mul_ps(ey, _mm_set1_ps(absPlanes[p][1])));
+			d = _mm_add_ps(d, _mm_mul_ps(ez, _mm_set1_ps(absPlanes[p][2])));
+
+			in = _mm_and_ps(in, _mm_cmpge_ps(d, _mm_setzero_ps()));
+		}
+
+		mask |= (uint8_t)(_mm_movemask_ps(in) << h);
+	}
+
+	return mask;
+
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+	const uint32x4_t bits = { 1, 2, 4, 8 };
+	uint8_t mask = 0;
+
+	for (size_t h = 0; h < 8; h += 4)
+	{
+		const float32x4_t cx = vld1q_f32(b->cx + h);
+		const float32x4_t cy = vld1q_f32(b->cy + h);
+		const float32x4_t cz = vld1q_f32(b->cz + h);
+		const float32x4_t ex = vld1q_f32(b->ex + h);
+		const float32x4_t ey = vld1q_f32(b->ey + h);
+		const float32x4_t ez = vld1q_f32(b->ez + h);
+		const float32x4_t r = vld1q_f32(b->r + h);
+
+		uint32x4_t in = vdupq_n_u32(UINT32_MAX);
+
+		for (size_t p = 0; p < 6; ++p)
+		{
+			float32x4_t d = vaddq_f32(r, vdupq_n_f32(planes[p][3]));
+			d = vmlaq_n_f32(d, cx, planes[p][0]);
+			d = vmlaq_n_f32(d, cy, planes[p][1]);
+			d = vmlaq_n_f32(d, cz, planes[p][2]);
+			d = vmlaq_n_f32(d, ex, absPlanes[p][0]);
+			d = vmlaq_n_f32(d, ey, absPlanes[p][1]);
+			d = vmlaq_n_f32(d, ez, absPlanes[p][2]);
+
+			in = vandq_u32(in, vcgeq_f32(d, vdupq_n_f32(0.0f)));
+		}
+
+		mask |= (uint8_t)(vaddvq_u32(vandq_u32(in, bits)) << h);
+	}
+
+	return mask;
+
+#else
+	uint8_t mask = 0;
+
+	for (size_t l = 0; l < 8; ++l)
+	{
+		bool in = 1;
+
+		for (size_t p = 0; p < 6; ++p)
+		{
+			const float d = b->r[l] + planes[p][3] +
+				b->cx[l] * planes[p][0] +
+				b->cy[l] * planes[p][1] +
+				b->cz[l] * planes[p][2] +
+				b->ex[l] * absPlanes[p][0] +
+				b->ey[l] * absPlanes[p][1] +
+				b->ez[l] * absPlanes[p][2];
+
+			in = in && (d >= 0.0f);
+		}
+
+		mask |= (uint8_t)(in << l);
+	}
+
+	return mask;
+
+#endif
+}
+
+/****************************
+ * Computes how much state changes inbetween two consecutive visible items.
+ * @param pos Visible position of the second item, must be > 0.
+ * @return Higher is a bigger change, zero if none.
+ *
+ * Keys pack the most expensive state in their most significant bits,
+ * so the higher the most significant differing bit, the bigger the change.
+ */
+static uint64_t gfx_draw_list_change_(GFXDrawList* list, size_t pos)
+{
+	const size_t* inds = gfx_vec_at(&list->inds, pos - 1);
+	void* lItem = gfx_vec_at(&list->items, inds[0]);
+	void* rItem = gfx_vec_at(&list->items, inds[1]);
+
+	if (list->key != NULL)
+		return GFX_GET_KEY_(lItem) ^ GFX_GET_KEY_(rItem);
+
+	if (list->cmp != NULL)
+		return list->cmp(
+			GFX_GET_ELEMENT_(lItem), GFX_GET_ELEMENT_(rItem)) != 0;
+
+	return 0;
+}
+
+/****************************
+ * Render callback of parallel recording, draws a range of chunks.
+ * @param ptr Must be a GFXDrawRender_*.
+ */
+static void gfx_draw_list_render_(GFXRecorder* recorder,
+                                  size_t first, size_t count, void* ptr)
+{
+	GFXDrawRender_* render = ptr;
+	GFXDrawList* list = render->list;
+
+	const size_t end = render->bounds[first + count];
+
+	for (size_t p = render->bounds[first]; p < end; ++p)
+	{
+		const void* elem = GFX_GET_ELEMENT_FROM_POS_(list, p);
+		list->draw(recorder, elem, render->ptr);
+	}
+}
+
+/****************************
+ * Flags a draw list as dirty without recomputing any keys.
+ */
+static void gfx_draw_list_flag_(GFXDrawList* list)
+{
+	// Only flag as dirty if there are visible items.
+	// Also, ignore if we have no comparison or key function.
+	list->dirty =
+		((list->cmp || list->key) && list->numVisible > 0) ? 1 : 0;
+}
+
+/****************************
+ * Marks a visible item as changed, so it gets re-sorted.
+ * @param ind Index into items.
+ *
+ * Falls back to flagging the list as dirty if too many items changed.
+ */
+static void gfx_draw_list_mark_(GFXDrawList* list, size_t ind)
+{
+	// Nothing to do if fully sorting anyway or never sorting.
+	if (list->dirty || (!list->cmp && !list->key))
+		return;
+
+	if (
+		list->changed.size >= (list->numVisible >> 2) ||
+		!gfx_vec_push(&list->changed, 1, &ind))
+	{
+		gfx_vec_release(&list->changed);
+		gfx_draw_list_flag_(list);
+	}
+}
+
 /****************************/
 GFX_API void gfx_draw_list_init(GFXDrawList* list, size_t elemSize,
                                 void (*draw)(GFXRecorder*, const void*, void*),
@@ -108,17 +814,38 @@ GFX_API void gfx_draw_list_init(GFXDrawList* list, size_t elemSize,
 
 	gfx_vec_init(&list->inds, sizeof(size_t));
 	gfx_vec_init(&list->items,
-		GFX_ALIGN_UP(sizeof(size_t), alignof(max_align_t)) +
+		GFX_HEADER_SIZE_ +
 		GFX_ALIGN_UP(elemSize, alignof(max_align_t)));
+	gfx_vec_init(&list->sorts, sizeof(GFXDrawSort_));
+	gfx_vec_init(&list->changed, sizeof(size_t));
+	gfx_vec_init(&list->bounds, sizeof(GFXDrawBounds_));
+	gfx_vec_init(&list->masks, sizeof(uint8_t));
 
 	list->free = SIZE_MAX;
 
 	list->numVisible = 0;
 	list->elementSize = elemSize;
 	list->dirty = 0;
+	list->rekey = 0;
+	list->parallel = 0;
 
 	list->draw = draw;
 	list->cmp = cmp;
+	list->key = NULL;
+}
+
+/****************************/
+GFX_API void gfx_draw_list_init_keyed(GFXDrawList* list, size_t elemSize,
+                                      void (*draw)(GFXRecorder*, const void*, void*),
+                                      uint64_t (*key)(const void*))
+{
+	assert(list != NULL);
+	assert(elemSize > 0);
+	assert(draw != NULL);
+	assert(key != NULL);
+
+	gfx_draw_list_init(list, elemSize, draw, NULL);
+	list->key = key;
 }
 
 /****************************/
@@ -128,10 +855,15 @@ GFX_API void gfx_draw_list_clear(GFXDrawList* list)
 
 	gfx_vec_clear(&list->inds);
 	gfx_vec_clear(&list->items);
+	gfx_vec_clear(&list->sorts);
+	gfx_vec_clear(&list->changed);
+	gfx_vec_clear(&list->bounds);
+	gfx_vec_clear(&list->masks);
 
 	list->free = SIZE_MAX;
 	list->numVisible = 0;
 	list->dirty = 0;
+	list->rekey = 0;
 }
 
 /****************************/
@@ -144,6 +876,16 @@ GFX_API GFXDrawInd gfx_draw_list_add(GFXDrawList* list, const void* elem,
 	if (!gfx_vec_push(&list->inds, 1, NULL))
 		return 0;
 
+	// If bounded, make sure a new item would be covered.
+	if (
+		list->bounds.size > 0 &&
+		!gfx_draw_list_cover_(list,
+			list->items.size + (list->free == SIZE_MAX ? 1 : 0)))
+	{
+		gfx_vec_pop(&list->inds, 1);
+		return 0;
+	}
+
 	const size_t pos = list->inds.size - 1;
 	size_t* ind = gfx_vec_at(&list->inds, pos);
 
@@ -170,15 +912,27 @@ GFX_API GFXDrawInd gfx_draw_list_add(GFXDrawList* list, const void* elem,
 	void* item = gfx_vec_at(&list->items, *ind);
 	GFX_GET_POSITION_(item) = pos;
 
-	// Copy the element data.
+	// Copy the element data & compute its key.
 	if (elem != NULL) memcpy(
 		GFX_GET_ELEMENT_(item), elem, list->elementSize);
 
+	GFX_GET_KEY_(item) = (list->key != NULL && elem != NULL) ?
+		list->key(GFX_GET_ELEMENT_(item)) : 0;
+
+	// It starts out unbounded, it may have been a free item.
+	if (list->bounds.size > 0)
+	{
+		const float zero[3] = { 0.0f, 0.0f, 0.0f };
+		gfx_draw_list_set_bounds_(list, *ind, zero, zero, INFINITY);
+	}
+
 	// Set visibility & return.
 	// We return the 1-based index, 0 is considered an error.
-	gfx_draw_list_set_visible(list, *ind + 1, visible);
+	// Copy the index first, setting visibility may swap it away!
+	const GFXDrawInd drawInd = *ind + 1;
+	gfx_draw_list_set_visible(list, drawInd, visible);
 
-	return *ind + 1;
+	return drawInd;
 }
 
 /****************************/
@@ -202,10 +956,23 @@ GFX_API void gfx_draw_list_erase(GFXDrawList* list, GFXDrawInd ind)
 	// Now we can pop the index.
 	gfx_vec_pop(&list->inds, 1);
 
+	// Make sure it is not marked as changed anymore,
+	// as its position is about to become a free index.
+	for (size_t c = list->changed.size; c > 0; --c)
+		if (*(size_t*)gfx_vec_at(&list->changed, c-1) == ind-1)
+			gfx_vec_erase(&list->changed, 1, c-1);
+
 	// And add the item to the free chain.
 	// To do so, use its position to point to the next free item index.
 	GFX_GET_POSITION_(item) = list->free;
 	list->free = ind-1;
+
+	// Free items are never visible when culling.
+	if (list->bounds.size > 0)
+	{
+		const float zero[3] = { 0.0f, 0.0f, 0.0f };
+		gfx_draw_list_set_bounds_(list, ind-1, zero, zero, -INFINITY);
+	}
 }
 
 /****************************/
@@ -262,7 +1029,11 @@ GFX_API void gfx_draw_list_set_visible(GFXDrawList* list, GFXDrawInd ind,
 	if (pos != newPos)
 		gfx_draw_list_swap_(list, pos, newPos);
 
-	gfx_draw_list_dirty(list);
+	// Mark whichever item became visible or moved within the visibles.
+	if (!isVisible)
+		gfx_draw_list_mark_(list, ind-1);
+	else if (pos != newPos)
+		gfx_draw_list_mark_(list, *(size_t*)gfx_vec_at(&list->inds, pos));
 }
 
 /****************************/
@@ -272,7 +1043,168 @@ GFX_API void gfx_draw_list_reset_visible(GFXDrawList* list, bool visible)
 
 	list->numVisible = visible ? list->inds.size : 0;
 
-	gfx_draw_list_dirty(list);
+	gfx_draw_list_flag_(list);
+}
+
+/****************************/
+GFX_API bool gfx_draw_list_set_sphere(GFXDrawList* list, GFXDrawInd ind,
+                                      const float* center, float radius)
+{
+	assert(list != NULL);
+	assert(ind != 0);
+	assert(center != NULL);
+	assert(radius >= 0.0f);
+
+	if (!gfx_draw_list_cover_(list, list->items.size))
+		return 0;
+
+	const float zero[3] = { 0.0f, 0.0f, 0.0f };
+	gfx_draw_list_set_bounds_(list, ind-1, center, zero, radius);
+
+	return 1;
+}
+
+/****************************/
+GFX_API bool gfx_draw_list_set_aabb(GFXDrawList* list, GFXDrawInd ind,
+                                    const float* min, const float* max)
+{
+	assert(list != NULL);
+	assert(ind != 0);
+	assert(min != NULL);
+	assert(max != NULL);
+
+	if (!gfx_draw_list_cover_(list, list->items.size))
+		return 0;
+
+	const float center[3] = {
+		(min[0] + max[0]) * 0.5f,
+		(min[1] + max[1]) * 0.5f,
+		(min[2] + max[2]) * 0.5f
+	};
+
+	const float extents[3] = {
+		(max[0] - min[0]) * 0.5f,
+		(max[1] - min[1]) * 0.5f,
+		(max[2] - min[2]) * 0.5f
+	};
+
+	gfx_draw_list_set_bounds_(list, ind-1, center, extents, 0.0f);
+
+	return 1;
+}
+
+/****************************/
+GFX_API bool gfx_draw_list_cull(GFXDrawList* list, const float* viewProj)
+{
+	assert(list != NULL);
+	assert(viewProj != NULL);
+
+	// Nothing is bounded, everything is visible.
+	if (list->bounds.size == 0)
+	{
+		if (list->numVisible != list->inds.size)
+			gfx_draw_list_reset_visible(list, 1);
+
+		return 1;
+	}
+
+	// Allocate visibility masks & room for the new partition.
+	const size_t numItems = list->inds.size;
+	const size_t numBlocks = list->bounds.size;
+
+	if (list->sorts.size < numItems)
+		if (!gfx_vec_push(&list->sorts, numItems - list->sorts.size, NULL))
+			return 0;
+
+	if (list->masks.size < numBlocks)
+		if (!gfx_vec_push(&list->masks, numBlocks - list->masks.size, NULL))
+			return 0;
+
+	// Extract the frustum planes from the (column-major) matrix,
+	// each plane is a combination of the rows of the matrix.
+	// Vulkan clips to -w <= x,y <= w and 0 <= z <= w.
+	const float* m = viewProj;
+	GFXDrawFrustum_ frustum;
+	float (*planes)[4] = frustum.planes;
+
+	for (size_t c = 0; c < 4; ++c)
+	{
+		const float r0 = m[c*4 + 0];
+		const float r1 = m[c*4 + 1];
+		const float r2 = m[c*4 + 2];
+		const float r3 = m[c*4 + 3];
+
+		planes[0][c] = r3 + r0; // Left.
+		planes[1][c] = r3 - r0; // Right.
+		planes[2][c] = r3 + r1; // Top.
+		planes[3][c] = r3 - r1; // Bottom.
+		planes[4][c] = r2;      // Near.
+		planes[5][c] = r3 - r2; // Far.
+	}
+
+	// Normalize so distances are in world space, to compare to bounds.
+	for (size_t p = 0; p < 6; ++p)
+	{
+		const float len = sqrtf(
+			planes[p][0] * planes[p][0] +
+			planes[p][1] * planes[p][1] +
+			planes[p][2] * planes[p][2]);
+
+		const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+
+		for (size_t c = 0; c < 4; ++c)
+			planes[p][c] *= inv;
+
+		for (size_t c = 0; c < 3; ++c)
+			frustum.absPlanes[p][c] = fabsf(planes[p][c]);
+	}
+
+	// Test all bounds.
+	uint8_t* masks = gfx_vec_at(&list->masks, 0);
+
+	for (size_t b = 0; b < numBlocks; ++b)
+		masks[b] = gfx_draw_list_cull_block_(
+			gfx_vec_at(&list->bounds, b), &frustum);
+
+	// Rebuild the visible partition in a single stable pass,
+	// visible items in the front, invisible items in the back.
+	// Free items are never visible, so the total can be counted in masks.
+	GFXDrawSort_* sorts = gfx_vec_at(&list->sorts, 0);
+	size_t numVisible = 0;
+
+	for (size_t b = 0; b < numBlocks; ++b)
+		for (uint8_t mask = masks[b]; mask; mask &= (uint8_t)(mask - 1))
+			++numVisible;
+
+	size_t vis = 0;
+	size_t invis = numVisible;
+
+	for (size_t p = 0; p < numItems; ++p)
+	{
+		const size_t ind = *(size_t*)gfx_vec_at(&list->inds, p);
+		const bool visible = (masks[ind >> 3] >> (ind & 7)) & 1;
+
+		sorts[visible ? vis++ : invis++].ind = ind;
+	}
+
+	// Write back & mark all items that became visible.
+	// Items that remain visible keep their relative order.
+	const size_t oldVisible = list->numVisible;
+	list->numVisible = numVisible;
+
+	for (size_t p = 0; p < numItems; ++p)
+	{
+		void* item = gfx_vec_at(&list->items, sorts[p].ind);
+
+		*(size_t*)gfx_vec_at(&list->inds, p) = sorts[p].ind;
+
+		if (p < numVisible && GFX_GET_POSITION_(item) >= oldVisible)
+			gfx_draw_list_mark_(list, sorts[p].ind);
+
+		GFX_GET_POSITION_(item) = p;
+	}
+
+	return 1;
 }
 
 /****************************/
@@ -280,9 +1212,33 @@ GFX_API void gfx_draw_list_dirty(GFXDrawList* list)
 {
 	assert(list != NULL);
 
-	// Only flag as dirty if there are visible items.
-	// Also, ignore if we have no comparison function.
-	list->dirty = (list->cmp && list->numVisible > 0) ? 1 : 0;
+	// Recompute all keys when sorting, invisible ones may become visible.
+	list->rekey = (list->key != NULL);
+	gfx_draw_list_flag_(list);
+}
+
+/****************************/
+GFX_API void gfx_draw_list_dirty_elem(GFXDrawList* list, GFXDrawInd ind)
+{
+	assert(list != NULL);
+	assert(ind != 0);
+
+	void* item = gfx_vec_at(&list->items, ind-1);
+
+	if (list->key != NULL)
+		GFX_GET_KEY_(item) = list->key(GFX_GET_ELEMENT_(item));
+
+	// Only re-sort if it is visible.
+	if (GFX_GET_POSITION_(item) < list->numVisible)
+		gfx_draw_list_mark_(list, ind-1);
+}
+
+/****************************/
+GFX_API void gfx_draw_list_set_parallel(GFXDrawList* list, bool parallel)
+{
+	assert(list != NULL);
+
+	list->parallel = parallel;
 }
 
 /****************************/
@@ -290,7 +1246,46 @@ GFX_API void gfx_draw_list_sort(GFXDrawList* list)
 {
 	assert(list != NULL);
 
-	if (list->dirty)
+	// Recompute all keys first, which always requires a full sort.
+	if (list->rekey)
+	{
+		for (size_t p = 0; p < list->inds.size; ++p)
+		{
+			void* item = gfx_vec_at(&list->items,
+				*(size_t*)gfx_vec_at(&list->inds, p));
+
+			GFX_GET_KEY_(item) = list->key(GFX_GET_ELEMENT_(item));
+		}
+
+		list->rekey = 0;
+		gfx_draw_list_flag_(list);
+	}
+
+	// Only some items changed, re-sort only those.
+	// If few that did not move far, insert them, otherwise merge them.
+	// If merging fails, we can still insert them without limit.
+	if (!list->dirty && list->changed.size > 0)
+	{
+		const bool inserted =
+			list->changed.size <= GFX_DRAW_LIST_INSERT_MAX_ &&
+			gfx_draw_list_insert_(list, GFX_DRAW_LIST_INSERT_MOVES_);
+
+		if (!inserted && !gfx_draw_list_merge_(list))
+			gfx_draw_list_insert_(list, SIZE_MAX);
+
+		gfx_vec_release(&list->changed);
+	}
+
+	else if (list->dirty && list->key != NULL)
+	{
+		// If we could not allocate, stay dirty & draw unsorted.
+		if (gfx_draw_list_rsort_(list))
+			list->dirty = 0;
+
+		gfx_vec_release(&list->changed);
+	}
+
+	else if (list->dirty)
 	{
 		// We choose to strictly only use quicksort, without a fallback
 		// to e.g. insertion sort when the input length is small.
@@ -301,6 +1296,7 @@ GFX_API void gfx_draw_list_sort(GFXDrawList* list)
 		gfx_draw_list_qsort_(list, 0, list->numVisible);
 
 		list->dirty = 0;
+		gfx_vec_release(&list->changed);
 	}
 }
 
@@ -320,3 +1316,81 @@ GFX_API void gfx_cmd_draw_list(GFXRecorder* recorder,
 		list->draw(recorder, elem, ptr);
 	}
 }
+
+/****************************/
+GFX_API void gfx_draw_list_render(GFXDrawList* list,
+                                  GFXRecorder* recorder, GFXPass* pass,
+                                  void* ptr)
+{
+	assert(list != NULL);
+	assert(recorder != NULL);
+	assert(pass != NULL);
+
+	// First sort all indices.
+	gfx_draw_list_sort(list);
+
+	const size_t n = list->numVisible;
+	if (n == 0) return;
+
+	// Split the visible range into a few chunks per worker,
+	// so stealing can balance the load, but not into tiny chunks.
+	const size_t numChunks = GFX_MAX(1, GFX_MIN(
+		gfx_job_get_num_workers() * GFX_DRAW_LIST_CHUNKS_,
+		n / GFX_DRAW_LIST_CHUNK_MIN_));
+
+	size_t bounds[numChunks + 1];
+	bounds[0] = 0;
+	bounds[numChunks] = n;
+
+	// Each chunk is recorded without any bound state,
+	// so move each boundary to the biggest state change nearby.
+	// This way chunks do not rebind state the previous chunk had bound.
+	const size_t window = (n / numChunks) >> 2;
+
+	for (size_t c = 1; c < numChunks; ++c)
+	{
+		const size_t target = n * c / numChunks;
+		size_t best = target;
+		uint64_t bestChange = gfx_draw_list_change_(list, target);
+
+		// Search outwards, so the closest of equal changes wins.
+		for (size_t d = 1; d <= window; ++d)
+		{
+			if (target - d > bounds[c-1])
+			{
+				const uint64_t change =
+					gfx_draw_list_change_(list, target - d);
+
+				if (change > bestChange)
+				{
+					best = target - d;
+					bestChange = change;
+				}
+			}
+
+			if (target + d < n)
+			{
+				const uint64_t change =
+					gfx_draw_list_change_(list, target + d);
+
+				if (change > bestChange)
+				{
+					best = target + d;
+					bestChange = change;
+				}
+			}
+		}
+
+		bounds[c] = best;
+	}
+
+	// Record all chunks in parallel, they are submitted in order.
+	GFXDrawRender_ render = {
+		.list = list,
+		.bounds = bounds,
+		.ptr = ptr
+	};
+
+	gfx_recorder_render_range(recorder, pass,
+		numChunks, 1, gfx_draw_list_render_, &render);
+}
@@ -0,0 +1,348 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#include "groufix/drawers/scene.h"
+#include "groufix/core/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+// Size of a single transform, in bytes.
+#define GFX_SCENE_MAT_SIZE_ (sizeof(float) * 16)
+
+
+/****************************
+ * Flattened scene node.
+ */
+typedef struct GFXSceneNode_
+{
+	const GFXGltfNode* node;
+	size_t             parent; // SIZE_MAX if a root node.
+
+} GFXSceneNode_;
+
+
+/****************************
+ * Instance of a primitive/material pair, to be grouped into batches.
+ */
+typedef struct GFXSceneEntry_
+{
+	GFXGltfPrimitive prim;
+	size_t           node;
+
+} GFXSceneEntry_;
+
+
+/****************************
+ * Compares two instances by material, then primitive, then node.
+ * Grouping by material first minimizes material binds when drawing.
+ */
+static int gfx_scene_cmp_(const void* l, const void* r)
+{
+	const GFXSceneEntry_* le = l;
+	const GFXSceneEntry_* re = r;
+
+	const uintptr_t lm = (uintptr_t)le->prim.material;
+	const uintptr_t rm = (uintptr_t)re->prim.material;
+	if (lm != rm) return (lm > rm) - (lm < rm);
+
+	const uintptr_t lp = (uintptr_t)le->prim.primitive;
+	const uintptr_t rp = (uintptr_t)re->prim.primitive;
+	if (lp != rp) return (lp > rp) - (lp < rp);
+
+	return (le->node > re->node) - (le->node < re->node);
+}
+
+/****************************
+ * Multiplies two 4x4 column-major matrices, out = l * r.
+ * out cannot alias l or r.
+ */
+static void gfx_scene_mul_(float* out, const float* l, const float* r)
+{
+	for (size_t c = 0; c < 4; ++c)
+		for (size_t i = 0; i < 4; ++i)
+			out[c*4 + i] =
+				l[0*4 + i] * r[c*4 + 0] +
+				l[1*4 + i] * r[c*4 + 1] +
+				l[2*4 + i] * r[c*4 + 2] +
+				l[3*4 + i] * r[c*4 + 3];
+}
+
+/****************************
+ * Frees all built data of a drawer, leaving it empty.
+ * @param drawer Cannot be NULL.
+ */
+static void gfx_scene_free_(GFXSceneDrawer* drawer)
+{
+	assert(drawer != NULL);
+
+	if (drawer->tset != NULL)
+		gfx_erase_set(drawer->tset);
+
+	if (drawer->data != NULL)
+		gfx_unmap(gfx_ref_buffer(drawer->transforms));
+
+	gfx_free_buffer(drawer->transforms);
+
+	gfx_vec_clear(&drawer->nodes);
+	gfx_vec_clear(&drawer->worlds);
+	gfx_vec_clear(&drawer->instances);
+	gfx_vec_clear(&drawer->batches);
+
+	drawer->transforms = NULL;
+	drawer->tset = NULL;
+	drawer->data = NULL;
+}
+
+/****************************/
+GFX_API void gfx_scene_init(GFXSceneDrawer* drawer, GFXRenderer* renderer,
+                            GFXPass* pass, GFXTechnique* tech,
+                            const GFXRenderState* state,
+                            size_t set, size_t binding, GFXHeap* heap)
+{
+	assert(drawer != NULL);
+	assert(renderer != NULL);
+	assert(pass != NULL);
+	assert(gfx_pass_get_renderer(pass) == renderer);
+	assert(gfx_pass_get_type(pass) == GFX_PASS_RENDER);
+	assert(tech != NULL);
+	assert(gfx_tech_get_renderer(tech) == renderer);
+
+	// Use the renderer's heap if none is given.
+	if (heap == NULL)
+		heap = gfx_renderer_get_heap(renderer);
+
+	drawer->heap = heap;
+	drawer->renderer = renderer;
+	drawer->pass = pass;
+	drawer->tech = tech;
+	drawer->state = state;
+	drawer->set = set;
+	drawer->binding = binding;
+
+	gfx_vec_init(&drawer->nodes, sizeof(GFXSceneNode_));
+	gfx_vec_init(&drawer->worlds, GFX_SCENE_MAT_SIZE_);
+	gfx_vec_init(&drawer->instances, sizeof(size_t));
+	gfx_vec_init(&drawer->batches, sizeof(GFXSceneBatch));
+
+	drawer->transforms = NULL;
+	drawer->tset = NULL;
+	drawer->data = NULL;
+}
+
+/****************************/
+GFX_API void gfx_scene_clear(GFXSceneDrawer* drawer)
+{
+	assert(drawer != NULL);
+
+	gfx_scene_free_(drawer);
+
+	// Leave all values, drawer is invalidated.
+}
+
+/****************************/
+GFX_API bool gfx_scene_build(GFXSceneDrawer* drawer, const GFXGltfScene* scene)
+{
+	assert(drawer != NULL);
+	assert(scene != NULL);
+
+	const unsigned int numFrames =
+		gfx_renderer_get_num_frames(drawer->renderer);
+
+	// Free the old scene first.
+	gfx_scene_free_(drawer);
+
+	GFXVec entries;
+	gfx_vec_init(&entries, sizeof(GFXSceneEntry_));
+
+	// Flatten the node hierarchy breadth-first,
+	// so every parent comes before all of its children.
+	for (size_t n = 0; n < scene->numNodes; ++n)
+		if (!gfx_vec_push(&drawer->nodes, 1,
+			&(GFXSceneNode_){ .node = scene->nodes[n], .parent = SIZE_MAX }))
+		{
+			goto clean;
+		}
+
+	for (size_t n = 0; n < drawer->nodes.size; ++n)
+	{
+		const GFXGltfNode* node =
+			((GFXSceneNode_*)gfx_vec_at(&drawer->nodes, n))->node;
+
+		for (size_t c = 0; c < node->numChildren; ++c)
+			if (!gfx_vec_push(&drawer->nodes, 1,
+				&(GFXSceneNode_){ .node = node->children[c], .parent = n }))
+			{
+				goto clean;
+			}
+
+		// Each drawable primitive of its mesh is an instance.
+		if (node->mesh != NULL)
+			for (size_t p = 0; p < node->mesh->numPrimitives; ++p)
+			{
+				const GFXGltfPrimitive* prim = &node->mesh->primitives[p];
+				if (prim->primitive == NULL) continue;
+
+				if (!gfx_vec_push(&entries, 1,
+					&(GFXSceneEntry_){ .prim = *prim, .node = n }))
+				{
+					goto clean;
+				}
+			}
+	}
+
+	if (drawer->nodes.size > 0 &&
+		!gfx_vec_push(&drawer->worlds, drawer->nodes.size, NULL))
+	{
+		goto clean;
+	}
+
+	// Nothing to draw, done.
+	if (entries.size == 0)
+	{
+		gfx_vec_clear(&entries);
+		return 1;
+	}
+
+	if (entries.size > UINT32_MAX / numFrames)
+		goto clean;
+
+	// Group identical primitive/material pairs into batches.
+	qsort(entries.data, entries.size, sizeof(GFXSceneEntry_), gfx_scene_cmp_);
+
+	if (!gfx_vec_reserve(&drawer->instances, entries.size))
+		goto clean;
+
+	for (size_t e = 0; e < entries.size; ++e)
+	{
+		const GFXSceneEntry_* entry = gfx_vec_at(&entries, e);
+		GFXSceneBatch* batch = drawer->batches.size > 0 ?
+			gfx_vec_at(&drawer->batches, drawer->batches.size - 1) : NULL;
+
+		if (
+			batch == NULL ||
+			batch->prim.primitive != entry->prim.primitive ||
+			batch->prim.material != entry->prim.material)
+		{
+			if (!gfx_vec_push(&drawer->batches, 1, NULL))
+				goto clean;
+
+			batch = gfx_vec_at(&drawer->batches, drawer->batches.size - 1);
+			batch->prim = entry->prim;
+			batch->firstInstance = (uint32_t)e;
+			batch->numInstances = 0;
+
+			if (!gfx_renderable(&batch->renderable,
+				drawer->pass, drawer->tech,
+				entry->prim.primitive, drawer->state))
+			{
+				goto clean;
+			}
+		}
+
+		++batch->numInstances;
+		gfx_vec_push(&drawer->instances, 1, &entry->node);
+	}
+
+	gfx_vec_clear(&entries);
+
+	// Allocate & map the transforms of all frames, streamed every frame.
+	drawer->transforms = gfx_alloc_buffer(drawer->heap,
+		GFX_MEMORY_HOST_VISIBLE | GFX_MEMORY_DEVICE_LOCAL,
+		GFX_BUFFER_STORAGE,
+		GFX_SCENE_MAT_SIZE_ * drawer->instances.size * numFrames);
+
+	if (drawer->transforms == NULL)
+		goto clean;
+
+	drawer->data = gfx_map(gfx_ref_buffer(drawer->transforms));
+	if (drawer->data == NULL)
+		goto clean;
+
+	drawer->tset = gfx_renderer_add_set(drawer->renderer,
+		drawer->tech, drawer->set,
+		1, 0, 0, 0,
+		(GFXSetResource[]){{
+			.binding = drawer->binding,
+			.index = 0,
+			.ref = gfx_ref_buffer(drawer->transforms)
+		}},
+		NULL, NULL, NULL);
+
+	if (drawer->tset == NULL)
+		goto clean;
+
+	return 1;
+
+
+	// Cleanup on failure.
+clean:
+	gfx_vec_clear(&entries);
+	gfx_scene_free_(drawer);
+	gfx_log_error("Could not build a glTF scene for an instanced scene drawer.");
+
+	return 0;
+}
+
+/****************************/
+GFX_API void gfx_cmd_scene(GFXRecorder* recorder, GFXSceneDrawer* drawer,
+                           void (*material)(GFXRecorder*,
+                                            const GFXGltfMaterial*, void*),
+                           void* ptr)
+{
+	assert(recorder != NULL);
+	assert(drawer != NULL);
+	assert(gfx_recorder_get_pass(recorder) == drawer->pass);
+
+	if (drawer->batches.size == 0)
+		return;
+
+	// Compute all world matrices, parents are always computed first.
+	for (size_t n = 0; n < drawer->nodes.size; ++n)
+	{
+		const GFXSceneNode_* node = gfx_vec_at(&drawer->nodes, n);
+		float* world = gfx_vec_at(&drawer->worlds, n);
+
+		if (node->parent == SIZE_MAX)
+			memcpy(world, node->node->matrix, GFX_SCENE_MAT_SIZE_);
+		else
+			gfx_scene_mul_(world,
+				gfx_vec_at(&drawer->worlds, node->parent), node->node->matrix);
+	}
+
+	// Stream them into this frame's transforms in one contiguous write.
+	const unsigned int frame = gfx_recorder_get_frame_index(recorder);
+	const uint32_t base = (uint32_t)drawer->instances.size * frame;
+	float* data = drawer->data + (size_t)base * 16;
+
+	for (size_t i = 0; i < drawer->instances.size; ++i)
+		memcpy(data + i * 16,
+			gfx_vec_at(&drawer->worlds,
+				*(size_t*)gfx_vec_at(&drawer->instances, i)),
+			GFX_SCENE_MAT_SIZE_);
+
+	// Draw all batches, each with a single instanced draw.
+	// gl_InstanceIndex includes the first instance, which we offset
+	// to the current frame's transforms.
+	gfx_cmd_bind(recorder, drawer->tech,
+		drawer->set, 1, 0, &drawer->tset, NULL);
+
+	for (size_t b = 0; b < drawer->batches.size; ++b)
+	{
+		GFXSceneBatch* batch = gfx_vec_at(&drawer->batches, b);
+
+		if (material != NULL && (b == 0 ||
+			batch->prim.material != (batch - 1)->prim.material))
+		{
+			material(recorder, batch->prim.material, ptr);
+		}
+
+		gfx_cmd_draw_prim(recorder, &batch->renderable,
+			batch->numInstances, base + batch->firstInstance);
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#define TEST_SKIP_CREATE_WINDOW
+#define TEST_NUM_FRAMES 1
+#include "test.h"
+
+
+// #shaders to compile at once, enough to keep all workers busy.
+#define TEST_NUM_SHADERS 16
+
+
+/****************************
+ * Shaders to batch compile, the last one is invalid.
+ */
+static const char* glsl_vertex =
+	"#version 450\n"
+	"layout(location = 0) in vec3 vPosition;\n"
+	"void main() {\n"
+	"  gl_Position = vec4(vPosition, 1.0f);\n"
+	"}\n";
+
+static const char* glsl_fragment =
+	"#version 450\n"
+	"layout(location = 0) out vec4 oColor;\n"
+	"void main() {\n"
+	"  oColor = vec4(1.0f);\n"
+	"}\n";
+
+static const char* glsl_compute =
+	"#version 450\n"
+	"layout(set = 0, binding = 0, std430) buffer Values {\n"
+	"  float values[];\n"
+	"};\n"
+	"void main() {\n"
+	"  values[gl_GlobalInvocationID.x] *= 2.0f;\n"
+	"}\n";
+
+static const char* glsl_invalid =
+	"#version 450\n"
+	"void main() {\n"
+	"  undeclared = 1.0f;\n"
+	"}\n";
+
+
+/****************************
+ * Batch shader compilation test.
+ */
+TEST_DESCRIBE(compile, t)
+{
+	bool success = 0;
+
+	GFXShader* shaders[TEST_NUM_SHADERS] = { NULL };
+	GFXShaderSource sources[TEST_NUM_SHADERS];
+	GFXStringReader strs[TEST_NUM_SHADERS];
+	bool results[TEST_NUM_SHADERS];
+
+	// Create a mix of shaders, each with its own source stream.
+	for (size_t s = 0; s < TEST_NUM_SHADERS; ++s)
+	{
+		const bool invalid = (s == TEST_NUM_SHADERS - 1);
+
+		const GFXShaderStage stage =
+			invalid ? GFX_STAGE_COMPUTE :
+			(s % 3 == 0) ? GFX_STAGE_VERTEX :
+			(s % 3 == 1) ? GFX_STAGE_FRAGMENT : GFX_STAGE_COMPUTE;
+
+		const char* glsl =
+			invalid ? glsl_invalid :
+			(s % 3 == 0) ? glsl_vertex :
+			(s % 3 == 1) ? glsl_fragment : glsl_compute;
+
+		shaders[s] = gfx_create_shader(stage, t->device);
+		if (shaders[s] == NULL)
+			goto clean;
+
+		sources[s] = (GFXShaderSource){
+			.language = GFX_GLSL,
+			.optimize = 1,
+			.src = gfx_string_reader(&strs[s], glsl)
+		};
+	}
+
+	// Compile all shaders at once, only the invalid one should fail.
+	const size_t compiled =
+		gfx_shaders_compile(TEST_NUM_SHADERS, shaders, sources, results);
+
+	gfx_log_info("\n"
+		"Shaders:\n"
+		"    %u\n"
+		"Compiled:\n"
+		"    %"GFX_PRIs"\n",
+		(unsigned int)TEST_NUM_SHADERS,
+		compiled);
+
+	if (compiled != TEST_NUM_SHADERS - 1)
+		goto clean;
+
+	for (size_t s = 0; s < TEST_NUM_SHADERS; ++s)
+		if (results[s] != (s != TEST_NUM_SHADERS - 1))
+			goto clean;
+
+	success = 1;
+
+
+	// Cleanup.
+clean:
+	for (size_t s = 0; s < TEST_NUM_SHADERS; ++s)
+		gfx_destroy_shader(shaders[s]);
+
+	if (!success) TEST_FAIL();
+}
+
+
+/****************************
+ * Run the batch shader compilation test.
+ */
+TEST_MAIN(compile);
@@ -0,0 +1,233 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#define TEST_SKIP_CREATE_WINDOW
+#define TEST_NUM_FRAMES 1
+#include <groufix/drawers/cull.h>
+#include <groufix/drawers/list.h>
+#include "test.h"
+#include <math.h>
+#include <string.h>
+
+
+// #instances to cull, spans multiple workgroups.
+#define TEST_NUM_INSTANCES 1000
+
+// #frames to cull, counters must be reset inbetween.
+#define TEST_NUM_RUNS 3
+
+// Near & far planes of the view frustum.
+#define TEST_ZNEAR 0.1f
+#define TEST_ZFAR 100.0f
+
+
+/****************************
+ * Perspective looking down -z, 90 degree fov, depth in [0,1].
+ */
+static const float viewProj[16] = {
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, -1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, TEST_ZFAR / (TEST_ZNEAR - TEST_ZFAR), -1.0f,
+	0.0f, 0.0f, (TEST_ZNEAR * TEST_ZFAR) / (TEST_ZNEAR - TEST_ZFAR), 0.0f
+};
+
+
+/****************************
+ * Draw list draw function, never called.
+ */
+static void draw(GFXRecorder* recorder, const void* elem, void* ptr)
+{
+}
+
+/****************************
+ * Compute callback, culls all instances.
+ */
+static void compute(GFXRecorder* recorder, void* ptr)
+{
+	gfx_cmd_cull(recorder, ptr, viewProj);
+}
+
+/****************************
+ * Returns a pseudo-random float in [min, max).
+ */
+static float random_float(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / ((float)RAND_MAX + 1.0f));
+}
+
+
+/****************************
+ * GPU culling test, compares against CPU culling of a draw list.
+ */
+TEST_DESCRIBE(cull, t)
+{
+	bool success = 0;
+
+	GFXDevice* dev = gfx_renderer_get_device(t->renderer);
+	if (!dev->features.indirectCount)
+	{
+		gfx_log_warn("Indirect draw counts not supported, skipping test.");
+		return;
+	}
+
+	// Generate a mix of spheres & boxes around the frustum.
+	GFXCullInstance instances[TEST_NUM_INSTANCES];
+	srand(42);
+
+	for (uint32_t i = 0; i < TEST_NUM_INSTANCES; ++i)
+	{
+		const bool box = i % 2;
+		const float size = random_float(0.1f, 2.0f);
+
+		instances[i] = (GFXCullInstance){
+			.center = {
+				random_float(-60.0f, 60.0f),
+				random_float(-60.0f, 60.0f),
+				random_float(-120.0f, 20.0f)
+			},
+			.radius = (i % 100 == 0) ? INFINITY : (box ? 0.0f : size),
+			.extents = {
+				box ? size : 0.0f,
+				box ? size * 0.5f : 0.0f,
+				box ? size * 2.0f : 0.0f
+			},
+			.cmd = {
+				.indices = 3,
+				.instances = 1,
+				.firstIndex = 0,
+				.vertexOffset = 0,
+				.firstInstance = i
+			}
+		};
+	}
+
+	// Cull the same instances on the CPU.
+	GFXDrawList list;
+	GFXDrawInd inds[TEST_NUM_INSTANCES];
+	gfx_draw_list_init(&list, sizeof(uint32_t), draw, NULL);
+
+	for (uint32_t i = 0; i < TEST_NUM_INSTANCES; ++i)
+	{
+		const GFXCullInstance* inst = &instances[i];
+		const GFXDrawInd ind = inds[i] = gfx_draw_list_add(&list, &i, 1);
+
+		if (ind == 0)
+			goto clean_list;
+
+		if (inst->radius > 0.0f)
+		{
+			if (!gfx_draw_list_set_sphere(&list, ind, inst->center, inst->radius))
+				goto clean_list;
+		}
+		else
+		{
+			const float min[3] = {
+				inst->center[0] - inst->extents[0],
+				inst->center[1] - inst->extents[1],
+				inst->center[2] - inst->extents[2]
+			};
+			const float max[3] = {
+				inst->center[0] + inst->extents[0],
+				inst->center[1] + inst->extents[1],
+				inst->center[2] + inst->extents[2]
+			};
+
+			if (!gfx_draw_list_set_aabb(&list, ind, min, max))
+				goto clean_list;
+		}
+	}
+
+	if (!gfx_draw_list_cull(&list, viewProj))
+		goto clean_list;
+
+	// Add an inline compute pass & init the drawer.
+	GFXPass* pass = gfx_renderer_add_pass(
+		t->renderer, GFX_PASS_COMPUTE_INLINE, 0, 0, NULL);
+
+	if (pass == NULL)
+		goto clean_list;
+
+	GFXCullDrawer drawer;
+	if (!gfx_cull_init(&drawer, t->renderer, pass, NULL, NULL))
+		goto clean_list;
+
+	if (!gfx_cull_upload(&drawer, TEST_NUM_INSTANCES, instances))
+		goto clean;
+
+	gfx_pass_inject(pass, 1, (GFXInject[]){
+		gfx_sem_sigrf(t->sem,
+			GFX_ACCESS_STORAGE_READ_WRITE, GFX_STAGE_COMPUTE,
+			GFX_ACCESS_HOST_READ, GFX_STAGE_ANY,
+			gfx_ref_buffer(drawer.out))
+	});
+
+	// Cull multiple times, the shader must reset its own counters.
+	for (unsigned int r = 0; r < TEST_NUM_RUNS; ++r)
+	{
+		GFXFrame* frame = gfx_renderer_start(t->renderer);
+		gfx_recorder_compute(t->recorder, pass, compute, &drawer);
+		gfx_frame_submit(frame);
+		gfx_frame_block(frame);
+
+		const uint32_t* out = gfx_map(gfx_ref_buffer(drawer.out));
+		if (out == NULL)
+			goto clean;
+
+		// Check the compacted count & that all draws are visible ones.
+		const uint32_t count = out[2];
+		const GFXDrawIndexedCmd* cmds = (const GFXDrawIndexedCmd*)(out + 4);
+		bool valid = count == list.numVisible && out[0] == 0 && out[1] == 0;
+		bool drawn[TEST_NUM_INSTANCES] = { 0 };
+
+		for (uint32_t c = 0; valid && c < count; ++c)
+		{
+			const uint32_t i = cmds[c].firstInstance;
+			valid = i < TEST_NUM_INSTANCES && !drawn[i] &&
+				gfx_draw_list_is_visible(&list, inds[i]) &&
+				memcmp(&cmds[c], &instances[i].cmd, sizeof(cmds[c])) == 0;
+
+			if (valid) drawn[i] = 1;
+		}
+
+		gfx_log_info("\n"
+			"Instances:\n"
+			"    %u\n"
+			"CPU visible:\n"
+			"    %"GFX_PRIs"\n"
+			"GPU visible:\n"
+			"    %u\n",
+			(unsigned int)TEST_NUM_INSTANCES,
+			list.numVisible,
+			(unsigned int)count);
+
+		gfx_unmap(gfx_ref_buffer(drawer.out));
+
+		if (!valid)
+		{
+			gfx_log_error("GPU culling results are not as expected!");
+			goto clean;
+		}
+	}
+
+	success = 1;
+
+
+	// Cleanup.
+clean:
+	gfx_cull_clear(&drawer);
+clean_list:
+	gfx_draw_list_clear(&list);
+
+	if (!success) TEST_FAIL();
+}
+
+
+/****************************
+ * Run the GPU culling test.
+ */
+TEST_MAIN(cull);
@@ -0,0 +1,177 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#define TEST_SKIP_CREATE_WINDOW
+#include <groufix/drawers/list.h>
+#include "test.h"
+#include <time.h>
+
+
+// #sorts to average over.
+#define TEST_NUM_AVG 10
+
+// Every TEST_HIDE'th element is invisible, i.e. 75% is visible.
+#define TEST_HIDE 4
+
+
+/****************************
+ * Draw list element, sorted by key.
+ */
+typedef struct TestElem
+{
+	uint64_t key;
+
+} TestElem;
+
+
+/****************************
+ * Draw order check state.
+ */
+typedef struct TestCheck
+{
+	uint64_t prev;
+	bool     sorted;
+
+} TestCheck;
+
+
+/****************************
+ * Compares two elements by key.
+ */
+static int cmp(const void* l, const void* r)
+{
+	const uint64_t lKey = ((const TestElem*)l)->key;
+	const uint64_t rKey = ((const TestElem*)r)->key;
+
+	return (lKey > rKey) - (lKey < rKey);
+}
+
+/****************************
+ * Retrieves the key of an element.
+ */
+static uint64_t key(const void* elem)
+{
+	return ((const TestElem*)elem)->key;
+}
+
+/****************************
+ * Draw function, checks elements are drawn in order of key.
+ */
+static void draw(GFXRecorder* recorder, const void* elem, void* ptr)
+{
+	TestCheck* check = ptr;
+	const uint64_t k = ((const TestElem*)elem)->key;
+
+	if (k < check->prev) check->sorted = 0;
+	check->prev = k;
+}
+
+/****************************
+ * Generates a random 64-bit key with few distinct high bits,
+ * like a typical pipeline/material/depth packed key.
+ */
+static uint64_t random_key(void)
+{
+	return
+		((uint64_t)(rand() & 0x3f) << 58) |
+		((uint64_t)(rand() & 0xff) << 32) |
+		((uint64_t)rand() & 0xffffffff);
+}
+
+/****************************
+ * Times sorting a draw list with fresh keys, in milliseconds.
+ */
+static double bench(GFXDrawList* list, size_t numItems, const uint64_t* keys)
+{
+	double total = 0.0;
+
+	for (unsigned int i = 0; i < TEST_NUM_AVG; ++i)
+	{
+		// Give all elements new keys & flag it as dirty.
+		for (size_t e = 0; e < numItems; ++e)
+			((TestElem*)gfx_draw_list_get(list, e + 1))->key =
+				keys[(e + i * 7919) % numItems];
+
+		gfx_draw_list_dirty(list);
+
+		struct timespec start, end;
+		timespec_get(&start, TIME_UTC);
+		gfx_draw_list_sort(list);
+		timespec_get(&end, TIME_UTC);
+
+		total +=
+			(double)(end.tv_sec - start.tv_sec) * 1000.0 +
+			(double)(end.tv_nsec - start.tv_nsec) / 1000000.0;
+	}
+
+	return total / TEST_NUM_AVG;
+}
+
+
+/****************************
+ * Draw list sorting benchmark, quicksort vs. radix sort.
+ */
+TEST_DESCRIBE(drawlist, t)
+{
+	const size_t sizes[] = { 10000, 100000, 1000000 };
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		const size_t numItems = sizes[s];
+
+		uint64_t* keys = malloc(sizeof(uint64_t) * numItems);
+		if (keys == NULL)
+			TEST_FAIL();
+
+		for (size_t e = 0; e < numItems; ++e)
+			keys[e] = random_key();
+
+		// Create a list for each sort mode, with the same elements.
+		GFXDrawList lists[3];
+		gfx_draw_list_init(&lists[0], sizeof(TestElem), draw, cmp);
+		gfx_draw_list_init_keyed(&lists[1], sizeof(TestElem), draw, key);
+		gfx_draw_list_init_keyed(&lists[2], sizeof(TestElem), draw, key);
+		gfx_draw_list_set_parallel(&lists[2], 1);
+
+		for (size_t l = 0; l < 3; ++l)
+			for (size_t e = 0; e < numItems; ++e)
+				if (!gfx_draw_list_add(&lists[l], &(TestElem){ keys[e] },
+					e % TEST_HIDE != TEST_HIDE - 1))
+				{
+					TEST_FAIL();
+				}
+
+		const double qsortTime = bench(&lists[0], numItems, keys);
+		const double radixTime = bench(&lists[1], numItems, keys);
+		const double parallelTime = bench(&lists[2], numItems, keys);
+
+		printf(
+			"Sort %"GFX_PRIs" items: "
+			"quicksort %f ms, radix %f ms, parallel radix %f ms.\n",
+			numItems, qsortTime, radixTime, parallelTime);
+
+		// Check all lists are actually sorted.
+		for (size_t l = 0; l < 3; ++l)
+		{
+			TestCheck check = { .prev = 0, .sorted = 1 };
+			gfx_cmd_draw_list(NULL, &lists[l], &check);
+			gfx_draw_list_clear(&lists[l]);
+
+			if (!check.sorted)
+				TEST_FAIL();
+		}
+
+		free(keys);
+	}
+}
+
+
+/****************************
+ * Run the draw list benchmark.
+ */
+TEST_MAIN(drawlist);
@@ -0,0 +1,169 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#define TEST_SKIP_CREATE_WINDOW
+#define TEST_NUM_FRAMES 1
+#include "test.h"
+#include <time.h>
+
+
+// #re-analyses to average over.
+#define TEST_NUM_AVG 10
+
+// #passes sharing the same attachment, i.e. the length of a subpass chain.
+#define TEST_CHAIN_LENGTH 8
+
+
+/****************************
+ * Times a single frame, in milliseconds.
+ */
+static double bench_frame(GFXRenderer* renderer)
+{
+	struct timespec start, end;
+	timespec_get(&start, TIME_UTC);
+
+	GFXFrame* frame = gfx_renderer_start(renderer);
+	gfx_frame_submit(frame);
+
+	timespec_get(&end, TIME_UTC);
+	gfx_frame_block(frame);
+
+	return
+		(double)(end.tv_sec - start.tv_sec) * 1000.0 +
+		(double)(end.tv_nsec - start.tv_nsec) / 1000000.0;
+}
+
+/****************************
+ * Builds a render graph of numPasses passes, each the child of the previous.
+ * Every TEST_CHAIN_LENGTH passes write to their own attachment and sample
+ * the attachment of the previous group, so they merge into subpass chains.
+ * @return NULL on failure.
+ */
+static GFXRenderer* build_graph(TestBase* t, size_t numPasses, GFXPass** passes)
+{
+	GFXRenderer* renderer = gfx_create_renderer(t->heap, TEST_NUM_FRAMES);
+	if (renderer == NULL) return NULL;
+
+	const size_t numAttachs =
+		(numPasses + TEST_CHAIN_LENGTH - 1) / TEST_CHAIN_LENGTH;
+
+	for (size_t a = 0; a < numAttachs; ++a)
+		if (!gfx_renderer_attach(renderer, a,
+			(GFXAttachment){
+				.type  = GFX_IMAGE_2D,
+				.flags = GFX_MEMORY_NONE,
+				.usage = GFX_IMAGE_OUTPUT | GFX_IMAGE_SAMPLED,
+
+				.format  = GFX_FORMAT_R8G8B8A8_UNORM,
+				.samples = 1,
+				.mipmaps = 1,
+				.layers  = 1,
+
+				.size = GFX_SIZE_ABSOLUTE,
+				.width = 16,
+				.height = 16,
+				.depth = 1
+			}))
+		{
+			goto error;
+		}
+
+	for (size_t p = 0; p < numPasses; ++p)
+	{
+		const size_t a = p / TEST_CHAIN_LENGTH;
+
+		passes[p] = gfx_renderer_add_pass(renderer, GFX_PASS_RENDER, 0,
+			p > 0 ? 1 : 0, p > 0 ? &passes[p - 1] : NULL);
+
+		if (passes[p] == NULL)
+			goto error;
+
+		if (!gfx_pass_consume(passes[p], a,
+			GFX_ACCESS_ATTACHMENT_WRITE, GFX_STAGE_ANY))
+		{
+			goto error;
+		}
+
+		if (a > 0 && !gfx_pass_consume(passes[p], a - 1,
+			GFX_ACCESS_SAMPLED_READ, GFX_STAGE_FRAGMENT))
+		{
+			goto error;
+		}
+	}
+
+	return renderer;
+
+
+	// Cleanup on failure.
+error:
+	gfx_destroy_renderer(renderer);
+
+	return NULL;
+}
+
+
+/****************************
+ * Render graph analysis benchmark, re-analyzing graphs of varying size.
+ */
+TEST_DESCRIBE(graph, t)
+{
+	const size_t sizes[] = { 10, 100, 500, 1000, 2000 };
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		const size_t numPasses = sizes[s];
+
+		GFXPass** passes = malloc(sizeof(GFXPass*) * numPasses);
+		if (passes == NULL)
+			TEST_FAIL();
+
+		GFXRenderer* renderer = build_graph(t, numPasses, passes);
+		if (renderer == NULL)
+			TEST_FAIL();
+
+		// Build everything once.
+		const double buildTime = bench_frame(renderer);
+
+		// Then time frames that only re-analyze the graph.
+		// Setting the same parents invalidates the graph,
+		// but no pass its output changes, so nothing is rebuilt.
+		double frameTime = 0.0;
+		double analyzeTime = 0.0;
+
+		for (unsigned int i = 0; i < TEST_NUM_AVG; ++i)
+		{
+			frameTime += bench_frame(renderer);
+
+			if (!gfx_pass_set_parents(passes[numPasses - 1],
+				numPasses > 1 ? 1 : 0,
+				numPasses > 1 ? &passes[numPasses - 2] : NULL))
+			{
+				TEST_FAIL();
+			}
+
+			analyzeTime += bench_frame(renderer);
+		}
+
+		frameTime /= TEST_NUM_AVG;
+		analyzeTime /= TEST_NUM_AVG;
+
+		printf(
+			"Graph of %"GFX_PRIs" passes: "
+			"build %f ms, frame %f ms, re-analyzed frame %f ms.\n",
+			numPasses, buildTime, frameTime, analyzeTime);
+
+		gfx_destroy_renderer(renderer);
+		free(passes);
+	}
+}
+
+
+/****************************
+ * Run the render graph benchmark.
+ */
+TEST_MAIN(graph);
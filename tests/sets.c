@@ -0,0 +1,156 @@
+/**
+ * This file is part of groufix.
+ * Copyright (c) Stef Velzel. All rights reserved.
+ *
+ * groufix : graphics engine produced by Stef Velzel.
+ * www     : <www.vuzzel.nl>
+ */
+
+#include "test.h"
+#include <time.h>
+
+
+// #sets to keep alive & #frames to average over.
+#define TEST_NUM_SETS 100000
+#define TEST_NUM_AVG 100
+
+// Uniform buffer offset alignment to use (maximum of all devices).
+#define TEST_UBO_ALIGN 256
+
+
+/****************************
+ * Renders by binding all sets.
+ */
+static void render(GFXRecorder* recorder, void* ptr)
+{
+	GFXSet** sets = ptr;
+
+	// Bind all sets, so the pool has to hold all of them each frame.
+	for (size_t s = 0; s < TEST_NUM_SETS; ++s)
+		gfx_cmd_bind(recorder, TEST_BASE.technique, 0, 1, 0, sets + s, NULL);
+
+	// And draw something at the end.
+	TEST_CALLBACK_RENDER(recorder, NULL);
+}
+
+
+/****************************
+ * Descriptor pool flush benchmark with many live sets.
+ */
+TEST_DESCRIBE(sets, t)
+{
+	// Triple buffer the window so we're not limited by v-sync.
+	gfx_window_set_flags(
+		t->window,
+		gfx_window_get_flags(t->window) | GFX_WINDOW_TRIPLE_BUFFER);
+
+	// Allocate a uniform buffer to give each set a distinct descriptor.
+	GFXBuffer* buffer = gfx_alloc_buffer(t->heap,
+		GFX_MEMORY_NONE, GFX_BUFFER_UNIFORM,
+		(uint64_t)TEST_NUM_SETS * TEST_UBO_ALIGN);
+
+	if (buffer == NULL)
+		TEST_FAIL();
+
+	// And a single image they can all sample.
+	uint8_t imgData[] = {
+		255, 255, 255, 255,
+		255, 255, 255, 255,
+		255, 255, 255, 255,
+		255, 255, 255, 255
+	};
+
+	GFXImage* image = gfx_alloc_image(t->heap,
+		GFX_IMAGE_2D, GFX_MEMORY_WRITE,
+		GFX_IMAGE_SAMPLED, GFX_FORMAT_R8_UNORM, 1, 1,
+		4, 4, 1);
+
+	if (image == NULL)
+		TEST_FAIL();
+
+	if (!gfx_write(imgData, gfx_ref_image(image), GFX_TRANSFER_BLOCK, 1, 0,
+		(GFXRegion[]){{
+			.offset = 0,
+			.rowSize = 0,
+			.numRows = 0
+		}},
+		(GFXRegion[]){{
+			.aspect = GFX_IMAGE_COLOR,
+			.mipmap = 0, .layer = 0,  .numLayers = 1,
+			.x = 0,      .y = 0,      .z = 0,
+			.width = 4,  .height = 4, .depth = 1
+		}},
+		NULL))
+	{
+		TEST_FAIL();
+	}
+
+	// Create all the sets.
+	GFXSet** sets = malloc(sizeof(GFXSet*) * TEST_NUM_SETS);
+	if (sets == NULL)
+		TEST_FAIL();
+
+	for (size_t s = 0; s < TEST_NUM_SETS; ++s)
+	{
+		sets[s] = gfx_renderer_add_set(t->renderer,
+			t->technique, 0,
+			2, 0, 0, 0,
+			(GFXSetResource[]){
+				{
+					.binding = 0,
+					.index = 0,
+					.ref = gfx_ref_buffer_at(buffer, s * TEST_UBO_ALIGN)
+				}, {
+					.binding = 1,
+					.index = 0,
+					.ref = gfx_ref_image(image)
+				}
+			},
+			NULL, NULL, NULL);
+
+		if (sets[s] == NULL)
+			TEST_FAIL();
+	}
+
+	// Setup an event loop, timing every frame submission.
+	// Submission is where the descriptor pool is flushed.
+	double total = 0.0;
+	unsigned int frames = 0;
+
+	while (!gfx_window_should_close(t->window))
+	{
+		GFXFrame* frame = gfx_renderer_start(t->renderer);
+		gfx_poll_events();
+		gfx_recorder_render(t->recorder, t->pass, render, sets);
+
+		struct timespec start, end;
+		timespec_get(&start, TIME_UTC);
+		gfx_frame_submit(frame);
+		timespec_get(&end, TIME_UTC);
+
+		total +=
+			(double)(end.tv_sec - start.tv_sec) * 1000.0 +
+			(double)(end.tv_nsec - start.tv_nsec) / 1000000.0;
+
+		if (++frames == TEST_NUM_AVG)
+		{
+			printf("Submit with %u sets: %f ms (average of %u frames).\n",
+				TEST_NUM_SETS, total / TEST_NUM_AVG, TEST_NUM_AVG);
+
+			total = 0.0;
+			frames = 0;
+		}
+	}
+
+	// Erase all sets again, memory is freed with the heap.
+	for (size_t s = 0; s < TEST_NUM_SETS; ++s)
+		gfx_erase_set(sets[s]);
+
+	free(sets);
+}
+
+
+/****************************
+ * Run the descriptor sets benchmark.
+ */
+TEST_MAIN(sets);